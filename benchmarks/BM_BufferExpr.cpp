@@ -0,0 +1,87 @@
+/**
+ * ****************************************************************************
+ * Copyright (c) 2017, Robert Lukierski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * ****************************************************************************
+ * Lazy buffer expression benchmarks, fused vs chained.
+ * ****************************************************************************
+ */
+
+#include <BenchmarkCommon.hpp>
+
+#include <VisionCore/Image/BufferExpr.hpp>
+#include <VisionCore/Image/BufferOps.hpp>
+#include <VisionCore/Image/PixelConvert.hpp>
+
+// rescale + clamp -> threshold -> convert to bytes, one pass per step with temporaries
+static void BM_pipelineChained(benchmark::State& state)
+{
+    const std::size_t w = state.range(0), h = state.range(1);
+    vc::bench::ThreadScope threads(state.range(2));
+    vc::Buffer2DManaged<float, vc::TargetHost> buf_in(w, h);
+    vc::Buffer2DManaged<float, vc::TargetHost> buf_tmp1(w, h);
+    vc::Buffer2DManaged<float, vc::TargetHost> buf_tmp2(w, h);
+    vc::Buffer2DManaged<uint8_t, vc::TargetHost> buf_out(w, h);
+    vc::bench::fillRandom(buf_in);
+    
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        vc::image::rescaleBuffer(buf_in, buf_tmp1, 0.5f, 0.1f, 0.0f, 1.0f);
+        vc::image::thresholdBuffer(buf_tmp1, buf_tmp2, 0.5f, 0.25f, 0.75f);
+        vc::image::convertBuffer(buf_tmp2, buf_out);
+        benchmark::ClobberMemory();
+    }
+    
+    vc::bench::setThroughput(state, w * h, w * h * (sizeof(float) + sizeof(uint8_t)));
+}
+
+// same, single pass
+static void BM_pipelineFused(benchmark::State& state)
+{
+    const std::size_t w = state.range(0), h = state.range(1);
+    vc::bench::ThreadScope threads(state.range(2));
+    vc::Buffer2DManaged<float, vc::TargetHost> buf_in(w, h);
+    vc::Buffer2DManaged<uint8_t, vc::TargetHost> buf_out(w, h);
+    vc::bench::fillRandom(buf_in);
+    
+    using namespace vc::image::expr;
+    
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        evaluate(threshold(clamp(scale(buf_in, 0.5f, 0.1f), 0.0f, 1.0f), 0.5f, 0.25f, 0.75f).convert<uint8_t>(), buf_out);
+        benchmark::ClobberMemory();
+    }
+    
+    vc::bench::setThroughput(state, w * h, w * h * (sizeof(float) + sizeof(uint8_t)));
+}
+
+BENCHMARK(BM_pipelineChained)->Apply(vc::bench::ImageArgs);
+BENCHMARK(BM_pipelineFused)->Apply(vc::bench::ImageArgs);
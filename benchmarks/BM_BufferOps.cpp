@@ -0,0 +1,827 @@
+/**
+ * ****************************************************************************
+ * Copyright (c) 2017, Robert Lukierski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * ****************************************************************************
+ * Buffer operations benchmarks.
+ * ****************************************************************************
+ */
+
+#include <BenchmarkCommon.hpp>
+
+#include <VisionCore/Buffers/ImagePyramid.hpp>
+#include <VisionCore/Image/BufferOps.hpp>
+
+// ---------------------------------------------------------------------------
+// Rescaling & normalization
+// ---------------------------------------------------------------------------
+
+template<typename T1, typename T2>
+static void BM_rescaleBuffer(benchmark::State& state)
+{
+    const std::size_t w = state.range(0), h = state.range(1);
+    vc::bench::ThreadScope threads(state.range(2));
+    vc::Buffer2DManaged<T1, vc::TargetHost> buf_in(w, h);
+    vc::Buffer2DManaged<T2, vc::TargetHost> buf_out(w, h);
+    vc::bench::fillRandom(buf_in);
+    
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        vc::image::rescaleBuffer(buf_in, buf_out, 0.5f, 0.1f, 0.0f, 1.0f);
+        benchmark::ClobberMemory();
+    }
+    
+    vc::bench::setThroughput(state, w * h, w * h * (sizeof(T1) + sizeof(T2)));
+}
+
+template<typename T>
+static void BM_rescaleBufferInplace1D(benchmark::State& state)
+{
+    const std::size_t n = state.range(0);
+    vc::bench::ThreadScope threads(state.range(1));
+    vc::Buffer1DManaged<T, vc::TargetHost> buf(n);
+    vc::bench::fillRandom(buf);
+    
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        vc::image::rescaleBufferInplace(buf, T(1.0), T(0.0), T(0.0), T(1.0));
+        benchmark::ClobberMemory();
+    }
+    
+    vc::bench::setThroughput(state, n, n * sizeof(T) * 2);
+}
+
+template<typename T>
+static void BM_rescaleBufferInplace(benchmark::State& state)
+{
+    const std::size_t w = state.range(0), h = state.range(1);
+    vc::bench::ThreadScope threads(state.range(2));
+    vc::Buffer2DManaged<T, vc::TargetHost> buf(w, h);
+    vc::bench::fillRandom(buf);
+    
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        vc::image::rescaleBufferInplace(buf, T(1.0), T(0.0), T(0.0), T(1.0));
+        benchmark::ClobberMemory();
+    }
+    
+    vc::bench::setThroughput(state, w * h, w * h * sizeof(T) * 2);
+}
+
+template<typename T>
+static void BM_rescaleBufferInplaceMinMax(benchmark::State& state)
+{
+    const std::size_t w = state.range(0), h = state.range(1);
+    vc::bench::ThreadScope threads(state.range(2));
+    vc::Buffer2DManaged<T, vc::TargetHost> buf(w, h);
+    vc::bench::fillRandom(buf);
+    
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        vc::image::rescaleBufferInplaceMinMax(buf, T(0.0), T(1.0), T(0.0), T(1.0));
+        benchmark::ClobberMemory();
+    }
+    
+    vc::bench::setThroughput(state, w * h, w * h * sizeof(T) * 2);
+}
+
+template<typename T>
+static void BM_normalizeBufferInplace(benchmark::State& state)
+{
+    const std::size_t w = state.range(0), h = state.range(1);
+    vc::bench::ThreadScope threads(state.range(2));
+    vc::Buffer2DManaged<T, vc::TargetHost> buf(w, h);
+    vc::bench::fillRandom(buf);
+    
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        vc::image::normalizeBufferInplace(buf);
+        benchmark::ClobberMemory();
+    }
+    
+    // stats pass + rescale pass
+    vc::bench::setThroughput(state, w * h, w * h * sizeof(T) * 3);
+}
+
+BENCHMARK_TEMPLATE(BM_rescaleBuffer, uint8_t, float)->Apply(vc::bench::ImageArgs);
+BENCHMARK_TEMPLATE(BM_rescaleBuffer, uint16_t, float)->Apply(vc::bench::ImageArgs);
+BENCHMARK_TEMPLATE(BM_rescaleBuffer, uint32_t, float)->Apply(vc::bench::ImageArgs);
+BENCHMARK_TEMPLATE(BM_rescaleBuffer, float, float)->Apply(vc::bench::ImageArgs);
+BENCHMARK_TEMPLATE(BM_rescaleBuffer, float, uint8_t)->Apply(vc::bench::ImageArgs);
+BENCHMARK_TEMPLATE(BM_rescaleBuffer, float, uint16_t)->Apply(vc::bench::ImageArgs);
+BENCHMARK_TEMPLATE(BM_rescaleBuffer, float, uint32_t)->Apply(vc::bench::ImageArgs);
+BENCHMARK_TEMPLATE(BM_rescaleBufferInplace1D, float)->Apply(vc::bench::LinearArgs);
+BENCHMARK_TEMPLATE(BM_rescaleBufferInplace, float)->Apply(vc::bench::ImageArgs);
+BENCHMARK_TEMPLATE(BM_rescaleBufferInplaceMinMax, float)->Apply(vc::bench::ImageArgs);
+BENCHMARK_TEMPLATE(BM_normalizeBufferInplace, float)->Apply(vc::bench::ImageArgs);
+
+// ---------------------------------------------------------------------------
+// Clamp
+// ---------------------------------------------------------------------------
+
+template<typename T>
+static void BM_clampBuffer1D(benchmark::State& state)
+{
+    const std::size_t n = state.range(0);
+    vc::bench::ThreadScope threads(state.range(1));
+    vc::Buffer1DManaged<T, vc::TargetHost> buf(n);
+    vc::bench::fillRandom(buf);
+    const T lo = vc::bench::scaledPixel<T>(0.25), hi = vc::bench::scaledPixel<T>(0.75);
+    
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        vc::image::clampBuffer(buf, lo, hi);
+        benchmark::ClobberMemory();
+    }
+    
+    vc::bench::setThroughput(state, n, n * sizeof(T) * 2);
+}
+
+template<typename T>
+static void BM_clampBuffer(benchmark::State& state)
+{
+    const std::size_t w = state.range(0), h = state.range(1);
+    vc::bench::ThreadScope threads(state.range(2));
+    vc::Buffer2DManaged<T, vc::TargetHost> buf(w, h);
+    vc::bench::fillRandom(buf);
+    const T lo = vc::bench::scaledPixel<T>(0.25), hi = vc::bench::scaledPixel<T>(0.75);
+    
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        vc::image::clampBuffer(buf, lo, hi);
+        benchmark::ClobberMemory();
+    }
+    
+    vc::bench::setThroughput(state, w * h, w * h * sizeof(T) * 2);
+}
+
+#define CLAMP_BENCHMARKS(BUF_TYPE) \
+BENCHMARK_TEMPLATE(BM_clampBuffer1D, BUF_TYPE)->Apply(vc::bench::LinearArgs); \
+BENCHMARK_TEMPLATE(BM_clampBuffer, BUF_TYPE)->Apply(vc::bench::ImageArgs);
+
+CLAMP_BENCHMARKS(uint8_t)
+CLAMP_BENCHMARKS(uint16_t)
+CLAMP_BENCHMARKS(float)
+CLAMP_BENCHMARKS(float2)
+CLAMP_BENCHMARKS(float3)
+CLAMP_BENCHMARKS(float4)
+
+// ---------------------------------------------------------------------------
+// Statistics & thresholding
+// ---------------------------------------------------------------------------
+
+template<typename T>
+static void BM_calcBufferMinMaxMean1D(benchmark::State& state)
+{
+    const std::size_t n = state.range(0);
+    vc::bench::ThreadScope threads(state.range(1));
+    vc::Buffer1DManaged<T, vc::TargetHost> buf(n);
+    vc::bench::fillRandom(buf);
+    
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(vc::image::calcBufferMin(buf));
+        benchmark::DoNotOptimize(vc::image::calcBufferMax(buf));
+        benchmark::DoNotOptimize(vc::image::calcBufferMean(buf));
+    }
+    
+    vc::bench::setThroughput(state, n * 3, n * sizeof(T) * 3);
+}
+
+template<typename T>
+static void BM_calcBufferMin(benchmark::State& state)
+{
+    const std::size_t w = state.range(0), h = state.range(1);
+    vc::bench::ThreadScope threads(state.range(2));
+    vc::Buffer2DManaged<T, vc::TargetHost> buf(w, h);
+    vc::bench::fillRandom(buf);
+    
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(vc::image::calcBufferMin(buf));
+    }
+    
+    vc::bench::setThroughput(state, w * h, w * h * sizeof(T));
+}
+
+template<typename T>
+static void BM_calcBufferMax(benchmark::State& state)
+{
+    const std::size_t w = state.range(0), h = state.range(1);
+    vc::bench::ThreadScope threads(state.range(2));
+    vc::Buffer2DManaged<T, vc::TargetHost> buf(w, h);
+    vc::bench::fillRandom(buf);
+    
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(vc::image::calcBufferMax(buf));
+    }
+    
+    vc::bench::setThroughput(state, w * h, w * h * sizeof(T));
+}
+
+template<typename T>
+static void BM_calcBufferMean(benchmark::State& state)
+{
+    const std::size_t w = state.range(0), h = state.range(1);
+    vc::bench::ThreadScope threads(state.range(2));
+    vc::Buffer2DManaged<T, vc::TargetHost> buf(w, h);
+    vc::bench::fillRandom(buf);
+    
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(vc::image::calcBufferMean(buf));
+    }
+    
+    vc::bench::setThroughput(state, w * h, w * h * sizeof(T));
+}
+
+template<typename T>
+static void BM_calcBufferStats(benchmark::State& state)
+{
+    const std::size_t w = state.range(0), h = state.range(1);
+    vc::bench::ThreadScope threads(state.range(2));
+    vc::Buffer2DManaged<T, vc::TargetHost> buf(w, h);
+    vc::bench::fillRandom(buf);
+    
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(vc::image::calcBufferStats(buf));
+    }
+    
+    vc::bench::setThroughput(state, w * h, w * h * sizeof(T));
+}
+
+template<typename T>
+static void BM_calcBufferStatsMasked(benchmark::State& state)
+{
+    const std::size_t w = state.range(0), h = state.range(1);
+    vc::bench::ThreadScope threads(state.range(2));
+    vc::Buffer2DManaged<T, vc::TargetHost> buf(w, h);
+    vc::bench::fillRandom(buf);
+    
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(vc::image::calcBufferStats(buf, T(0)));
+    }
+    
+    vc::bench::setThroughput(state, w * h, w * h * sizeof(T));
+}
+
+template<typename T>
+static void BM_thresholdBuffer(benchmark::State& state)
+{
+    const std::size_t w = state.range(0), h = state.range(1);
+    vc::bench::ThreadScope threads(state.range(2));
+    vc::Buffer2DManaged<T, vc::TargetHost> buf_in(w, h), buf_out(w, h);
+    vc::bench::fillRandom(buf_in);
+    
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        vc::image::thresholdBuffer(buf_in, buf_out, vc::bench::scaledPixel<T>(0.5), 
+                                   vc::bench::scaledPixel<T>(0.0), vc::bench::scaledPixel<T>(1.0));
+        benchmark::ClobberMemory();
+    }
+    
+    vc::bench::setThroughput(state, w * h, w * h * sizeof(T) * 2);
+}
+
+template<typename T>
+static void BM_thresholdBufferSaturation(benchmark::State& state)
+{
+    const std::size_t w = state.range(0), h = state.range(1);
+    vc::bench::ThreadScope threads(state.range(2));
+    vc::Buffer2DManaged<T, vc::TargetHost> buf_in(w, h), buf_out(w, h);
+    vc::bench::fillRandom(buf_in);
+    
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        vc::image::thresholdBuffer(buf_in, buf_out, vc::bench::scaledPixel<T>(0.5), 
+                                   vc::bench::scaledPixel<T>(0.0), vc::bench::scaledPixel<T>(1.0),
+                                   vc::bench::scaledPixel<T>(0.1), vc::bench::scaledPixel<T>(0.9), true);
+        benchmark::ClobberMemory();
+    }
+    
+    vc::bench::setThroughput(state, w * h, w * h * sizeof(T) * 2);
+}
+
+#define MIN_MAX_MEAN_THR_BENCHMARKS(BUF_TYPE) \
+BENCHMARK_TEMPLATE(BM_calcBufferMinMaxMean1D, BUF_TYPE)->Apply(vc::bench::LinearArgs); \
+BENCHMARK_TEMPLATE(BM_calcBufferMin, BUF_TYPE)->Apply(vc::bench::ImageArgs); \
+BENCHMARK_TEMPLATE(BM_calcBufferMax, BUF_TYPE)->Apply(vc::bench::ImageArgs); \
+BENCHMARK_TEMPLATE(BM_calcBufferMean, BUF_TYPE)->Apply(vc::bench::ImageArgs); \
+BENCHMARK_TEMPLATE(BM_calcBufferStats, BUF_TYPE)->Apply(vc::bench::ImageArgs); \
+BENCHMARK_TEMPLATE(BM_calcBufferStatsMasked, BUF_TYPE)->Apply(vc::bench::ImageArgs); \
+BENCHMARK_TEMPLATE(BM_thresholdBuffer, BUF_TYPE)->Apply(vc::bench::ImageArgs); \
+BENCHMARK_TEMPLATE(BM_thresholdBufferSaturation, BUF_TYPE)->Apply(vc::bench::ImageArgs);
+
+MIN_MAX_MEAN_THR_BENCHMARKS(float)
+MIN_MAX_MEAN_THR_BENCHMARKS(uint8_t)
+MIN_MAX_MEAN_THR_BENCHMARKS(uint16_t)
+
+// ---------------------------------------------------------------------------
+// Resampling, fill, invert, flip, sum
+// ---------------------------------------------------------------------------
+
+template<typename T>
+static void BM_leaveQuarter(benchmark::State& state)
+{
+    const std::size_t w = state.range(0), h = state.range(1);
+    vc::bench::ThreadScope threads(state.range(2));
+    vc::Buffer2DManaged<T, vc::TargetHost> buf_in(w, h), buf_out(w / 2, h / 2);
+    vc::bench::fillRandom(buf_in);
+    
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        vc::image::leaveQuarter(buf_in, buf_out);
+        benchmark::ClobberMemory();
+    }
+    
+    vc::bench::setThroughput(state, buf_out.area(), buf_out.area() * sizeof(T) * 2);
+}
+
+template<typename T>
+static void BM_downsampleHalf(benchmark::State& state)
+{
+    const std::size_t w = state.range(0), h = state.range(1);
+    vc::bench::ThreadScope threads(state.range(2));
+    vc::Buffer2DManaged<T, vc::TargetHost> buf_in(w, h), buf_out(w / 2, h / 2);
+    vc::bench::fillRandom(buf_in);
+    
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        vc::image::downsampleHalf(buf_in, buf_out);
+        benchmark::ClobberMemory();
+    }
+    
+    vc::bench::setThroughput(state, buf_in.area(), (buf_in.area() + buf_out.area()) * sizeof(T));
+}
+
+template<typename T>
+static void BM_fillBuffer1D(benchmark::State& state)
+{
+    const std::size_t n = state.range(0);
+    vc::bench::ThreadScope threads(state.range(1));
+    vc::Buffer1DManaged<T, vc::TargetHost> buf(n);
+    
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        vc::image::fillBuffer(buf, typename vc::type_traits<T>::ChannelType(1));
+        benchmark::ClobberMemory();
+    }
+    
+    vc::bench::setThroughput(state, n, n * sizeof(T));
+}
+
+template<typename T>
+static void BM_fillBuffer(benchmark::State& state)
+{
+    const std::size_t w = state.range(0), h = state.range(1);
+    vc::bench::ThreadScope threads(state.range(2));
+    vc::Buffer2DManaged<T, vc::TargetHost> buf(w, h);
+    
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        vc::image::fillBuffer(buf, typename vc::type_traits<T>::ChannelType(1));
+        benchmark::ClobberMemory();
+    }
+    
+    vc::bench::setThroughput(state, w * h, w * h * sizeof(T));
+}
+
+template<typename T>
+static void BM_invertBuffer1D(benchmark::State& state)
+{
+    const std::size_t n = state.range(0);
+    vc::bench::ThreadScope threads(state.range(1));
+    vc::Buffer1DManaged<T, vc::TargetHost> buf(n);
+    vc::bench::fillRandom(buf);
+    
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        vc::image::invertBuffer(buf);
+        benchmark::ClobberMemory();
+    }
+    
+    vc::bench::setThroughput(state, n, n * sizeof(T) * 2);
+}
+
+template<typename T>
+static void BM_invertBuffer(benchmark::State& state)
+{
+    const std::size_t w = state.range(0), h = state.range(1);
+    vc::bench::ThreadScope threads(state.range(2));
+    vc::Buffer2DManaged<T, vc::TargetHost> buf(w, h);
+    vc::bench::fillRandom(buf);
+    
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        vc::image::invertBuffer(buf);
+        benchmark::ClobberMemory();
+    }
+    
+    vc::bench::setThroughput(state, w * h, w * h * sizeof(T) * 2);
+}
+
+template<typename T>
+static void BM_flipXBuffer(benchmark::State& state)
+{
+    const std::size_t w = state.range(0), h = state.range(1);
+    vc::bench::ThreadScope threads(state.range(2));
+    vc::Buffer2DManaged<T, vc::TargetHost> buf_in(w, h), buf_out(w, h);
+    vc::bench::fillRandom(buf_in);
+    
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        vc::image::flipXBuffer(buf_in, buf_out);
+        benchmark::ClobberMemory();
+    }
+    
+    vc::bench::setThroughput(state, w * h, w * h * sizeof(T) * 2);
+}
+
+template<typename T>
+static void BM_flipYBuffer(benchmark::State& state)
+{
+    const std::size_t w = state.range(0), h = state.range(1);
+    vc::bench::ThreadScope threads(state.range(2));
+    vc::Buffer2DManaged<T, vc::TargetHost> buf_in(w, h), buf_out(w, h);
+    vc::bench::fillRandom(buf_in);
+    
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        vc::image::flipYBuffer(buf_in, buf_out);
+        benchmark::ClobberMemory();
+    }
+    
+    vc::bench::setThroughput(state, w * h, w * h * sizeof(T) * 2);
+}
+
+template<typename T>
+static void BM_bufferSum1D(benchmark::State& state)
+{
+    const std::size_t n = state.range(0);
+    vc::bench::ThreadScope threads(state.range(1));
+    vc::Buffer1DManaged<T, vc::TargetHost> buf(n);
+    vc::bench::fillRandom(buf);
+    const T initial = vc::bench::scaledPixel<T>(0.0);
+    
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        T sum = vc::image::bufferSum(buf, initial);
+        benchmark::DoNotOptimize(sum);
+    }
+    
+    vc::bench::setThroughput(state, n, n * sizeof(T));
+}
+
+template<typename T>
+static void BM_bufferSum(benchmark::State& state)
+{
+    const std::size_t w = state.range(0), h = state.range(1);
+    vc::bench::ThreadScope threads(state.range(2));
+    vc::Buffer2DManaged<T, vc::TargetHost> buf(w, h);
+    vc::bench::fillRandom(buf);
+    const T initial = vc::bench::scaledPixel<T>(0.0);
+    
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        T sum = vc::image::bufferSum(buf, initial);
+        benchmark::DoNotOptimize(sum);
+    }
+    
+    vc::bench::setThroughput(state, w * h, w * h * sizeof(T));
+}
+
+#define SIMPLE_TYPE_BENCHMARKS(BUF_TYPE) \
+BENCHMARK_TEMPLATE(BM_leaveQuarter, BUF_TYPE)->Apply(vc::bench::ImageArgs); \
+BENCHMARK_TEMPLATE(BM_downsampleHalf, BUF_TYPE)->Apply(vc::bench::ImageArgs); \
+BENCHMARK_TEMPLATE(BM_fillBuffer1D, BUF_TYPE)->Apply(vc::bench::LinearArgs); \
+BENCHMARK_TEMPLATE(BM_fillBuffer, BUF_TYPE)->Apply(vc::bench::ImageArgs); \
+BENCHMARK_TEMPLATE(BM_invertBuffer1D, BUF_TYPE)->Apply(vc::bench::LinearArgs); \
+BENCHMARK_TEMPLATE(BM_invertBuffer, BUF_TYPE)->Apply(vc::bench::ImageArgs); \
+BENCHMARK_TEMPLATE(BM_flipXBuffer, BUF_TYPE)->Apply(vc::bench::ImageArgs); \
+BENCHMARK_TEMPLATE(BM_flipYBuffer, BUF_TYPE)->Apply(vc::bench::ImageArgs); \
+BENCHMARK_TEMPLATE(BM_bufferSum1D, BUF_TYPE)->Apply(vc::bench::LinearArgs); \
+BENCHMARK_TEMPLATE(BM_bufferSum, BUF_TYPE)->Apply(vc::bench::ImageArgs);
+
+SIMPLE_TYPE_BENCHMARKS(uint8_t)
+SIMPLE_TYPE_BENCHMARKS(uint16_t)
+SIMPLE_TYPE_BENCHMARKS(uchar3)
+SIMPLE_TYPE_BENCHMARKS(uchar4)
+SIMPLE_TYPE_BENCHMARKS(float)
+SIMPLE_TYPE_BENCHMARKS(float3)
+SIMPLE_TYPE_BENCHMARKS(float4)
+SIMPLE_TYPE_BENCHMARKS(Eigen::Vector3f)
+SIMPLE_TYPE_BENCHMARKS(Eigen::Vector4f)
+
+template<typename T>
+static void BM_downsampleHalfNoInvalid(benchmark::State& state)
+{
+    const std::size_t w = state.range(0), h = state.range(1);
+    vc::bench::ThreadScope threads(state.range(2));
+    vc::Buffer2DManaged<T, vc::TargetHost> buf_in(w, h), buf_out(w / 2, h / 2);
+    vc::bench::fillRandom(buf_in);
+    
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        vc::image::downsampleHalfNoInvalid(buf_in, buf_out);
+        benchmark::ClobberMemory();
+    }
+    
+    vc::bench::setThroughput(state, buf_in.area(), (buf_in.area() + buf_out.area()) * sizeof(T));
+}
+
+BENCHMARK_TEMPLATE(BM_downsampleHalfNoInvalid, uint8_t)->Apply(vc::bench::ImageArgs);
+BENCHMARK_TEMPLATE(BM_downsampleHalfNoInvalid, uint16_t)->Apply(vc::bench::ImageArgs);
+BENCHMARK_TEMPLATE(BM_downsampleHalfNoInvalid, float)->Apply(vc::bench::ImageArgs);
+
+template<typename T>
+static void BM_fillPyramidBilinear(benchmark::State& state)
+{
+    const std::size_t w = state.range(0), h = state.range(1);
+    vc::bench::ThreadScope threads(state.range(2));
+    vc::ImagePyramidManaged<T, 4, vc::TargetHost> pyr(w, h);
+    vc::bench::fillRandom(pyr[0]);
+    
+    std::size_t pixels = 0;
+    for(std::size_t l = 0 ; l < pyr.LevelCount ; ++l) { pixels += pyr[l].area(); }
+    
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        vc::image::fillPyramidBilinear(pyr);
+        benchmark::ClobberMemory();
+    }
+    
+    vc::bench::setThroughput(state, pixels - pyr[pyr.LevelCount - 1].area(), pixels * sizeof(T));
+}
+
+BENCHMARK_TEMPLATE(BM_fillPyramidBilinear, float)->Apply(vc::bench::ImageArgs);
+BENCHMARK_TEMPLATE(BM_fillPyramidBilinear, uint8_t)->Apply(vc::bench::ImageArgs);
+
+/**
+ * Whole pyramid copy, one slab transfer vs level by level through the views.
+ */
+template<typename T, bool Bulk>
+static void BM_pyramidCopy(benchmark::State& state)
+{
+    const std::size_t w = state.range(0), h = state.range(1);
+    vc::bench::ThreadScope threads(state.range(2));
+    vc::ImagePyramidManaged<T, 4, vc::TargetHost> pyr_in(w, h), pyr_out(w, h);
+    pyr_in.memset(1);
+    
+    std::size_t pixels = 0;
+    for(std::size_t l = 0 ; l < pyr_in.LevelCount ; ++l) { pixels += pyr_in[l].area(); }
+    
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        if(Bulk)
+        {
+            pyr_out.copyFrom(pyr_in);
+        }
+        else
+        {
+            pyr_out.view().copyFrom(pyr_in.view());
+        }
+        
+        benchmark::ClobberMemory();
+    }
+    
+    vc::bench::setThroughput(state, pixels, pixels * sizeof(T) * 2);
+}
+
+BENCHMARK_TEMPLATE(BM_pyramidCopy, float, true)->Apply(vc::bench::ImageArgs);
+BENCHMARK_TEMPLATE(BM_pyramidCopy, float, false)->Apply(vc::bench::ImageArgs);
+
+// ---------------------------------------------------------------------------
+// Arithmetic
+// ---------------------------------------------------------------------------
+
+template<typename T>
+static void BM_bufferSubstract(benchmark::State& state)
+{
+    const std::size_t w = state.range(0), h = state.range(1);
+    vc::bench::ThreadScope threads(state.range(2));
+    vc::Buffer2DManaged<T, vc::TargetHost> buf_in1(w, h), buf_in2(w, h), buf_out(w, h);
+    vc::bench::fillRandom(buf_in1, 1);
+    vc::bench::fillRandom(buf_in2, 2);
+    
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        vc::image::bufferSubstract(buf_in1, buf_in2, buf_out);
+        benchmark::ClobberMemory();
+    }
+    
+    vc::bench::setThroughput(state, w * h, w * h * sizeof(T) * 3);
+}
+
+template<typename T>
+static void BM_bufferSubstractL1(benchmark::State& state)
+{
+    const std::size_t w = state.range(0), h = state.range(1);
+    vc::bench::ThreadScope threads(state.range(2));
+    vc::Buffer2DManaged<T, vc::TargetHost> buf_in1(w, h), buf_in2(w, h), buf_out(w, h);
+    vc::bench::fillRandom(buf_in1, 1);
+    vc::bench::fillRandom(buf_in2, 2);
+    
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        vc::image::bufferSubstractL1(buf_in1, buf_in2, buf_out);
+        benchmark::ClobberMemory();
+    }
+    
+    vc::bench::setThroughput(state, w * h, w * h * sizeof(T) * 3);
+}
+
+template<typename T>
+static void BM_bufferSubstractL2(benchmark::State& state)
+{
+    const std::size_t w = state.range(0), h = state.range(1);
+    vc::bench::ThreadScope threads(state.range(2));
+    vc::Buffer2DManaged<T, vc::TargetHost> buf_in1(w, h), buf_in2(w, h), buf_out(w, h);
+    vc::bench::fillRandom(buf_in1, 1);
+    vc::bench::fillRandom(buf_in2, 2);
+    
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        vc::image::bufferSubstractL2(buf_in1, buf_in2, buf_out);
+        benchmark::ClobberMemory();
+    }
+    
+    vc::bench::setThroughput(state, w * h, w * h * sizeof(T) * 3);
+}
+
+BENCHMARK_TEMPLATE(BM_bufferSubstract, float)->Apply(vc::bench::ImageArgs);
+BENCHMARK_TEMPLATE(BM_bufferSubstractL1, float)->Apply(vc::bench::ImageArgs);
+BENCHMARK_TEMPLATE(BM_bufferSubstractL2, float)->Apply(vc::bench::ImageArgs);
+
+// ---------------------------------------------------------------------------
+// Join & split
+// ---------------------------------------------------------------------------
+
+template<typename TCOMP, int Channels = vc::type_traits<TCOMP>::ChannelCount>
+struct JoinSplit;
+
+template<typename TCOMP>
+struct JoinSplit<TCOMP,2>
+{
+    typedef vc::Buffer2DView<typename vc::type_traits<TCOMP>::ChannelType, vc::TargetHost> ChannelBufferT;
+    
+    static void join(ChannelBufferT& c1, ChannelBufferT& c2, ChannelBufferT&, ChannelBufferT&, vc::Buffer2DView<TCOMP, vc::TargetHost>& buf)
+    {
+        vc::image::join<TCOMP>(c1, c2, buf);
+    }
+    
+    static void split(ChannelBufferT& c1, ChannelBufferT& c2, ChannelBufferT&, ChannelBufferT&, vc::Buffer2DView<TCOMP, vc::TargetHost>& buf)
+    {
+        vc::image::split<TCOMP>(buf, c1, c2);
+    }
+};
+
+template<typename TCOMP>
+struct JoinSplit<TCOMP,3>
+{
+    typedef vc::Buffer2DView<typename vc::type_traits<TCOMP>::ChannelType, vc::TargetHost> ChannelBufferT;
+    
+    static void join(ChannelBufferT& c1, ChannelBufferT& c2, ChannelBufferT& c3, ChannelBufferT&, vc::Buffer2DView<TCOMP, vc::TargetHost>& buf)
+    {
+        vc::image::join<TCOMP>(c1, c2, c3, buf);
+    }
+    
+    static void split(ChannelBufferT& c1, ChannelBufferT& c2, ChannelBufferT& c3, ChannelBufferT&, vc::Buffer2DView<TCOMP, vc::TargetHost>& buf)
+    {
+        vc::image::split<TCOMP>(buf, c1, c2, c3);
+    }
+};
+
+template<typename TCOMP>
+struct JoinSplit<TCOMP,4>
+{
+    typedef vc::Buffer2DView<typename vc::type_traits<TCOMP>::ChannelType, vc::TargetHost> ChannelBufferT;
+    
+    static void join(ChannelBufferT& c1, ChannelBufferT& c2, ChannelBufferT& c3, ChannelBufferT& c4, vc::Buffer2DView<TCOMP, vc::TargetHost>& buf)
+    {
+        vc::image::join<TCOMP>(c1, c2, c3, c4, buf);
+    }
+    
+    static void split(ChannelBufferT& c1, ChannelBufferT& c2, ChannelBufferT& c3, ChannelBufferT& c4, vc::Buffer2DView<TCOMP, vc::TargetHost>& buf)
+    {
+        vc::image::split<TCOMP>(buf, c1, c2, c3, c4);
+    }
+};
+
+template<typename TCOMP>
+static void BM_join(benchmark::State& state)
+{
+    typedef typename vc::type_traits<TCOMP>::ChannelType ChannelT;
+    
+    const std::size_t w = state.range(0), h = state.range(1);
+    vc::bench::ThreadScope threads(state.range(2));
+    vc::Buffer2DManaged<ChannelT, vc::TargetHost> buf_c1(w, h), buf_c2(w, h), buf_c3(w, h), buf_c4(w, h);
+    vc::Buffer2DManaged<TCOMP, vc::TargetHost> buf(w, h);
+    vc::bench::fillRandom(buf_c1, 1);
+    vc::bench::fillRandom(buf_c2, 2);
+    vc::bench::fillRandom(buf_c3, 3);
+    vc::bench::fillRandom(buf_c4, 4);
+    
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        JoinSplit<TCOMP>::join(buf_c1, buf_c2, buf_c3, buf_c4, buf);
+        benchmark::ClobberMemory();
+    }
+    
+    vc::bench::setThroughput(state, w * h, w * h * sizeof(TCOMP) * 2);
+}
+
+template<typename TCOMP>
+static void BM_split(benchmark::State& state)
+{
+    typedef typename vc::type_traits<TCOMP>::ChannelType ChannelT;
+    
+    const std::size_t w = state.range(0), h = state.range(1);
+    vc::bench::ThreadScope threads(state.range(2));
+    vc::Buffer2DManaged<TCOMP, vc::TargetHost> buf(w, h);
+    vc::Buffer2DManaged<ChannelT, vc::TargetHost> buf_c1(w, h), buf_c2(w, h), buf_c3(w, h), buf_c4(w, h);
+    vc::bench::fillRandom(buf);
+    
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        JoinSplit<TCOMP>::split(buf_c1, buf_c2, buf_c3, buf_c4, buf);
+        benchmark::ClobberMemory();
+    }
+    
+    vc::bench::setThroughput(state, w * h, w * h * sizeof(TCOMP) * 2);
+}
+
+#define JOIN_SPLIT_BENCHMARKS(TCOMP) \
+BENCHMARK_TEMPLATE(BM_join, TCOMP)->Apply(vc::bench::ImageArgs); \
+BENCHMARK_TEMPLATE(BM_split, TCOMP)->Apply(vc::bench::ImageArgs);
+
+JOIN_SPLIT_BENCHMARKS(Eigen::Vector2f)
+JOIN_SPLIT_BENCHMARKS(Eigen::Vector3f)
+JOIN_SPLIT_BENCHMARKS(Eigen::Vector4f)
+JOIN_SPLIT_BENCHMARKS(Eigen::Vector2d)
+JOIN_SPLIT_BENCHMARKS(Eigen::Vector3d)
+JOIN_SPLIT_BENCHMARKS(Eigen::Vector4d)
+JOIN_SPLIT_BENCHMARKS(float2)
+JOIN_SPLIT_BENCHMARKS(float3)
+JOIN_SPLIT_BENCHMARKS(float4)
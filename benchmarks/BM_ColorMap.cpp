@@ -0,0 +1,85 @@
+/**
+ * ****************************************************************************
+ * Copyright (c) 2017, Robert Lukierski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * ****************************************************************************
+ * Color map benchmarks.
+ * ****************************************************************************
+ */
+
+#include <BenchmarkCommon.hpp>
+
+#include <VisionCore/Image/ColorMap.hpp>
+
+template<typename T, typename TOUT>
+static void BM_createColorMap1D(benchmark::State& state)
+{
+    const std::size_t n = state.range(0);
+    vc::bench::ThreadScope threads(state.range(1));
+    vc::Buffer1DManaged<T, vc::TargetHost> buf_in(n);
+    vc::Buffer1DManaged<TOUT, vc::TargetHost> buf_out(n);
+    vc::bench::fillRandom(buf_in);
+    
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        vc::image::createColorMap(vc::image::ColorMap::JET, buf_in, T(0.0), T(1.0), buf_out);
+        benchmark::ClobberMemory();
+    }
+    
+    vc::bench::setThroughput(state, n, n * (sizeof(T) + sizeof(TOUT)));
+}
+
+template<typename T, typename TOUT>
+static void BM_createColorMap(benchmark::State& state)
+{
+    const std::size_t w = state.range(0), h = state.range(1);
+    vc::bench::ThreadScope threads(state.range(2));
+    vc::Buffer2DManaged<T, vc::TargetHost> buf_in(w, h);
+    vc::Buffer2DManaged<TOUT, vc::TargetHost> buf_out(w, h);
+    vc::bench::fillRandom(buf_in);
+    
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        vc::image::createColorMap(vc::image::ColorMap::JET, buf_in, T(0.0), T(1.0), buf_out);
+        benchmark::ClobberMemory();
+    }
+    
+    vc::bench::setThroughput(state, w * h, w * h * (sizeof(T) + sizeof(TOUT)));
+}
+
+#define COLORMAP_BENCHMARKS(TIN, TOUT) \
+BENCHMARK_TEMPLATE(BM_createColorMap1D, TIN, TOUT)->Apply(vc::bench::LinearArgs); \
+BENCHMARK_TEMPLATE(BM_createColorMap, TIN, TOUT)->Apply(vc::bench::ImageArgs);
+
+COLORMAP_BENCHMARKS(float, float3)
+COLORMAP_BENCHMARKS(float, float4)
+COLORMAP_BENCHMARKS(float, Eigen::Vector3f)
+COLORMAP_BENCHMARKS(float, Eigen::Vector4f)
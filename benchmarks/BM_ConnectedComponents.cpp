@@ -0,0 +1,154 @@
+/**
+ * ****************************************************************************
+ * Copyright (c) 2017, Robert Lukierski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * ****************************************************************************
+ * Connected components benchmarks.
+ * ****************************************************************************
+ */
+
+#include <BenchmarkCommon.hpp>
+
+#include <VisionCore/Image/ConnectedComponents.hpp>
+
+namespace
+{
+
+/**
+ * Grid of filled disks (valid_val = 255) on a zero background, away from the borders.
+ */
+void makeDisks(vc::Buffer2DView<uint8_t, vc::TargetHost>& img, std::size_t spacing)
+{
+    const int radius = int(spacing) / 3;
+    
+    for(std::size_t y = 0 ; y < img.height() ; ++y)
+    {
+        for(std::size_t x = 0 ; x < img.width() ; ++x)
+        {
+            const int cx = int(x % spacing) - int(spacing) / 2;
+            const int cy = int(y % spacing) - int(spacing) / 2;
+            const bool border = x < spacing || y < spacing || x + spacing >= img.width() || y + spacing >= img.height();
+            img(x,y) = (!border && (cx * cx + cy * cy <= radius * radius)) ? 255 : 0;
+        }
+    }
+}
+
+}
+
+static void BM_blobDetector(benchmark::State& state)
+{
+    const std::size_t w = state.range(0), h = state.range(1);
+    vc::Buffer2DManaged<uint8_t, vc::TargetHost> img_thr(w, h);
+    vc::image::BlobManagedImageT blobs(w, h);
+    vc::image::BlobMapT<float> bmap;
+    makeDisks(img_thr, 32);
+    
+    vc::image::BlobID found = 0;
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        found = vc::image::blobDetector<uint8_t,float>(img_thr, blobs, bmap, 255, state.range(2) != 0);
+        benchmark::ClobberMemory();
+    }
+    
+    state.counters["blobs"] = found;
+    vc::bench::setThroughput(state, w * h, w * h * (sizeof(uint8_t) + sizeof(vc::image::BlobID)));
+}
+
+BENCHMARK(BM_blobDetector)->Apply([](benchmark::internal::Benchmark* b)
+{
+    // serial algorithm, no thread sweep
+    b->ArgNames({"w", "h", "contour"});
+    for(const auto& sz : vc::bench::ImageSizes)
+    {
+        b->Args({sz.first, sz.second, 0});
+        b->Args({sz.first, sz.second, 1});
+    }
+    b->Unit(benchmark::kMicrosecond)->UseRealTime();
+});
+
+static void BM_computeGradient(benchmark::State& state)
+{
+    const std::size_t w = state.range(0), h = state.range(1);
+    vc::bench::ThreadScope threads(state.range(2));
+    vc::Buffer2DManaged<float, vc::TargetHost> img_in(w, h);
+    vc::Buffer2DManaged<Eigen::Vector2f, vc::TargetHost> grad_img(w, h);
+    vc::bench::fillRandom(img_in);
+    
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        vc::image::computeGradient(img_in, grad_img);
+        benchmark::ClobberMemory();
+    }
+    
+    vc::bench::setThroughput(state, w * h, w * h * (sizeof(float) + sizeof(Eigen::Vector2f)));
+}
+
+BENCHMARK(BM_computeGradient)->Apply(vc::bench::ImageArgs);
+
+static void BM_estimateConic(benchmark::State& state)
+{
+    const std::size_t w = state.range(0), h = state.range(1);
+    vc::Buffer2DManaged<uint8_t, vc::TargetHost> img_thr(w, h);
+    vc::Buffer2DManaged<float, vc::TargetHost> img(w, h);
+    vc::Buffer2DManaged<Eigen::Vector2f, vc::TargetHost> grad_img(w, h);
+    vc::image::BlobManagedImageT blobs(w, h);
+    vc::image::BlobMapT<float> bmap;
+    makeDisks(img_thr, 32);
+    
+    for(std::size_t y = 0 ; y < h ; ++y)
+    {
+        for(std::size_t x = 0 ; x < w ; ++x)
+        {
+            img(x,y) = img_thr(x,y) / 255.0f;
+        }
+    }
+    
+    vc::image::blobDetector<uint8_t,float>(img_thr, blobs, bmap, 255, false);
+    vc::image::computeGradient(img, grad_img);
+    
+    std::size_t pixels = 0;
+    for(const auto& b : bmap) { pixels += b.second.BoundingBox.area(); }
+    
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        for(const auto& b : bmap)
+        {
+            vc::image::Conic<float> conic = vc::image::estimateConic(grad_img, b.second);
+            benchmark::DoNotOptimize(conic);
+        }
+    }
+    
+    state.counters["blobs"] = bmap.size();
+    vc::bench::setThroughput(state, pixels, pixels * sizeof(Eigen::Vector2f));
+}
+
+BENCHMARK(BM_estimateConic)->Apply(vc::bench::ImageArgsSerial);
@@ -0,0 +1,141 @@
+/**
+ * ****************************************************************************
+ * Copyright (c) 2017, Robert Lukierski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * ****************************************************************************
+ * Convolution benchmarks.
+ * ****************************************************************************
+ */
+
+#include <BenchmarkCommon.hpp>
+
+#include <VisionCore/Math/Convolution.hpp>
+
+template<typename T, int KernelSize>
+static void BM_convolve1D(benchmark::State& state)
+{
+    const std::size_t n = state.range(0);
+    vc::bench::ThreadScope threads(state.range(1));
+    vc::Buffer1DManaged<T, vc::TargetHost> buf_in(n), buf_out(n);
+    vc::bench::fillRandom(buf_in);
+    const Eigen::Matrix<T,KernelSize,1> kern = Eigen::Matrix<T,KernelSize,1>::Constant(T(1.0) / T(KernelSize));
+    
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        vc::math::convolve(buf_in, buf_out, kern);
+        benchmark::ClobberMemory();
+    }
+    
+    vc::bench::setThroughput(state, n, n * sizeof(T) * 2);
+}
+
+template<typename T, int KernelSize>
+static void BM_convolve2D(benchmark::State& state)
+{
+    const std::size_t w = state.range(0), h = state.range(1);
+    vc::bench::ThreadScope threads(state.range(2));
+    vc::Buffer2DManaged<T, vc::TargetHost> buf_in(w, h), buf_out(w, h);
+    vc::bench::fillRandom(buf_in);
+    const Eigen::Matrix<T,KernelSize,KernelSize> kern = 
+        Eigen::Matrix<T,KernelSize,KernelSize>::Constant(T(1.0) / T(KernelSize * KernelSize));
+    
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        vc::math::convolve(buf_in, buf_out, kern);
+        benchmark::ClobberMemory();
+    }
+    
+    vc::bench::setThroughput(state, w * h, w * h * sizeof(T) * 2);
+}
+
+template<typename T, typename TK, int Sigma>
+static void BM_convolveSeparable(benchmark::State& state)
+{
+    const std::size_t w = state.range(0), h = state.range(1);
+    vc::bench::ThreadScope threads(state.range(2));
+    vc::Buffer2DManaged<T, vc::TargetHost> buf_in(w, h), buf_out(w, h);
+    vc::bench::fillRandom(buf_in);
+    const Eigen::Matrix<TK,Eigen::Dynamic,1> kern = vc::math::gaussianKernel<TK>(Sigma);
+    
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        vc::math::convolveSeparable(buf_in, buf_out, kern, kern);
+        benchmark::ClobberMemory();
+    }
+    
+    vc::bench::setThroughput(state, w * h, w * h * sizeof(T) * 2);
+}
+
+template<typename T, int Radius>
+static void BM_boxFilter(benchmark::State& state)
+{
+    const std::size_t w = state.range(0), h = state.range(1);
+    vc::bench::ThreadScope threads(state.range(2));
+    vc::Buffer2DManaged<T, vc::TargetHost> buf_in(w, h), buf_out(w, h);
+    vc::bench::fillRandom(buf_in);
+    
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        vc::math::boxFilter(buf_in, buf_out, Radius, Radius);
+        benchmark::ClobberMemory();
+    }
+    
+    vc::bench::setThroughput(state, w * h, w * h * sizeof(T) * 2);
+}
+
+#define CONVOLUTION_BENCHMARKS(BUF_TYPE, KERNEL_SIZE) \
+BENCHMARK_TEMPLATE(BM_convolve1D, BUF_TYPE, KERNEL_SIZE)->Apply(vc::bench::LinearArgs); \
+BENCHMARK_TEMPLATE(BM_convolve2D, BUF_TYPE, KERNEL_SIZE)->Apply(vc::bench::ImageArgs);
+
+CONVOLUTION_BENCHMARKS(float, 3)
+CONVOLUTION_BENCHMARKS(float, 5)
+CONVOLUTION_BENCHMARKS(float, 7)
+CONVOLUTION_BENCHMARKS(float, 9)
+CONVOLUTION_BENCHMARKS(double, 3)
+CONVOLUTION_BENCHMARKS(double, 5)
+CONVOLUTION_BENCHMARKS(double, 7)
+CONVOLUTION_BENCHMARKS(double, 9)
+
+// Gaussian, sigma 1 is 7 taps, sigma 3 is 19 taps
+BENCHMARK_TEMPLATE(BM_convolveSeparable, uint8_t, float, 1)->Apply(vc::bench::ImageArgs);
+BENCHMARK_TEMPLATE(BM_convolveSeparable, uint8_t, float, 3)->Apply(vc::bench::ImageArgs);
+BENCHMARK_TEMPLATE(BM_convolveSeparable, uint16_t, float, 3)->Apply(vc::bench::ImageArgs);
+BENCHMARK_TEMPLATE(BM_convolveSeparable, float, float, 1)->Apply(vc::bench::ImageArgs);
+BENCHMARK_TEMPLATE(BM_convolveSeparable, float, float, 3)->Apply(vc::bench::ImageArgs);
+BENCHMARK_TEMPLATE(BM_convolveSeparable, double, double, 3)->Apply(vc::bench::ImageArgs);
+
+// 5x5 and 15x15
+BENCHMARK_TEMPLATE(BM_boxFilter, uint8_t, 2)->Apply(vc::bench::ImageArgs);
+BENCHMARK_TEMPLATE(BM_boxFilter, uint8_t, 7)->Apply(vc::bench::ImageArgs);
+BENCHMARK_TEMPLATE(BM_boxFilter, uint16_t, 2)->Apply(vc::bench::ImageArgs);
+BENCHMARK_TEMPLATE(BM_boxFilter, float, 2)->Apply(vc::bench::ImageArgs);
@@ -0,0 +1,98 @@
+/**
+ * ****************************************************************************
+ * Copyright (c) 2017, Robert Lukierski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * ****************************************************************************
+ * Filter benchmarks.
+ * ****************************************************************************
+ */
+
+#include <BenchmarkCommon.hpp>
+
+#include <VisionCore/Image/Filters.hpp>
+
+/**
+ * Arguments: width, height, window dimension, threads.
+ */
+static void BilateralArgs(benchmark::internal::Benchmark* b)
+{
+    b->ArgNames({"w", "h", "dim", "threads"});
+    
+    for(const auto& sz : vc::bench::ImageSizes)
+    {
+        for(int64_t dim : { 1, 2, 3 }) // half window size
+        {
+            for(int64_t t : vc::bench::threadCounts())
+            {
+                b->Args({sz.first, sz.second, dim, t});
+            }
+        }
+    }
+    
+    b->Unit(benchmark::kMicrosecond)->UseRealTime();
+}
+
+template<typename T>
+static void BM_bilateral(benchmark::State& state)
+{
+    const std::size_t w = state.range(0), h = state.range(1), dim = state.range(2);
+    vc::bench::ThreadScope threads(state.range(3));
+    vc::Buffer2DManaged<T, vc::TargetHost> buf_in(w, h), buf_out(w, h);
+    vc::bench::fillRandom(buf_in);
+    
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        vc::image::bilateral(buf_in, buf_out, T(2.0), T(0.1), dim);
+        benchmark::ClobberMemory();
+    }
+    
+    vc::bench::setThroughput(state, w * h, w * h * sizeof(T) * 2);
+}
+
+template<typename T>
+static void BM_bilateralMinVal(benchmark::State& state)
+{
+    const std::size_t w = state.range(0), h = state.range(1), dim = state.range(2);
+    vc::bench::ThreadScope threads(state.range(3));
+    vc::Buffer2DManaged<T, vc::TargetHost> buf_in(w, h), buf_out(w, h);
+    vc::bench::fillRandom(buf_in);
+    
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        vc::image::bilateral(buf_in, buf_out, T(2.0), T(0.1), T(0.05), dim);
+        benchmark::ClobberMemory();
+    }
+    
+    vc::bench::setThroughput(state, w * h, w * h * sizeof(T) * 2);
+}
+
+BENCHMARK_TEMPLATE(BM_bilateral, float)->Apply(BilateralArgs);
+BENCHMARK_TEMPLATE(BM_bilateralMinVal, float)->Apply(BilateralArgs);
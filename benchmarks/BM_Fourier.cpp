@@ -0,0 +1,372 @@
+/**
+ * ****************************************************************************
+ * Copyright (c) 2017, Robert Lukierski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * ****************************************************************************
+ * Fourier transform benchmarks.
+ * ****************************************************************************
+ */
+
+#include <complex>
+
+#include <BenchmarkCommon.hpp>
+
+#include <VisionCore/Math/Fourier.hpp>
+#include <VisionCore/Math/FFTConvolution.hpp>
+
+namespace
+{
+
+// real or complex (std::complex / Eigen::Vector2) sample
+template<typename T> struct Sample { typedef T RealT; static constexpr int Fields = 1; };
+template<typename T> struct Sample<std::complex<T>> { typedef T RealT; static constexpr int Fields = 2; };
+template<typename T> struct Sample<Eigen::Matrix<T,2,1>> { typedef T RealT; static constexpr int Fields = 2; };
+
+template<typename T>
+void fillSignal(T* data, std::size_t count)
+{
+    typedef typename Sample<T>::RealT RealT;
+    
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<RealT> dist(RealT(-1.0), RealT(1.0));
+    RealT* fields = reinterpret_cast<RealT*>(data);
+    
+    for(std::size_t i = 0 ; i < count * Sample<T>::Fields ; ++i)
+    {
+        fields[i] = dist(rng);
+    }
+}
+
+}
+
+// ---------------------------------------------------------------------------
+// Transforms, forward for R2C & C2C, inverse for C2R
+// ---------------------------------------------------------------------------
+
+template<typename T_INPUT, typename T_OUTPUT>
+static void BM_fft1D(benchmark::State& state)
+{
+    const std::size_t n = state.range(0);
+    vc::bench::ThreadScope threads(state.range(1));
+    vc::Buffer1DManaged<T_INPUT, vc::TargetHost> buf_in(n);
+    vc::Buffer1DManaged<T_OUTPUT, vc::TargetHost> buf_out(n);
+    fillSignal(buf_in.ptr(), n);
+    const bool forward = Sample<T_OUTPUT>::Fields == 2;
+    
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        vc::math::fft(n, buf_in, buf_out, forward);
+        benchmark::ClobberMemory();
+    }
+    
+    vc::bench::setThroughput(state, n, n * (sizeof(T_INPUT) + sizeof(T_OUTPUT)));
+}
+
+template<typename T_INPUT, typename T_OUTPUT>
+static void BM_fft2D(benchmark::State& state)
+{
+    const std::size_t w = state.range(0), h = state.range(1);
+    vc::bench::ThreadScope threads(state.range(2));
+    vc::Buffer2DManaged<T_INPUT, vc::TargetHost> buf_in(w, h);
+    vc::Buffer2DManaged<T_OUTPUT, vc::TargetHost> buf_out(w, h);
+    fillSignal(buf_in.ptr(), w * h);
+    const bool forward = Sample<T_OUTPUT>::Fields == 2;
+    
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        vc::math::fft(buf_in, buf_out, forward);
+        benchmark::ClobberMemory();
+    }
+    
+    vc::bench::setThroughput(state, w * h, w * h * (sizeof(T_INPUT) + sizeof(T_OUTPUT)));
+}
+
+template<typename T_INPUT, typename T_OUTPUT>
+static void BM_makeFFT1D(benchmark::State& state)
+{
+    const std::size_t n = state.range(0);
+    vc::bench::ThreadScope threads(state.range(1));
+    vc::Buffer1DManaged<T_INPUT, vc::TargetHost> buf_in(n);
+    vc::Buffer1DManaged<T_OUTPUT, vc::TargetHost> buf_out(n);
+    const bool forward = Sample<T_OUTPUT>::Fields == 2;
+    
+    // planning may scribble over the buffers, fill afterwards
+    std::unique_ptr<vc::math::PersistentFFT> plan = vc::math::makeFFT(n, buf_in, buf_out, forward);
+    fillSignal(buf_in.ptr(), n);
+    
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        plan->execute();
+        benchmark::ClobberMemory();
+    }
+    
+    vc::bench::setThroughput(state, n, n * (sizeof(T_INPUT) + sizeof(T_OUTPUT)));
+}
+
+template<typename T_INPUT, typename T_OUTPUT>
+static void BM_makeFFT2D(benchmark::State& state)
+{
+    const std::size_t w = state.range(0), h = state.range(1);
+    vc::bench::ThreadScope threads(state.range(2));
+    vc::Buffer2DManaged<T_INPUT, vc::TargetHost> buf_in(w, h);
+    vc::Buffer2DManaged<T_OUTPUT, vc::TargetHost> buf_out(w, h);
+    const bool forward = Sample<T_OUTPUT>::Fields == 2;
+    
+    std::unique_ptr<vc::math::PersistentFFT> plan = vc::math::makeFFT(buf_in, buf_out, forward);
+    fillSignal(buf_in.ptr(), w * h);
+    
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        plan->execute();
+        benchmark::ClobberMemory();
+    }
+    
+    vc::bench::setThroughput(state, w * h, w * h * (sizeof(T_INPUT) + sizeof(T_OUTPUT)));
+}
+
+#define FFT_BENCHMARKS(T_INPUT, T_OUTPUT) \
+BENCHMARK_TEMPLATE(BM_fft1D, T_INPUT, T_OUTPUT)->Apply(vc::bench::LinearArgs); \
+BENCHMARK_TEMPLATE(BM_fft2D, T_INPUT, T_OUTPUT)->Apply(vc::bench::ImageArgs); \
+BENCHMARK_TEMPLATE(BM_makeFFT1D, T_INPUT, T_OUTPUT)->Apply(vc::bench::LinearArgs); \
+BENCHMARK_TEMPLATE(BM_makeFFT2D, T_INPUT, T_OUTPUT)->Apply(vc::bench::ImageArgs);
+
+// R2C
+FFT_BENCHMARKS(float, Eigen::Vector2f)
+FFT_BENCHMARKS(float, std::complex<float>)
+FFT_BENCHMARKS(double, Eigen::Vector2d)
+FFT_BENCHMARKS(double, std::complex<double>)
+// C2R
+FFT_BENCHMARKS(Eigen::Vector2f, float)
+FFT_BENCHMARKS(std::complex<float>, float)
+FFT_BENCHMARKS(Eigen::Vector2d, double)
+FFT_BENCHMARKS(std::complex<double>, double)
+// C2C
+FFT_BENCHMARKS(Eigen::Vector2f, Eigen::Vector2f)
+FFT_BENCHMARKS(Eigen::Vector2f, std::complex<float>)
+FFT_BENCHMARKS(std::complex<float>, Eigen::Vector2f)
+FFT_BENCHMARKS(std::complex<float>, std::complex<float>)
+FFT_BENCHMARKS(Eigen::Vector2d, Eigen::Vector2d)
+FFT_BENCHMARKS(Eigen::Vector2d, std::complex<double>)
+FFT_BENCHMARKS(std::complex<double>, Eigen::Vector2d)
+FFT_BENCHMARKS(std::complex<double>, std::complex<double>)
+
+// ---------------------------------------------------------------------------
+// Spectrum helpers
+// ---------------------------------------------------------------------------
+
+template<typename T_COMPLEX>
+static void BM_splitComplex(benchmark::State& state)
+{
+    typedef typename Sample<T_COMPLEX>::RealT RealT;
+    const std::size_t w = state.range(0), h = state.range(1);
+    vc::bench::ThreadScope threads(state.range(2));
+    vc::Buffer2DManaged<T_COMPLEX, vc::TargetHost> buf_in(w, h);
+    vc::Buffer2DManaged<RealT, vc::TargetHost> buf_real(w, h), buf_imag(w, h);
+    fillSignal(buf_in.ptr(), w * h);
+    
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        vc::math::splitComplex(buf_in, buf_real, buf_imag);
+        benchmark::ClobberMemory();
+    }
+    
+    vc::bench::setThroughput(state, w * h, w * h * sizeof(T_COMPLEX) * 2);
+}
+
+template<typename T_COMPLEX>
+static void BM_joinComplex(benchmark::State& state)
+{
+    typedef typename Sample<T_COMPLEX>::RealT RealT;
+    const std::size_t w = state.range(0), h = state.range(1);
+    vc::bench::ThreadScope threads(state.range(2));
+    vc::Buffer2DManaged<RealT, vc::TargetHost> buf_real(w, h), buf_imag(w, h);
+    vc::Buffer2DManaged<T_COMPLEX, vc::TargetHost> buf_out(w, h);
+    fillSignal(buf_real.ptr(), w * h);
+    fillSignal(buf_imag.ptr(), w * h);
+    
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        vc::math::joinComplex(buf_real, buf_imag, buf_out);
+        benchmark::ClobberMemory();
+    }
+    
+    vc::bench::setThroughput(state, w * h, w * h * sizeof(T_COMPLEX) * 2);
+}
+
+template<typename T_COMPLEX>
+static void BM_magnitude(benchmark::State& state)
+{
+    typedef typename Sample<T_COMPLEX>::RealT RealT;
+    const std::size_t w = state.range(0), h = state.range(1);
+    vc::bench::ThreadScope threads(state.range(2));
+    vc::Buffer2DManaged<T_COMPLEX, vc::TargetHost> buf_in(w, h);
+    vc::Buffer2DManaged<RealT, vc::TargetHost> buf_out(w, h);
+    fillSignal(buf_in.ptr(), w * h);
+    
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        vc::math::magnitude(buf_in, buf_out);
+        benchmark::ClobberMemory();
+    }
+    
+    vc::bench::setThroughput(state, w * h, w * h * (sizeof(T_COMPLEX) + sizeof(RealT)));
+}
+
+template<typename T_COMPLEX>
+static void BM_phase(benchmark::State& state)
+{
+    typedef typename Sample<T_COMPLEX>::RealT RealT;
+    const std::size_t w = state.range(0), h = state.range(1);
+    vc::bench::ThreadScope threads(state.range(2));
+    vc::Buffer2DManaged<T_COMPLEX, vc::TargetHost> buf_in(w, h);
+    vc::Buffer2DManaged<RealT, vc::TargetHost> buf_out(w, h);
+    fillSignal(buf_in.ptr(), w * h);
+    
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        vc::math::phase(buf_in, buf_out);
+        benchmark::ClobberMemory();
+    }
+    
+    vc::bench::setThroughput(state, w * h, w * h * (sizeof(T_COMPLEX) + sizeof(RealT)));
+}
+
+template<typename T_COMPLEX>
+static void BM_convertToComplex(benchmark::State& state)
+{
+    typedef typename Sample<T_COMPLEX>::RealT RealT;
+    const std::size_t w = state.range(0), h = state.range(1);
+    vc::bench::ThreadScope threads(state.range(2));
+    vc::Buffer2DManaged<RealT, vc::TargetHost> buf_in(w, h);
+    vc::Buffer2DManaged<T_COMPLEX, vc::TargetHost> buf_out(w, h);
+    fillSignal(buf_in.ptr(), w * h);
+    
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        vc::math::convertToComplex(buf_in, buf_out);
+        benchmark::ClobberMemory();
+    }
+    
+    vc::bench::setThroughput(state, w * h, w * h * (sizeof(T_COMPLEX) + sizeof(RealT)));
+}
+
+template<typename T_COMPLEX>
+static void BM_calculateCrossPowerSpectrum(benchmark::State& state)
+{
+    const std::size_t w = state.range(0), h = state.range(1);
+    vc::bench::ThreadScope threads(state.range(2));
+    vc::Buffer2DManaged<T_COMPLEX, vc::TargetHost> buf_fft1(w, h), buf_fft2(w, h), buf_out(w, h);
+    fillSignal(buf_fft1.ptr(), w * h);
+    fillSignal(buf_fft2.ptr(), w * h);
+    
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        vc::math::calculateCrossPowerSpectrum(buf_fft1, buf_fft2, buf_out);
+        benchmark::ClobberMemory();
+    }
+    
+    vc::bench::setThroughput(state, w * h, w * h * sizeof(T_COMPLEX) * 3);
+}
+
+#define SPECTRUM_BENCHMARKS(T_COMPLEX) \
+BENCHMARK_TEMPLATE(BM_splitComplex, T_COMPLEX)->Apply(vc::bench::ImageArgs); \
+BENCHMARK_TEMPLATE(BM_joinComplex, T_COMPLEX)->Apply(vc::bench::ImageArgs); \
+BENCHMARK_TEMPLATE(BM_magnitude, T_COMPLEX)->Apply(vc::bench::ImageArgs); \
+BENCHMARK_TEMPLATE(BM_phase, T_COMPLEX)->Apply(vc::bench::ImageArgs); \
+BENCHMARK_TEMPLATE(BM_convertToComplex, T_COMPLEX)->Apply(vc::bench::ImageArgs); \
+BENCHMARK_TEMPLATE(BM_calculateCrossPowerSpectrum, T_COMPLEX)->Apply(vc::bench::ImageArgs);
+
+SPECTRUM_BENCHMARKS(Eigen::Vector2f)
+SPECTRUM_BENCHMARKS(std::complex<float>)
+SPECTRUM_BENCHMARKS(Eigen::Vector2d)
+SPECTRUM_BENCHMARKS(std::complex<double>)
+
+// ---------------------------------------------------------------------------
+// Large kernel convolution, direct vs FFT vs what the cost model picks
+// ---------------------------------------------------------------------------
+
+/**
+ * Arguments: width, height, kernel size, method, threads.
+ */
+static void FFTConvolutionArgs(benchmark::internal::Benchmark* b)
+{
+    b->ArgNames({"w", "h", "k", "method", "threads"});
+    
+    for(const auto& sz : vc::bench::ImageSizes)
+    {
+        for(int64_t k : { 7, 15, 31, 63 })
+        {
+            for(int64_t m : { (int64_t)vc::math::ConvolutionMethod::Auto, (int64_t)vc::math::ConvolutionMethod::Direct, (int64_t)vc::math::ConvolutionMethod::FFT })
+            {
+                for(int64_t t : vc::bench::threadCounts())
+                {
+                    b->Args({sz.first, sz.second, k, m, t});
+                }
+            }
+        }
+    }
+    
+    b->Unit(benchmark::kMicrosecond)->UseRealTime();
+}
+
+template<typename T>
+static void BM_FFTConvolution(benchmark::State& state)
+{
+    const std::size_t w = state.range(0), h = state.range(1), k = state.range(2);
+    vc::bench::ThreadScope threads(state.range(4));
+    vc::Buffer2DManaged<T, vc::TargetHost> buf_in(w, h), buf_out(w, h), kern(k, k);
+    fillSignal(buf_in.ptr(), w * h);
+    fillSignal(kern.ptr(), k * k);
+    
+    // kernel spectrum and plans are made on the first call, as for a frame sequence
+    vc::math::FFTConvolution<T> conv(kern, true, (vc::math::ConvolutionMethod)state.range(3));
+    conv(buf_in, buf_out);
+    
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        conv(buf_in, buf_out);
+        benchmark::ClobberMemory();
+    }
+    
+    vc::bench::setThroughput(state, w * h, w * h * sizeof(T) * 2);
+}
+
+BENCHMARK_TEMPLATE(BM_FFTConvolution, float)->Apply(FFTConvolutionArgs);
+BENCHMARK_TEMPLATE(BM_FFTConvolution, double)->Apply(FFTConvolutionArgs);
@@ -0,0 +1,173 @@
+/**
+ * ****************************************************************************
+ * Copyright (c) 2017, Robert Lukierski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * ****************************************************************************
+ * Host copy engine benchmarks.
+ * ****************************************************************************
+ */
+
+#include <BenchmarkCommon.hpp>
+
+#include <VisionCore/HostCopy.hpp>
+#include <VisionCore/Buffers/Buffer3D.hpp>
+
+/**
+ * Arguments: width, height, threads, hint (CopyHint).
+ */
+static void CopyArgs(benchmark::internal::Benchmark* b)
+{
+    b->ArgNames({"w", "h", "threads", "hint"});
+    
+    for(const auto& sz : vc::bench::ImageSizes)
+    {
+        for(int64_t t : vc::bench::threadCounts())
+        {
+            for(int64_t hint : { (int64_t)vc::CopyHint::Cached, (int64_t)vc::CopyHint::Streaming })
+            {
+                b->Args({sz.first, sz.second, t, hint});
+            }
+        }
+    }
+    
+    b->Unit(benchmark::kMicrosecond)->UseRealTime();
+}
+
+template<typename T>
+static void BM_copy2D(benchmark::State& state)
+{
+    const std::size_t w = state.range(0), h = state.range(1);
+    const vc::CopyHint hint = (vc::CopyHint)state.range(3);
+    vc::bench::ThreadScope threads(state.range(2));
+    vc::Buffer2DManaged<T, vc::TargetHost> buf_in(w, h);
+    vc::Buffer2DManaged<T, vc::TargetHost> buf_out(w, h);
+    vc::bench::fillRandom(buf_in);
+    
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        buf_out.copyFrom(buf_in, hint);
+        benchmark::ClobberMemory();
+    }
+    
+    vc::bench::setThroughput(state, w * h, w * h * sizeof(T) * 2);
+}
+
+/**
+ * Copies the centre half of an image into a packed buffer.
+ */
+template<typename T>
+static void BM_copySubBuffer(benchmark::State& state)
+{
+    const std::size_t w = state.range(0), h = state.range(1);
+    const vc::CopyHint hint = (vc::CopyHint)state.range(3);
+    vc::bench::ThreadScope threads(state.range(2));
+    vc::Buffer2DManaged<T, vc::TargetHost> buf_in(w, h);
+    vc::Buffer2DManaged<T, vc::TargetHost> buf_out(w / 2, h / 2);
+    vc::bench::fillRandom(buf_in);
+    
+    const vc::Buffer2DView<T, vc::TargetHost> sub(buf_in.ptr(w / 4, h / 4), w / 2, h / 2, buf_in.pitch());
+    
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        buf_out.copyFrom(sub, hint);
+        benchmark::ClobberMemory();
+    }
+    
+    vc::bench::setThroughput(state, w * h / 4, w * h / 4 * sizeof(T) * 2);
+}
+
+/**
+ * Volume of about 64 MB, planes of the image size.
+ */
+template<typename T>
+static void BM_copy3D(benchmark::State& state)
+{
+    const std::size_t w = state.range(0), h = state.range(1);
+    const std::size_t Planes = std::max<std::size_t>((std::size_t(64) << 20) / (w * h * sizeof(T)), 1);
+    const vc::CopyHint hint = (vc::CopyHint)state.range(3);
+    vc::bench::ThreadScope threads(state.range(2));
+    vc::Buffer3DManaged<T, vc::TargetHost> buf_in(w, h, Planes);
+    vc::Buffer3DManaged<T, vc::TargetHost> buf_out(w, h, Planes);
+    buf_in.memset(1);
+    
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        buf_out.copyFrom(buf_in, hint);
+        benchmark::ClobberMemory();
+    }
+    
+    vc::bench::setThroughput(state, w * h * Planes, w * h * Planes * sizeof(T) * 2);
+}
+
+/**
+ * Whole buffer clear and fill, split across threads like the copies.
+ */
+template<typename T>
+static void BM_memset2D(benchmark::State& state)
+{
+    const std::size_t w = state.range(0), h = state.range(1);
+    vc::bench::ThreadScope threads(state.range(2));
+    vc::Buffer2DManaged<T, vc::TargetHost> buf(w, h);
+    
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        buf.memset(0);
+        benchmark::ClobberMemory();
+    }
+    
+    vc::bench::setThroughput(state, w * h, buf.pitch() * h);
+}
+
+template<typename T>
+static void BM_fill2D(benchmark::State& state)
+{
+    const std::size_t w = state.range(0), h = state.range(1);
+    vc::bench::ThreadScope threads(state.range(2));
+    vc::Buffer2DManaged<T, vc::TargetHost> buf(w, h);
+    
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        buf.fill(T(1));
+        benchmark::ClobberMemory();
+    }
+    
+    vc::bench::setThroughput(state, w * h, w * h * sizeof(T));
+}
+
+BENCHMARK_TEMPLATE(BM_copy2D, float)->Apply(CopyArgs);
+BENCHMARK_TEMPLATE(BM_copy2D, float4)->Apply(CopyArgs);
+BENCHMARK_TEMPLATE(BM_copySubBuffer, float)->Apply(CopyArgs);
+BENCHMARK_TEMPLATE(BM_copy3D, float)->Apply(CopyArgs);
+BENCHMARK_TEMPLATE(BM_memset2D, float)->Apply(vc::bench::ImageArgs);
+BENCHMARK_TEMPLATE(BM_fill2D, float)->Apply(vc::bench::ImageArgs);
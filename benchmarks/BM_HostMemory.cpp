@@ -0,0 +1,139 @@
+/**
+ * ****************************************************************************
+ * Copyright (c) 2017, Robert Lukierski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * ****************************************************************************
+ * Host memory pool benchmarks.
+ * ****************************************************************************
+ */
+
+#include <BenchmarkCommon.hpp>
+
+#include <VisionCore/HostMemory.hpp>
+#include <VisionCore/Buffers/Buffer3D.hpp>
+
+/**
+ * Arguments: width, height, pool (0 = system allocator, 1 = HostMemoryPool).
+ */
+static void PoolArgs(benchmark::internal::Benchmark* b)
+{
+    b->ArgNames({"w", "h", "pool"});
+    
+    for(const auto& sz : vc::bench::ImageSizes)
+    {
+        for(int64_t pool : { 0, 1 })
+        {
+            b->Args({sz.first, sz.second, pool});
+        }
+    }
+    
+    b->Unit(benchmark::kMicrosecond);
+}
+
+/**
+ * A typical per-frame set of temporaries, constructed and destroyed every iteration.
+ */
+static void BM_frameTemporaries(benchmark::State& state)
+{
+    const std::size_t w = state.range(0), h = state.range(1);
+    const bool was_enabled = vc::HostMemoryPool::isEnabled();
+    vc::HostMemoryPool::setEnabled(state.range(2) != 0);
+    vc::HostMemoryPool::resetStats();
+    
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        vc::Buffer2DManaged<float, vc::TargetHost> depth(w, h);
+        vc::Buffer2DManaged<float4, vc::TargetHost> normals(w, h);
+        vc::Buffer2DManaged<uint8_t, vc::TargetHost> mask(w, h);
+        benchmark::DoNotOptimize(depth.ptr());
+        benchmark::DoNotOptimize(normals.ptr());
+        benchmark::DoNotOptimize(mask.ptr());
+    }
+    
+    const vc::HostMemoryPoolStats st = vc::HostMemoryPool::stats();
+    state.counters["sys_allocs"] = benchmark::Counter(double(st.system_allocations), benchmark::Counter::kAvgIterations);
+    
+    vc::HostMemoryPool::setEnabled(was_enabled);
+}
+
+BENCHMARK(BM_frameTemporaries)->Apply(PoolArgs);
+
+/**
+ * Arguments: volume side, huge pages (-1 = not mapped, otherwise vc::HugePages).
+ */
+static void VolumeArgs(benchmark::internal::Benchmark* b)
+{
+    b->ArgNames({"side", "map"});
+    
+    for(int64_t side : { int64_t(256), int64_t(512) })
+    {
+        for(int64_t map : { int64_t(-1), (int64_t)vc::HugePages::Off, (int64_t)vc::HugePages::Transparent })
+        {
+            b->Args({side, map});
+        }
+    }
+    
+    b->Unit(benchmark::kMillisecond);
+}
+
+/**
+ * Resetting an SDF-like (2 floats) volume that was written to.
+ */
+static void BM_volumeReset(benchmark::State& state)
+{
+    const std::size_t side = state.range(0);
+    const vc::HostMapSettings previous = vc::getHostMapSettings();
+    
+    vc::HostMapSettings settings;
+    settings.threshold = state.range(1) < 0 ? 0 : 1;
+    settings.huge_pages = (vc::HugePages)std::max<int64_t>(state.range(1), 0);
+    settings.lazy_commit = true;
+    vc::setHostMapSettings(settings);
+    
+    {
+        vc::Buffer3DManaged<float2, vc::TargetHost> vol(side, side, side);
+        
+        for(auto _ : state)
+        {
+            state.PauseTiming();
+            vol.memset(1);
+            state.ResumeTiming();
+            
+            vol.memset(0);
+            benchmark::ClobberMemory();
+        }
+        
+        state.SetBytesProcessed(int64_t(state.iterations()) * vol.bytes());
+    }
+    
+    vc::setHostMapSettings(previous);
+}
+
+BENCHMARK(BM_volumeReset)->Apply(VolumeArgs);
@@ -0,0 +1,142 @@
+/**
+ * ****************************************************************************
+ * Copyright (c) 2017, Robert Lukierski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * ****************************************************************************
+ * PLY I/O benchmarks.
+ * ****************************************************************************
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include <BenchmarkCommon.hpp>
+
+#include <VisionCore/IO/PLYModel.hpp>
+
+namespace
+{
+
+template<typename T>
+using PointVectorT = std::vector<T, Eigen::aligned_allocator<T>>;
+
+/**
+ * One point per pixel of an organized cloud, so the sizes match the image benchmarks.
+ */
+void PointArgs(benchmark::internal::Benchmark* b)
+{
+    b->ArgNames({"points"});
+    
+    for(const auto& sz : vc::bench::ImageSizes)
+    {
+        b->Arg(sz.first * sz.second);
+    }
+    
+    b->Unit(benchmark::kMillisecond)->UseRealTime();
+}
+
+template<typename T>
+PointVectorT<T> makePoints(std::size_t count)
+{
+    std::mt19937 rng(42);
+    PointVectorT<T> ret(count);
+    
+    for(auto& pt : ret)
+    {
+        pt = vc::bench::randomPixel<T>(rng);
+    }
+    
+    return ret;
+}
+
+std::size_t fileSize(const std::string& fn)
+{
+    std::ifstream ifs(fn, std::ios::binary | std::ios::ate);
+    return ifs ? std::size_t(ifs.tellg()) : 0;
+}
+
+}
+
+template<typename T>
+static void BM_savePLY(benchmark::State& state)
+{
+    const std::string fn = "BM_savePLY.ply";
+    const PointVectorT<T> points = makePoints<T>(state.range(0));
+    
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        if(!vc::io::savePLY(fn, points))
+        {
+            state.SkipWithError("savePLY failed");
+            break;
+        }
+    }
+    
+    vc::bench::setThroughput(state, points.size(), fileSize(fn));
+    std::remove(fn.c_str());
+}
+
+template<typename T>
+static void BM_loadPLY(benchmark::State& state)
+{
+    const std::string fn = "BM_loadPLY.ply";
+    
+    if(!vc::io::savePLY(fn, makePoints<T>(state.range(0))))
+    {
+        state.SkipWithError("savePLY failed");
+        return;
+    }
+    
+    PointVectorT<T> points;
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        points.clear();
+        if(!vc::io::loadPLY(fn, points))
+        {
+            state.SkipWithError("loadPLY failed");
+            break;
+        }
+    }
+    
+    vc::bench::setThroughput(state, points.size(), fileSize(fn));
+    std::remove(fn.c_str());
+}
+
+#define PLY_BENCHMARKS(POINT_TYPE) \
+BENCHMARK_TEMPLATE(BM_savePLY, POINT_TYPE)->Apply(PointArgs); \
+BENCHMARK_TEMPLATE(BM_loadPLY, POINT_TYPE)->Apply(PointArgs);
+
+PLY_BENCHMARKS(Eigen::Vector3f)
+PLY_BENCHMARKS(vc::ColorPoint)
+PLY_BENCHMARKS(vc::NormalPoint)
+PLY_BENCHMARKS(vc::ColorNormalPoint)
+PLY_BENCHMARKS(vc::Surfel)
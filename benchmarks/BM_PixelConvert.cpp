@@ -0,0 +1,138 @@
+/**
+ * ****************************************************************************
+ * Copyright (c) 2017, Robert Lukierski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * ****************************************************************************
+ * Pixel conversion benchmarks.
+ * ****************************************************************************
+ */
+
+#include <BenchmarkCommon.hpp>
+
+#include <VisionCore/Image/PixelConvert.hpp>
+
+template<typename T_IN, typename T_OUT>
+static void BM_convertBuffer(benchmark::State& state)
+{
+    const std::size_t w = state.range(0), h = state.range(1);
+    vc::bench::ThreadScope threads(state.range(2));
+    vc::Buffer2DManaged<T_IN, vc::TargetHost> buf_in(w, h);
+    vc::Buffer2DManaged<T_OUT, vc::TargetHost> buf_out(w, h);
+    vc::bench::fillRandom(buf_in);
+    
+    vc::bench::HardwareCounters counters(state);
+    for(auto _ : state)
+    {
+        vc::image::convertBuffer(buf_in, buf_out);
+        benchmark::ClobberMemory();
+    }
+    
+    vc::bench::setThroughput(state, w * h, w * h * (sizeof(T_IN) + sizeof(T_OUT)));
+}
+
+#define CONVERT_BENCHMARK(T_IN, T_OUT) \
+BENCHMARK_TEMPLATE(BM_convertBuffer, T_IN, T_OUT)->Apply(vc::bench::ImageArgs);
+
+// all conversions
+CONVERT_BENCHMARK(uint8_t, uchar3)
+CONVERT_BENCHMARK(uint8_t, uchar4)
+CONVERT_BENCHMARK(uint8_t, float)
+CONVERT_BENCHMARK(uint8_t, float3)
+CONVERT_BENCHMARK(uint8_t, float4)
+CONVERT_BENCHMARK(uint8_t, Eigen::Vector3f)
+CONVERT_BENCHMARK(uint8_t, Eigen::Vector4f)
+
+CONVERT_BENCHMARK(float, uint8_t)
+CONVERT_BENCHMARK(float, uchar3)
+CONVERT_BENCHMARK(float, uchar4)
+CONVERT_BENCHMARK(float, float3)
+CONVERT_BENCHMARK(float, float4)
+CONVERT_BENCHMARK(float, Eigen::Vector3f)
+CONVERT_BENCHMARK(float, Eigen::Vector4f)
+CONVERT_BENCHMARK(float, double)
+
+CONVERT_BENCHMARK(double, uint8_t)
+CONVERT_BENCHMARK(double, uchar3)
+CONVERT_BENCHMARK(double, uchar4)
+CONVERT_BENCHMARK(double, float3)
+CONVERT_BENCHMARK(double, float4)
+CONVERT_BENCHMARK(double, Eigen::Vector3f)
+CONVERT_BENCHMARK(double, Eigen::Vector4f)
+CONVERT_BENCHMARK(double, float)
+
+CONVERT_BENCHMARK(uchar3, uint8_t)
+CONVERT_BENCHMARK(uchar3, uchar4)
+CONVERT_BENCHMARK(uchar3, float)
+CONVERT_BENCHMARK(uchar3, float3)
+CONVERT_BENCHMARK(uchar3, float4)
+CONVERT_BENCHMARK(uchar3, Eigen::Vector3f)
+CONVERT_BENCHMARK(uchar3, Eigen::Vector4f)
+
+CONVERT_BENCHMARK(uchar4, uint8_t)
+CONVERT_BENCHMARK(uchar4, uchar3)
+CONVERT_BENCHMARK(uchar4, float)
+CONVERT_BENCHMARK(uchar4, float3)
+CONVERT_BENCHMARK(uchar4, float4)
+CONVERT_BENCHMARK(uchar4, Eigen::Vector3f)
+CONVERT_BENCHMARK(uchar4, Eigen::Vector4f)
+
+CONVERT_BENCHMARK(float3, uint8_t)
+CONVERT_BENCHMARK(float3, uchar3)
+CONVERT_BENCHMARK(float3, uchar4)
+CONVERT_BENCHMARK(float3, float)
+CONVERT_BENCHMARK(float3, float4)
+CONVERT_BENCHMARK(float3, Eigen::Vector3f)
+CONVERT_BENCHMARK(float3, Eigen::Vector4f)
+
+CONVERT_BENCHMARK(float4, uint8_t)
+CONVERT_BENCHMARK(float4, uchar3)
+CONVERT_BENCHMARK(float4, uchar4)
+CONVERT_BENCHMARK(float4, float)
+CONVERT_BENCHMARK(float4, float3)
+CONVERT_BENCHMARK(float4, Eigen::Vector3f)
+CONVERT_BENCHMARK(float4, Eigen::Vector4f)
+
+CONVERT_BENCHMARK(Eigen::Vector3f, uint8_t)
+CONVERT_BENCHMARK(Eigen::Vector3f, uchar3)
+CONVERT_BENCHMARK(Eigen::Vector3f, uchar4)
+CONVERT_BENCHMARK(Eigen::Vector3f, float)
+CONVERT_BENCHMARK(Eigen::Vector3f, float3)
+CONVERT_BENCHMARK(Eigen::Vector3f, float4)
+CONVERT_BENCHMARK(Eigen::Vector3f, Eigen::Vector4f)
+
+CONVERT_BENCHMARK(Eigen::Vector4f, uint8_t)
+CONVERT_BENCHMARK(Eigen::Vector4f, uchar3)
+CONVERT_BENCHMARK(Eigen::Vector4f, uchar4)
+CONVERT_BENCHMARK(Eigen::Vector4f, float)
+CONVERT_BENCHMARK(Eigen::Vector4f, float3)
+CONVERT_BENCHMARK(Eigen::Vector4f, float4)
+CONVERT_BENCHMARK(Eigen::Vector4f, Eigen::Vector3f)
+
+// special
+CONVERT_BENCHMARK(uint16_t, float)
@@ -0,0 +1,440 @@
+/**
+ * ****************************************************************************
+ * Copyright (c) 2017, Robert Lukierski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * ****************************************************************************
+ * End-to-end RGB-D frontend benchmark on synthetic frames.
+ *
+ * Per frame: depth uint16_t -> float, bilateral, depth pyramid, color mapped
+ * depth, marker blobs from the color image and, every N frames, a colored
+ * point cloud saved as PLY. Reports per-frame latency percentiles and
+ * sustained FPS for a set of thread counts, optionally hardware counters
+ * per frame.
+ * ****************************************************************************
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include <BenchmarkCommon.hpp>
+
+#include <VisionCore/Trace.hpp>
+#include <VisionCore/Buffers/ImagePyramid.hpp>
+#include <VisionCore/Image/BufferOps.hpp>
+#include <VisionCore/Image/ColorMap.hpp>
+#include <VisionCore/Image/ConnectedComponents.hpp>
+#include <VisionCore/Image/Filters.hpp>
+#include <VisionCore/Image/PixelConvert.hpp>
+#include <VisionCore/IO/PLYModel.hpp>
+
+namespace
+{
+
+typedef std::chrono::steady_clock ClockT;
+
+static constexpr std::size_t PyramidLevels = 4;
+static constexpr std::size_t PointCloudLevel = 1;
+static constexpr std::size_t MarkerCount = 12;
+static constexpr std::size_t SyntheticFrames = 16;
+
+struct Options
+{
+    std::size_t width = 640;
+    std::size_t height = 480;
+    std::size_t frames = 100;
+    std::size_t warmup = 5;
+    std::size_t dim = 2;
+    std::size_t ply_every = 30;
+    bool perf = false;
+    std::vector<int64_t> threads = vc::bench::threadCounts();
+    std::string ply_file = "BM_RGBDFrontend.ply";
+    std::string trace_file;
+};
+
+enum Stage
+{
+    StageConvert = 0,
+    StageBilateral,
+    StagePyramid,
+    StageColorMap,
+    StageBlobs,
+    StagePLY,
+    StageCount
+};
+
+static const char* StageNames[StageCount] = { "convert", "bilateral", "pyramid", "colormap", "blobs", "ply" };
+
+struct SyntheticFrame
+{
+    SyntheticFrame(std::size_t w, std::size_t h) : depth(w, h), color(w, h) { }
+    
+    vc::Buffer2DManaged<uint16_t, vc::TargetHost> depth;  // millimeters, 0 = invalid
+    vc::Buffer2DManaged<uchar3, vc::TargetHost>   color;
+};
+
+/**
+ * Tilted floor plane with spheres drifting across, sensor-like noise and dropouts.
+ * Bright square markers on a dark textured background in the color image.
+ */
+void generateFrame(SyntheticFrame& frame, std::size_t idx)
+{
+    const std::size_t w = frame.depth.width(), h = frame.depth.height();
+    const float phase = float(idx) / float(SyntheticFrames);
+    std::mt19937 rng(1234 + idx);
+    std::normal_distribution<float> noise(0.0f, 2.0f);
+    std::uniform_real_distribution<float> dropout(0.0f, 1.0f);
+    
+    for(std::size_t y = 0 ; y < h ; ++y)
+    {
+        for(std::size_t x = 0 ; x < w ; ++x)
+        {
+            const float u = float(x) / float(w), v = float(y) / float(h);
+            float z = 3000.0f - 1500.0f * v;
+            
+            for(int s = 0 ; s < 3 ; ++s)
+            {
+                const float cx = std::fmod(0.2f + 0.3f * s + 0.25f * phase, 1.0f), cy = 0.3f + 0.2f * s;
+                const float r2 = (u - cx) * (u - cx) + (v - cy) * (v - cy);
+                if(r2 < 0.01f)
+                {
+                    z = std::min(z, 1000.0f + 400.0f * s + 4000.0f * r2);
+                }
+            }
+            
+            const bool hole = dropout(rng) < 0.01f || (x < w / 32);
+            frame.depth(x,y) = hole ? 0 : uint16_t(std::max(z + noise(rng), 1.0f));
+            
+            const uint8_t texture = uint8_t(32 + ((x / 8 + y / 8) % 2) * 16);
+            frame.color(x,y) = make_uchar3(texture, texture, texture);
+        }
+    }
+    
+    // markers, clear of the borders
+    const std::size_t msize = std::max<std::size_t>(h / 40, 4);
+    for(std::size_t m = 0 ; m < MarkerCount ; ++m)
+    {
+        const std::size_t mx = msize * 2 + ((m % 4) * w / 4 + std::size_t(phase * w / 8)) % (w - msize * 4);
+        const std::size_t my = msize * 2 + (m / 4) * (h - msize * 4) / 3;
+        
+        for(std::size_t y = my ; y < std::min(my + msize, h - msize) ; ++y)
+        {
+            for(std::size_t x = mx ; x < std::min(mx + msize, w - msize) ; ++x)
+            {
+                frame.color(x,y) = make_uchar3(250, 240, 230);
+            }
+        }
+    }
+}
+
+/**
+ * Per-thread-count pipeline state, allocated once.
+ */
+struct Frontend
+{
+    typedef std::vector<vc::ColorPoint, Eigen::aligned_allocator<vc::ColorPoint>> CloudT;
+    
+    Frontend(std::size_t w, std::size_t h) : 
+        depth_raw(w, h), 
+        depth_pyr(w, h), 
+        depth_rgb(w, h),
+        gray(w, h),
+        mask(w, h),
+        labels(w, h)
+    {
+        cloud.reserve(depth_pyr[PointCloudLevel].area());
+    }
+    
+    void process(const SyntheticFrame& frame, bool save_ply, const Options& opts, double* stage_time)
+    {
+        ClockT::time_point t0 = ClockT::now();
+        auto lap = [&](Stage s)
+        {
+            const ClockT::time_point t1 = ClockT::now();
+            stage_time[s] += std::chrono::duration<double>(t1 - t0).count();
+            t0 = t1;
+        };
+        
+        vc::image::convertBuffer(frame.depth, depth_raw);
+        lap(StageConvert);
+        
+        vc::image::bilateral(depth_raw, depth_pyr[0], 3.0f, 30.0f, 1.0f, opts.dim);
+        lap(StageBilateral);
+        
+        vc::image::fillPyramidBilinear(depth_pyr);
+        lap(StagePyramid);
+        
+        vc::image::createColorMap(vc::image::ColorMap::JET, depth_pyr[0], 500.0f, 3000.0f, depth_rgb);
+        lap(StageColorMap);
+        
+        vc::image::convertBuffer(frame.color, gray);
+        vc::image::thresholdBuffer(gray, mask, uint8_t(200), uint8_t(0), uint8_t(255));
+        blob_count = vc::image::blobDetector<uint8_t,float>(mask, labels, blobs, 255);
+        lap(StageBlobs);
+        
+        if(save_ply)
+        {
+            backproject(frame);
+            vc::io::savePLY(opts.ply_file, cloud);
+            lap(StagePLY);
+        }
+    }
+    
+    void backproject(const SyntheticFrame& frame)
+    {
+        const vc::Image2DView<float, vc::TargetHost>& lvl = depth_pyr[PointCloudLevel];
+        const std::size_t scale = std::size_t(1) << PointCloudLevel;
+        const float f = 525.0f * float(frame.depth.width()) / 640.0f / float(scale);
+        const float cx = float(lvl.width()) * 0.5f, cy = float(lvl.height()) * 0.5f;
+        
+        cloud.clear();
+        for(std::size_t y = 0 ; y < lvl.height() ; ++y)
+        {
+            for(std::size_t x = 0 ; x < lvl.width() ; ++x)
+            {
+                const float z = lvl(x,y) * 0.001f;
+                if(z > 0.0f)
+                {
+                    const uchar3& c = frame.color(x * scale, y * scale);
+                    
+                    vc::ColorPoint pt;
+                    pt.Position << (float(x) - cx) * z / f, (float(y) - cy) * z / f, z;
+                    pt.Color << c.x / 255.0f, c.y / 255.0f, c.z / 255.0f;
+                    cloud.push_back(pt);
+                }
+            }
+        }
+    }
+    
+    vc::Buffer2DManaged<float, vc::TargetHost>                      depth_raw;
+    vc::ImagePyramidManaged<float, PyramidLevels, vc::TargetHost>   depth_pyr;
+    vc::Buffer2DManaged<float4, vc::TargetHost>                     depth_rgb;
+    vc::Buffer2DManaged<uint8_t, vc::TargetHost>                    gray;
+    vc::Buffer2DManaged<uint8_t, vc::TargetHost>                    mask;
+    vc::image::BlobManagedImageT                                    labels;
+    vc::image::BlobMapT<float>                                      blobs;
+    vc::image::BlobID                                               blob_count = 0;
+    CloudT                                                          cloud;
+};
+
+/// Nearest-rank percentile of sorted values.
+double percentile(const std::vector<double>& sorted, double p)
+{
+    const std::size_t rank = std::size_t(std::ceil(p / 100.0 * double(sorted.size())));
+    return sorted[std::min(std::max<std::size_t>(rank, 1), sorted.size()) - 1];
+}
+
+std::vector<int64_t> parseList(const std::string& s)
+{
+    std::vector<int64_t> ret;
+    std::stringstream ss(s);
+    std::string item;
+    
+    while(std::getline(ss, item, ','))
+    {
+        ret.push_back(std::stoll(item));
+    }
+    
+    return ret;
+}
+
+void usage(const char* exe)
+{
+    std::cout << "Usage: " << exe << " [--width=640] [--height=480] [--frames=100] [--warmup=5]"
+              << " [--dim=2] [--threads=1,2,4] [--ply_every=30] [--ply_file=BM_RGBDFrontend.ply]"
+              << " [--trace_file=trace.json] [--perf]" << std::endl;
+}
+
+bool parseOptions(int argc, char** argv, Options& opts)
+{
+    for(int i = 1 ; i < argc ; ++i)
+    {
+        const std::string arg(argv[i]);
+        const std::size_t eq = arg.find('=');
+        const std::string key = arg.substr(0, eq);
+        const std::string val = eq == std::string::npos ? std::string() : arg.substr(eq + 1);
+        
+        if(key == "--width") { opts.width = std::stoul(val); }
+        else if(key == "--height") { opts.height = std::stoul(val); }
+        else if(key == "--frames") { opts.frames = std::stoul(val); }
+        else if(key == "--warmup") { opts.warmup = std::stoul(val); }
+        else if(key == "--dim") { opts.dim = std::stoul(val); }
+        else if(key == "--ply_every") { opts.ply_every = std::stoul(val); }
+        else if(key == "--ply_file") { opts.ply_file = val; }
+        else if(key == "--trace_file") { opts.trace_file = val; }
+        else if(key == "--threads") { opts.threads = parseList(val); }
+        else if(key == "--perf") { opts.perf = val.empty() || val != "0"; }
+        else
+        {
+            usage(argv[0]);
+            return false;
+        }
+    }
+    
+    return opts.frames > 0 && opts.width >= 64 && opts.height >= 64;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    Options opts;
+    if(!parseOptions(argc, argv, opts))
+    {
+        return EXIT_FAILURE;
+    }
+    
+    std::vector<SyntheticFrame> frames;
+    frames.reserve(SyntheticFrames);
+    for(std::size_t i = 0 ; i < SyntheticFrames ; ++i)
+    {
+        frames.emplace_back(opts.width, opts.height);
+        generateFrame(frames.back(), i);
+    }
+    
+#ifdef VISIONCORE_HAVE_TRACE
+    vc::trace::setEnabled(!opts.trace_file.empty());
+#else // VISIONCORE_HAVE_TRACE
+    if(!opts.trace_file.empty())
+    {
+        std::cerr << "Tracing not compiled in (USE_TRACE), ignoring --trace_file" << std::endl;
+    }
+#endif // VISIONCORE_HAVE_TRACE
+    
+    if(opts.perf && !vc::perf::processCounters().read().any())
+    {
+        std::cerr << "Hardware counters not available, ignoring --perf" << std::endl;
+        opts.perf = false;
+    }
+    
+    std::cout << "RGB-D frontend " << opts.width << "x" << opts.height << ", " << opts.frames 
+              << " frames (+" << opts.warmup << " warmup), bilateral dim " << opts.dim 
+              << ", PLY every " << opts.ply_every << " frames" << std::endl << std::endl;
+    std::cout << std::setw(8) << "threads" << std::setw(12) << "p50 [ms]" << std::setw(12) << "p95 [ms]" 
+              << std::setw(12) << "p99 [ms]" << std::setw(12) << "max [ms]" << std::setw(10) << "FPS" << std::setw(8) << "blobs";
+    for(int s = 0 ; s < StageCount ; ++s)
+    {
+        std::cout << std::setw(12) << StageNames[s];
+    }
+    std::cout << std::endl;
+    
+    for(int64_t threads : opts.threads)
+    {
+        vc::bench::ThreadScope scope(std::max<int64_t>(threads, 1));
+        Frontend frontend(opts.width, opts.height);
+        std::vector<double> latency;
+        latency.reserve(opts.frames);
+        double stage_time[StageCount] = { 0.0 };
+        
+        for(std::size_t i = 0 ; i < opts.warmup ; ++i)
+        {
+            frontend.process(frames[i % SyntheticFrames], false, opts, stage_time);
+        }
+        
+        std::fill(stage_time, stage_time + StageCount, 0.0);
+        
+        // the warmup started the workers, count them too
+        vc::perf::Sample counters;
+        if(opts.perf)
+        {
+            vc::perf::processCounters().rescan();
+#ifdef VISIONCORE_HAVE_TRACE
+            vc::trace::setHardwareCounters(!opts.trace_file.empty());
+#endif // VISIONCORE_HAVE_TRACE
+            counters = vc::perf::processCounters().read();
+        }
+        
+        const ClockT::time_point start = ClockT::now();
+        for(std::size_t i = 0 ; i < opts.frames ; ++i)
+        {
+            const bool save_ply = opts.ply_every > 0 && (i % opts.ply_every) == opts.ply_every - 1;
+            
+            const ClockT::time_point t0 = ClockT::now();
+            frontend.process(frames[i % SyntheticFrames], save_ply, opts, stage_time);
+            latency.push_back(std::chrono::duration<double, std::milli>(ClockT::now() - t0).count());
+        }
+        const double total = std::chrono::duration<double>(ClockT::now() - start).count();
+        
+        if(opts.perf)
+        {
+            counters = vc::perf::processCounters().read() - counters;
+        }
+        
+        std::sort(latency.begin(), latency.end());
+        
+        std::cout << std::fixed << std::setprecision(2) 
+                  << std::setw(8) << threads 
+                  << std::setw(12) << percentile(latency, 50.0) 
+                  << std::setw(12) << percentile(latency, 95.0) 
+                  << std::setw(12) << percentile(latency, 99.0) 
+                  << std::setw(12) << latency.back()
+                  << std::setw(10) << double(opts.frames) / total
+                  << std::setw(8) << frontend.blob_count;
+        // mean per frame, PLY amortized over all frames
+        for(int s = 0 ; s < StageCount ; ++s)
+        {
+            std::cout << std::setw(12) << stage_time[s] * 1000.0 / double(opts.frames);
+        }
+        std::cout << std::endl;
+        
+        if(opts.perf)
+        {
+            std::cout << std::setw(8) << "" << "  per frame:";
+            for(std::size_t c = 0 ; c < vc::perf::CounterCount ; ++c)
+            {
+                if(counters.valid[c])
+                {
+                    std::cout << " " << vc::perf::counterName((vc::perf::Counter)c) << "=" 
+                              << std::setprecision(0) << double(counters.values[c]) / double(opts.frames);
+                }
+            }
+            if(counters.ipc() > 0.0)
+            {
+                std::cout << " ipc=" << std::setprecision(2) << counters.ipc();
+            }
+            std::cout << std::endl;
+        }
+    }
+    
+    std::remove(opts.ply_file.c_str());
+    
+#ifdef VISIONCORE_HAVE_TRACE
+    if(!opts.trace_file.empty())
+    {
+        vc::trace::saveChromeTrace(opts.trace_file);
+    }
+#endif // VISIONCORE_HAVE_TRACE
+    
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,303 @@
+/**
+ * ****************************************************************************
+ * Copyright (c) 2017, Robert Lukierski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * ****************************************************************************
+ * Common helpers for the micro-benchmarks.
+ * ****************************************************************************
+ */
+
+#ifndef VISIONCORE_BENCHMARK_COMMON_HPP
+#define VISIONCORE_BENCHMARK_COMMON_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <VisionCore/Platform.hpp>
+#include <VisionCore/ExecutionContext.hpp>
+#include <VisionCore/PerfCounters.hpp>
+#include <VisionCore/Buffers/Buffer1D.hpp>
+#include <VisionCore/Buffers/Buffer2D.hpp>
+
+namespace vc
+{
+
+namespace bench
+{
+
+/**
+ * Image sizes swept by the 2D benchmarks, VGA to 4K UHD.
+ */
+static const std::vector<std::pair<int64_t,int64_t>> ImageSizes = 
+{
+    {  640,  480 }, // VGA
+    { 1280,  720 }, // 720p
+    { 1920, 1080 }, // 1080p
+    { 3840, 2160 }  // 4K UHD
+};
+
+/**
+ * Thread counts: 1, 2, 4, ... up to (and including) the hardware concurrency.
+ */
+static inline std::vector<int64_t> threadCounts()
+{
+    const int64_t hw = std::max<int64_t>(std::thread::hardware_concurrency(), 1);
+    
+    std::vector<int64_t> ret;
+    for(int64_t t = 1 ; t < hw ; t *= 2)
+    {
+        ret.push_back(t);
+    }
+    ret.push_back(hw);
+    
+    return ret;
+}
+
+/**
+ * Arguments: width, height, threads.
+ */
+static inline void ImageArgs(benchmark::internal::Benchmark* b)
+{
+    b->ArgNames({"w", "h", "threads"});
+    
+    for(const auto& sz : ImageSizes)
+    {
+        for(int64_t t : threadCounts())
+        {
+            b->Args({sz.first, sz.second, t});
+        }
+    }
+    
+    b->Unit(benchmark::kMicrosecond)->UseRealTime();
+}
+
+/**
+ * Arguments: width, height. For kernels that are not parallelized.
+ */
+static inline void ImageArgsSerial(benchmark::internal::Benchmark* b)
+{
+    b->ArgNames({"w", "h"});
+    
+    for(const auto& sz : ImageSizes)
+    {
+        b->Args({sz.first, sz.second});
+    }
+    
+    b->Unit(benchmark::kMicrosecond)->UseRealTime();
+}
+
+/**
+ * Arguments: length, threads. 1D sizes match the pixel counts of ImageSizes.
+ */
+static inline void LinearArgs(benchmark::internal::Benchmark* b)
+{
+    b->ArgNames({"n", "threads"});
+    
+    for(const auto& sz : ImageSizes)
+    {
+        for(int64_t t : threadCounts())
+        {
+            b->Args({sz.first * sz.second, t});
+        }
+    }
+    
+    b->Unit(benchmark::kMicrosecond)->UseRealTime();
+}
+
+/**
+ * Runs the launches of a benchmark on a context limited to the requested number of threads.
+ */
+class ThreadScope
+{
+public:
+    ThreadScope(std::size_t threads) : ctx(threads), scope(ctx) { }
+    
+private:
+    vc::ExecutionContext        ctx;
+    vc::ExecutionContextScope   scope;
+};
+
+/**
+ * Reports pixels/s and bytes/s (decimal prefixes, so G/s reads as GB/s), pixels and bytes are per iteration.
+ * Bytes are the ones a kernel has to move at least (reads + writes).
+ */
+static inline void setThroughput(benchmark::State& state, std::size_t pixels, std::size_t bytes)
+{
+    state.counters["pixels"] = benchmark::Counter(double(state.iterations()) * double(pixels), 
+                                                  benchmark::Counter::kIsRate);
+    state.counters["bytes"] = benchmark::Counter(double(state.iterations()) * double(bytes), 
+                                                 benchmark::Counter::kIsRate, benchmark::Counter::kIs1000);
+}
+
+/**
+ * Reports hardware counters per iteration (cycles, instructions, ipc, llc_misses, branch_misses, 
+ * task_clock_ns) over [construction, destruction), construct it right before the benchmark loop.
+ * Counts all threads of the process, workers started by the earlier (calibration) runs included.
+ * Nothing is reported if counters are unavailable or VISIONCORE_BENCHMARK_COUNTERS=0.
+ */
+class HardwareCounters
+{
+public:
+    HardwareCounters(benchmark::State& st) : state(st), enabled(isEnabled())
+    {
+        if(!enabled) { return; }
+        
+        vc::perf::processCounters().rescan();
+        begin = vc::perf::processCounters().read();
+    }
+    
+    ~HardwareCounters()
+    {
+        if(!enabled || state.iterations() == 0) { return; }
+        
+        const vc::perf::Sample diff = vc::perf::processCounters().read() - begin;
+        
+        for(std::size_t c = 0 ; c < vc::perf::CounterCount ; ++c)
+        {
+            if(diff.valid[c])
+            {
+                state.counters[vc::perf::counterName((vc::perf::Counter)c)] = 
+                    benchmark::Counter(double(diff.values[c]), benchmark::Counter::kAvgIterations);
+            }
+        }
+        
+        if(diff.ipc() > 0.0)
+        {
+            state.counters["ipc"] = diff.ipc();
+        }
+    }
+    
+    HardwareCounters(const HardwareCounters&) = delete;
+    HardwareCounters& operator=(const HardwareCounters&) = delete;
+    
+    static bool isEnabled()
+    {
+        static const bool enabled = []()
+        {
+            const char* env = std::getenv("VISIONCORE_BENCHMARK_COUNTERS");
+            if(env != nullptr && std::strcmp(env, "0") == 0) { return false; }
+            return vc::perf::processCounters().read().any();
+        }();
+        
+        return enabled;
+    }
+    
+private:
+    benchmark::State&   state;
+    bool                enabled;
+    vc::perf::Sample    begin;
+};
+
+/**
+ * Deterministic test data. Floating point channels are in [0,1), integer ones cover the full range.
+ */
+template<typename T>
+static inline typename std::enable_if<std::is_floating_point<T>::value, T>::type randomChannel(std::mt19937& rng)
+{
+    return std::uniform_real_distribution<T>(T(0.0), T(1.0))(rng);
+}
+
+template<typename T>
+static inline typename std::enable_if<std::is_integral<T>::value, T>::type randomChannel(std::mt19937& rng)
+{
+    return T(std::uniform_int_distribution<int64_t>(std::numeric_limits<T>::min(), std::numeric_limits<T>::max())(rng));
+}
+
+template<typename T>
+static inline T randomPixel(std::mt19937& rng)
+{
+    typedef typename vc::type_traits<T>::ChannelType ChannelT;
+    
+    T ret;
+    ChannelT* ch = reinterpret_cast<ChannelT*>(&ret);
+    for(int c = 0 ; c < vc::type_traits<T>::ChannelCount ; ++c)
+    {
+        ch[c] = randomChannel<ChannelT>(rng);
+    }
+    return ret;
+}
+
+/**
+ * Pixel with every channel set to a fraction of the channel range ([0,1] for floating point).
+ */
+template<typename T>
+static inline T scaledPixel(double fraction)
+{
+    typedef typename vc::type_traits<T>::ChannelType ChannelT;
+    const double range = std::is_floating_point<ChannelT>::value ? 1.0 : double(std::numeric_limits<ChannelT>::max());
+    
+    T ret;
+    ChannelT* ch = reinterpret_cast<ChannelT*>(&ret);
+    for(int c = 0 ; c < vc::type_traits<T>::ChannelCount ; ++c)
+    {
+        ch[c] = ChannelT(fraction * range);
+    }
+    return ret;
+}
+
+template<typename T>
+static inline void fillRandom(vc::Buffer2DView<T,vc::TargetHost>& buf, unsigned int seed = 42)
+{
+    std::mt19937 rng(seed);
+    
+    for(std::size_t y = 0 ; y < buf.height() ; ++y)
+    {
+        for(std::size_t x = 0 ; x < buf.width() ; ++x)
+        {
+            buf(x,y) = randomPixel<T>(rng);
+        }
+    }
+}
+
+template<typename T>
+static inline void fillRandom(vc::Buffer1DView<T,vc::TargetHost>& buf, unsigned int seed = 42)
+{
+    std::mt19937 rng(seed);
+    
+    for(std::size_t i = 0 ; i < buf.size() ; ++i)
+    {
+        buf(i) = randomPixel<T>(rng);
+    }
+}
+
+}
+
+}
+
+#endif // VISIONCORE_BENCHMARK_COMMON_HPP
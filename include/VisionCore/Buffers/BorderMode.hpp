@@ -0,0 +1,57 @@
+/**
+ * ****************************************************************************
+ * Copyright (c) 2017, Robert Lukierski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ****************************************************************************
+ * Border handling of the stencil operations.
+ * ****************************************************************************
+ */
+
+#ifndef VISIONCORE_BUFFERS_BORDER_MODE_HPP
+#define VISIONCORE_BUFFERS_BORDER_MODE_HPP
+
+namespace vc
+{
+
+/**
+ * What stencil operations (convolve, bilateral, ...) read outside of the image, 
+ * shown for a row abcd.
+ */
+enum class BorderMode
+{
+    Clamp = 0,  ///< edge repeated, aaa|abcd|ddd
+    Reflect,    ///< mirrored including the edge, cba|abcd|dcb
+    Wrap,       ///< periodic, bcd|abcd|abc
+    Constant,   ///< given value, vvv|abcd|vvv
+    Skip        ///< output pixels whose stencil leaves the image are not written
+};
+
+}
+
+#endif // VISIONCORE_BUFFERS_BORDER_MODE_HPP
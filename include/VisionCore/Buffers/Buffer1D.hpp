@@ -331,6 +331,7 @@ public:
                          const std::vector<cl::Event>* events = nullptr, cl::Event* event = nullptr)
     {
         queue.enqueueReadBuffer(img.clType(), true, 0, std::min(BaseT::bytes(), img.bytes()), BaseT::rawPtr(), events, event);
+        memstats::recordTransfer(MemoryTarget::OpenCL, MemoryTarget::Host, std::min(BaseT::bytes(), img.bytes()));
     }
 #endif // VISIONCORE_HAVE_OPENCL
     
@@ -339,6 +340,11 @@ public:
         TargetType::template memset<T>(BaseT::rawPtr(), v, BaseT::bytes());
     }
     
+    inline void fill(const ValueType& v)
+    {
+        hostFill2D(BaseT::rawPtr(), BaseT::bytes(), &v, sizeof(ValueType), BaseT::size(), 1);
+    }
+    
     inline ValueType* begin() { return BaseT::ptr(); }
     inline const ValueType* begin() const { return BaseT::ptr(); }
     inline ValueType* end() { return (BaseT::ptr() + BaseT::size()); }
@@ -470,12 +476,14 @@ public:
                          const std::vector<cl::Event>* events = nullptr, cl::Event* event = nullptr)
     {
         queue.enqueueWriteBuffer(clType(), true, 0, std::min(BaseT::bytes(), img.bytes()), img.rawPtr(), events, event);
+        memstats::recordTransfer(MemoryTarget::Host, MemoryTarget::OpenCL, std::min(BaseT::bytes(), img.bytes()));
     }
     
     inline void copyFrom(const cl::CommandQueue& queue, const Buffer1DView<ValueType,TargetDeviceOpenCL>& img, 
                          const std::vector<cl::Event>* events = nullptr, cl::Event* event = nullptr)
     {
         queue.enqueueCopyBuffer(img.clType(), clType(), 0, 0, std::min(BaseT::bytes(), img.bytes()), events, event);
+        memstats::recordTransfer(MemoryTarget::OpenCL, MemoryTarget::OpenCL, std::min(BaseT::bytes(), img.bytes()));
     }
     
     inline void memset(const cl::CommandQueue& queue, T v, const std::vector<cl::Event>* events = nullptr, cl::Event* event = nullptr)
@@ -678,7 +686,7 @@ public:
     
     Buffer1DManaged(std::size_t s, const cl::Context& context, cl_mem_flags flags, PointerType hostptr = nullptr) : ViewT()
     {
-        ViewT::memptr = new cl::Buffer(context, flags, s * sizeof(RealValueType), hostptr);
+        ViewT::memptr = TargetDeviceOpenCL::create<cl::Buffer>(context, flags, s * sizeof(RealValueType), hostptr);
         ViewT::xsize = s;
     }
     
@@ -687,7 +695,7 @@ public:
         if(ViewT::isValid())
         {
             cl::Buffer* clb = static_cast<cl::Buffer*>(ViewT::memptr);
-            delete clb;
+            TargetDeviceOpenCL::release(clb);
             ViewT::memptr = nullptr;
             ViewT::xsize = 0;
         }
@@ -381,13 +381,10 @@ public:
         return *this;
     }
     
-    inline void copyFrom(const Buffer2DView<T,TargetHost>& img)
+    inline void copyFrom(const Buffer2DView<T,TargetHost>& img, CopyHint hint = CopyHint::Auto)
     {
-        typedef TargetHost TargetFrom;
-        TargetTransfer<TargetFrom,TargetType>::template memcpy2D<T>(BaseT::rawPtr(), BaseT::pitch(), 
-                                                                    (typename TargetFrom::template PointerType<T>)img.ptr(),
-                                                                    img.pitch(), std::min(img.width(),BaseT::width())*sizeof(T),
-                                                                    std::min(img.height(),BaseT::height()));
+        hostCopy2D(BaseT::rawPtr(), BaseT::pitch(), img.rawPtr(), img.pitch(), 
+                   std::min(img.width(),BaseT::width())*sizeof(T), std::min(img.height(),BaseT::height()), hint);
     }
     
 #ifdef VISIONCORE_HAVE_CUDA
@@ -405,7 +402,13 @@ public:
     inline void copyFrom(const cl::CommandQueue& queue, const Buffer2DView<T,TargetDeviceOpenCL>& img, 
                          const std::vector<cl::Event>* events = nullptr, cl::Event* event = nullptr)
     {
-        queue.enqueueReadBuffer(img.clType(), true, 0, std::min(BaseT::bytes(), img.bytes()), BaseT::rawPtr(), events, event);
+        // host rows may be padded
+        const std::array<std::size_t,3> origin = {{ 0, 0, 0 }};
+        const std::array<std::size_t,3> region = {{ std::min(BaseT::width(), img.width()) * sizeof(T), 
+                                                    std::min(BaseT::height(), img.height()), 1 }};
+        queue.enqueueReadBufferRect(img.clType(), true, origin, origin, region, img.pitch(), 0, 
+                                    BaseT::pitch(), 0, BaseT::rawPtr(), events, event);
+        memstats::recordTransfer(MemoryTarget::OpenCL, MemoryTarget::Host, region[0] * region[1] * region[2]);
     }
 
     inline void copyFrom(const cl::CommandQueue& queue, const Image2DView<T,TargetDeviceOpenCL>& img, 
@@ -418,7 +421,8 @@ public:
         region[0] = std::min(BaseT::width(), img.width());
         region[1] = std::min(BaseT::height(), img.height());
         region[2] = 1; // API says so
-        queue.enqueueReadImage(img.clType(), true, origin, region, 0, 0, BaseT::rawPtr(), events, event);
+        queue.enqueueReadImage(img.clType(), true, origin, region, BaseT::pitch(), 0, BaseT::rawPtr(), events, event);
+        memstats::recordTransfer(MemoryTarget::OpenCL, MemoryTarget::Host, region[0] * region[1] * sizeof(T));
     }
 #endif // VISIONCORE_HAVE_OPENCL
 
@@ -427,6 +431,12 @@ public:
         TargetType::template memset2D<T>(BaseT::rawPtr(), BaseT::pitch(),  v, BaseT::width() * sizeof(T), BaseT::height());
     }
     
+    /// Parallel, rows only (sub-buffers keep their neighbours).
+    inline void fill(const T& v)
+    {
+        hostFill2D(BaseT::rawPtr(), BaseT::pitch(), &v, sizeof(T), BaseT::width(), BaseT::height());
+    }
+    
     inline T* begin() { return BaseT::ptr(); }
     inline const T* begin() const { return BaseT::ptr(); }
     inline T* end() { return (BaseT::ptr() + BaseT::totalElements()); }
@@ -583,13 +593,20 @@ public:
     inline void copyFrom(const cl::CommandQueue& queue, const Buffer2DView<T,TargetHost>& img, 
                          const std::vector<cl::Event>* events = nullptr, cl::Event* event = nullptr)
     {
-        queue.enqueueWriteBuffer(clType(), true, 0, std::min(BaseT::bytes(), img.bytes()), img.rawPtr(), events, event);
+        // host rows may be padded
+        const std::array<std::size_t,3> origin = {{ 0, 0, 0 }};
+        const std::array<std::size_t,3> region = {{ std::min(BaseT::width(), img.width()) * sizeof(T), 
+                                                    std::min(BaseT::height(), img.height()), 1 }};
+        queue.enqueueWriteBufferRect(clType(), true, origin, origin, region, BaseT::pitch(), 0, 
+                                     img.pitch(), 0, img.rawPtr(), events, event);
+        memstats::recordTransfer(MemoryTarget::Host, MemoryTarget::OpenCL, region[0] * region[1] * region[2]);
     }
     
     inline void copyFrom(const cl::CommandQueue& queue, const Buffer2DView<T,TargetDeviceOpenCL>& img, 
                          const std::vector<cl::Event>* events = nullptr, cl::Event* event = nullptr)
     {
         queue.enqueueCopyBuffer(img.clType(), clType(), 0, 0, std::min(BaseT::bytes(), img.bytes()), events, event);
+        memstats::recordTransfer(MemoryTarget::OpenCL, MemoryTarget::OpenCL, std::min(BaseT::bytes(), img.bytes()));
     }
     
     inline void copyFrom(const cl::CommandQueue& queue, const Image2DView<T,TargetDeviceOpenCL>& img, 
@@ -604,6 +621,7 @@ public:
         region[2] = 1; // API says so
         
         queue.enqueueCopyImageToBuffer(img.clType(), clType(), origin, region, 0, events, event);
+        memstats::recordTransfer(MemoryTarget::OpenCL, MemoryTarget::OpenCL, region[0] * region[1] * sizeof(T));
     }
     
     inline void memset(const cl::CommandQueue& queue, T v, 
@@ -729,7 +747,7 @@ public:
     inline Buffer2DManaged(std::size_t w, std::size_t h, const cl::Context& context, 
                            cl_mem_flags flags, typename TargetHost::template PointerType<T> hostptr = nullptr) : ViewT()
     {        
-        ViewT::memptr = new cl::Buffer(context, flags, w*h*sizeof(T), hostptr);
+        ViewT::memptr = TargetDeviceOpenCL::create<cl::Buffer>(context, flags, w*h*sizeof(T), hostptr);
         ViewT::xsize = w;
         ViewT::ysize = h;
         ViewT::line_pitch = w * sizeof(T);
@@ -740,7 +758,7 @@ public:
         if(ViewT::isValid())
         {
             cl::Buffer* clb = static_cast<cl::Buffer*>(ViewT::memptr);
-            delete clb;
+            TargetDeviceOpenCL::release(clb);
             ViewT::memptr = nullptr;
             ViewT::xsize = 0;
             ViewT::ysize = 0;
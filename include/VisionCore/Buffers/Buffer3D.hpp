@@ -335,11 +335,18 @@ public:
     {
         TargetType::template memset3D<T>(BaseT::rawPtr(), BaseT::pitch(), v, BaseT::width(), BaseT::height(), BaseT::depth());
     }
+    
+    /// Parallel, rows only (sub-buffers keep their neighbours).
+    inline void fill(const T& v)
+    {
+        hostFill3D(BaseT::rawPtr(), BaseT::pitch(), BaseT::planePitch(), &v, sizeof(T), BaseT::width(), BaseT::height(), BaseT::depth());
+    }
 
-    inline void copyFrom(const Buffer3DView<T,TargetHost>& img)
+    inline void copyFrom(const Buffer3DView<T,TargetHost>& img, CopyHint hint = CopyHint::Auto)
     {
-        typedef TargetHost TargetFrom;
-        TargetTransfer<TargetFrom,TargetType>::template memcpy2D<T>(BaseT::rawPtr(), BaseT::pitch(), (typename TargetFrom::template PointerType<T>)img.ptr(), img.pitch(), std::min(img.width(), BaseT::width()) * sizeof(T), BaseT::height()*std::min(img.depth(), BaseT::depth()));
+        hostCopy3D(BaseT::rawPtr(), BaseT::pitch(), BaseT::planePitch(), img.rawPtr(), img.pitch(), img.planePitch(), 
+                   std::min(img.width(), BaseT::width()) * sizeof(T), std::min(img.height(), BaseT::height()), 
+                   std::min(img.depth(), BaseT::depth()), hint);
     }
     
 #ifdef VISIONCORE_HAVE_CUDA
@@ -353,7 +360,14 @@ public:
 #ifdef VISIONCORE_HAVE_OPENCL
     inline void copyFrom(const cl::CommandQueue& queue, const Buffer3DView<T,TargetDeviceOpenCL>& img)
     {
-        queue.enqueueReadBuffer(img.clType(), true, 0, std::min(BaseT::bytes(), img.bytes()), BaseT::rawPtr());
+        // host rows may be padded
+        const std::array<std::size_t,3> origin = {{ 0, 0, 0 }};
+        const std::array<std::size_t,3> region = {{ std::min(BaseT::width(), img.width()) * sizeof(T), 
+                                                    std::min(BaseT::height(), img.height()),
+                                                    std::min(BaseT::depth(), img.depth()) }};
+        queue.enqueueReadBufferRect(img.clType(), true, origin, origin, region, img.pitch(), img.planePitch(), 
+                                    BaseT::pitch(), BaseT::planePitch(), BaseT::rawPtr());
+        memstats::recordTransfer(MemoryTarget::OpenCL, MemoryTarget::Host, region[0] * region[1] * region[2]);
     }
 #endif // VISIONCORE_HAVE_OPENCL
     
@@ -468,12 +482,20 @@ public:
     
     inline void copyFrom(const cl::CommandQueue& queue, const Buffer3DView<T,TargetHost>& img)
     {
-        queue.enqueueWriteBuffer(clType(), true, 0, std::min(BaseT::bytes(), img.bytes()), img.rawPtr());
+        // host rows may be padded
+        const std::array<std::size_t,3> origin = {{ 0, 0, 0 }};
+        const std::array<std::size_t,3> region = {{ std::min(BaseT::width(), img.width()) * sizeof(T), 
+                                                    std::min(BaseT::height(), img.height()),
+                                                    std::min(BaseT::depth(), img.depth()) }};
+        queue.enqueueWriteBufferRect(clType(), true, origin, origin, region, BaseT::pitch(), BaseT::planePitch(), 
+                                     img.pitch(), img.planePitch(), img.rawPtr());
+        memstats::recordTransfer(MemoryTarget::Host, MemoryTarget::OpenCL, region[0] * region[1] * region[2]);
     }
     
     inline void copyFrom(const cl::CommandQueue& queue, const Buffer3DView<T,TargetDeviceOpenCL>& img)
     {
         queue.enqueueCopyBuffer(img.clType(), clType(), 0, 0, std::min(BaseT::bytes(), img.bytes()));
+        memstats::recordTransfer(MemoryTarget::OpenCL, MemoryTarget::OpenCL, std::min(BaseT::bytes(), img.bytes()));
     }
     
     inline void memset(const cl::CommandQueue& queue, T v)
@@ -573,7 +595,7 @@ public:
     
     inline Buffer3DManaged(std::size_t w, std::size_t h, std::size_t d, const cl::Context& context, cl_mem_flags flags, typename TargetHost::template PointerType<T> hostptr = nullptr) : ViewT()
     {        
-        ViewT::memptr = new cl::Buffer(context, flags, d*w*h*sizeof(T), hostptr);
+        ViewT::memptr = TargetDeviceOpenCL::create<cl::Buffer>(context, flags, d*w*h*sizeof(T), hostptr);
         ViewT::xsize = w;
         ViewT::ysize = h;
         ViewT::zsize = d;
@@ -586,7 +608,7 @@ public:
         if(ViewT::isValid())
         {
             cl::Buffer* clb = static_cast<cl::Buffer*>(ViewT::memptr);
-            delete clb;
+            TargetDeviceOpenCL::release(clb);
             ViewT::memptr = nullptr;
             ViewT::xsize = 0;
             ViewT::ysize = 0;
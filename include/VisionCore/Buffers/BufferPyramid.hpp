@@ -448,23 +448,18 @@ public:
     
     BufferPyramidManaged() = delete;
     
-    inline BufferPyramidManaged(std::size_t w, std::size_t h)
+    inline BufferPyramidManaged(std::size_t w, std::size_t h) : slab(PyramidSlab<Target>::template create<T>(LevelCount, w, h))
     {        
-        // Build power of two structure
-        for(std::size_t l = 0; l < LevelCount && (w>>l > 0) && (h>>l > 0); ++l ) 
+        // Build power of two structure, all levels in one slab
+        for(std::size_t l = 0; l < slab.levels() ; ++l ) 
         {
-            typename Target::template PointerType<T> ptr = 0;
-            std::size_t line_pitch = 0;
-            
-            Target::template AllocatePitchedMem<T>(&ptr, &line_pitch, w >> l, h >> l);
-            
-            ViewT::imgs[l] = LevelT(ptr, w >> l, h >> l, line_pitch);
+            ViewT::imgs[l] = LevelT(slab.template levelPtr<T>(l), w >> l, h >> l, slab.pitch(l));
         }
     }
     
     BufferPyramidManaged(const BufferPyramidManaged<T,LevelCount,Target>& img) = delete;
     
-    inline BufferPyramidManaged(BufferPyramidManaged<T,LevelCount,Target>&& img) : ViewT(std::move(img))
+    inline BufferPyramidManaged(BufferPyramidManaged<T,LevelCount,Target>&& img) : ViewT(std::move(img)), slab(std::move(img.slab))
     {
         
     }
@@ -474,19 +469,43 @@ public:
     inline BufferPyramidManaged<T,LevelCount,Target>& operator=(BufferPyramidManaged<T,LevelCount,Target>&& img)
     {
         ViewT::operator=(std::move(img));
+        slab = std::move(img.slab);
         return *this;
     }
     
     inline ~BufferPyramidManaged()
     {
-        for(std::size_t l = 0; l < LevelCount ; ++l)
+        
+    }
+    
+    using ViewT::copyFrom;
+    
+    /// All levels at once.
+    inline void memset(unsigned char v = 0)
+    {
+        slab.memset(v);
+    }
+    
+    /// All levels in one transfer when both slabs are laid out the same, level by level otherwise.
+    template<typename TargetFrom>
+    inline void copyFrom(const BufferPyramidManaged<T,LevelCount,TargetFrom>& pyramid)
+    {
+        if(slab.sameLayout(pyramid.memory()))
+        {
+            slab.copyFrom(pyramid.memory());
+        }
+        else
         {
-            Target::template DeallocatePitchedMem<T>(ViewT::imgs[l].rawPtr());
+            ViewT::copyFrom(pyramid.view());
         }
     }
     
+    inline const PyramidSlab<Target>& memory() const { return slab; }
+    
     inline const ViewT& view() const { return (const ViewT&)*this; }
     inline ViewT& view() { return (ViewT&)*this; }
+private:
+    PyramidSlab<Target> slab;
 };
 
 #ifdef VISIONCORE_HAVE_OPENCL
@@ -513,7 +532,7 @@ public:
         {
             const std::size_t new_w = w >> l;
             const std::size_t new_h = h >> l;
-            ViewT::imgs[l] = Buffer2DView<T,TargetType>(new cl::Buffer(context, flags, new_w*new_h*sizeof(T)), new_w, new_h, new_w * sizeof(T));
+            ViewT::imgs[l] = Buffer2DView<T,TargetType>(TargetDeviceOpenCL::create<cl::Buffer>(context, flags, new_w*new_h*sizeof(T)), new_w, new_h, new_w * sizeof(T));
         }
     }
     
@@ -539,7 +558,7 @@ public:
             if(ViewT::imgs[l].isValid())
             {
                 cl::Buffer* clb = static_cast<cl::Buffer*>(ViewT::imgs[l].rawPtr());
-                delete clb;
+                TargetDeviceOpenCL::release(clb);
             }
         }
     }
@@ -564,23 +583,19 @@ public:
     
     RuntimeBufferPyramidManaged() = delete;
     
-    inline RuntimeBufferPyramidManaged(std::size_t LevelCount, std::size_t w, std::size_t h) : ViewT(LevelCount)
+    inline RuntimeBufferPyramidManaged(std::size_t LevelCount, std::size_t w, std::size_t h) : ViewT(LevelCount), 
+        slab(PyramidSlab<Target>::template create<T>(LevelCount, w, h))
     {        
-        // Build power of two structure
-        for(std::size_t l = 0; l < LevelCount && (w>>l > 0) && (h>>l > 0); ++l ) 
+        // Build power of two structure, all levels in one slab
+        for(std::size_t l = 0; l < slab.levels() ; ++l ) 
         {
-            typename Target::template PointerType<T> ptr = 0;
-            std::size_t line_pitch = 0;
-            
-            Target::template AllocatePitchedMem<T>(&ptr, &line_pitch, w >> l, h >> l);
-            
-            ViewT::imgs[l] = LevelT(ptr, w >> l, h >> l, line_pitch);
+            ViewT::imgs[l] = LevelT(slab.template levelPtr<T>(l), w >> l, h >> l, slab.pitch(l));
         }
     }
     
     RuntimeBufferPyramidManaged(const RuntimeBufferPyramidManaged<T,Target>& img) = delete;
     
-    inline RuntimeBufferPyramidManaged(RuntimeBufferPyramidManaged<T,Target>&& img) : ViewT(std::move(img))
+    inline RuntimeBufferPyramidManaged(RuntimeBufferPyramidManaged<T,Target>&& img) : ViewT(std::move(img)), slab(std::move(img.slab))
     {
       
     }
@@ -590,19 +605,43 @@ public:
     inline RuntimeBufferPyramidManaged<T,Target>& operator=(RuntimeBufferPyramidManaged<T,Target>&& img)
     {
         ViewT::operator=(std::move(img));
+        slab = std::move(img.slab);
         return *this;
     }
     
     inline ~RuntimeBufferPyramidManaged()
     {
-        for(std::size_t l = 0; l < ViewT::getLevelCount() ; ++l)
+        
+    }
+    
+    using ViewT::copyFrom;
+    
+    /// All levels at once.
+    inline void memset(unsigned char v = 0)
+    {
+        slab.memset(v);
+    }
+    
+    /// All levels in one transfer when both slabs are laid out the same, level by level otherwise.
+    template<typename TargetFrom>
+    inline void copyFrom(const RuntimeBufferPyramidManaged<T,TargetFrom>& pyramid)
+    {
+        if(ViewT::getLevelCount() == pyramid.getLevelCount() && slab.sameLayout(pyramid.memory()))
         {
-            Target::template DeallocatePitchedMem<T>(ViewT::imgs[l].rawPtr());
+            slab.copyFrom(pyramid.memory());
+        }
+        else
+        {
+            ViewT::copyFrom(pyramid.view());
         }
     }
     
+    inline const PyramidSlab<Target>& memory() const { return slab; }
+    
     inline const ViewT& view() const { return (const ViewT&)*this; }
     inline ViewT& view() { return (ViewT&)*this; }
+private:
+    PyramidSlab<Target> slab;
 };
 
 }
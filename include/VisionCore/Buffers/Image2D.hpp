@@ -354,7 +354,8 @@ public:
         region[0] = std::min(BaseType::width(), img.width());
         region[1] = std::min(BaseType::height(), img.height());
         region[2] = 1; // API says so
-        queue.enqueueReadImage(img.clType(), true, origin, region, 0, 0, BaseType::rawPtr(), events, event);
+        queue.enqueueReadImage(img.clType(), true, origin, region, BaseType::pitch(), 0, BaseType::rawPtr(), events, event);
+        memstats::recordTransfer(MemoryTarget::OpenCL, MemoryTarget::Host, region[0] * region[1] * sizeof(T));
     }
 #endif // VISIONCORE_HAVE_OPENCL
 };
@@ -436,7 +437,8 @@ public:
         region[0] = std::min(BaseType::width(), img.width());
         region[1] = std::min(BaseType::height(), img.height());
         region[2] = 1; // API says so
-        queue.enqueueWriteImage(clType(), true, origin, region, 0, 0, img.rawPtr(), events, event);
+        queue.enqueueWriteImage(clType(), true, origin, region, img.pitch(), 0, img.rawPtr(), events, event);
+        memstats::recordTransfer(MemoryTarget::Host, MemoryTarget::OpenCL, region[0] * region[1] * sizeof(T));
     }
     
     inline void copyFrom(const cl::CommandQueue& queue, const Image2DView<T,TargetDeviceOpenCL>& img, const std::vector<cl::Event>* events = nullptr, cl::Event* event = nullptr)
@@ -449,6 +451,7 @@ public:
         region[1] = std::min(BaseType::height(), img.height());
         region[2] = 1; // API says so
         queue.enqueueCopyImage(img.clType(), clType(), origin, origin, region, events, event);
+        memstats::recordTransfer(MemoryTarget::OpenCL, MemoryTarget::OpenCL, region[0] * region[1] * sizeof(T));
     }
     
     inline void copyFrom(const cl::CommandQueue& queue, const Buffer2DView<T, TargetDeviceOpenCL>& buf, const std::vector<cl::Event>* events = nullptr, cl::Event* event = nullptr)
@@ -462,6 +465,7 @@ public:
         region[2] = 1; // API says so
         
         queue.enqueueCopyBufferToImage(buf.clType(), clType(), 0, origin, region, events, event);
+        memstats::recordTransfer(MemoryTarget::OpenCL, MemoryTarget::OpenCL, region[0] * region[1] * sizeof(T));
     }
     
     inline void memset(const cl::CommandQueue& queue, cl_float4 v, const std::vector<cl::Event>* events = nullptr, cl::Event* event = nullptr)
@@ -605,7 +609,7 @@ public:
         ViewT::line_pitch = w * sizeof(T);
         ViewT::xsize = w;
         ViewT::ysize = h;
-        ViewT::memptr = new cl::Image2D(context, flags, fmt, w, h, 0, hostptr);   
+        ViewT::memptr = TargetDeviceOpenCL::create<cl::Image2D>(context, flags, fmt, w, h, 0, hostptr);   
     }
     
     inline Image2DManaged(std::size_t w, std::size_t h, const cl::Context& context, cl_mem_flags flags, typename TargetHost::template PointerType<T> hostptr = nullptr) : ViewT()
@@ -613,7 +617,7 @@ public:
         ViewT::line_pitch = w * sizeof(T);
         ViewT::xsize = w;
         ViewT::ysize = h;
-        ViewT::memptr = new cl::Image2D(context, flags, 
+        ViewT::memptr = TargetDeviceOpenCL::create<cl::Image2D>(context, flags, 
                                         cl::ImageFormat(internal::ChannelCountToOpenCLChannelOrder<ViewT::Channels>::ChannelOrder,
                                                         internal::TypeToOpenCLChannelType<typename ViewT::ValueType>::ChannelType)
                                         , w, h, 0, hostptr);   
@@ -624,7 +628,7 @@ public:
         if(ViewT::isValid())
         {
             cl::Image2D* clb = static_cast<cl::Image2D*>(ViewT::memptr);
-            delete clb;
+            TargetDeviceOpenCL::release(clb);
             ViewT::memptr = nullptr;
             ViewT::xsize = 0;
             ViewT::ysize = 0;
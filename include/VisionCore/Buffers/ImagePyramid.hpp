@@ -256,23 +256,18 @@ public:
     
     ImagePyramidManaged() = delete;
     
-    inline ImagePyramidManaged(std::size_t w, std::size_t h)
+    inline ImagePyramidManaged(std::size_t w, std::size_t h) : slab(PyramidSlab<Target>::template create<T>(LevelCount, w, h))
     {        
-        // Build power of two structure
-        for(std::size_t l = 0; l < LevelCount && (w>>l > 0) && (h>>l > 0); ++l ) 
+        // Build power of two structure, all levels in one slab
+        for(std::size_t l = 0; l < slab.levels() ; ++l ) 
         {
-            typename Target::template PointerType<T> ptr = 0;
-            std::size_t line_pitch = 0;
-            
-            Target::template AllocatePitchedMem<T>(&ptr, &line_pitch, w >> l, h >> l);
-            
-            ViewT::imgs[l] = Image2DView<T,Target>((T*)ptr, w >> l, h >> l, line_pitch);
+            ViewT::imgs[l] = Image2DView<T,Target>((T*)slab.template levelPtr<T>(l), w >> l, h >> l, slab.pitch(l));
         }
     }
     
     ImagePyramidManaged(const ImagePyramidManaged<T,LevelCount,Target>& img) = delete;
     
-    inline ImagePyramidManaged(ImagePyramidManaged<T,LevelCount,Target>&& img) : ViewT(std::move(img))
+    inline ImagePyramidManaged(ImagePyramidManaged<T,LevelCount,Target>&& img) : ViewT(std::move(img)), slab(std::move(img.slab))
     {
         
     }
@@ -282,19 +277,43 @@ public:
     inline ImagePyramidManaged<T,LevelCount,Target>& operator=(ImagePyramidManaged<T,LevelCount,Target>&& img)
     {
         ViewT::operator=(std::move(img));
+        slab = std::move(img.slab);
         return *this;
     }
     
     inline ~ImagePyramidManaged()
     {
-        for(std::size_t l = 0; l < LevelCount ; ++l)
+        
+    }
+    
+    using ViewT::copyFrom;
+    
+    /// All levels at once.
+    inline void memset(unsigned char v = 0)
+    {
+        slab.memset(v);
+    }
+    
+    /// All levels in one transfer when both slabs are laid out the same, level by level otherwise.
+    template<typename TargetFrom>
+    inline void copyFrom(const ImagePyramidManaged<T,LevelCount,TargetFrom>& pyramid)
+    {
+        if(slab.sameLayout(pyramid.memory()))
+        {
+            slab.copyFrom(pyramid.memory());
+        }
+        else
         {
-            Target::template DeallocatePitchedMem<T>(ViewT::imgs[l].ptr());
+            ViewT::copyFrom(pyramid.view());
         }
     }
     
+    inline const PyramidSlab<Target>& memory() const { return slab; }
+    
     inline const ViewT& view() const { return (const ViewT&)*this; }
     inline ViewT& view() { return (ViewT&)*this; }
+private:
+    PyramidSlab<Target> slab;
 };
 
 #ifdef VISIONCORE_HAVE_OPENCL
@@ -319,7 +338,7 @@ public:
         // Build power of two structure
         for(std::size_t l = 0; l < LevelCount && (w>>l > 0) && (h>>l > 0); ++l ) 
         {
-            ViewT::imgs[l] = Image2DView<T,TargetType>(new cl::Image2D(context, flags, fmt, w >> l, h >> l, 0, nullptr), w >> l, h >> l, w * sizeof(T));
+            ViewT::imgs[l] = Image2DView<T,TargetType>(TargetDeviceOpenCL::create<cl::Image2D>(context, flags, fmt, w >> l, h >> l, 0, nullptr), w >> l, h >> l, w * sizeof(T));
         }
     }
     
@@ -330,7 +349,7 @@ public:
         {
             const std::size_t new_w = w >> l;
             const std::size_t new_h = h >> l;
-            ViewT::imgs[l] = Image2DView<T,TargetType>(new cl::Image2D(context, flags, cl::ImageFormat(internal::ChannelCountToOpenCLChannelOrder<LevelT::Channels>::ChannelOrder,
+            ViewT::imgs[l] = Image2DView<T,TargetType>(TargetDeviceOpenCL::create<cl::Image2D>(context, flags, cl::ImageFormat(internal::ChannelCountToOpenCLChannelOrder<LevelT::Channels>::ChannelOrder,
                                                                                                              internal::TypeToOpenCLChannelType<typename LevelT::ValueType>::ChannelType), new_w, new_h, 0, nullptr), new_w, new_h, new_w * sizeof(T));
         }
     }
@@ -357,7 +376,7 @@ public:
             if(ViewT::imgs[l].isValid())
             {
                 cl::Image2D* clb = static_cast<cl::Image2D*>(ViewT::imgs[l].rawPtr());
-                delete clb;
+                TargetDeviceOpenCL::release(clb);
             }
         }
     }
@@ -35,11 +35,138 @@
 #ifndef VISIONCORE_PYRAMID_BASE_HPP
 #define VISIONCORE_PYRAMID_BASE_HPP
 
+#include <vector>
+
 #include <VisionCore/Platform.hpp>
+#include <VisionCore/MemoryPolicy.hpp>
 
 namespace vc
 {
 
+/**
+ * One allocation holding every level of a power of two pyramid.
+ * 
+ * Levels start at multiples of Target::alignment() and rows are padded with Target::pitchFor, 
+ * so each level looks exactly as if allocated on its own, but the whole pyramid is one 
+ * contiguous region and can be cleared or copied in one go.
+ */
+template<typename Target>
+class PyramidSlab
+{
+public:
+    typedef typename Target::template PointerType<uint8_t> PointerT;
+    
+    inline PyramidSlab() : memptr(nullptr), slab_bytes(0) { }
+    
+    /**
+     * Up to max_levels levels, stops at the first level with a zero dimension.
+     */
+    template<typename T>
+    inline static PyramidSlab create(std::size_t max_levels, std::size_t w, std::size_t h)
+    {
+        PyramidSlab slab;
+        
+        for(std::size_t l = 0 ; l < max_levels && (w >> l > 0) && (h >> l > 0) ; ++l)
+        {
+            const std::size_t level_pitch = Target::template pitchFor<T>(w >> l);
+            slab.offsets.push_back(slab.slab_bytes);
+            slab.pitches.push_back(level_pitch);
+            slab.slab_bytes += (level_pitch * (h >> l) + Target::alignment() - 1) / Target::alignment() * Target::alignment();
+        }
+        
+        if(slab.slab_bytes > 0)
+        {
+            Target::template AllocateMem<uint8_t>(&slab.memptr, slab.slab_bytes);
+        }
+        
+        return slab;
+    }
+    
+    inline ~PyramidSlab()
+    {
+        release();
+    }
+    
+    PyramidSlab(const PyramidSlab&) = delete;
+    PyramidSlab& operator=(const PyramidSlab&) = delete;
+    
+    inline PyramidSlab(PyramidSlab&& slab) : memptr(slab.memptr), slab_bytes(slab.slab_bytes), 
+        offsets(std::move(slab.offsets)), pitches(std::move(slab.pitches))
+    {
+        slab.memptr = nullptr;
+        slab.slab_bytes = 0;
+    }
+    
+    inline PyramidSlab& operator=(PyramidSlab&& slab)
+    {
+        if(this != &slab)
+        {
+            release();
+            memptr = slab.memptr;
+            slab_bytes = slab.slab_bytes;
+            offsets = std::move(slab.offsets);
+            pitches = std::move(slab.pitches);
+            slab.memptr = nullptr;
+            slab.slab_bytes = 0;
+        }
+        
+        return *this;
+    }
+    
+    inline std::size_t levels() const { return offsets.size(); }
+    inline std::size_t bytes() const { return slab_bytes; }
+    inline std::size_t pitch(std::size_t l) const { return pitches[l]; }
+    inline std::size_t offset(std::size_t l) const { return offsets[l]; }
+    inline PointerT rawPtr() const { return memptr; }
+    
+    template<typename T>
+    inline typename Target::template PointerType<T> levelPtr(std::size_t l) const 
+    { 
+        return (typename Target::template PointerType<T>)(static_cast<uint8_t*>(memptr) + offsets[l]); 
+    }
+    
+    template<typename OtherTarget>
+    inline bool sameLayout(const PyramidSlab<OtherTarget>& slab) const
+    {
+        return slab_bytes == slab.bytes() && offsets == slab.offsets && pitches == slab.pitches;
+    }
+    
+    /// Whole slab, including the padding.
+    inline void memset(unsigned char v)
+    {
+        if(memptr != nullptr)
+        {
+            Target::template memset<uint8_t>(memptr, v, slab_bytes);
+        }
+    }
+    
+    /// Whole slab in one transfer, layouts must match (sameLayout).
+    template<typename TargetFrom>
+    inline void copyFrom(const PyramidSlab<TargetFrom>& slab)
+    {
+        if(memptr != nullptr)
+        {
+            TargetTransfer<TargetFrom,Target>::template memcpy<uint8_t>(memptr, slab.rawPtr(), slab_bytes);
+        }
+    }
+    
+    template<typename OtherTarget> friend class PyramidSlab;
+private:
+    inline void release()
+    {
+        if(memptr != nullptr)
+        {
+            Target::template DeallocatePitchedMem<uint8_t>(memptr);
+            memptr = nullptr;
+        }
+    }
+    
+    PointerT                    memptr;
+    std::size_t                 slab_bytes;
+    std::vector<std::size_t>    offsets;
+    std::vector<std::size_t>    pitches;
+};
+
 // Power of two pyramid.
 template<template<class, class> class ViewT, typename T, std::size_t Levels, typename Target>
 class PyramidViewBase
@@ -0,0 +1,162 @@
+/**
+ * ****************************************************************************
+ * Copyright (c) 2015, Robert Lukierski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * ****************************************************************************
+ * Shared, copy-on-write ownership of a managed buffer.
+ * ****************************************************************************
+ */
+#ifndef VISIONCORE_SHARED_BUFFER_HPP
+#define VISIONCORE_SHARED_BUFFER_HPP
+
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+
+#include <VisionCore/Platform.hpp>
+#include <VisionCore/Buffers/Buffer2D.hpp>
+#include <VisionCore/Buffers/Image2D.hpp>
+
+namespace vc
+{
+
+/**
+ * Reference counted owner of a Host/CUDA Managed buffer (Buffer2DManaged, Image2DManaged).
+ * 
+ * Copies share the allocation, so a frame can be handed to several consumers without copying.
+ * Reading goes through view() / operator-> (const, the usual view API). Writing goes through
+ * edit(), which first makes a private copy if the allocation is shared (copy-on-write):
+ * 
+ *   vc::Buffer2DShared<float> frame(640, 480);
+ *   fill(frame.edit());
+ *   recorder.push(frame); visualizer.push(frame);     // no copies
+ *   frame.edit()(0,0) = 1.0f;                         // copies now, consumers keep the old data
+ * 
+ * The reference count is atomic, a SharedBuffer object itself is not thread safe (like std::shared_ptr).
+ * Owners may be handed to and released on other threads, their accesses happen before the writes
+ * of an owner that finds itself unique.
+ * A view returned by edit() must not be kept across a copy of this owner, writes through it would
+ * be seen by the other owners.
+ */
+template<typename ManagedT>
+class SharedBuffer
+{
+public:
+    typedef ManagedT ManagedType;
+    typedef typename ManagedT::ViewT ViewT;
+    
+    inline SharedBuffer() { }
+    
+    inline SharedBuffer(std::size_t w, std::size_t h) : data(std::make_shared<ManagedT>(w, h)) { }
+    
+    /// Takes over an existing allocation, no copy.
+    inline explicit SharedBuffer(ManagedT&& owner) : data(std::make_shared<ManagedT>(std::move(owner))) { }
+    
+    SharedBuffer(const SharedBuffer<ManagedT>& other) = default;
+    SharedBuffer(SharedBuffer<ManagedT>&& other) = default;
+    SharedBuffer<ManagedT>& operator=(const SharedBuffer<ManagedT>& other) = default;
+    SharedBuffer<ManagedT>& operator=(SharedBuffer<ManagedT>&& other) = default;
+    
+    inline bool isValid() const { return data && data->isValid(); }
+    
+    /**
+     * True if no other owner shares the allocation, i.e. edit() won't copy. use_count() is a relaxed
+     * load, the fence pairs it with the release in the last other owner's decrement, so that owner's
+     * reads are done before anything written after this returns true.
+     */
+    inline bool unique() const 
+    { 
+        if(data.use_count() != 1) { return false; }
+        
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return true;
+    }
+    inline long useCount() const { return data.use_count(); }
+    
+    /// Read access, shared with the other owners. Invalid (empty) view for an empty owner.
+    inline const ViewT& view() const 
+    { 
+        static const ViewT empty;
+        return data ? data->view() : empty; 
+    }
+    inline operator const ViewT&() const { return view(); }
+    inline const ViewT* operator->() const { return &view(); }
+    
+    /**
+     * Write access, copies the contents first if they are shared.
+     */
+    inline ViewT& edit()
+    {
+        checkValid();
+        
+        if(!unique())
+        {
+            std::shared_ptr<ManagedT> copy = std::make_shared<ManagedT>(data->width(), data->height());
+            copy->copyFrom(data->view());
+            data = std::move(copy);
+        }
+        
+        return data->view();
+    }
+    
+    /**
+     * Write access without copying the contents, for a full overwrite: a fresh allocation if shared.
+     */
+    inline ViewT& overwrite()
+    {
+        checkValid();
+        
+        if(!unique())
+        {
+            data = std::make_shared<ManagedT>(data->width(), data->height());
+        }
+        
+        return data->view();
+    }
+    
+    inline void reset() { data.reset(); }
+    
+private:
+    inline void checkValid() const
+    {
+        if(!data) { throw std::runtime_error("Writing to an empty SharedBuffer"); }
+    }
+    
+    std::shared_ptr<ManagedT> data;
+};
+
+template<typename T, typename Target = TargetHost>
+using Buffer2DShared = SharedBuffer<Buffer2DManaged<T,Target>>;
+
+template<typename T, typename Target = TargetHost>
+using Image2DShared = SharedBuffer<Image2DManaged<T,Target>>;
+
+}
+
+#endif // VISIONCORE_SHARED_BUFFER_HPP
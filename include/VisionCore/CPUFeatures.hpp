@@ -0,0 +1,73 @@
+/**
+ * ****************************************************************************
+ * Copyright (c) 2017, Robert Lukierski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ****************************************************************************
+ * Runtime CPU feature detection for kernel dispatch.
+ * ****************************************************************************
+ */
+
+#ifndef VISIONCORE_CPU_FEATURES_HPP
+#define VISIONCORE_CPU_FEATURES_HPP
+
+namespace vc
+{
+
+/**
+ * Instruction set levels the hot CPU kernels are compiled for. Each level includes the ones below:
+ * SSE42 is SSSE3 + SSE4.1/4.2 + POPCNT, AVX2 adds AVX + FMA, AVX512 adds AVX-512 F/BW/DQ/VL.
+ * Generic is whatever the library was compiled for (SSE2 on x86-64, NEON on AArch64).
+ *
+ * The level is detected with cpuid on first use. The VISIONCORE_CPU_LEVEL environment variable
+ * (generic, sse4.2, avx2 or avx512) can lower it, e.g. to compare kernels or to chase a bug.
+ */
+enum class CPULevel
+{
+    Generic = 0,
+    SSE42,
+    AVX2,
+    AVX512
+};
+
+/// Best level supported by this CPU and OS, ignores any override.
+CPULevel detectCPULevel();
+
+/// Level the kernels dispatch on.
+CPULevel getCPULevel();
+
+/// Throws std::runtime_error if the CPU doesn't support the level.
+void setCPULevel(CPULevel level);
+
+bool isCPULevelAvailable(CPULevel level);
+
+const char* cpuLevelName(CPULevel level);
+
+}
+
+#endif // VISIONCORE_CPU_FEATURES_HPP
@@ -0,0 +1,180 @@
+/**
+ * ****************************************************************************
+ * Copyright (c) 2017, Robert Lukierski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ****************************************************************************
+ * Execution contexts - where and how CPU launches run.
+ * ****************************************************************************
+ */
+
+#ifndef VISIONCORE_EXECUTION_CONTEXT_HPP
+#define VISIONCORE_EXECUTION_CONTEXT_HPP
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace vc
+{
+
+class ThreadPool;
+    
+/**
+ * CPU execution backends. TBB is the default when available, otherwise the built-in thread pool.
+ * The initial choice can be overridden with the VISIONCORE_LAUNCH_BACKEND environment variable
+ * (serial, pool or tbb).
+ */
+enum class LaunchBackend
+{
+    Serial = 0,
+    ThreadPool,
+    TBB
+};
+
+LaunchBackend getLaunchBackend();
+/// Throws std::runtime_error if the backend was not compiled in.
+void setLaunchBackend(LaunchBackend lb);
+bool isLaunchBackendAvailable(LaunchBackend lb);
+
+/**
+ * A set of threads that launchParallelFor & co. run on. Wraps a tbb::task_arena or a private
+ * ThreadPool, limited to max_concurrency threads, optionally pinned to a set of CPUs and
+ * running at a given priority.
+ *
+ * Launches use the context that is current on the calling thread (see ExecutionContextScope),
+ * or the global backend if there is none. Worker threads of a context have it as current,
+ * so nested launches stay inside.
+ *
+ * Affinity and priority are best effort: they need Linux, with TBB also oneTBB. 
+ * Raising the priority usually needs privileges, failures are ignored.
+ *
+ * Asynchronous launches (launchAsync) submitted while the context is current hold on to it, 
+ * the destructor blocks until all of them have run. Do not destroy a context from one of its 
+ * own tasks.
+ */
+class ExecutionContext
+{
+public:
+    enum class Priority
+    {
+        Low = 0,
+        Normal,
+        High
+    };
+    
+    /**
+     * max_concurrency = 0 means the number of CPUs given in affinity, or the backend default.
+     * Empty affinity means no pinning.
+     * Throws std::runtime_error if the backend was not compiled in.
+     */
+    explicit ExecutionContext(std::size_t max_concurrency = 0, 
+                              const std::vector<int>& affinity = std::vector<int>(),
+                              Priority prio = Priority::Normal,
+                              LaunchBackend backend = getLaunchBackend());
+    ~ExecutionContext();
+    
+    ExecutionContext(const ExecutionContext&) = delete;
+    ExecutionContext(ExecutionContext&&) = delete;
+    ExecutionContext& operator=(const ExecutionContext&) = delete;
+    ExecutionContext& operator=(ExecutionContext&&) = delete;
+    
+    inline LaunchBackend backend() const { return lbackend; }
+    inline Priority priority() const { return prio; }
+    inline const std::vector<int>& affinity() const { return cpus; }
+    
+    /// Maximum number of threads working on a single launch.
+    std::size_t concurrency() const;
+    
+    /// Private pool (ThreadPool backend with concurrency > 1), nullptr otherwise.
+    inline ThreadPool* pool() const { return tpool.get(); }
+    
+    /**
+     * Runs fn on the calling thread with this context as current, inside the arena for TBB.
+     * Blocks until fn returns.
+     */
+    void execute(const std::function<void()>& fn);
+    
+    /// Context current on this thread, nullptr if none.
+    static ExecutionContext* current();
+    
+    /**
+     * Keeps ctx from being destroyed while an asynchronous launch is outstanding.
+     * nullptr (global backend) is allowed. Used by launchAsync.
+     */
+    class AsyncToken
+    {
+    public:
+        explicit AsyncToken(ExecutionContext* ctx);
+        ~AsyncToken();
+        
+        AsyncToken(const AsyncToken&) = delete;
+        AsyncToken& operator=(const AsyncToken&) = delete;
+        
+        inline ExecutionContext* context() const { return ctx; }
+    private:
+        ExecutionContext* ctx;
+    };
+    
+private:
+    friend class ExecutionContextScope;
+    
+    struct ArenaData;
+    struct AsyncData;
+    
+    void initThread();
+    
+    LaunchBackend                   lbackend;
+    Priority                        prio;
+    std::vector<int>                cpus;
+    std::unique_ptr<ThreadPool>     tpool;
+    std::unique_ptr<ArenaData>      arena;
+    std::unique_ptr<AsyncData>      async;
+};
+
+/**
+ * Makes a context current on this thread for the lifetime of the scope.
+ * nullptr means the global backend.
+ */
+class ExecutionContextScope
+{
+public:
+    explicit ExecutionContextScope(ExecutionContext* ctx);
+    explicit ExecutionContextScope(ExecutionContext& ctx) : ExecutionContextScope(&ctx) { }
+    ~ExecutionContextScope();
+    
+    ExecutionContextScope(const ExecutionContextScope&) = delete;
+    ExecutionContextScope& operator=(const ExecutionContextScope&) = delete;
+private:
+    ExecutionContext* previous;
+};
+
+}
+
+#endif // VISIONCORE_EXECUTION_CONTEXT_HPP
@@ -0,0 +1,104 @@
+/**
+ * ****************************************************************************
+ * Copyright (c) 2017, Robert Lukierski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * 
+ * ****************************************************************************
+ * Parallel, pitch aware host memory copies.
+ * ****************************************************************************
+ */
+
+#ifndef VISIONCORE_HOST_COPY_HPP
+#define VISIONCORE_HOST_COPY_HPP
+
+#include <cstddef>
+
+namespace vc
+{
+
+/**
+ * Cached: regular stores, the destination stays in cache.
+ * Streaming: non-temporal stores, for destinations that won't be re-read soon.
+ * Auto: streaming above HostCopySettings::streaming_threshold bytes.
+ */
+enum class CopyHint
+{
+    Auto = 0,
+    Cached,
+    Streaming
+};
+
+struct HostCopySettings
+{
+    std::size_t parallel_threshold;     // bytes, smaller copies run on the calling thread
+    std::size_t streaming_threshold;    // bytes, CopyHint::Auto streams at and above this
+    std::size_t chunk_bytes;            // approximate work per parallel chunk
+};
+
+HostCopySettings getHostCopySettings();
+void setHostCopySettings(const HostCopySettings& settings);
+
+/**
+ * Linear copy of count bytes, the ranges must not overlap.
+ */
+void hostCopy(void* dst, const void* src, std::size_t count, CopyHint hint = CopyHint::Auto);
+
+/**
+ * Copies height rows of width bytes between pitched regions, parallel across rows
+ * on the current ExecutionContext for large copies.
+ */
+void hostCopy2D(void* dst, std::size_t dpitch, const void* src, std::size_t spitch, 
+                std::size_t width, std::size_t height, CopyHint hint = CopyHint::Auto);
+
+/**
+ * Copies depth planes of height rows of width bytes, dplane/splane are the plane pitches.
+ */
+void hostCopy3D(void* dst, std::size_t dpitch, std::size_t dplane, 
+                const void* src, std::size_t spitch, std::size_t splane,
+                std::size_t width, std::size_t height, std::size_t depth, CopyHint hint = CopyHint::Auto);
+
+/**
+ * Parallel memset, split like the copies (contiguous chunks of rows / bytes). Besides being faster, 
+ * clearing fresh memory this way places its pages (first touch) near the threads that later run 
+ * row-parallel kernels over it, instead of all on the allocating thread's NUMA node.
+ */
+void hostMemset(void* dst, int value, std::size_t count);
+
+/**
+ * Fills height rows of width elements of value_bytes each with the element at value, in parallel.
+ */
+void hostFill2D(void* dst, std::size_t pitch, const void* value, std::size_t value_bytes, 
+                std::size_t width, std::size_t height);
+
+void hostFill3D(void* dst, std::size_t pitch, std::size_t plane_pitch, const void* value, std::size_t value_bytes, 
+                std::size_t width, std::size_t height, std::size_t depth);
+
+}
+
+#endif // VISIONCORE_HOST_COPY_HPP
@@ -0,0 +1,183 @@
+/**
+ * ****************************************************************************
+ * Copyright (c) 2017, Robert Lukierski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * 
+ * ****************************************************************************
+ * Host memory allocation with an optional recycling pool.
+ * ****************************************************************************
+ */
+
+#ifndef VISIONCORE_HOST_MEMORY_HPP
+#define VISIONCORE_HOST_MEMORY_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace vc
+{
+
+/**
+ * Allocates bytes of host memory aligned to alignment (a power of two), pinned with cudaMallocHost 
+ * in CUDA builds. Throws std::bad_alloc. Served from the pool when it is enabled, 
+ * mapped (see HostMapSettings) when large enough.
+ */
+void* hostAllocate(std::size_t bytes, std::size_t alignment);
+
+/**
+ * Releases memory from hostAllocate, to the pool if enabled and below its high-water mark.
+ */
+void hostDeallocate(void* ptr) noexcept;
+
+/// Usable size of a hostAllocate block (at least the requested size).
+std::size_t hostAllocationSize(const void* ptr);
+
+/**
+ * Default base alignment for TargetHost: the VISIONCORE_HOST_ALIGNMENT environment variable
+ * (bytes, a power of two, at least sizeof(void*), e.g. VISIONCORE_HOST_ALIGNMENT=4096) if set, 
+ * fallback otherwise or if the value is invalid.
+ */
+std::size_t hostDefaultAlignment(std::size_t fallback);
+
+enum class HugePages
+{
+    Off = 0,
+    Transparent,    // 2 MiB aligned mapping + madvise(MADV_HUGEPAGE)
+    Explicit        // MAP_HUGETLB (needs reserved huge pages), Transparent if that fails
+};
+
+/**
+ * Large host allocations straight from mmap instead of malloc/the pool.
+ * 
+ * Pages are committed on first touch, so untouched parts of a huge volume cost nothing, unless 
+ * lazy_commit is off (then they are cleared up front in parallel, after any NUMA placement). 
+ * Huge pages cut TLB misses for scattered access (e.g. trilinear SDF sampling). Clearing such an 
+ * allocation to zero (TargetHost::memset*, hostDiscard) hands the pages back to the OS with 
+ * MADV_DONTNEED, which is near-instant regardless of size.
+ * 
+ * Off by default (threshold 0), also set by the VISIONCORE_HOST_MMAP environment variable 
+ * (threshold in MB). POSIX only, in CUDA builds host memory stays pinned and this is ignored.
+ */
+struct HostMapSettings
+{
+    std::size_t     threshold;      // map allocations of at least this many bytes, 0 = never
+    HugePages       huge_pages;
+    bool            lazy_commit;
+};
+
+HostMapSettings getHostMapSettings();
+void setHostMapSettings(const HostMapSettings& settings);
+
+/// True if ptr points into a live mapped allocation.
+bool hostIsMapped(const void* ptr);
+
+/**
+ * Zeroes [ptr, ptr + bytes) by releasing whole pages of a mapped allocation (MADV_DONTNEED), 
+ * the unaligned ends are cleared with memset. Returns false, touching nothing, if the range isn't 
+ * fully inside a mapped allocation.
+ */
+bool hostDiscard(void* ptr, std::size_t bytes);
+
+enum class NumaPolicy
+{
+    Default = 0,    // first touch
+    Interleave,     // pages round robin over all nodes
+    Bind            // pages on HostNumaSettings::node
+};
+
+/**
+ * NUMA placement of new large host allocations, applied before any page is touched.
+ * Needs libnuma (VISIONCORE_HAVE_NUMA), no-op otherwise. Also set by the VISIONCORE_HOST_NUMA 
+ * environment variable ("interleave" or "bind:<node>").
+ * 
+ * With the default policy pages land on the node of the thread touching them first, so clear new 
+ * buffers with the parallel memset/fill (hostMemset) rather than from a single thread.
+ */
+struct HostNumaSettings
+{
+    NumaPolicy      policy;
+    int             node;
+    std::size_t     threshold;      // bytes, smaller allocations are left alone
+};
+
+HostNumaSettings getHostNumaSettings();
+void setHostNumaSettings(const HostNumaSettings& settings);
+
+bool hostNumaAvailable();
+std::size_t hostNumaNodes();
+
+/**
+ * Sets the placement of the whole pages of [ptr, ptr + bytes) faulted in from now on.
+ * Returns false if NUMA isn't available.
+ */
+bool hostNumaPlace(void* ptr, std::size_t bytes, NumaPolicy policy, int node = 0);
+
+struct HostMemoryPoolStats
+{
+    std::size_t     cached_bytes;           // bytes held by the pool (all threads)
+    std::size_t     cached_blocks;
+    std::size_t     peak_cached_bytes;
+    uint64_t        hits;                   // allocations served from the pool
+    uint64_t        misses;                 // allocations that went to the system
+    uint64_t        system_allocations;
+    uint64_t        system_frees;
+};
+
+/**
+ * Recycling pool behind hostAllocate (so behind TargetHost and every host Managed buffer).
+ * 
+ * Freed blocks are kept by size class (4 classes per power of two, so at most 25% slack) in a small
+ * per-thread cache first, then in a shared one. Blocks are reused for requests of the same class and
+ * at most the same alignment, so steady-state per-frame temporaries cause no system allocations.
+ * The total cached is bounded by the high-water mark, blocks beyond it go back to the system.
+ * 
+ * Disabled by default, enable with setEnabled or the VISIONCORE_HOST_POOL environment variable
+ * (high-water mark in MB, e.g. VISIONCORE_HOST_POOL=512).
+ */
+class HostMemoryPool
+{
+public:
+    static constexpr std::size_t DefaultHighWaterMark = std::size_t(256) << 20;
+    
+    static void setEnabled(bool enabled);
+    static bool isEnabled();
+    
+    static void setHighWaterMark(std::size_t bytes);
+    static std::size_t highWaterMark();
+    
+    /// Returns every cached block to the system, from the caches of all threads and the shared one.
+    static void trim();
+    
+    static HostMemoryPoolStats stats();
+    static void resetStats();
+};
+
+}
+
+#endif // VISIONCORE_HOST_MEMORY_HPP
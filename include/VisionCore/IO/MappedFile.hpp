@@ -0,0 +1,204 @@
+/**
+ * ****************************************************************************
+ * Copyright (c) 2017, Robert Lukierski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ****************************************************************************
+ * Memory mapped files exposed as host buffers.
+ * ****************************************************************************
+ */
+
+#ifndef VISIONCORE_IO_MAPPED_FILE_HPP
+#define VISIONCORE_IO_MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <limits>
+#include <string>
+#include <stdexcept>
+
+#include <VisionCore/Buffers/Buffer1D.hpp>
+#include <VisionCore/Buffers/Buffer2D.hpp>
+#include <VisionCore/Buffers/Buffer3D.hpp>
+#include <VisionCore/Buffers/Volume.hpp>
+
+namespace vc
+{
+
+namespace io
+{
+
+enum class MapMode
+{
+    ReadOnly = 0,   // shared with every other process mapping the file, writes fault
+    CopyOnWrite     // private, written pages are copied, the file never changes
+};
+
+/// madvise hints.
+enum class AccessHint
+{
+    Normal = 0,
+    Sequential,     // aggressive read-ahead, pages dropped soon after use
+    Random,         // no read-ahead
+    WillNeed        // start reading now
+};
+
+/**
+ * A whole file mapped into memory, with its contents exposed as TargetHost views without copying.
+ * 
+ * Opening is instant, pages are read on first access and stay in the page cache, shared with 
+ * other processes mapping the same file. Views are valid while the MappedFile is open.
+ * Offsets and pitches are in bytes, a zero pitch means packed rows / planes (as saveBufferAsBinary 
+ * writes them). Views outside of the file, or too large to address, throw std::out_of_range, 
+ * offsets not aligned for T throw std::invalid_argument. POSIX only, open throws std::runtime_error elsewhere.
+ */
+class MappedFile
+{
+public:
+    MappedFile();
+    MappedFile(const std::string& fn, MapMode mode = MapMode::ReadOnly, AccessHint hint = AccessHint::Normal);
+    ~MappedFile();
+    
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& mf);
+    MappedFile& operator=(MappedFile&& mf);
+    
+    /// Throws std::runtime_error if the file can't be opened or mapped.
+    void open(const std::string& fn, MapMode mode = MapMode::ReadOnly, AccessHint hint = AccessHint::Normal);
+    void close();
+    
+    inline bool isOpened() const { return memptr != nullptr; }
+    inline std::size_t size() const { return file_size; }
+    inline MapMode mode() const { return map_mode; }
+    inline void* data() const { return memptr; }
+    
+    /// Hint for [offset, offset + length), length 0 = to the end.
+    void advise(AccessHint hint, std::size_t offset = 0, std::size_t length = 0);
+    
+    template<typename T>
+    inline Buffer1DView<T,TargetHost> buffer1D(std::size_t offset, std::size_t count) const
+    {
+        return Buffer1DView<T,TargetHost>(at<T>(offset, product(count, sizeof(T))), count);
+    }
+    
+    template<typename T>
+    inline Buffer2DView<T,TargetHost> buffer2D(std::size_t offset, std::size_t w, std::size_t h, 
+                                               std::size_t pitch = 0) const
+    {
+        const std::size_t row = product(w, sizeof(T));
+        if(pitch == 0) { pitch = row; }
+        checkPitch<T>(pitch, row);
+        
+        return Buffer2DView<T,TargetHost>(at<T>(offset, extent(pitch, row, h)), w, h, pitch);
+    }
+    
+    template<typename T>
+    inline Buffer3DView<T,TargetHost> buffer3D(std::size_t offset, std::size_t w, std::size_t h, std::size_t d, 
+                                               std::size_t pitch = 0, std::size_t plane_pitch = 0) const
+    {
+        const std::size_t row = product(w, sizeof(T));
+        if(pitch == 0) { pitch = row; }
+        checkPitch<T>(pitch, row);
+        const std::size_t plane = product(pitch, h);
+        if(plane_pitch == 0) { plane_pitch = plane; }
+        checkPitch<T>(plane_pitch, plane);
+        
+        return Buffer3DView<T,TargetHost>(at<T>(offset, extent(plane_pitch, extent(pitch, row, h), d)), 
+                                          w, h, d, pitch, plane_pitch);
+    }
+    
+    template<typename T>
+    inline VolumeView<T,TargetHost> volume(std::size_t offset, std::size_t w, std::size_t h, std::size_t d, 
+                                           std::size_t pitch = 0, std::size_t plane_pitch = 0) const
+    {
+        const Buffer3DView<T,TargetHost> b = buffer3D<T>(offset, w, h, d, pitch, plane_pitch);
+        return VolumeView<T,TargetHost>(b.rawPtr(), w, h, d, b.pitch(), b.planePitch());
+    }
+    
+private:
+    /// a * b, sizes that overflow can't be inside of any file.
+    static inline std::size_t product(std::size_t a, std::size_t b)
+    {
+        if(a != 0 && b > std::numeric_limits<std::size_t>::max() / a)
+        {
+            throw std::out_of_range("View outside of the mapped file");
+        }
+        
+        return a * b;
+    }
+    
+    /// Bytes spanned by n items stride apart, the last one last bytes long.
+    static inline std::size_t extent(std::size_t stride, std::size_t last, std::size_t n)
+    {
+        if(n == 0) { return 0; }
+        
+        const std::size_t span = product(stride, n - 1);
+        if(last > std::numeric_limits<std::size_t>::max() - span)
+        {
+            throw std::out_of_range("View outside of the mapped file");
+        }
+        
+        return span + last;
+    }
+    
+    template<typename T>
+    static inline void checkPitch(std::size_t pitch, std::size_t minimum)
+    {
+        if(pitch < minimum || pitch % sizeof(T) != 0)
+        {
+            throw std::invalid_argument("Pitch too small or not a multiple of the element size");
+        }
+    }
+    
+    template<typename T>
+    inline void* at(std::size_t offset, std::size_t bytes) const
+    {
+        if(!isOpened() || offset > file_size || bytes > file_size - offset)
+        {
+            throw std::out_of_range("View outside of the mapped file");
+        }
+        
+        // the mapping is page aligned
+        if(offset % alignof(T) != 0)
+        {
+            throw std::invalid_argument("Offset not aligned for the element type");
+        }
+        
+        return static_cast<char*>(memptr) + offset;
+    }
+    
+    void*           memptr;
+    std::size_t     file_size;
+    MapMode         map_mode;
+};
+
+}
+
+}
+
+#endif // VISIONCORE_IO_MAPPED_FILE_HPP
@@ -0,0 +1,425 @@
+/**
+ * ****************************************************************************
+ * Copyright (c) 2017, Robert Lukierski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ****************************************************************************
+ * Lazy element-wise expressions over host buffers, evaluated in one pass.
+ * ****************************************************************************
+ */
+
+#ifndef VISIONCORE_IMAGE_BUFFER_EXPR_HPP
+#define VISIONCORE_IMAGE_BUFFER_EXPR_HPP
+
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+
+#include <VisionCore/Platform.hpp>
+#include <VisionCore/Buffers/Buffer2D.hpp>
+#include <VisionCore/Image/PixelConvert.hpp>
+#include <VisionCore/LaunchUtils.hpp>
+#include <VisionCore/Trace.hpp>
+
+/**
+ * Chaining rescaleBuffer, clampBuffer, thresholdBuffer, convertBuffer etc. costs a full
+ * read + write of the image per step and a temporary between the steps. Here the steps
+ * only build a tree of small value types and evaluate() runs the whole tree in a single
+ * parallel pass over the rows:
+ * 
+ *   using namespace vc::image::expr;
+ *   evaluate(clamp(scale(buf_in, a, b), 0.0f, 255.0f).cast<uint8_t>(), buf_out);
+ * 
+ * Operands are Buffer2DView<T,TargetHost> (or anything derived, e.g. Buffer2DManaged) and
+ * other expressions. Nodes hold views by value, so expressions can be stored and evaluated
+ * later, as long as the buffers outlive them. Values follow the usual C++ promotions, 
+ * uint8_t + uint8_t is int, uint8_t * float is float and so on.
+ * 
+ * Each node hands out a Row for a given y, a few pointers and parameters with operator[],
+ * so the inner loop of evaluate() is flat and the compiler is free to vectorize it.
+ * 
+ * @note Host only. Every output element depends only on the inputs at the same (x,y), 
+ * so the output may also be one of the inputs.
+ */
+
+namespace vc
+{
+
+namespace image
+{
+
+namespace expr
+{
+
+/**
+ * Tag for detection of the expression nodes.
+ */
+struct BufferExprTag { };
+
+template<typename E, typename T> class UnaryExpr;
+template<typename T> struct CastOp;
+template<typename T> struct ConvertOp;
+
+/**
+ * CRTP base of the nodes.
+ */
+template<typename Derived>
+class BufferExpr : public BufferExprTag
+{
+public:
+    inline const Derived& derived() const { return static_cast<const Derived&>(*this); }
+    
+    /// static_cast to T, saturation is up to the caller (clamp first).
+    template<typename T>
+    inline UnaryExpr<Derived, CastOp<T>> cast() const { return UnaryExpr<Derived, CastOp<T>>(derived(), CastOp<T>()); }
+    
+    /// Conversion as in convertPixel / convertBuffer.
+    template<typename T>
+    inline UnaryExpr<Derived, ConvertOp<T>> convert() const { return UnaryExpr<Derived, ConvertOp<T>>(derived(), ConvertOp<T>()); }
+};
+
+/**
+ * Leaf, reads a buffer.
+ */
+template<typename T>
+class TerminalExpr : public BufferExpr<TerminalExpr<T>>
+{
+public:
+    typedef T ValueType;
+    static constexpr std::size_t BytesPerPixel = sizeof(T);
+    
+    struct Row
+    {
+        const T* ptr;
+        
+        inline T operator[](std::size_t x) const { return ptr[x]; }
+    };
+    
+    inline explicit TerminalExpr(const Buffer2DView<T,TargetHost>& b) : buf(b) { }
+    
+    inline std::size_t width() const { return buf.width(); }
+    inline std::size_t height() const { return buf.height(); }
+    inline Row row(std::size_t y) const { return Row{buf.rowPtr(y)}; }
+    
+private:
+    Buffer2DView<T,TargetHost> buf;
+};
+
+/**
+ * Element-wise function of one expression.
+ */
+template<typename E, typename Op>
+class UnaryExpr : public BufferExpr<UnaryExpr<E,Op>>
+{
+public:
+    typedef typename std::decay<decltype(std::declval<Op>()(std::declval<typename E::ValueType>()))>::type ValueType;
+    static constexpr std::size_t BytesPerPixel = E::BytesPerPixel;
+    
+    struct Row
+    {
+        typename E::Row in;
+        Op op;
+        
+        inline ValueType operator[](std::size_t x) const { return op(in[x]); }
+    };
+    
+    inline UnaryExpr(const E& e, const Op& o) : expr(e), op(o) { }
+    
+    inline std::size_t width() const { return expr.width(); }
+    inline std::size_t height() const { return expr.height(); }
+    inline Row row(std::size_t y) const { return Row{expr.row(y), op}; }
+    
+private:
+    E expr;
+    Op op;
+};
+
+/**
+ * Element-wise function of two expressions, evaluated over the common area.
+ */
+template<typename E1, typename E2, typename Op>
+class BinaryExpr : public BufferExpr<BinaryExpr<E1,E2,Op>>
+{
+public:
+    typedef typename std::decay<decltype(std::declval<Op>()(std::declval<typename E1::ValueType>(), 
+                                                            std::declval<typename E2::ValueType>()))>::type ValueType;
+    static constexpr std::size_t BytesPerPixel = E1::BytesPerPixel + E2::BytesPerPixel;
+    
+    struct Row
+    {
+        typename E1::Row in1;
+        typename E2::Row in2;
+        Op op;
+        
+        inline ValueType operator[](std::size_t x) const { return op(in1[x], in2[x]); }
+    };
+    
+    inline BinaryExpr(const E1& e1, const E2& e2, const Op& o) : expr1(e1), expr2(e2), op(o) { }
+    
+    inline std::size_t width() const { return std::min(expr1.width(), expr2.width()); }
+    inline std::size_t height() const { return std::min(expr1.height(), expr2.height()); }
+    inline Row row(std::size_t y) const { return Row{expr1.row(y), expr2.row(y), op}; }
+    
+private:
+    E1 expr1;
+    E2 expr2;
+    Op op;
+};
+
+// ---------------------------------------------------------------------------
+// Operations
+// ---------------------------------------------------------------------------
+
+template<typename T> struct CastOp
+{
+    template<typename V> inline T operator()(const V& v) const { return static_cast<T>(v); }
+};
+
+template<typename T> struct ConvertOp
+{
+    template<typename V> inline T operator()(const V& v) const { return convertPixel<T,V>(v); }
+};
+
+template<typename S> struct ScaleOp
+{
+    S alpha, beta;
+    
+    template<typename V> inline auto operator()(const V& v) const -> decltype(v * alpha + beta) { return v * alpha + beta; }
+};
+
+template<typename S> struct ClampOp
+{
+    S lo, hi;
+    
+    template<typename V> inline typename std::common_type<V,S>::type operator()(const V& v) const
+    {
+        typedef typename std::common_type<V,S>::type RT;
+        return std::min<RT>(std::max<RT>(v, lo), hi);
+    }
+};
+
+template<typename S> struct ThresholdOp
+{
+    S thr, below, above;
+    
+    template<typename V> inline S operator()(const V& v) const { return v < thr ? below : above; }
+};
+
+struct AbsOp
+{
+    template<typename V> inline V operator()(const V& v) const { return v < V(0) ? V(-v) : v; }
+};
+
+struct AddOp { template<typename A, typename B> inline auto operator()(const A& a, const B& b) const -> decltype(a + b) { return a + b; } };
+struct SubOp { template<typename A, typename B> inline auto operator()(const A& a, const B& b) const -> decltype(a - b) { return a - b; } };
+struct MulOp { template<typename A, typename B> inline auto operator()(const A& a, const B& b) const -> decltype(a * b) { return a * b; } };
+struct DivOp { template<typename A, typename B> inline auto operator()(const A& a, const B& b) const -> decltype(a / b) { return a / b; } };
+
+struct MinOp
+{
+    template<typename A, typename B> inline typename std::common_type<A,B>::type operator()(const A& a, const B& b) const 
+    { 
+        return std::min<typename std::common_type<A,B>::type>(a, b);
+    }
+};
+
+struct MaxOp
+{
+    template<typename A, typename B> inline typename std::common_type<A,B>::type operator()(const A& a, const B& b) const 
+    { 
+        return std::max<typename std::common_type<A,B>::type>(a, b);
+    }
+};
+
+/**
+ * Binary operation with a constant on the right (or left) side.
+ */
+template<typename Op, typename S> struct BindRightOp
+{
+    Op op;
+    S s;
+    
+    template<typename V> inline auto operator()(const V& v) const -> decltype(op(v, s)) { return op(v, s); }
+};
+
+template<typename Op, typename S> struct BindLeftOp
+{
+    Op op;
+    S s;
+    
+    template<typename V> inline auto operator()(const V& v) const -> decltype(op(s, v)) { return op(s, v); }
+};
+
+// ---------------------------------------------------------------------------
+// Operands
+// ---------------------------------------------------------------------------
+
+/**
+ * Maps an operand (expression or host buffer) to its node type. No Type for anything else,
+ * which keeps the functions below out of overload resolution for scalars.
+ */
+template<typename X, typename Enable = void>
+struct Operand { };
+
+template<typename X>
+struct Operand<X, typename std::enable_if<std::is_base_of<BufferExprTag, X>::value>::type>
+{
+    typedef X Type;
+    static inline const X& get(const X& x) { return x; }
+};
+
+template<typename X>
+struct Operand<X, typename std::enable_if<std::is_base_of<Buffer2DView<typename X::ValueType, TargetHost>, X>::value>::type>
+{
+    typedef TerminalExpr<typename X::ValueType> Type;
+    static inline Type get(const X& x) { return Type(x); }
+};
+
+template<typename X>
+struct IsExpr : std::integral_constant<bool, std::is_base_of<BufferExprTag, X>::value> { };
+
+/**
+ * Turns a buffer into an expression, needed only to use the operators on plain buffers.
+ */
+template<typename T>
+inline TerminalExpr<T> lazy(const Buffer2DView<T,TargetHost>& buf) { return TerminalExpr<T>(buf); }
+
+// ---------------------------------------------------------------------------
+// Functions, accept buffers and expressions
+// ---------------------------------------------------------------------------
+
+/// v * alpha + beta
+template<typename X, typename S>
+inline UnaryExpr<typename Operand<X>::Type, ScaleOp<S>> scale(const X& x, S alpha, S beta = S(0))
+{
+    return UnaryExpr<typename Operand<X>::Type, ScaleOp<S>>(Operand<X>::get(x), ScaleOp<S>{alpha, beta});
+}
+
+/// min(max(v, lo), hi)
+template<typename X, typename S>
+inline UnaryExpr<typename Operand<X>::Type, ClampOp<S>> clamp(const X& x, S lo, S hi)
+{
+    return UnaryExpr<typename Operand<X>::Type, ClampOp<S>>(Operand<X>::get(x), ClampOp<S>{lo, hi});
+}
+
+/// v < thr ? below : above
+template<typename X, typename S>
+inline UnaryExpr<typename Operand<X>::Type, ThresholdOp<S>> threshold(const X& x, S thr, S below, S above)
+{
+    return UnaryExpr<typename Operand<X>::Type, ThresholdOp<S>>(Operand<X>::get(x), ThresholdOp<S>{thr, below, above});
+}
+
+template<typename X>
+inline UnaryExpr<typename Operand<X>::Type, AbsOp> abs(const X& x)
+{
+    return UnaryExpr<typename Operand<X>::Type, AbsOp>(Operand<X>::get(x), AbsOp());
+}
+
+template<typename X1, typename X2>
+inline BinaryExpr<typename Operand<X1>::Type, typename Operand<X2>::Type, MinOp> min(const X1& x1, const X2& x2)
+{
+    return BinaryExpr<typename Operand<X1>::Type, typename Operand<X2>::Type, MinOp>(Operand<X1>::get(x1), Operand<X2>::get(x2), MinOp());
+}
+
+template<typename X1, typename X2>
+inline BinaryExpr<typename Operand<X1>::Type, typename Operand<X2>::Type, MaxOp> max(const X1& x1, const X2& x2)
+{
+    return BinaryExpr<typename Operand<X1>::Type, typename Operand<X2>::Type, MaxOp>(Operand<X1>::get(x1), Operand<X2>::get(x2), MaxOp());
+}
+
+// ---------------------------------------------------------------------------
+// Arithmetic operators, at least one side has to be an expression (see lazy)
+// ---------------------------------------------------------------------------
+
+#define VISIONCORE_BUFFER_EXPR_OPERATOR(OPERATOR, OP)                                                              \
+template<typename X1, typename X2>                                                                                 \
+inline typename std::enable_if<IsExpr<X1>::value || IsExpr<X2>::value,                                             \
+    BinaryExpr<typename Operand<X1>::Type, typename Operand<X2>::Type, OP>>::type                                  \
+OPERATOR(const X1& x1, const X2& x2)                                                                               \
+{                                                                                                                  \
+    return BinaryExpr<typename Operand<X1>::Type, typename Operand<X2>::Type, OP>(Operand<X1>::get(x1),           \
+                                                                                   Operand<X2>::get(x2), OP());   \
+}                                                                                                                  \
+template<typename X, typename S>                                                                                   \
+inline typename std::enable_if<IsExpr<X>::value && std::is_arithmetic<S>::value,                                  \
+    UnaryExpr<X, BindRightOp<OP,S>>>::type                                                                         \
+OPERATOR(const X& x, S s)                                                                                          \
+{                                                                                                                  \
+    return UnaryExpr<X, BindRightOp<OP,S>>(x, BindRightOp<OP,S>{OP(), s});                                         \
+}                                                                                                                  \
+template<typename S, typename X>                                                                                   \
+inline typename std::enable_if<IsExpr<X>::value && std::is_arithmetic<S>::value,                                  \
+    UnaryExpr<X, BindLeftOp<OP,S>>>::type                                                                          \
+OPERATOR(S s, const X& x)                                                                                          \
+{                                                                                                                  \
+    return UnaryExpr<X, BindLeftOp<OP,S>>(x, BindLeftOp<OP,S>{OP(), s});                                           \
+}
+
+VISIONCORE_BUFFER_EXPR_OPERATOR(operator+, AddOp)
+VISIONCORE_BUFFER_EXPR_OPERATOR(operator-, SubOp)
+VISIONCORE_BUFFER_EXPR_OPERATOR(operator*, MulOp)
+VISIONCORE_BUFFER_EXPR_OPERATOR(operator/, DivOp)
+
+#undef VISIONCORE_BUFFER_EXPR_OPERATOR
+
+// ---------------------------------------------------------------------------
+// Evaluation
+// ---------------------------------------------------------------------------
+
+/**
+ * Evaluates the expression into buf_out, over the area common to the output and all the inputs.
+ * Values are converted to T as with an assignment.
+ */
+template<typename X, typename T>
+inline void evaluate(const X& x, Buffer2DView<T,TargetHost>& buf_out)
+{
+    typedef typename Operand<X>::Type ExprT;
+    const ExprT e = Operand<X>::get(x);
+    
+    const std::size_t width = std::min(e.width(), buf_out.width());
+    const std::size_t height = std::min(e.height(), buf_out.height());
+    VISIONCORE_TRACE_SCOPE_2D("evaluate", width, height, width * height * (ExprT::BytesPerPixel + sizeof(T)));
+    vc::launchParallelForRows(width, height, [&](std::size_t y, std::size_t x_begin, std::size_t x_end)
+    {
+        const typename ExprT::Row row = e.row(y);
+        T* row_out = buf_out.rowPtr(y);
+        
+        for(std::size_t ix = x_begin ; ix < x_end ; ++ix)
+        {
+            row_out[ix] = row[ix];
+        }
+    });
+}
+
+}
+
+}
+
+}
+
+#endif // VISIONCORE_IMAGE_BUFFER_EXPR_HPP
@@ -36,12 +36,14 @@
 #ifndef VISIONCORE_IMAGE_BUFFEROPS_HPP
 #define VISIONCORE_IMAGE_BUFFEROPS_HPP
 
+#include <algorithm>
 #include <type_traits>
 
 #include <VisionCore/Buffers/Buffer1D.hpp>
 #include <VisionCore/Buffers/Buffer2D.hpp>
 #include <VisionCore/Buffers/Image2D.hpp>
 #include <VisionCore/Buffers/ImagePyramid.hpp>
+#include <VisionCore/LaunchAsync.hpp>
 
 /**
  * @note No dimension checking for now, also Thrust is non-pitched.
@@ -137,6 +139,40 @@ T calcBufferMax(const Buffer2DView<T, Target>& buf_in);
 template<typename T, typename Target>
 T calcBufferMean(const Buffer2DView<T, Target>& buf_in);
 
+/**
+ * Statistics of a 2D buffer, one pass.
+ * For an empty (or all invalid) buffer count is 0 and min / max stay at the limits of T.
+ */
+template<typename T>
+struct BufferStats
+{
+    T               min;
+    T               max;
+    double          sum;
+    double          sum_sq;
+    std::size_t     count;      // elements that took part
+    
+    inline double mean() const { return count > 0 ? sum / double(count) : 0.0; }
+    
+    /// Population variance.
+    inline double variance() const 
+    { 
+        return count > 0 ? std::max(sum_sq / double(count) - mean() * mean(), 0.0) : 0.0;
+    }
+};
+
+/**
+ * Min, max, sum, sum of squares and count in a single parallel read of the buffer.
+ */
+template<typename T, typename Target>
+BufferStats<T> calcBufferStats(const Buffer2DView<T, Target>& buf_in);
+
+/**
+ * As above, skipping elements equal to invalid_value and non-finite ones (floating point).
+ */
+template<typename T, typename Target>
+BufferStats<T> calcBufferStats(const Buffer2DView<T, Target>& buf_in, T invalid_value);
+
 /**
  * Downsample by half.
  */
@@ -294,6 +330,122 @@ T bufferSum(const Buffer1DView<T, Target>& buf_in, const T& initial, unsigned in
 template<typename T, typename Target>
 T bufferSum(const Buffer2DView<T, Target>& buf_in, const T& initial, unsigned int tpb = 32);
 
+/**
+ * Asynchronous overloads, see AsyncLaunch. 
+ * They run the synchronous versions above once the dependencies are done.
+ */
+template<typename T1, typename T2, typename Target>
+static inline LaunchEvent rescaleBuffer(const AsyncLaunch& al, const Buffer2DView<T1, Target>& buf_in, const Buffer2DView<T2, Target>& buf_out, 
+                                        float alpha, float beta = 0.0f, float clamp_min = 0.0f, float clamp_max = 1.0f)
+{
+    return launchAsync([=]()
+    {
+        Buffer2DView<T2, Target> out(buf_out);
+        rescaleBuffer(buf_in, out, alpha, beta, clamp_min, clamp_max);
+    }, al.deps);
+}
+
+template<typename T, typename Target>
+static inline LaunchEvent normalizeBufferInplace(const AsyncLaunch& al, const Buffer2DView<T, Target>& buf_in)
+{
+    return launchAsync([=]()
+    {
+        Buffer2DView<T, Target> io(buf_in);
+        normalizeBufferInplace(io);
+    }, al.deps);
+}
+
+template<typename T, typename Target>
+static inline LaunchEvent clampBuffer(const AsyncLaunch& al, const Buffer2DView<T, Target>& buf_io, T a, T b)
+{
+    return launchAsync([=]()
+    {
+        Buffer2DView<T, Target> io(buf_io);
+        clampBuffer(io, a, b);
+    }, al.deps);
+}
+
+template<typename T, typename Target>
+static inline LaunchFuture<T> calcBufferMin(const AsyncLaunch& al, const Buffer2DView<T, Target>& buf_in)
+{
+    return launchAsync([=]() { return calcBufferMin(buf_in); }, al.deps);
+}
+
+template<typename T, typename Target>
+static inline LaunchFuture<T> calcBufferMax(const AsyncLaunch& al, const Buffer2DView<T, Target>& buf_in)
+{
+    return launchAsync([=]() { return calcBufferMax(buf_in); }, al.deps);
+}
+
+template<typename T, typename Target>
+static inline LaunchFuture<T> calcBufferMean(const AsyncLaunch& al, const Buffer2DView<T, Target>& buf_in)
+{
+    return launchAsync([=]() { return calcBufferMean(buf_in); }, al.deps);
+}
+
+template<typename T, typename Target>
+static inline LaunchFuture<BufferStats<T>> calcBufferStats(const AsyncLaunch& al, const Buffer2DView<T, Target>& buf_in)
+{
+    return launchAsync([=]() { return calcBufferStats(buf_in); }, al.deps);
+}
+
+template<typename T, typename Target>
+static inline LaunchEvent downsampleHalf(const AsyncLaunch& al, const Buffer2DView<T, Target>& buf_in, const Buffer2DView<T, Target>& buf_out)
+{
+    return launchAsync([=]()
+    {
+        Buffer2DView<T, Target> out(buf_out);
+        downsampleHalf(buf_in, out);
+    }, al.deps);
+}
+
+template<typename T, typename Target>
+static inline LaunchEvent downsampleHalfNoInvalid(const AsyncLaunch& al, const Buffer2DView<T, Target>& buf_in, const Buffer2DView<T, Target>& buf_out)
+{
+    return launchAsync([=]()
+    {
+        Buffer2DView<T, Target> out(buf_out);
+        downsampleHalfNoInvalid(buf_in, out);
+    }, al.deps);
+}
+
+template<typename T, std::size_t Levels, typename Target>
+static inline LaunchEvent fillPyramidBilinear(const AsyncLaunch& al, const ImagePyramidView<T,Levels,Target>& pyr)
+{
+    return launchAsync([=]()
+    {
+        ImagePyramidView<T,Levels,Target> io(pyr);
+        fillPyramidBilinear(io);
+    }, al.deps);
+}
+
+template<typename T, typename Target>
+static inline LaunchEvent fillBuffer(const AsyncLaunch& al, const Buffer2DView<T, Target>& buf_in, const typename type_traits<T>::ChannelType& v)
+{
+    return launchAsync([=]()
+    {
+        Buffer2DView<T, Target> io(buf_in);
+        fillBuffer(io, v);
+    }, al.deps);
+}
+
+template<typename T, typename Target>
+static inline LaunchEvent thresholdBuffer(const AsyncLaunch& al, const Buffer2DView<T, Target>& buf_in, const Buffer2DView<T, Target>& buf_out, 
+                                          T thr, T val_below, T val_above)
+{
+    return launchAsync([=]()
+    {
+        Buffer2DView<T, Target> out(buf_out);
+        thresholdBuffer(buf_in, out, thr, val_below, val_above);
+    }, al.deps);
+}
+
+template<typename T, typename Target>
+static inline LaunchFuture<T> bufferSum(const AsyncLaunch& al, const Buffer2DView<T, Target>& buf_in, const T& initial, unsigned int tpb = 32)
+{
+    return launchAsync([=]() { return bufferSum(buf_in, initial, tpb); }, al.deps);
+}
+
 }
 
 }
@@ -134,7 +134,7 @@ struct Blob
 /**
  * Map mapping blob label with blob structure.
  */
-template <typename T> using BlobMapT = std::map<BlobID,Blob<T>,std::less<BlobID>,Eigen::aligned_allocator<std::pair<BlobID,Blob<T>>>>;
+template <typename T> using BlobMapT = std::map<BlobID,Blob<T>,std::less<BlobID>,Eigen::aligned_allocator<std::pair<const BlobID,Blob<T>>>>;
 
 typedef Buffer2DView<BlobID,TargetHost> BlobImageT;
 typedef Buffer2DManaged<BlobID,TargetHost> BlobManagedImageT;
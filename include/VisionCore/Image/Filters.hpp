@@ -39,6 +39,8 @@
 #include <VisionCore/Platform.hpp>
 
 #include <VisionCore/Buffers/Buffer2D.hpp>
+#include <VisionCore/Buffers/BorderMode.hpp>
+#include <VisionCore/LaunchAsync.hpp>
 
 namespace vc
 {
@@ -46,6 +48,10 @@ namespace vc
 namespace image
 {
     
+/**
+ * Without minval every tap counts, a NaN input makes every output whose window covers it NaN.
+ * With minval only taps >= minval count (NaN never does), outputs at pixels below minval are NaN.
+ */
 template<typename T, typename Target>
 void bilateral(const Buffer2DView<T,Target>& img_in, Buffer2DView<T,Target>& img_out, 
                const T& gs, const T& gr, std::size_t dim = 3);
@@ -54,6 +60,42 @@ template<typename T, typename Target>
 void bilateral(const Buffer2DView<T,Target>& img_in, Buffer2DView<T,Target>& img_out, 
                const T& gs, const T& gr, const T& minval, std::size_t dim = 3);
 
+/**
+ * Host overloads with a border policy (the ones above clamp), border_value is read 
+ * outside of the image for BorderMode::Constant.
+ */
+template<typename T>
+void bilateral(const Buffer2DView<T,TargetHost>& img_in, Buffer2DView<T,TargetHost>& img_out, 
+               const T& gs, const T& gr, std::size_t dim, BorderMode border, const T& border_value = T(0));
+
+template<typename T>
+void bilateral(const Buffer2DView<T,TargetHost>& img_in, Buffer2DView<T,TargetHost>& img_out, 
+               const T& gs, const T& gr, const T& minval, std::size_t dim, BorderMode border, const T& border_value = T(0));
+
+/**
+ * Asynchronous overloads, see AsyncLaunch.
+ */
+template<typename T, typename Target>
+static inline LaunchEvent bilateral(const AsyncLaunch& al, const Buffer2DView<T,Target>& img_in, const Buffer2DView<T,Target>& img_out, 
+                                    const T& gs, const T& gr, std::size_t dim = 3)
+{
+    return launchAsync([=]()
+    {
+        Buffer2DView<T,Target> out(img_out);
+        bilateral(img_in, out, gs, gr, dim);
+    }, al.deps);
+}
+
+template<typename T, typename Target>
+static inline LaunchEvent bilateral(const AsyncLaunch& al, const Buffer2DView<T,Target>& img_in, const Buffer2DView<T,Target>& img_out, 
+                                    const T& gs, const T& gr, const T& minval, std::size_t dim = 3)
+{
+    return launchAsync([=]()
+    {
+        Buffer2DView<T,Target> out(img_out);
+        bilateral(img_in, out, gs, gr, minval, dim);
+    }, al.deps);
+}
 }
     
 }
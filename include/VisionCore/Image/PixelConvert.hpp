@@ -39,6 +39,7 @@
 #include <VisionCore/Platform.hpp>
 
 #include <VisionCore/Buffers/Buffer2D.hpp>
+#include <VisionCore/LaunchAsync.hpp>
 
 namespace vc
 {
@@ -131,12 +132,42 @@ template<> EIGEN_DEVICE_FUNC inline float3 convertPixel(Eigen::Vector4f p) { ret
 template<> EIGEN_DEVICE_FUNC inline float4 convertPixel(Eigen::Vector4f p) { return make_float4(p(0), p(1), p(2), p(3)); }
 template<> EIGEN_DEVICE_FUNC inline Eigen::Vector3f convertPixel(Eigen::Vector4f p) { return Eigen::Vector3f(p(0), p(1), p(2)); }
 
+/**
+ * How single precision channels are rounded when written to 8 bit ones.
+ * Out of range values and NaNs always saturate (NaN goes to 0).
+ */
+enum class ConvertRounding
+{
+    Truncate,   ///< toward zero, same as convertPixel for in-range values
+    Nearest     ///< to nearest, halves rounded up
+};
+
 /**
  * Convert 2D buffer between element types.
  */
 template<typename T_IN, typename T_OUT, typename Target>
 void convertBuffer(const Buffer2DView<T_IN, Target>& buf_in, Buffer2DView<T_OUT, Target>& buf_out);
 
+/**
+ * Convert 2D buffer between element types with an explicit rounding policy (CPU only).
+ * Sources of double precision keep the plain convertPixel behaviour.
+ */
+template<typename T_IN, typename T_OUT>
+void convertBuffer(const Buffer2DView<T_IN, TargetHost>& buf_in, Buffer2DView<T_OUT, TargetHost>& buf_out,
+                   ConvertRounding rounding);
+
+/**
+ * Asynchronous convertBuffer, see AsyncLaunch.
+ */
+template<typename T_IN, typename T_OUT, typename Target>
+static inline LaunchEvent convertBuffer(const AsyncLaunch& al, const Buffer2DView<T_IN, Target>& buf_in, const Buffer2DView<T_OUT, Target>& buf_out)
+{
+    return launchAsync([=]()
+    {
+        Buffer2DView<T_OUT, Target> out(buf_out);
+        convertBuffer(buf_in, out);
+    }, al.deps);
+}
 }
 
 }
@@ -0,0 +1,240 @@
+/**
+ * ****************************************************************************
+ * Copyright (c) 2017, Robert Lukierski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ****************************************************************************
+ * Asynchronous CPU launches - events, futures and dependencies.
+ * ****************************************************************************
+ */
+
+#ifndef VISIONCORE_LAUNCH_ASYNC_HPP
+#define VISIONCORE_LAUNCH_ASYNC_HPP
+
+#include <cstddef>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <VisionCore/ExecutionContext.hpp>
+
+namespace vc
+{
+
+class LaunchEvent;
+
+namespace detail
+{
+    /**
+     * Completion state shared between the task and its events.
+     */
+    class AsyncState
+    {
+    public:
+        AsyncState() : done(false) { }
+        virtual ~AsyncState() { }
+        
+        /// Marks as done, wakes up waiters and runs the continuations.
+        void complete(std::exception_ptr error = std::exception_ptr());
+        /// Runs fn on completion, or right away if already done.
+        void onComplete(std::function<void()> fn);
+        
+        void wait() const;
+        bool ready() const;
+        std::exception_ptr error() const;
+        
+    private:
+        mutable std::mutex                      mutex;
+        mutable std::condition_variable         cv;
+        bool                                    done;
+        std::exception_ptr                      err;
+        std::vector<std::function<void()>>      continuations;
+    };
+    
+    template<typename T>
+    class AsyncValueState : public AsyncState
+    {
+    public:
+        T value;
+    };
+    
+    /**
+     * Submits task once all deps completed, task runs with the current ExecutionContext as current
+     * and the context is kept alive until then. If one of the deps failed, the task is skipped 
+     * and st completes with the same exception.
+     */
+    void submitWhenReady(const std::vector<LaunchEvent>& deps, std::function<void()> task, 
+                         const std::shared_ptr<AsyncState>& st);
+}
+
+/**
+ * Completion event of an asynchronous launch, cheap to copy. 
+ * A default constructed event is invalid and always ready.
+ */
+class LaunchEvent
+{
+public:
+    LaunchEvent() { }
+    explicit LaunchEvent(const std::shared_ptr<detail::AsyncState>& st) : state(st) { }
+    
+    inline bool valid() const { return state != nullptr; }
+    inline bool ready() const { return !state || state->ready(); }
+    
+    /// Blocks until done, rethrows the exception thrown by the task.
+    inline void wait() const 
+    { 
+        if(!state) { return; }
+        
+        state->wait();
+        if(state->error()) { std::rethrow_exception(state->error()); }
+    }
+    
+    /// Launches fn asynchronously once this event is done.
+    template<typename Function>
+    auto then(Function fn) const;
+    
+protected:
+    friend void detail::submitWhenReady(const std::vector<LaunchEvent>&, std::function<void()>, 
+                                        const std::shared_ptr<detail::AsyncState>&);
+    
+    std::shared_ptr<detail::AsyncState> state;
+};
+
+/**
+ * Event with a value.
+ */
+template<typename T>
+class LaunchFuture : public LaunchEvent
+{
+public:
+    LaunchFuture() { }
+    explicit LaunchFuture(const std::shared_ptr<detail::AsyncValueState<T>>& st) : LaunchEvent(st) { }
+    
+    /// Waits and returns the value, rethrows the exception thrown by the task.
+    inline const T& get() const
+    {
+        wait();
+        return static_cast<const detail::AsyncValueState<T>*>(state.get())->value;
+    }
+};
+
+/**
+ * Selects the asynchronous overload of an operation, e.g. 
+ * bilateral(AsyncLaunch({ev}), img_in, img_out, gs, gr) runs after ev and returns a LaunchEvent.
+ * 
+ * @note Only views are captured, the buffers must outlive the returned event.
+ */
+struct AsyncLaunch
+{
+    AsyncLaunch() { }
+    AsyncLaunch(std::initializer_list<LaunchEvent> d) : deps(d) { }
+    explicit AsyncLaunch(const std::vector<LaunchEvent>& d) : deps(d) { }
+    
+    std::vector<LaunchEvent> deps;
+};
+
+namespace detail
+{
+    template<typename RT>
+    struct AsyncTraits
+    {
+        typedef AsyncValueState<RT> StateT;
+        typedef LaunchFuture<RT> FutureT;
+        
+        template<typename Function>
+        static inline void run(Function& fn, StateT& st) { st.value = fn(); }
+    };
+    
+    template<>
+    struct AsyncTraits<void>
+    {
+        typedef AsyncState StateT;
+        typedef LaunchEvent FutureT;
+        
+        template<typename Function>
+        static inline void run(Function& fn, StateT&) { fn(); }
+    };
+}
+
+/**
+ * Runs fn on a worker thread once all deps are done. Returns LaunchEvent for void functions,
+ * LaunchFuture<T> otherwise. 
+ * 
+ * Tasks go to the pool of the current ExecutionContext, or the global ThreadPool. Parallel launches 
+ * inside fn use the ExecutionContext current at submission. That context waits for the task in its 
+ * destructor, so it can be destroyed while launches are outstanding.
+ */
+template<typename Function>
+static inline typename detail::AsyncTraits<decltype(std::declval<Function&>()())>::FutureT 
+launchAsync(Function fn, const std::vector<LaunchEvent>& deps = std::vector<LaunchEvent>())
+{
+    typedef detail::AsyncTraits<decltype(std::declval<Function&>()())> TraitsT;
+    
+    std::shared_ptr<typename TraitsT::StateT> st = std::make_shared<typename TraitsT::StateT>();
+    
+    // runs with the ExecutionContext current here, see submitWhenReady
+    detail::submitWhenReady(deps, [st, fn]() mutable
+    {
+        try
+        {
+            TraitsT::run(fn, *st);
+        }
+        catch(...)
+        {
+            st->complete(std::current_exception());
+            return;
+        }
+        
+        st->complete();
+    }, st);
+    
+    return typename TraitsT::FutureT(st);
+}
+
+template<typename Function>
+auto LaunchEvent::then(Function fn) const
+{
+    return launchAsync(fn, std::vector<LaunchEvent>(1, *this));
+}
+
+/**
+ * Event done when all deps are done.
+ */
+static inline LaunchEvent whenAll(const std::vector<LaunchEvent>& deps)
+{
+    return launchAsync([](){ }, deps);
+}
+
+}
+
+#endif // VISIONCORE_LAUNCH_ASYNC_HPP
@@ -36,14 +36,19 @@
 #ifndef VISIONCORE_LAUNCH_UTILS_HPP
 #define VISIONCORE_LAUNCH_UTILS_HPP
 
+#include <algorithm>
+
 #include <VisionCore/Platform.hpp>
 #include <VisionCore/Buffers/Buffer1D.hpp>
 #include <VisionCore/Buffers/Buffer2D.hpp>
 #include <VisionCore/Buffers/Buffer3D.hpp>
+#include <VisionCore/ExecutionContext.hpp>
+#include <VisionCore/LaunchAsync.hpp>
+#include <VisionCore/ThreadPool.hpp>
+#include <VisionCore/Trace.hpp>
 
 #ifdef VISIONCORE_HAVE_TBB
 #include <tbb/blocked_range.h>
-#include <tbb/blocked_range2d.h>
 #include <tbb/parallel_for.h>
 #include <tbb/parallel_reduce.h>
 #endif // VISIONCORE_HAVE_TBB
@@ -81,6 +86,24 @@ namespace detail
     }
 }
 
+/// Let the launcher pick the grain (rows per band).
+static constexpr std::size_t LaunchGrainAuto = 0;
+/// Minimum number of elements a row band should carry when the grain is automatic.
+static constexpr std::size_t LaunchGrainMinElements = 4096;
+/// Default tile size for launchParallelForTiles.
+static constexpr std::size_t LaunchTileX = 256;
+static constexpr std::size_t LaunchTileY = 16;
+
+namespace detail
+{
+    inline std::size_t calculateGrainRows(std::size_t dimx, std::size_t grain_rows)
+    {
+        if(grain_rows != LaunchGrainAuto) { return grain_rows; }
+        
+        return std::max<std::size_t>(1, LaunchGrainMinElements / std::max<std::size_t>(dimx, 1));
+    }
+}
+
 template<typename T>
 inline void InitDimFromBuffer(dim3& blockDim, dim3& gridDim, const Buffer1DView<T,TargetDeviceCUDA>& image, int blockx = 32)
 {
@@ -156,31 +179,198 @@ inline void InitDimFromDimensions2DOver(dim3& blockDim, dim3& gridDim, int dimx,
                     detail::calculateGridDimOver(dimy, blockDim.y), 1);
 }
 
-/// TBB!
+namespace detail
+{
+    /**
+     * Runs body(begin, end) over sub-ranges of [begin, end) of at least grain items,
+     * on the current ExecutionContext or the global backend.
+     */
+    template<typename BodyFunction>
+    static inline void launchRange(std::size_t begin, std::size_t end, std::size_t grain, BodyFunction kernel)
+    {
+        if(end <= begin) { return; }
+        
+        grain = std::max<std::size_t>(grain, 1);
+        
+#ifdef VISIONCORE_HAVE_TRACE
+        // one event per chunk, named after the operation that launched it
+        const char* trace_name = trace::currentScope();
+        auto body = [&](std::size_t b, std::size_t e)
+        {
+            trace::Scope scope(trace_name, "kernel", e - b);
+            kernel(b, e);
+        };
+#else // VISIONCORE_HAVE_TRACE
+        BodyFunction& body = kernel;
+#endif // VISIONCORE_HAVE_TRACE
+        
+        ExecutionContext* ctx = ExecutionContext::current();
+        
+        switch(ctx != nullptr ? ctx->backend() : getLaunchBackend())
+        {
 #ifdef VISIONCORE_HAVE_TBB
+            case LaunchBackend::TBB:
+            {
+                auto run = [&]()
+                {
+                    tbb::parallel_for(tbb::blocked_range<std::size_t>(begin, end, grain), [&](const tbb::blocked_range<std::size_t>& r)
+                    {
+                        body(r.begin(), r.end());
+                    });
+                };
+                
+                if(ctx != nullptr) { ctx->execute(run); } else { run(); }
+                break;
+            }
+#endif // VISIONCORE_HAVE_TBB
+            case LaunchBackend::ThreadPool:
+            {
+                ThreadPool* pool = ctx != nullptr ? ctx->pool() : &ThreadPool::global();
+                if(pool != nullptr) { pool->parallelFor(begin, end, grain, body); } else { body(begin, end); }
+                break;
+            }
+            default:
+                body(begin, end);
+                break;
+        }
+    }
+    
+    /**
+     * Reduction version of launchRange, body(begin, end, value) accumulates into value.
+     */
+    template<typename VT, typename BodyFunction, typename JoinFunction>
+    static inline VT launchReduceRange(std::size_t begin, std::size_t end, std::size_t grain, const VT& initial, 
+                                       BodyFunction kernel, JoinFunction jf)
+    {
+        if(end <= begin) { return initial; }
+        
+        grain = std::max<std::size_t>(grain, 1);
+        
+#ifdef VISIONCORE_HAVE_TRACE
+        const char* trace_name = trace::currentScope();
+        auto body = [&](std::size_t b, std::size_t e, VT& v)
+        {
+            trace::Scope scope(trace_name, "kernel", e - b);
+            kernel(b, e, v);
+        };
+#else // VISIONCORE_HAVE_TRACE
+        BodyFunction& body = kernel;
+#endif // VISIONCORE_HAVE_TRACE
+        
+        ExecutionContext* ctx = ExecutionContext::current();
+        
+        switch(ctx != nullptr ? ctx->backend() : getLaunchBackend())
+        {
+#ifdef VISIONCORE_HAVE_TBB
+            case LaunchBackend::TBB:
+            {
+                VT result = initial;
+                auto run = [&]()
+                {
+                    result = tbb::parallel_reduce(tbb::blocked_range<std::size_t>(begin, end, grain), initial,
+                    [&](const tbb::blocked_range<std::size_t>& r, const VT& v)
+                    {
+                        VT ret = v;
+                        body(r.begin(), r.end(), ret);
+                        return ret;
+                    },
+                    [&](const VT& v1, const VT& v2)
+                    {
+                        return jf(v1, v2);
+                    }
+                    );
+                };
+                
+                if(ctx != nullptr) { ctx->execute(run); } else { run(); }
+                return result;
+            }
+#endif // VISIONCORE_HAVE_TBB
+            case LaunchBackend::ThreadPool:
+            {
+                ThreadPool* pool = ctx != nullptr ? ctx->pool() : &ThreadPool::global();
+                if(pool != nullptr) { return pool->parallelReduce(begin, end, grain, initial, body, jf); }
+                
+                VT ret = initial;
+                body(begin, end, ret);
+                return ret;
+            }
+            default:
+            {
+                VT ret = initial;
+                body(begin, end, ret);
+                return ret;
+            }
+        }
+    }
+}
+
 template<typename PerItemFunction>
 static inline void launchParallelFor(std::size_t dim, PerItemFunction pif)
 {
-    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, dim), [&](const tbb::blocked_range<std::size_t>& r)
+    detail::launchRange(0, dim, 1, [&](std::size_t begin, std::size_t end)
     {
-        for(std::size_t i = r.begin() ; i != r.end() ; ++i )
+        for(std::size_t i = begin ; i != end ; ++i )
         {
             pif(i);
         }
     });
 }
 
+/**
+ * Row-span launch. The image is split into bands of whole rows (at least grain_rows each)
+ * and the kernel is called once per row with the span [x_begin, x_end), so the inner loop 
+ * is visible to the compiler and can be vectorized.
+ */
+template<typename PerRowFunction>
+static inline void launchParallelForRows(std::size_t dimx, std::size_t dimy, PerRowFunction prf, 
+                                         std::size_t grain_rows = LaunchGrainAuto)
+{
+    if(dimx == 0 || dimy == 0) { return; }
+    
+    detail::launchRange(0, dimy, detail::calculateGrainRows(dimx, grain_rows), [&](std::size_t y_begin, std::size_t y_end)
+    {
+        for(std::size_t y = y_begin ; y != y_end ; ++y )
+        {
+            prf(y, std::size_t(0), dimx);
+        }
+    });
+}
+
+/**
+ * Tiled launch. The kernel is called with 2D tiles [x_begin, x_end) x [y_begin, y_end)
+ * of at most tile_x by tile_y elements. Good for stencils that re-read neighbouring rows.
+ */
+template<typename PerTileFunction>
+static inline void launchParallelForTiles(std::size_t dimx, std::size_t dimy, PerTileFunction ptf, 
+                                          std::size_t tile_x = LaunchTileX, std::size_t tile_y = LaunchTileY)
+{
+    if(dimx == 0 || dimy == 0) { return; }
+    
+    tile_x = std::max<std::size_t>(tile_x, 1);
+    tile_y = std::max<std::size_t>(tile_y, 1);
+    
+    const std::size_t tiles_x = (dimx + tile_x - 1) / tile_x;
+    const std::size_t tiles_y = (dimy + tile_y - 1) / tile_y;
+    
+    detail::launchRange(0, tiles_x * tiles_y, 1, [&](std::size_t t_begin, std::size_t t_end)
+    {
+        for(std::size_t t = t_begin ; t != t_end ; ++t )
+        {
+            const std::size_t x = (t % tiles_x) * tile_x;
+            const std::size_t y = (t / tiles_x) * tile_y;
+            ptf(x, std::min(x + tile_x, dimx), y, std::min(y + tile_y, dimy));
+        }
+    });
+}
+
 template<typename PerItemFunction>
 static inline void launchParallelFor(std::size_t dimx, std::size_t dimy, PerItemFunction pif)
 {
-    tbb::parallel_for(tbb::blocked_range2d<std::size_t>(0, dimy, 0, dimx), [&](const tbb::blocked_range2d<std::size_t>& r)
+    launchParallelForRows(dimx, dimy, [&](std::size_t y, std::size_t x_begin, std::size_t x_end)
     {
-        for(std::size_t y = r.rows().begin() ; y != r.rows().end() ; ++y )
+        for(std::size_t x = x_begin ; x != x_end ; ++x ) 
         {
-            for(std::size_t x = r.cols().begin() ; x != r.cols().end() ; ++x ) 
-            {
-                pif(x,y);
-            }
+            pif(x,y);
         }
     });
 }
@@ -188,102 +378,85 @@ static inline void launchParallelFor(std::size_t dimx, std::size_t dimy, PerItem
 template<typename VT, typename PerItemFunction, typename JoinFunction>
 static inline VT launchParallelReduce(std::size_t dim, const VT& initial, PerItemFunction pif, JoinFunction jf)
 {
-    return tbb::parallel_reduce(tbb::blocked_range<std::size_t>(0, dim), initial,
-    [&](const tbb::blocked_range<std::size_t>& r, const VT& v)
+    return detail::launchReduceRange(0, dim, 1, initial, [&](std::size_t begin, std::size_t end, VT& v)
     {
-        VT ret = v;
-        for(std::size_t i = r.begin() ; i != r.end() ; ++i )
+        for(std::size_t i = begin ; i != end ; ++i )
         {
-            pif(i, ret);
+            pif(i, v);
         }
-        return ret;
-    },
-    [&](const VT& v1, const VT& v2)
+    }, jf);
+}
+
+/**
+ * Row-span reduction, see launchParallelForRows.
+ */
+template<typename VT, typename PerRowFunction, typename JoinFunction>
+static inline VT launchParallelReduceRows(std::size_t dimx, std::size_t dimy, const VT& initial, PerRowFunction prf, 
+                                          JoinFunction jf, std::size_t grain_rows = LaunchGrainAuto)
+{
+    if(dimx == 0 || dimy == 0) { return initial; }
+    
+    return detail::launchReduceRange(0, dimy, detail::calculateGrainRows(dimx, grain_rows), initial, 
+                                     [&](std::size_t y_begin, std::size_t y_end, VT& v)
     {
-        return jf(v1, v2);
-    }
-    );
+        for(std::size_t y = y_begin ; y != y_end ; ++y )
+        {
+            prf(y, std::size_t(0), dimx, v);
+        }
+    }, jf);
 }
 
 template<typename VT, typename PerItemFunction, typename JoinFunction>
 static inline VT launchParallelReduce(std::size_t dimx, std::size_t dimy, const VT& initial, PerItemFunction pif, JoinFunction jf)
 {
-    return tbb::parallel_reduce(tbb::blocked_range2d<std::size_t>(0, dimy, 0, dimx), initial,
-    [&](const tbb::blocked_range2d<std::size_t>& r, const VT& v)
+    return launchParallelReduceRows(dimx, dimy, initial, [&](std::size_t y, std::size_t x_begin, std::size_t x_end, VT& v)
     {
-        VT ret = v;
-        
-        for(std::size_t y = r.rows().begin() ; y != r.rows().end() ; ++y )
+        for(std::size_t x = x_begin ; x != x_end ; ++x ) 
         {
-            for(std::size_t x = r.cols().begin() ; x != r.cols().end() ; ++x ) 
-            {
-                pif(x,y,ret);
-            }
+            pif(x, y, v);
         }
-        return ret;
-    },
-    [&](const VT& v1, const VT& v2)
-    {
-        return jf(v1, v2);
-    }
-    );
+    }, jf);
 }
 
-#else // VISIONCORE_HAVE_TBB
-
-/// no TBB = no parallelism at all
-
+/**
+ * Asynchronous versions, run after deps and return immediately. 
+ * The kernels are copied, everything they reference must outlive the returned event.
+ */
 template<typename PerItemFunction>
-static inline void launchParallelFor(std::size_t dim, PerItemFunction pif)
+static inline LaunchEvent launchParallelForAsync(std::size_t dim, PerItemFunction pif, 
+                                                 const std::vector<LaunchEvent>& deps = std::vector<LaunchEvent>())
 {
-    for(std::size_t i = 0 ; i < dim ; ++i )
-    {
-        pif(i);
-    }
+    return launchAsync([=]() { launchParallelFor(dim, pif); }, deps);
 }
 
 template<typename PerItemFunction>
-static inline void launchParallelFor(std::size_t dimx, std::size_t dimy, PerItemFunction pif)
+static inline LaunchEvent launchParallelForAsync(std::size_t dimx, std::size_t dimy, PerItemFunction pif, 
+                                                 const std::vector<LaunchEvent>& deps = std::vector<LaunchEvent>())
 {
-    for(std::size_t y = 0 ; y < dimy ; ++y)
-    {
-        for(std::size_t x = 0 ; x < dimy ; ++x)
-        {
-            pif(x,y);
-        }
-    }
+    return launchAsync([=]() { launchParallelFor(dimx, dimy, pif); }, deps);
 }
 
-template<typename VT, typename PerItemFunction, typename JoinFunction>
-static inline VT launchParallelReduce(std::size_t dim, const VT& initial, PerItemFunction pif, JoinFunction jf)
+template<typename PerRowFunction>
+static inline LaunchEvent launchParallelForRowsAsync(std::size_t dimx, std::size_t dimy, PerRowFunction prf, 
+                                                     const std::vector<LaunchEvent>& deps = std::vector<LaunchEvent>())
 {
-    VT ret = initial;
-    
-    for(std::size_t i = 0 ; i < dim ; ++i )
-    {
-        pif(i, ret);
-    }
-    
-    return ret;
+    return launchAsync([=]() { launchParallelForRows(dimx, dimy, prf); }, deps);
 }
 
 template<typename VT, typename PerItemFunction, typename JoinFunction>
-static inline VT launchParallelReduce(std::size_t dimx, std::size_t dimy, const VT& initial, PerItemFunction pif, JoinFunction jf)
+static inline LaunchFuture<VT> launchParallelReduceAsync(std::size_t dim, const VT& initial, PerItemFunction pif, JoinFunction jf,
+                                                         const std::vector<LaunchEvent>& deps = std::vector<LaunchEvent>())
 {
-    VT ret = initial;
-    
-    for(std::size_t y = 0 ; y < dimy ; ++y)
-    {
-        for(std::size_t x = 0 ; x < dimy ; ++x)
-        {
-            pif(x,y, ret);
-        }
-    }
-    
-    return ret;
+    return launchAsync([=]() { return launchParallelReduce(dim, initial, pif, jf); }, deps);
 }
 
-#endif // VISIONCORE_HAVE_TBB
+template<typename VT, typename PerItemFunction, typename JoinFunction>
+static inline LaunchFuture<VT> launchParallelReduceAsync(std::size_t dimx, std::size_t dimy, const VT& initial, 
+                                                         PerItemFunction pif, JoinFunction jf,
+                                                         const std::vector<LaunchEvent>& deps = std::vector<LaunchEvent>())
+{
+    return launchAsync([=]() { return launchParallelReduce(dimx, dimy, initial, pif, jf); }, deps);
+}
 
 }
 #endif // VISIONCORE_LAUNCH_UTILS_HPP
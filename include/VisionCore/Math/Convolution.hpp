@@ -36,10 +36,14 @@
 #ifndef VISIONCORE_MATH_CONVOLUTION_HPP
 #define VISIONCORE_MATH_CONVOLUTION_HPP
 
+#include <algorithm>
+#include <cmath>
+
 #include <VisionCore/Platform.hpp>
 
 #include <VisionCore/Buffers/Buffer1D.hpp>
 #include <VisionCore/Buffers/Buffer2D.hpp>
+#include <VisionCore/Buffers/BorderMode.hpp>
 
 namespace vc
 {
@@ -53,7 +57,73 @@ void convolve(const Buffer1DView<T,Target>& img_in, Buffer1DView<T,Target>& img_
 template<typename T, typename Target, typename T2>
 void convolve(const Buffer2DView<T,Target>& img_in, Buffer2DView<T,Target>& img_out, const T2& kern);
 
-// TODO add separable convolutions, see nVidia Sample
+/**
+ * As above with a border policy (the overload above clamps), host only. 
+ * border_value is read outside of the image for BorderMode::Constant.
+ */
+template<typename T, typename T2>
+void convolve(const Buffer2DView<T,TargetHost>& img_in, Buffer2DView<T,TargetHost>& img_out, const T2& kern,
+              BorderMode border, const T& border_value = T(0));
+
+/**
+ * Dense kernel of any size given as an image, kern(i, j) multiplies pixel (x + i - kern.width() / 2, y + j - kern.height() / 2),
+ * not normalised. Host only, float and double. With BorderMode::Skip pixels closer than kern.width() / 2 
+ * (kern.height() / 2) to the image border are not written. Cost grows with the kernel area, see FFTConvolution 
+ * for large kernels.
+ * 
+ * Throws std::runtime_error for an empty kernel or if in/out dimensions don't match.
+ */
+template<typename T>
+void correlate(const Buffer2DView<T,TargetHost>& img_in, Buffer2DView<T,TargetHost>& img_out, const Buffer2DView<T,TargetHost>& kern,
+               BorderMode border = BorderMode::Clamp, const T& border_value = T(0));
+
+/**
+ * Separable convolution, kern_x along the rows then kern_y along the columns.
+ * 
+ * Kernels have any odd length, tap i multiplies pixel x + i - length / 2 (as convolve above), 
+ * they are not normalised. Borders follow the border mode, border_value is used by 
+ * BorderMode::Constant, with BorderMode::Skip only the interior of img_out is written. Accumulation is in float (double for double images), 
+ * integer outputs are rounded and saturated. Host only, uint8_t, uint16_t, float and double,
+ * kernels are float except for double images.
+ * 
+ * uint8_t images with blur-like kernels (kern_x non-negative summing up to at most 1, 
+ * kern_y summing up to less than 2 in absolute value) run in fixed point instead: taps rounded to 
+ * 1/16384, 16 bit lines, 32 bit sums. Results stay within 1 of the float path.
+ * 
+ * Rows are processed in bands, each thread keeps a ring of row filtered lines, so there is
+ * no intermediate image, but img_out can't be img_in.
+ * 
+ * Throws std::runtime_error for even length kernels or if in/out dimensions don't match.
+ */
+template<typename T, typename TK>
+void convolveSeparable(const Buffer2DView<T,TargetHost>& img_in, Buffer2DView<T,TargetHost>& img_out, 
+                       const Eigen::Matrix<TK,Eigen::Dynamic,1>& kern_x, const Eigen::Matrix<TK,Eigen::Dynamic,1>& kern_y,
+                       BorderMode border = BorderMode::Clamp, const T& border_value = T(0));
+
+/**
+ * Mean over a (2 radius_x + 1) by (2 radius_y + 1) window, convolveSeparable with constant kernels,
+ * so the same borders, types and fixed-point path.
+ */
+template<typename T>
+void boxFilter(const Buffer2DView<T,TargetHost>& img_in, Buffer2DView<T,TargetHost>& img_out, 
+               std::size_t radius_x, std::size_t radius_y, BorderMode border = BorderMode::Clamp, const T& border_value = T(0));
+
+/**
+ * Normalised 1D Gaussian, radius defaults to ceil(3 sigma).
+ */
+template<typename TK>
+static inline Eigen::Matrix<TK,Eigen::Dynamic,1> gaussianKernel(TK sigma, int radius = -1)
+{
+    if(radius < 0) { radius = std::max((int)std::ceil(TK(3.0) * sigma), 1); }
+    
+    Eigen::Matrix<TK,Eigen::Dynamic,1> kern(2 * radius + 1);
+    for(int i = -radius ; i <= radius ; ++i)
+    {
+        kern(i + radius) = std::exp(-TK(i * i) / (TK(2.0) * sigma * sigma));
+    }
+    
+    return kern / kern.sum();
+}
 
 }
     
@@ -0,0 +1,126 @@
+/**
+ * ****************************************************************************
+ * Copyright (c) 2017, Robert Lukierski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ****************************************************************************
+ * Large kernel convolution through the FFT.
+ * ****************************************************************************
+ */
+
+#ifndef VISIONCORE_MATH_FFT_CONVOLUTION_HPP
+#define VISIONCORE_MATH_FFT_CONVOLUTION_HPP
+
+#include <memory>
+
+#include <VisionCore/Platform.hpp>
+
+#include <VisionCore/Buffers/Buffer2D.hpp>
+#include <VisionCore/Buffers/BorderMode.hpp>
+
+namespace vc
+{
+
+namespace math
+{
+
+/**
+ * How FFTConvolution computes its result.
+ */
+enum class ConvolutionMethod
+{
+    Auto = 0,   ///< FFT if the cost model puts it below Direct for the image size
+    Direct,     ///< correlate()
+    FFT         ///< overlap-save with FFT tiles
+};
+
+/**
+ * 2D convolution or correlation with a large kernel given as an image, host only, float and double.
+ * Needs FFTW, as the rest of the CPU Fourier functions.
+ * 
+ * Correlation takes the taps as correlate(): kern(i, j) multiplies pixel (x + i - kern.width() / 2, y + j - kern.height() / 2),
+ * convolution is the same with the kernel flipped in x and y. Not normalised. Borders as correlate().
+ * 
+ * The image is cut into overlap-save tiles, every tile is transformed, multiplied with the kernel spectrum
+ * and transformed back. The tile size minimises the modelled cost per output pixel, the same model decides 
+ * between the FFT and correlate(), around 9x9 at VGA and up. 
+ * The kernel spectrum and the FFTW plans are kept for the last image size, so keep the object around 
+ * when filtering a sequence of frames with the same kernel.
+ * 
+ * Calls on one object are serialised, tiles run in parallel. Throws std::runtime_error for an empty 
+ * kernel or if in/out dimensions don't match.
+ */
+template<typename T>
+class FFTConvolution
+{
+public:
+    FFTConvolution(const Buffer2DView<T,TargetHost>& kern, bool correlation = false, 
+                   ConvolutionMethod method = ConvolutionMethod::Auto);
+    ~FFTConvolution();
+    
+    FFTConvolution(const FFTConvolution&) = delete;
+    FFTConvolution& operator=(const FFTConvolution&) = delete;
+    
+    void operator()(const Buffer2DView<T,TargetHost>& img_in, Buffer2DView<T,TargetHost>& img_out,
+                    BorderMode border = BorderMode::Clamp, const T& border_value = T(0));
+    
+    /// Direct or FFT, what operator() does for this image size.
+    ConvolutionMethod method(std::size_t width, std::size_t height) const;
+    
+private:
+    struct Impl;
+    
+    std::unique_ptr<Impl>   impl;
+};
+
+/**
+ * One-shot versions, the kernel spectrum is computed on every call.
+ */
+template<typename T>
+static inline void fftConvolve(const Buffer2DView<T,TargetHost>& img_in, Buffer2DView<T,TargetHost>& img_out, 
+                               const Buffer2DView<T,TargetHost>& kern, BorderMode border = BorderMode::Clamp, 
+                               const T& border_value = T(0))
+{
+    FFTConvolution<T> conv(kern, false);
+    conv(img_in, img_out, border, border_value);
+}
+
+template<typename T>
+static inline void fftCorrelate(const Buffer2DView<T,TargetHost>& img_in, Buffer2DView<T,TargetHost>& img_out, 
+                                const Buffer2DView<T,TargetHost>& kern, BorderMode border = BorderMode::Clamp, 
+                                const T& border_value = T(0))
+{
+    FFTConvolution<T> conv(kern, true);
+    conv(img_in, img_out, border, border_value);
+}
+
+}
+
+}
+
+#endif // VISIONCORE_MATH_FFT_CONVOLUTION_HPP
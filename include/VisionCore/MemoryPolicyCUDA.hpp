@@ -39,6 +39,7 @@
 #include <cstdlib>
 
 #include <VisionCore/Platform.hpp>
+#include <VisionCore/MemoryStats.hpp>
 
 #include <thrust/device_vector.h>
 
@@ -66,12 +67,30 @@ struct TargetDeviceCUDA
 {
     template<typename T> using PointerType = void*;
     template<typename T> using TextureHandleType = cudaTextureObject_t;
-    
+
+    static constexpr std::size_t TextureAlignment = 512;
+
+    /**
+     * Alignment of sub-allocations (e.g. pyramid levels) that may be bound to textures.
+     */
+    inline static std::size_t alignment() { return TextureAlignment; }
+
+    /**
+     * Row pitch for w elements as cudaMallocPitch would pick it, for sub-allocations.
+     */
+    template<typename T>
+    inline static std::size_t pitchFor(std::size_t w)
+    {
+        const std::size_t granularity = (std::size_t(TextureAlignment) / internal::gcd(TextureAlignment, sizeof(T))) * sizeof(T);
+        return ((w * sizeof(T) + granularity - 1) / granularity) * granularity;
+    }
+
     template<typename T>
     inline static void AllocateMem(PointerType<T>* devPtr, std::size_t s)
     {
         const cudaError err = cudaMalloc(devPtr, sizeof(T) * s);
         if( err != cudaSuccess ) { throw CUDAException(err, "Unable to cudaMalloc"); }
+        memstats::trackAllocation(MemoryTarget::CUDA, *devPtr, sizeof(T) * s);
     }
     
     template<typename T>
@@ -79,6 +98,7 @@ struct TargetDeviceCUDA
     {
         const cudaError err = cudaMallocPitch(devPtr, pitch, w * sizeof(T), h);
         if( err != cudaSuccess ) { throw CUDAException(err, "Unable to cudaMallocPitch"); }
+        memstats::trackAllocation(MemoryTarget::CUDA, *devPtr, *pitch * h);
     }
 
     template<typename T>
@@ -86,6 +106,7 @@ struct TargetDeviceCUDA
     {
         const cudaError err = cudaMallocPitch(devPtr, pitch, w * sizeof(T), h * d);
         if( err != cudaSuccess ) { throw CUDAException(err, "Unable to cudaMallocPitch"); }
+        memstats::trackAllocation(MemoryTarget::CUDA, *devPtr, *pitch * h * d);
         
         *img_pitch = *pitch * h;
     }
@@ -94,6 +115,7 @@ struct TargetDeviceCUDA
     inline static bool DeallocatePitchedMem(PointerType<T> devPtr) throw()
     {
 #ifndef VISIONCORE_CUDA_KERNEL_SPACE
+        memstats::untrackAllocation(MemoryTarget::CUDA, devPtr);
         const cudaError err = cudaFree(devPtr);
         return err == cudaSuccess;
 #endif // VISIONCORE_CUDA_KERNEL_SPACE
@@ -131,6 +153,7 @@ template<> struct TargetTransfer<TargetHost,TargetDeviceCUDA>
     {
         const cudaError err = cudaMemcpy(dst, src, count, CopyKind );
         if( err != cudaSuccess ) { throw CUDAException(err, "Unable to cudaMemcpy"); }
+        memstats::recordTransfer(MemoryTarget::Host, MemoryTarget::CUDA, count);
     }
     
     template<typename T>
@@ -140,6 +163,7 @@ template<> struct TargetTransfer<TargetHost,TargetDeviceCUDA>
     {
         const cudaError err = cudaMemcpy2D(dst,dpitch,src,spitch, width, height, CopyKind );
         if(err != cudaSuccess) { throw CUDAException(err, "Unable to cudaMemcpy2D"); }
+        memstats::recordTransfer(MemoryTarget::Host, MemoryTarget::CUDA, width * height);
     }
 };
 
@@ -156,6 +180,7 @@ template<> struct TargetTransfer<TargetDeviceCUDA,TargetHost>
     {
         const cudaError err = cudaMemcpy(dst, src, count, CopyKind );
         if( err != cudaSuccess ) { throw CUDAException(err, "Unable to cudaMemcpy"); }
+        memstats::recordTransfer(MemoryTarget::CUDA, MemoryTarget::Host, count);
     }
     
     template<typename T>
@@ -165,6 +190,7 @@ template<> struct TargetTransfer<TargetDeviceCUDA,TargetHost>
     {
         const cudaError err = cudaMemcpy2D(dst,dpitch,src,spitch, width, height, CopyKind );
         if(err != cudaSuccess) { throw CUDAException(err, "Unable to cudaMemcpy2D"); }
+        memstats::recordTransfer(MemoryTarget::CUDA, MemoryTarget::Host, width * height);
     }
 };
 
@@ -181,6 +207,7 @@ template<> struct TargetTransfer<TargetDeviceCUDA,TargetDeviceCUDA>
     {
         const cudaError err = cudaMemcpy(dst, src, count, CopyKind );
         if( err != cudaSuccess ) { throw CUDAException(err, "Unable to cudaMemcpy"); }
+        memstats::recordTransfer(MemoryTarget::CUDA, MemoryTarget::CUDA, count);
     }
     
     template<typename T>
@@ -190,6 +217,7 @@ template<> struct TargetTransfer<TargetDeviceCUDA,TargetDeviceCUDA>
     {
         const cudaError err = cudaMemcpy2D(dst,dpitch,src,spitch, width, height, CopyKind );
         if(err != cudaSuccess) { throw CUDAException(err, "Unable to cudaMemcpy2D"); }
+        memstats::recordTransfer(MemoryTarget::CUDA, MemoryTarget::CUDA, width * height);
     }
 };
 
@@ -37,89 +37,147 @@
 #define VISIONCORE_MEMORY_POLICY_HOST_HPP
 
 #include <cstdlib>
+#include <algorithm>
+#include <cstring>
+#include <atomic>
+#include <stdexcept>
 
 #include <VisionCore/Platform.hpp>
+#include <VisionCore/HostCopy.hpp>
+#include <VisionCore/HostMemory.hpp>
+
+/**
+ * Compile-time fallback for the base alignment of host allocations, a cache line. At run time
+ * the VISIONCORE_HOST_ALIGNMENT environment variable (see hostDefaultAlignment) sets the
+ * starting value and TargetHost::setAlignment changes it.
+ */
+#ifndef VISIONCORE_HOST_ALIGNMENT
+#define VISIONCORE_HOST_ALIGNMENT 64
+#endif // VISIONCORE_HOST_ALIGNMENT
 
 namespace vc
 {
+    
+namespace internal
+{
+    inline std::atomic<std::size_t>& hostAlignment()
+    {
+        static std::atomic<std::size_t> alignment(hostDefaultAlignment(VISIONCORE_HOST_ALIGNMENT));
+        return alignment;
+    }
+    
+    static constexpr inline std::size_t gcd(std::size_t a, std::size_t b)
+    {
+        return b == 0 ? a : gcd(b, a % b);
+    }
+}
+    
 struct TargetHost
 {
     template<typename T> using PointerType = void*;
     template<typename T> using TextureHandleType = int;
     
+    static constexpr std::size_t CacheLineAlignment = 64;
+    static constexpr std::size_t PageAlignment = 4096;
+    
+    /**
+     * Base alignment of new host allocations, a power of two, at least sizeof(void*).
+     * Rows of pitched allocations start at multiples of min(alignment, CacheLineAlignment),
+     * so 4 KiB gives page aligned buffers without page sized (cache set aliasing) row strides.
+     * Affects allocations made afterwards only.
+     */
+    inline static void setAlignment(std::size_t alignment)
+    {
+        if(alignment < sizeof(void*) || (alignment & (alignment - 1)) != 0)
+        {
+            throw std::invalid_argument("Alignment must be a power of two, at least sizeof(void*)");
+        }
+        
+        internal::hostAlignment() = alignment;
+    }
+    
+    inline static std::size_t alignment() 
+    { 
+        return internal::hostAlignment().load(std::memory_order_relaxed); 
+    }
+    
+    /**
+     * Row pitch in bytes for w elements: w * sizeof(T) padded to the row alignment, 
+     * always a multiple of sizeof(T) so elementPitch() stays exact.
+     */
+    template<typename T>
+    inline static std::size_t pitchFor(std::size_t w)
+    {
+        const std::size_t row_align = std::min(alignment(), std::size_t(CacheLineAlignment));
+        const std::size_t granularity = (row_align / internal::gcd(row_align, sizeof(T))) * sizeof(T);
+        return ((w * sizeof(T) + granularity - 1) / granularity) * granularity;
+    }
+    
     template<typename T>
     inline static void AllocateMem(PointerType<T>* devPtr, size_t s)
     {
-        /// @todo is there much difference?
-#ifdef VISIONCORE_HAVE_CUDA
-        const cudaError err = cudaMallocHost(devPtr, sizeof(T) * s);
-        if( err != cudaSuccess )  { throw CUDAException(err, "Unable to cudaMallocHost"); }
-#else // VISIONCORE_HAVE_CUDA
-        *devPtr = malloc(sizeof(T) * s);
-        if(*devPtr == nullptr) { throw std::bad_alloc(); }
-#endif // VISIONCORE_HAVE_CUDA
+        *devPtr = allocateAligned(sizeof(T) * s);
     }
     
     template<typename T> 
     inline static void AllocatePitchedMem(PointerType<T>* hostPtr, size_t *pitch, size_t w, size_t h)
     {
-        *pitch = w * sizeof(T);
-        
-#ifdef VISIONCORE_HAVE_CUDA        
-        const cudaError err = cudaMallocHost(hostPtr, *pitch * h);        
-        if( err != cudaSuccess )  { throw CUDAException(err, "Unable to cudaMallocHost"); }
-#else // VISIONCORE_HAVE_CUDA
-        *hostPtr = malloc(*pitch * h);
-        if(*hostPtr == nullptr) { throw std::bad_alloc(); }
-#endif // VISIONCORE_HAVE_CUDA
+        *pitch = pitchFor<T>(w);
+        *hostPtr = allocateAligned(*pitch * h);
     }
 
     template<typename T> 
     inline static void AllocatePitchedMem(PointerType<T>* hostPtr, size_t *pitch, size_t *img_pitch, size_t w, size_t h, size_t d)
     {
-
-        *pitch = w * sizeof(T);
-
-#ifdef VISIONCORE_HAVE_CUDA        
-        const cudaError err = cudaMallocHost(hostPtr, *pitch * h * d);
-        
-        if( err != cudaSuccess ) { throw CUDAException(err, "Unable to cudaMallocHost"); }
-#else // VISIONCORE_HAVE_CUDA
-        *hostPtr = malloc(*pitch * h * d);
-        if(*hostPtr == nullptr) { throw std::bad_alloc(); }
-#endif // VISIONCORE_HAVE_CUDA
-        
+        *pitch = pitchFor<T>(w);
+        *hostPtr = allocateAligned(*pitch * h * d);
         *img_pitch = *pitch * h;
     }
 
     template<typename T> 
     inline static bool DeallocatePitchedMem(PointerType<T> hostPtr) throw()
     {
-#ifdef VISIONCORE_HAVE_CUDA
-        const cudaError err = cudaFreeHost(hostPtr);
-        return err == cudaSuccess;
-#else // VISIONCORE_HAVE_CUDA
-        free(hostPtr);
+        deallocateAligned(hostPtr);
         return true;
-#endif // VISIONCORE_HAVE_CUDA
     }
     
+    /**
+     * Raw aligned host memory (alignment()), pinned in CUDA builds and recycled by HostMemoryPool 
+     * when enabled. Release with deallocateAligned.
+     */
+    inline static void* allocateAligned(std::size_t bytes)
+    {
+        return hostAllocate(bytes, alignment());
+    }
+    
+    inline static void deallocateAligned(void* ptr) throw()
+    {
+        hostDeallocate(ptr);
+    }
+    
+    /**
+     * Parallel for large buffers (hostMemset). Zeroing a mapped allocation (HostMapSettings) 
+     * returns its pages to the OS instead of writing them.
+     */
     template<typename T> 
     inline static void memset(PointerType<T> ptr, int value, std::size_t count) 
     {
-        std::memset(ptr, value, count);
+        if(value != 0 || !hostDiscard(ptr, count))
+        {
+            hostMemset(ptr, value, count);
+        }
     }
     
     template<typename T>
     inline static void memset2D(PointerType<T> ptr, std::size_t pitch, int value, std::size_t width, std::size_t height)
     {
-        std::memset(ptr, value, std::max(width,pitch) * height);
+        memset<T>(ptr, value, std::max(width,pitch) * height);
     }
     
     template<typename T>
     inline static void memset3D(PointerType<T> ptr, std::size_t pitch, int value, std::size_t width, std::size_t height, std::size_t depth)
     {
-        std::memset(ptr, value, std::max(width,pitch) * height * depth);
+        memset<T>(ptr, value, std::max(width,pitch) * height * depth);
     }
 };
 
@@ -128,28 +186,17 @@ template<> struct TargetTransfer<TargetHost,TargetHost>
     typedef TargetHost TargetFrom;
     typedef TargetHost TargetTo;
     
+    // host to host never needs the CUDA runtime, the copy engine is parallel and pitch aware
     template<typename T>
     inline static void memcpy(typename TargetTo::template PointerType<T> dst, const typename TargetFrom::template PointerType<T> src, std::size_t count)
     {
-#ifdef VISIONCORE_HAVE_CUDA
-        static constexpr cudaMemcpyKind CopyKind = cudaMemcpyHostToHost;
-        const cudaError err = cudaMemcpy(dst, src, count, CopyKind );
-        if( err != cudaSuccess ) { throw CUDAException(err, "Unable to cudaMemcpy"); }
-#else // VISIONCORE_HAVE_CUDA
-        std::memcpy(dst, src, count);
-#endif // VISIONCORE_HAVE_CUDA
+        hostCopy(dst, src, count);
     }
     
     template<typename T>
     inline static void memcpy2D(typename TargetTo::template PointerType<T> dst, std::size_t  dpitch, const typename TargetFrom::template PointerType<T> src, std::size_t  spitch, std::size_t  width, std::size_t  height)
     {
-#ifdef VISIONCORE_HAVE_CUDA
-        static constexpr cudaMemcpyKind CopyKind = cudaMemcpyHostToHost;
-        const cudaError err = cudaMemcpy2D(dst,dpitch,src,spitch, width, height, CopyKind );
-        if(err != cudaSuccess) { throw CUDAException(err, "Unable to cudaMemcpy2D"); }
-#else // VISIONCORE_HAVE_CUDA
-        std::memcpy(dst, src, width * height);
-#endif // VISIONCORE_HAVE_CUDA
+        hostCopy2D(dst, dpitch, src, spitch, width, height);
     }
 };
 
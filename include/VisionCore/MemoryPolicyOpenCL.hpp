@@ -36,7 +36,10 @@
 #ifndef VISIONCORE_MEMORY_POLICY_OPENCL_HPP
 #define VISIONCORE_MEMORY_POLICY_OPENCL_HPP
 
+#include <utility>
+
 #include <VisionCore/Platform.hpp>
+#include <VisionCore/MemoryStats.hpp>
 
 namespace vc
 {
@@ -45,6 +48,24 @@ struct TargetDeviceOpenCL
 {
     template<typename T> using PointerType = cl::Memory*;
     template<typename T> using TextureHandleType = int;
+    
+    /**
+     * new MemT(args...), counted in memstats with the size the runtime reports.
+     */
+    template<typename MemT, typename... Args>
+    inline static MemT* create(Args&&... args)
+    {
+        MemT* mem = new MemT(std::forward<Args>(args)...);
+        memstats::trackAllocation(MemoryTarget::OpenCL, mem, static_cast<cl::Memory*>(mem)->getInfo<CL_MEM_SIZE>());
+        return mem;
+    }
+    
+    template<typename MemT>
+    inline static void release(MemT* mem)
+    {
+        memstats::untrackAllocation(MemoryTarget::OpenCL, mem);
+        delete mem;
+    }
 };
 
 }
@@ -0,0 +1,134 @@
+/**
+ * ****************************************************************************
+ * Copyright (c) 2017, Robert Lukierski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ****************************************************************************
+ * Allocation and transfer accounting per memory target.
+ * ****************************************************************************
+ */
+
+#ifndef VISIONCORE_MEMORY_STATS_HPP
+#define VISIONCORE_MEMORY_STATS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * Every allocation made through the memory policies (TargetHost via hostAllocate, TargetDeviceCUDA,
+ * the OpenCL Managed buffers) and every copy between targets is counted, per target and per label.
+ * Labels come from the innermost LabelScope on the allocating / copying thread:
+ * 
+ *   vc::memstats::LabelScope label("tracker");
+ *   vc::Buffer2DManaged<float> tmp(w, h);      // counted under "tracker"
+ * 
+ * Freed memory is counted under the label it was allocated with. Counters are relaxed atomics,
+ * always on.
+ */
+
+namespace vc
+{
+
+enum class MemoryTarget
+{
+    Host = 0,
+    CUDA,
+    OpenCL,
+    Count
+};
+
+const char* memoryTargetName(MemoryTarget target);
+
+namespace memstats
+{
+
+struct Counters
+{
+    std::size_t     live_bytes;
+    std::size_t     peak_bytes;
+    uint64_t        allocations;
+    uint64_t        deallocations;
+    uint64_t        copies_in;          // transfers with this target as the destination
+    uint64_t        bytes_copied_in;
+};
+
+/// Labels beyond this many distinct names are counted as unlabelled.
+static constexpr std::size_t MaxLabels = 256;
+
+/**
+ * Sets the label for allocations and copies on this thread, restores the previous one when destroyed.
+ */
+class LabelScope
+{
+public:
+    explicit LabelScope(const char* label);
+    ~LabelScope();
+    
+    LabelScope(const LabelScope&) = delete;
+    LabelScope& operator=(const LabelScope&) = delete;
+private:
+    uint32_t previous;
+};
+
+/// Id of the current label on this thread, 0 = unlabelled.
+uint32_t currentLabel();
+
+/// Fast path for allocators that store the label id themselves (e.g. in a block header).
+void recordAllocation(MemoryTarget target, std::size_t bytes, uint32_t label);
+void recordDeallocation(MemoryTarget target, std::size_t bytes, uint32_t label);
+
+/// For allocations without a header, remembers size & label by pointer.
+void trackAllocation(MemoryTarget target, const void* key, std::size_t bytes);
+void untrackAllocation(MemoryTarget target, const void* key);
+
+void recordTransfer(MemoryTarget from, MemoryTarget to, std::size_t bytes);
+
+Counters counters(MemoryTarget target);
+/// Counters of one label, all zero for unknown labels.
+Counters counters(MemoryTarget target, const std::string& label);
+
+/// Bytes copied from one target to another.
+uint64_t transferredBytes(MemoryTarget from, MemoryTarget to);
+
+/// Labels seen so far, index = label id ("" for 0).
+std::vector<std::string> labels();
+
+/// Peaks down to the live bytes, counts and transfers to zero.
+void resetCounters();
+
+/// Human readable table of all targets and labels with activity.
+void writeReport(std::ostream& os);
+
+}
+
+}
+
+#endif // VISIONCORE_MEMORY_STATS_HPP
@@ -0,0 +1,170 @@
+/**
+ * ****************************************************************************
+ * Copyright (c) 2017, Robert Lukierski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * 
+ * ****************************************************************************
+ * Hardware performance counters (Linux perf_event_open).
+ * ****************************************************************************
+ */
+
+#ifndef VISIONCORE_PERF_COUNTERS_HPP
+#define VISIONCORE_PERF_COUNTERS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/**
+ * Counters are compiled in with VISIONCORE_HAVE_PERF_COUNTERS (CMake USE_PERF_COUNTERS, Linux only),
+ * otherwise everything reports as unavailable. Even when compiled in, the kernel may refuse some or
+ * all of them (perf_event_paranoid, virtual machines without a PMU), so always check Sample::has().
+ * 
+ * Only user space is counted. Values are scaled when the kernel multiplexes the PMU.
+ */
+
+namespace vc
+{
+    
+namespace perf
+{
+    
+enum class Counter : int
+{
+    Cycles = 0,
+    Instructions,
+    LLCMisses,          // last level cache read misses, generic cache misses if not supported
+    BranchMisses,
+    TaskClock,          // CPU time in nanoseconds (software counter)
+    Count
+};
+
+static constexpr std::size_t CounterCount = (std::size_t)Counter::Count;
+
+/// Short name, e.g. "cycles", "llc_misses".
+const char* counterName(Counter c);
+
+/// True if counters are compiled in.
+bool isSupported();
+
+/**
+ * Counter values, valid[i] is false if the counter could not be opened.
+ */
+struct Sample
+{
+    Sample();
+    
+    inline uint64_t get(Counter c) const { return values[(std::size_t)c]; }
+    inline bool has(Counter c) const { return valid[(std::size_t)c]; }
+    
+    /// Any counter valid.
+    bool any() const;
+    
+    /// Instructions per cycle, 0 if either is missing.
+    double ipc() const;
+    
+    /// Difference of two readings, clamped at zero. Valid only where both are.
+    Sample operator-(const Sample& other) const;
+    Sample& operator+=(const Sample& other);
+    
+    uint64_t    values[CounterCount];
+    bool        valid[CounterCount];
+};
+
+/**
+ * Set of running counters.
+ * 
+ * Mode::Thread counts the constructing thread only. Mode::Process counts every thread of the process
+ * that exists at construction (and at each rescan()), including ones that exit later, so pool workers
+ * are included. Counting starts at construction, take differences of read() around the code of interest.
+ * 
+ * rescan() also releases the counters of threads that have exited (their totals so far are kept)
+ * and starts counting threads that reuse the id of an exited one.
+ */
+class Counters
+{
+public:
+    enum class Mode
+    {
+        Thread,
+        Process
+    };
+    
+    explicit Counters(Mode mode = Mode::Process);
+    ~Counters();
+    
+    Counters(const Counters&) = delete;
+    Counters& operator=(const Counters&) = delete;
+    
+    inline Mode mode() const { return cmode; }
+    
+    /// Counter could be opened.
+    bool available(Counter c) const;
+    
+    /// Number of live threads being counted, as of the last rescan().
+    std::size_t threads() const;
+    
+    /// Mode::Process only, start counting threads created since the last rescan, drop exited ones.
+    void rescan();
+    
+    /// Totals since construction (or since the thread was added), summed over threads. Thread safe.
+    Sample read() const;
+    
+private:
+    struct Impl;
+    
+    Mode                    cmode;
+    std::unique_ptr<Impl>   impl;
+};
+
+/// Process wide counters, created on first use.
+Counters& processCounters();
+
+/**
+ * Adds the counts of [construction, destruction) to a Sample.
+ */
+class Scope
+{
+public:
+    Scope(Sample& out, Counters& c = processCounters()) : counters(c), result(out), begin(c.read()) { }
+    ~Scope() { result += counters.read() - begin; }
+    
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+private:
+    Counters&   counters;
+    Sample&     result;
+    Sample      begin;
+};
+
+}
+
+}
+
+#endif // VISIONCORE_PERF_COUNTERS_HPP
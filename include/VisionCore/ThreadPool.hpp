@@ -0,0 +1,194 @@
+/**
+ * ****************************************************************************
+ * Copyright (c) 2017, Robert Lukierski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ****************************************************************************
+ * Portable work-stealing thread pool (std::thread based).
+ * ****************************************************************************
+ */
+
+#ifndef VISIONCORE_THREAD_POOL_HPP
+#define VISIONCORE_THREAD_POOL_HPP
+
+#include <cstddef>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vc
+{
+
+/**
+ * Work-stealing thread pool.
+ *
+ * Every worker owns a task deque, pops from its back and steals from the front of the others.
+ * parallelFor / parallelReduce let the calling thread take part in the work, so nested
+ * launches from inside a task never deadlock.
+ */
+class ThreadPool
+{
+public:
+    typedef std::function<void()> TaskT;
+    typedef std::function<void(std::size_t)> ThreadInitT;
+
+    /**
+     * workers = 0 picks std::thread::hardware_concurrency() - 1 (the caller is the extra thread).
+     * thread_init, if given, runs first on every worker thread (with the worker index),
+     * e.g. to set affinity or priority.
+     */
+    explicit ThreadPool(std::size_t workers = 0, ThreadInitT thread_init = ThreadInitT());
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool(ThreadPool&&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ThreadPool& operator=(ThreadPool&&) = delete;
+
+    /// Number of worker threads.
+    inline std::size_t workers() const { return threads.size(); }
+    /// Number of threads that take part in a parallelFor (workers + caller).
+    inline std::size_t concurrency() const { return threads.size() + 1; }
+
+    /// Fire and forget.
+    void submit(TaskT task);
+
+    /// True if the current thread is one of this pool's workers.
+    bool isWorkerThread() const;
+
+    /**
+     * Splits [begin, end) into chunks of at least grain items and runs body(chunk_begin, chunk_end)
+     * on them. Blocks until all chunks are done, rethrows the first exception thrown by body.
+     */
+    template<typename BodyFunction>
+    void parallelFor(std::size_t begin, std::size_t end, std::size_t grain, BodyFunction body)
+    {
+        if(end <= begin) { return; }
+
+        const std::size_t chunk = chunkSize(end - begin, grain);
+        const std::size_t chunks = (end - begin + chunk - 1) / chunk;
+
+        if(chunks == 1 || workers() == 0)
+        {
+            body(begin, end);
+            return;
+        }
+
+        runChunks(chunks, [&](std::size_t c)
+        {
+            const std::size_t cb = begin + c * chunk;
+            body(cb, std::min(cb + chunk, end));
+        });
+    }
+
+    /**
+     * Reduction over [begin, end). body(chunk_begin, chunk_end, value) accumulates into value,
+     * partial results are joined in chunk order, so the result is deterministic.
+     */
+    template<typename VT, typename BodyFunction, typename JoinFunction>
+    VT parallelReduce(std::size_t begin, std::size_t end, std::size_t grain, const VT& initial,
+                      BodyFunction body, JoinFunction join)
+    {
+        if(end <= begin) { return initial; }
+
+        const std::size_t chunk = chunkSize(end - begin, grain);
+        const std::size_t chunks = (end - begin + chunk - 1) / chunk;
+
+        if(chunks == 1 || workers() == 0)
+        {
+            VT ret = initial;
+            body(begin, end, ret);
+            return ret;
+        }
+
+        std::vector<VT> partials(chunks, initial);
+
+        runChunks(chunks, [&](std::size_t c)
+        {
+            const std::size_t cb = begin + c * chunk;
+            body(cb, std::min(cb + chunk, end), partials[c]);
+        });
+
+        VT ret = partials[0];
+        for(std::size_t c = 1 ; c < chunks ; ++c)
+        {
+            ret = join(ret, partials[c]);
+        }
+
+        return ret;
+    }
+
+    /// Process-wide pool used by launchParallelFor & co.
+    static ThreadPool& global();
+
+    /**
+     * Recreate the global pool with a given number of workers (0 = default).
+     * Must not be called while the global pool is running work.
+     * The default can also be set with the VISIONCORE_NUM_THREADS environment variable
+     * (total threads, including the caller).
+     */
+    static void setGlobalWorkers(std::size_t workers);
+
+private:
+    struct Queue
+    {
+        std::mutex              mutex;
+        std::deque<TaskT>       tasks;
+    };
+
+    std::size_t chunkSize(std::size_t count, std::size_t grain) const
+    {
+        // a few chunks per thread for load balancing, but never below the grain
+        const std::size_t balanced = (count + concurrency() * 4 - 1) / (concurrency() * 4);
+        return std::max<std::size_t>(std::max<std::size_t>(grain, balanced), 1);
+    }
+
+    void runChunks(std::size_t chunks, const std::function<void(std::size_t)>& fn);
+
+    bool popTask(std::size_t self, TaskT& task);
+    void workerLoop(std::size_t idx);
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread>            threads;
+    std::mutex                          sleep_mutex;
+    std::condition_variable             sleep_cv;
+    std::atomic<std::size_t>            pending;
+    std::atomic<std::size_t>            next_queue;
+    std::atomic<bool>                   finish;
+};
+
+}
+
+#endif // VISIONCORE_THREAD_POOL_HPP
@@ -0,0 +1,142 @@
+/**
+ * ****************************************************************************
+ * Copyright (c) 2017, Robert Lukierski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ****************************************************************************
+ * Hot-path tracing, exported as Chrome trace JSON (chrome://tracing, Perfetto).
+ * ****************************************************************************
+ */
+
+#ifndef VISIONCORE_TRACE_HPP
+#define VISIONCORE_TRACE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <VisionCore/PerfCounters.hpp>
+
+/**
+ * Tracing is compiled in only with VISIONCORE_HAVE_TRACE (CMake USE_TRACE), otherwise
+ * the VISIONCORE_TRACE_* macros expand to nothing. 
+ * 
+ * Public CPU operations open a named scope, parallel launches record one "kernel" event 
+ * per chunk with the name of the enclosing scope, so a trace shows per-kernel, per-thread timelines.
+ */
+
+namespace vc
+{
+    
+namespace trace
+{
+
+struct Event
+{
+    const char*     name;           // must be a string literal / static
+    const char*     category;       // "op" for public operations, "kernel" for launch chunks
+    uint64_t        start_ns;       // since the first trace call
+    uint64_t        duration_ns;
+    uint32_t        thread_id;      // small sequential id
+    uint32_t        width;          // image dimensions or items in a chunk
+    uint32_t        height;
+    uint64_t        bytes;          // bytes touched, 0 if unknown
+    perf::Sample    counters;       // "op" events only, see setHardwareCounters
+};
+
+/// Runtime switch, enabled by default when compiled in.
+void setEnabled(bool enabled);
+bool isEnabled();
+
+/**
+ * Attach process wide hardware counter deltas (see PerfCounters.hpp) to "op" events, off by default.
+ * Returns true if at least one counter is available. Counts of operations running concurrently
+ * on different threads overlap.
+ */
+bool setHardwareCounters(bool enabled);
+bool hardwareCounters();
+
+/// Current time in nanoseconds since the trace epoch.
+uint64_t now();
+
+void record(const Event& ev);
+
+/// Drops all recorded events.
+void clear();
+
+/// Snapshot of all recorded events from all threads, ordered by start time.
+std::vector<Event> events();
+
+/// Name of the innermost open scope on this thread, "launch" if none.
+const char* currentScope();
+
+void writeChromeTrace(std::ostream& os);
+bool saveChromeTrace(const std::string& filename);
+
+/**
+ * Records [construction, destruction) as one event.
+ */
+class Scope
+{
+public:
+    explicit Scope(const char* name, const char* category = "op", 
+                   std::size_t width = 0, std::size_t height = 0, std::size_t bytes = 0);
+    ~Scope();
+    
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+private:
+    Event           ev;
+    const char*     parent;
+    bool            active;
+    bool            counted;
+};
+
+}
+
+}
+
+#define VISIONCORE_TRACE_CONCAT_IMPL(a,b) a##b
+#define VISIONCORE_TRACE_CONCAT(a,b) VISIONCORE_TRACE_CONCAT_IMPL(a,b)
+
+#ifdef VISIONCORE_HAVE_TRACE
+#define VISIONCORE_TRACE_SCOPE(name) \
+    ::vc::trace::Scope VISIONCORE_TRACE_CONCAT(vc_trace_scope_, __LINE__)(name)
+#define VISIONCORE_TRACE_SCOPE_1D(name, size, bytes) \
+    ::vc::trace::Scope VISIONCORE_TRACE_CONCAT(vc_trace_scope_, __LINE__)(name, "op", size, 1, bytes)
+#define VISIONCORE_TRACE_SCOPE_2D(name, width, height, bytes) \
+    ::vc::trace::Scope VISIONCORE_TRACE_CONCAT(vc_trace_scope_, __LINE__)(name, "op", width, height, bytes)
+#else // VISIONCORE_HAVE_TRACE
+#define VISIONCORE_TRACE_SCOPE(name)
+#define VISIONCORE_TRACE_SCOPE_1D(name, size, bytes)
+#define VISIONCORE_TRACE_SCOPE_2D(name, width, height, bytes)
+#endif // VISIONCORE_HAVE_TRACE
+
+#endif // VISIONCORE_TRACE_HPP
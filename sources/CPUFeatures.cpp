@@ -0,0 +1,177 @@
+/**
+ * ****************************************************************************
+ * Copyright (c) 2017, Robert Lukierski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * ****************************************************************************
+ * Runtime CPU feature detection for kernel dispatch.
+ * ****************************************************************************
+ */
+
+#include <VisionCore/CPUFeatures.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define VISIONCORE_CPU_X86
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else // _MSC_VER
+#include <cpuid.h>
+#endif // _MSC_VER
+#endif // x86
+
+namespace
+{
+#ifdef VISIONCORE_CPU_X86
+    struct CPUIDRegs
+    {
+        uint32_t eax, ebx, ecx, edx;
+    };
+    
+    CPUIDRegs cpuid(uint32_t leaf, uint32_t subleaf)
+    {
+        CPUIDRegs r;
+#if defined(_MSC_VER)
+        int regs[4];
+        __cpuidex(regs, int(leaf), int(subleaf));
+        r.eax = regs[0]; r.ebx = regs[1]; r.ecx = regs[2]; r.edx = regs[3];
+#else // _MSC_VER
+        __cpuid_count(leaf, subleaf, r.eax, r.ebx, r.ecx, r.edx);
+#endif // _MSC_VER
+        return r;
+    }
+    
+    /// Register state the OS saves on context switches (XCR0), only valid with OSXSAVE
+    uint64_t xgetbv0()
+    {
+#if defined(_MSC_VER)
+        return _xgetbv(0);
+#else // _MSC_VER
+        uint32_t eax, edx;
+        __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+        return (uint64_t(edx) << 32) | eax;
+#endif // _MSC_VER
+    }
+    
+    inline bool hasBits(uint32_t reg, uint32_t bits) { return (reg & bits) == bits; }
+#endif // VISIONCORE_CPU_X86
+    
+    vc::CPULevel detectLevel()
+    {
+#ifdef VISIONCORE_CPU_X86
+        const uint32_t max_leaf = cpuid(0, 0).eax;
+        if(max_leaf < 1) { return vc::CPULevel::Generic; }
+        
+        const CPUIDRegs l1 = cpuid(1, 0);
+        const CPUIDRegs l7 = max_leaf >= 7 ? cpuid(7, 0) : CPUIDRegs{0, 0, 0, 0};
+        
+        // ECX of leaf 1: SSSE3, SSE4.1, SSE4.2, POPCNT
+        if(!hasBits(l1.ecx, (1u << 9) | (1u << 19) | (1u << 20) | (1u << 23))) { return vc::CPULevel::Generic; }
+        
+        // ECX of leaf 1: FMA, OSXSAVE, AVX; EBX of leaf 7: AVX2; the OS has to save XMM & YMM
+        if(!hasBits(l1.ecx, (1u << 12) | (1u << 27) | (1u << 28)) || !hasBits(l7.ebx, 1u << 5)) { return vc::CPULevel::SSE42; }
+        const uint64_t xcr0 = xgetbv0();
+        if((xcr0 & 0x6) != 0x6) { return vc::CPULevel::SSE42; }
+        
+        // EBX of leaf 7: AVX-512 F, DQ, BW, VL; the OS has to save opmask & ZMM as well
+        if(!hasBits(l7.ebx, (1u << 16) | (1u << 17) | (1u << 30) | (1u << 31)) || (xcr0 & 0xE0) != 0xE0) { return vc::CPULevel::AVX2; }
+        
+        return vc::CPULevel::AVX512;
+#else // VISIONCORE_CPU_X86
+        return vc::CPULevel::Generic;
+#endif // VISIONCORE_CPU_X86
+    }
+    
+    vc::CPULevel defaultLevel()
+    {
+        const vc::CPULevel detected = vc::detectCPULevel();
+        vc::CPULevel requested = detected;
+        
+        const char* env = std::getenv("VISIONCORE_CPU_LEVEL");
+        if(env != nullptr)
+        {
+            if(std::strcmp(env, "generic") == 0) { requested = vc::CPULevel::Generic; }
+            if(std::strcmp(env, "sse4.2") == 0) { requested = vc::CPULevel::SSE42; }
+            if(std::strcmp(env, "avx2") == 0) { requested = vc::CPULevel::AVX2; }
+            if(std::strcmp(env, "avx512") == 0) { requested = vc::CPULevel::AVX512; }
+        }
+        
+        // never above what the CPU can run
+        return requested < detected ? requested : detected;
+    }
+    
+    std::atomic<vc::CPULevel>& currentLevel()
+    {
+        static std::atomic<vc::CPULevel> level(defaultLevel());
+        return level;
+    }
+}
+
+vc::CPULevel vc::detectCPULevel()
+{
+    static const vc::CPULevel detected = detectLevel();
+    return detected;
+}
+
+vc::CPULevel vc::getCPULevel()
+{
+    return currentLevel().load(std::memory_order_relaxed);
+}
+
+void vc::setCPULevel(vc::CPULevel level)
+{
+    if(!isCPULevelAvailable(level))
+    {
+        throw std::runtime_error("CPU level not supported by this CPU");
+    }
+    
+    currentLevel().store(level);
+}
+
+bool vc::isCPULevelAvailable(vc::CPULevel level)
+{
+    return level <= detectCPULevel();
+}
+
+const char* vc::cpuLevelName(vc::CPULevel level)
+{
+    switch(level)
+    {
+        case vc::CPULevel::Generic: return "generic";
+        case vc::CPULevel::SSE42: return "sse4.2";
+        case vc::CPULevel::AVX2: return "avx2";
+        case vc::CPULevel::AVX512: return "avx512";
+    }
+    
+    return "unknown";
+}
@@ -0,0 +1,327 @@
+/**
+ * ****************************************************************************
+ * Copyright (c) 2017, Robert Lukierski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * ****************************************************************************
+ * Execution contexts - where and how CPU launches run.
+ * ****************************************************************************
+ */
+
+#include <VisionCore/ExecutionContext.hpp>
+#include <VisionCore/ThreadPool.hpp>
+
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif // __linux__
+
+#ifdef VISIONCORE_HAVE_TBB
+#include <tbb/task_arena.h>
+#include <tbb/task_scheduler_observer.h>
+#if __has_include(<tbb/version.h>) // oneTBB, classic TBB defines the version in tbb_stddef.h
+#include <tbb/version.h>
+#endif
+#endif // VISIONCORE_HAVE_TBB
+
+namespace
+{
+    thread_local vc::ExecutionContext* tl_current = nullptr;
+    
+#ifdef __linux__
+    typedef cpu_set_t CPUMaskT;
+    
+#ifdef VISIONCORE_HAVE_TBB
+    bool getThreadAffinity(CPUMaskT& mask)
+    {
+        CPU_ZERO(&mask);
+        return pthread_getaffinity_np(pthread_self(), sizeof(mask), &mask) == 0;
+    }
+#endif // VISIONCORE_HAVE_TBB
+    
+    void setThreadAffinity(const CPUMaskT& mask)
+    {
+        pthread_setaffinity_np(pthread_self(), sizeof(mask), &mask);
+    }
+    
+    void setThreadAffinity(const std::vector<int>& cpus)
+    {
+        if(cpus.empty()) { return; }
+        
+        CPUMaskT mask;
+        CPU_ZERO(&mask);
+        for(int c : cpus)
+        {
+            if(c >= 0 && c < CPU_SETSIZE) { CPU_SET(c, &mask); }
+        }
+        
+        setThreadAffinity(mask);
+    }
+    
+    void setThreadPriority(vc::ExecutionContext::Priority prio)
+    {
+        int nice_value = 0;
+        switch(prio)
+        {
+            case vc::ExecutionContext::Priority::Low: nice_value = 10; break;
+            case vc::ExecutionContext::Priority::High: nice_value = -10; break;
+            default: return;
+        }
+        
+        // per-thread on Linux, needs CAP_SYS_NICE to go below 0
+        setpriority(PRIO_PROCESS, (id_t)syscall(SYS_gettid), nice_value);
+    }
+#else // __linux__
+    void setThreadAffinity(const std::vector<int>&) { }
+    void setThreadPriority(vc::ExecutionContext::Priority) { }
+#endif // __linux__
+}
+
+#ifdef VISIONCORE_HAVE_TBB
+#if TBB_INTERFACE_VERSION >= 12000
+namespace
+{
+/**
+ * Threads joining the arena get the context as current and the CPU mask,
+ * the previous state is restored on leaving, as TBB workers are shared between arenas.
+ * A worker can enter another arena from inside one, so the saved states form a stack.
+ */
+class ArenaObserver : public tbb::task_scheduler_observer
+{
+public:
+    ArenaObserver(tbb::task_arena& a, vc::ExecutionContext* c) : tbb::task_scheduler_observer(a), ctx(c)
+    {
+        observe(true);
+    }
+    
+    virtual ~ArenaObserver()
+    {
+        observe(false);
+    }
+    
+    virtual void on_scheduler_entry(bool is_worker) override
+    {
+        if(!is_worker) { return; }
+        
+        Saved saved;
+        saved.previous = tl_current;
+#ifdef __linux__
+        saved.mask_saved = !ctx->affinity().empty() && getThreadAffinity(saved.mask);
+        if(saved.mask_saved) { setThreadAffinity(ctx->affinity()); }
+#endif // __linux__
+        tl_saved.push_back(saved);
+        tl_current = ctx;
+    }
+    
+    virtual void on_scheduler_exit(bool is_worker) override
+    {
+        if(!is_worker || tl_saved.empty()) { return; }
+        
+        const Saved& saved = tl_saved.back();
+        tl_current = saved.previous;
+#ifdef __linux__
+        if(saved.mask_saved) { setThreadAffinity(saved.mask); }
+#endif // __linux__
+        tl_saved.pop_back();
+    }
+    
+private:
+    struct Saved
+    {
+        vc::ExecutionContext*   previous;
+#ifdef __linux__
+        bool                    mask_saved;
+        CPUMaskT                mask;
+#endif // __linux__
+    };
+    
+    vc::ExecutionContext* ctx;
+    static thread_local std::vector<Saved> tl_saved;
+};
+
+thread_local std::vector<ArenaObserver::Saved> ArenaObserver::tl_saved;
+}
+#endif // TBB_INTERFACE_VERSION >= 12000
+
+struct vc::ExecutionContext::ArenaData
+{
+    ArenaData(std::size_t max_concurrency, vc::ExecutionContext::Priority prio, vc::ExecutionContext* ctx) : 
+#if TBB_INTERFACE_VERSION >= 12000
+        arena(max_concurrency > 0 ? (int)max_concurrency : tbb::task_arena::automatic, 1, 
+              prio == vc::ExecutionContext::Priority::Low ? tbb::task_arena::priority::low :
+              (prio == vc::ExecutionContext::Priority::High ? tbb::task_arena::priority::high : 
+                                                              tbb::task_arena::priority::normal)),
+        observer(arena, ctx)
+#else // TBB_INTERFACE_VERSION >= 12000
+        arena(max_concurrency > 0 ? (int)max_concurrency : tbb::task_arena::automatic)
+#endif // TBB_INTERFACE_VERSION >= 12000
+    {
+        
+    }
+    
+    tbb::task_arena     arena;
+#if TBB_INTERFACE_VERSION >= 12000
+    ArenaObserver       observer;
+#endif // TBB_INTERFACE_VERSION >= 12000
+};
+#else // VISIONCORE_HAVE_TBB
+struct vc::ExecutionContext::ArenaData { };
+#endif // VISIONCORE_HAVE_TBB
+
+struct vc::ExecutionContext::AsyncData
+{
+    std::mutex              mutex;
+    std::condition_variable cv;
+    std::size_t             outstanding = 0;
+};
+
+vc::ExecutionContext::ExecutionContext(std::size_t max_concurrency, const std::vector<int>& affinity,
+                                       Priority p, LaunchBackend lb) : lbackend(lb), prio(p), cpus(affinity), 
+                                                                       async(new AsyncData())
+{
+    if(!isLaunchBackendAvailable(lbackend))
+    {
+        throw std::runtime_error("Launch backend not available in this build");
+    }
+    
+    if(max_concurrency == 0)
+    {
+        max_concurrency = cpus.size();
+    }
+    
+    switch(lbackend)
+    {
+#ifdef VISIONCORE_HAVE_TBB
+        case LaunchBackend::TBB:
+            arena.reset(new ArenaData(max_concurrency, prio, this));
+            break;
+#endif // VISIONCORE_HAVE_TBB
+        case LaunchBackend::ThreadPool:
+            if(max_concurrency != 1)
+            {
+                tpool.reset(new ThreadPool(max_concurrency > 1 ? max_concurrency - 1 : 0, 
+                                           [this](std::size_t) { initThread(); }));
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+vc::ExecutionContext::~ExecutionContext()
+{
+    // asynchronous launches still waiting for dependencies or running reference this
+    {
+        std::unique_lock<std::mutex> lock(async->mutex);
+        async->cv.wait(lock, [&]() { return async->outstanding == 0; });
+    }
+    
+    // join workers first, they might still reference this
+    tpool.reset();
+    arena.reset();
+}
+
+std::size_t vc::ExecutionContext::concurrency() const
+{
+#ifdef VISIONCORE_HAVE_TBB
+    if(arena)
+    {
+        return (std::size_t)arena->arena.max_concurrency();
+    }
+#endif // VISIONCORE_HAVE_TBB
+    
+    if(tpool)
+    {
+        return tpool->concurrency();
+    }
+    
+    return 1;
+}
+
+void vc::ExecutionContext::execute(const std::function<void()>& fn)
+{
+    ExecutionContextScope scope(this);
+    
+#ifdef VISIONCORE_HAVE_TBB
+    if(arena)
+    {
+        arena->arena.execute(fn);
+        return;
+    }
+#endif // VISIONCORE_HAVE_TBB
+    
+    fn();
+}
+
+vc::ExecutionContext* vc::ExecutionContext::current()
+{
+    return tl_current;
+}
+
+void vc::ExecutionContext::initThread()
+{
+    tl_current = this;
+    setThreadAffinity(cpus);
+    setThreadPriority(prio);
+}
+
+vc::ExecutionContext::AsyncToken::AsyncToken(ExecutionContext* c) : ctx(c)
+{
+    if(ctx == nullptr) { return; }
+    
+    std::lock_guard<std::mutex> lock(ctx->async->mutex);
+    ++ctx->async->outstanding;
+}
+
+vc::ExecutionContext::AsyncToken::~AsyncToken()
+{
+    if(ctx == nullptr) { return; }
+    
+    std::lock_guard<std::mutex> lock(ctx->async->mutex);
+    if(--ctx->async->outstanding == 0)
+    {
+        ctx->async->cv.notify_all();
+    }
+}
+
+vc::ExecutionContextScope::ExecutionContextScope(ExecutionContext* ctx) : previous(tl_current)
+{
+    tl_current = ctx;
+}
+
+vc::ExecutionContextScope::~ExecutionContextScope()
+{
+    tl_current = previous;
+}
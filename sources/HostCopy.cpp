@@ -0,0 +1,323 @@
+/**
+ * ****************************************************************************
+ * Copyright (c) 2017, Robert Lukierski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * ****************************************************************************
+ * Parallel, pitch aware host memory copies.
+ * ****************************************************************************
+ */
+
+#include <VisionCore/HostCopy.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+#include <VisionCore/LaunchUtils.hpp>
+#include <VisionCore/MemoryStats.hpp>
+#include <VisionCore/Trace.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define VISIONCORE_HOST_COPY_STREAMING
+#endif // SSE2
+
+namespace
+{
+    std::atomic<std::size_t> parallel_threshold(std::size_t(1) << 20);
+    std::atomic<std::size_t> streaming_threshold(std::size_t(16) << 20);
+    std::atomic<std::size_t> chunk_bytes(std::size_t(256) << 10);
+    
+    // narrower rows gain nothing from streaming, the stores can't fill a line
+    static constexpr std::size_t MinStreamingWidth = 256;
+    
+    inline void copyStreaming(char* dst, const char* src, std::size_t count)
+    {
+#ifdef VISIONCORE_HOST_COPY_STREAMING
+        // head until the destination is 16 byte aligned
+        const std::size_t head = std::min(count, (16 - ((std::uintptr_t)dst & 15)) & 15);
+        std::memcpy(dst, src, head);
+        dst += head;
+        src += head;
+        count -= head;
+        
+        __m128i* d = reinterpret_cast<__m128i*>(dst);
+        const __m128i* s = reinterpret_cast<const __m128i*>(src);
+        
+        for( ; count >= 64 ; count -= 64, d += 4, s += 4)
+        {
+            const __m128i v0 = _mm_loadu_si128(s + 0);
+            const __m128i v1 = _mm_loadu_si128(s + 1);
+            const __m128i v2 = _mm_loadu_si128(s + 2);
+            const __m128i v3 = _mm_loadu_si128(s + 3);
+            _mm_stream_si128(d + 0, v0);
+            _mm_stream_si128(d + 1, v1);
+            _mm_stream_si128(d + 2, v2);
+            _mm_stream_si128(d + 3, v3);
+        }
+        
+        for( ; count >= 16 ; count -= 16, ++d, ++s)
+        {
+            _mm_stream_si128(d, _mm_loadu_si128(s));
+        }
+        
+        std::memcpy(d, s, count);
+#else // VISIONCORE_HOST_COPY_STREAMING
+        std::memcpy(dst, src, count);
+#endif // VISIONCORE_HOST_COPY_STREAMING
+    }
+    
+    inline void streamingFence()
+    {
+#ifdef VISIONCORE_HOST_COPY_STREAMING
+        // streaming stores are weakly ordered, publish them before the chunk counts as done
+        _mm_sfence();
+#endif // VISIONCORE_HOST_COPY_STREAMING
+    }
+    
+    inline bool useStreaming(vc::CopyHint hint, std::size_t width, std::size_t total)
+    {
+        if(width < MinStreamingWidth) { return false; }
+        
+        switch(hint)
+        {
+            case vc::CopyHint::Streaming: return true;
+            case vc::CopyHint::Cached: return false;
+            default: return total >= streaming_threshold.load(std::memory_order_relaxed);
+        }
+    }
+    
+    /**
+     * Runs body(begin, end) over items of item_bytes each, in parallel if the copy is large enough.
+     */
+    template<typename RangeFunction>
+    inline void dispatch(std::size_t items, std::size_t item_bytes, RangeFunction body)
+    {
+        if(items == 0) { return; }
+        
+        if(items == 1 || items * item_bytes < parallel_threshold.load(std::memory_order_relaxed))
+        {
+            body(std::size_t(0), items);
+            return;
+        }
+        
+        const std::size_t grain = std::max<std::size_t>(chunk_bytes.load(std::memory_order_relaxed) / std::max<std::size_t>(item_bytes, 1), 1);
+        vc::detail::launchRange(0, items, grain, body);
+    }
+    
+    /**
+     * Rows r = z * height + y of a 3D region (depth = 1 for 2D).
+     */
+    template<bool Streaming>
+    inline void copyRows(char* dst, std::size_t dpitch, std::size_t dplane, 
+                         const char* src, std::size_t spitch, std::size_t splane,
+                         std::size_t width, std::size_t height, std::size_t row_begin, std::size_t row_end)
+    {
+        for(std::size_t r = row_begin ; r < row_end ; ++r)
+        {
+            const std::size_t z = r / height, y = r % height;
+            char* d = dst + z * dplane + y * dpitch;
+            const char* s = src + z * splane + y * spitch;
+            
+            if(Streaming)
+            {
+                copyStreaming(d, s, width);
+            }
+            else
+            {
+                std::memcpy(d, s, width);
+            }
+        }
+        
+        if(Streaming) { streamingFence(); }
+    }
+    
+    void copyPitched(char* dst, std::size_t dpitch, std::size_t dplane, 
+                     const char* src, std::size_t spitch, std::size_t splane,
+                     std::size_t width, std::size_t height, std::size_t depth, vc::CopyHint hint)
+    {
+        const std::size_t rows = height * depth;
+        
+        if(useStreaming(hint, width, width * rows))
+        {
+            dispatch(rows, width, [&](std::size_t rb, std::size_t re)
+            {
+                copyRows<true>(dst, dpitch, dplane, src, spitch, splane, width, height, rb, re);
+            });
+        }
+        else
+        {
+            dispatch(rows, width, [&](std::size_t rb, std::size_t re)
+            {
+                copyRows<false>(dst, dpitch, dplane, src, spitch, splane, width, height, rb, re);
+            });
+        }
+    }
+    
+    /**
+     * One row: the first element, then the filled part copied onto the rest, doubling each time.
+     */
+    inline void fillRow(char* dst, const void* value, std::size_t value_bytes, std::size_t width)
+    {
+        const std::size_t row = width * value_bytes;
+        if(row == 0) { return; }
+        
+        std::memcpy(dst, value, value_bytes);
+        
+        for(std::size_t done = value_bytes ; done < row ; done *= 2)
+        {
+            std::memcpy(dst + done, dst, std::min(done, row - done));
+        }
+    }
+    
+    void fillPitched(char* dst, std::size_t pitch, std::size_t plane_pitch, const void* value, std::size_t value_bytes, 
+                     std::size_t width, std::size_t height, std::size_t depth)
+    {
+        dispatch(height * depth, width * value_bytes, [&](std::size_t rb, std::size_t re)
+        {
+            for(std::size_t r = rb ; r < re ; ++r)
+            {
+                fillRow(dst + (r / height) * plane_pitch + (r % height) * pitch, value, value_bytes, width);
+            }
+        });
+    }
+}
+
+vc::HostCopySettings vc::getHostCopySettings()
+{
+    HostCopySettings ret;
+    ret.parallel_threshold = parallel_threshold.load();
+    ret.streaming_threshold = streaming_threshold.load();
+    ret.chunk_bytes = chunk_bytes.load();
+    return ret;
+}
+
+void vc::setHostCopySettings(const HostCopySettings& settings)
+{
+    parallel_threshold = settings.parallel_threshold;
+    streaming_threshold = settings.streaming_threshold;
+    chunk_bytes = std::max<std::size_t>(settings.chunk_bytes, 1);
+}
+
+void vc::hostCopy(void* dst, const void* src, std::size_t count, CopyHint hint)
+{
+    if(count == 0) { return; }
+    
+    VISIONCORE_TRACE_SCOPE_1D("hostCopy", count, 2 * count);
+    
+    // split into blocks, presented as rows of a 2D copy
+    const std::size_t block = std::min(count, chunk_bytes.load(std::memory_order_relaxed));
+    const std::size_t blocks = count / block;
+    const std::size_t tail = count - blocks * block;
+    
+    copyPitched(static_cast<char*>(dst), block, 0, static_cast<const char*>(src), block, 0, block, blocks, 1, 
+                useStreaming(hint, block, count) ? CopyHint::Streaming : CopyHint::Cached);
+    
+    if(tail > 0)
+    {
+        std::memcpy(static_cast<char*>(dst) + blocks * block, static_cast<const char*>(src) + blocks * block, tail);
+    }
+    
+    memstats::recordTransfer(MemoryTarget::Host, MemoryTarget::Host, count);
+}
+
+void vc::hostCopy2D(void* dst, std::size_t dpitch, const void* src, std::size_t spitch, 
+                    std::size_t width, std::size_t height, CopyHint hint)
+{
+    if(width == 0 || height == 0) { return; }
+    
+    if(dpitch == width && spitch == width)
+    {
+        hostCopy(dst, src, width * height, hint);
+        return;
+    }
+    
+    VISIONCORE_TRACE_SCOPE_2D("hostCopy2D", width, height, 2 * width * height);
+    
+    copyPitched(static_cast<char*>(dst), dpitch, 0, static_cast<const char*>(src), spitch, 0, width, height, 1, hint);
+    
+    memstats::recordTransfer(MemoryTarget::Host, MemoryTarget::Host, width * height);
+}
+
+void vc::hostCopy3D(void* dst, std::size_t dpitch, std::size_t dplane, 
+                    const void* src, std::size_t spitch, std::size_t splane,
+                    std::size_t width, std::size_t height, std::size_t depth, CopyHint hint)
+{
+    if(width == 0 || height == 0 || depth == 0) { return; }
+    
+    if(dplane == dpitch * height && splane == spitch * height)
+    {
+        hostCopy2D(dst, dpitch, src, spitch, width, height * depth, hint);
+        return;
+    }
+    
+    VISIONCORE_TRACE_SCOPE_2D("hostCopy3D", width, height * depth, 2 * width * height * depth);
+    
+    copyPitched(static_cast<char*>(dst), dpitch, dplane, static_cast<const char*>(src), spitch, splane, width, height, depth, hint);
+    
+    memstats::recordTransfer(MemoryTarget::Host, MemoryTarget::Host, width * height * depth);
+}
+
+void vc::hostMemset(void* dst, int value, std::size_t count)
+{
+    if(count == 0) { return; }
+    
+    VISIONCORE_TRACE_SCOPE_1D("hostMemset", count, count);
+    
+    const std::size_t block = std::min(count, chunk_bytes.load(std::memory_order_relaxed));
+    const std::size_t blocks = (count + block - 1) / block;
+    char* d = static_cast<char*>(dst);
+    
+    dispatch(blocks, block, [&](std::size_t bb, std::size_t be)
+    {
+        const std::size_t begin = bb * block;
+        std::memset(d + begin, value, std::min(be * block, count) - begin);
+    });
+}
+
+void vc::hostFill2D(void* dst, std::size_t pitch, const void* value, std::size_t value_bytes, 
+                    std::size_t width, std::size_t height)
+{
+    if(width == 0 || height == 0) { return; }
+    
+    VISIONCORE_TRACE_SCOPE_2D("hostFill2D", width, height, width * height * value_bytes);
+    
+    fillPitched(static_cast<char*>(dst), pitch, 0, value, value_bytes, width, height, 1);
+}
+
+void vc::hostFill3D(void* dst, std::size_t pitch, std::size_t plane_pitch, const void* value, std::size_t value_bytes, 
+                    std::size_t width, std::size_t height, std::size_t depth)
+{
+    if(width == 0 || height == 0 || depth == 0) { return; }
+    
+    VISIONCORE_TRACE_SCOPE_2D("hostFill3D", width, height * depth, width * height * depth * value_bytes);
+    
+    fillPitched(static_cast<char*>(dst), pitch, plane_pitch, value, value_bytes, width, height, depth);
+}
@@ -0,0 +1,820 @@
+/**
+ * ****************************************************************************
+ * Copyright (c) 2017, Robert Lukierski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * ****************************************************************************
+ * Host memory allocation with an optional recycling pool.
+ * ****************************************************************************
+ */
+
+#include <VisionCore/HostMemory.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <malloc.h>
+#endif // _MSC_VER
+
+#include <map>
+
+#if (defined(__unix__) || defined(__APPLE__)) && !defined(VISIONCORE_HAVE_CUDA)
+#include <sys/mman.h>
+#include <unistd.h>
+#define VISIONCORE_HOST_MMAP
+#endif
+
+#include <VisionCore/Platform.hpp>
+#include <VisionCore/HostCopy.hpp>
+#include <VisionCore/MemoryStats.hpp>
+
+#ifdef VISIONCORE_HAVE_NUMA
+#include <numa.h>
+#endif // VISIONCORE_HAVE_NUMA
+
+namespace
+{
+    static constexpr uint64_t BlockMagic = 0x56434d454d424c4bULL;
+    
+    /**
+     * Sits right before the user pointer.
+     */
+    struct BlockHeader
+    {
+        uint64_t        magic;
+        void*           base;           // what the system gave us
+        std::size_t     size;           // usable bytes
+        std::size_t     map_length;     // whole mapping, if mapped
+        uint32_t        alignment;
+        int32_t         size_class;     // NotPooled, Mapped or the class
+        uint32_t        label;          // memstats label of the current owner
+    };
+    
+    static constexpr int32_t NotPooled = -1;
+    static constexpr int32_t Mapped = -2;
+    
+    static constexpr std::size_t MinClassBytes = 256;
+    static constexpr std::size_t SizeClasses = 64 * 4;
+    static constexpr std::size_t ThreadCacheBlocks = 2;     // per size class
+    
+    /**
+     * 4 classes per power of two: (2^k, 2^k * 1.25], ..., (2^k * 1.75, 2^(k+1)].
+     */
+    inline int sizeClass(std::size_t bytes, std::size_t& class_bytes)
+    {
+        bytes = std::max(bytes, MinClassBytes);
+        
+        int msb = 0;
+        for(std::size_t v = bytes - 1 ; v > 1 ; v >>= 1) { ++msb; }
+        
+        const std::size_t step = std::size_t(1) << (msb - 2);
+        class_bytes = (bytes + step - 1) / step * step;
+        
+        return msb * 4 + int(class_bytes / step - 4);
+    }
+    
+    inline BlockHeader* headerOf(const void* ptr)
+    {
+        BlockHeader* h = reinterpret_cast<BlockHeader*>(const_cast<char*>(static_cast<const char*>(ptr)) - sizeof(BlockHeader));
+        assert(h->magic == BlockMagic && "Not a hostAllocate block");
+        return h;
+    }
+    
+    inline void* userOf(BlockHeader* h)
+    {
+        return reinterpret_cast<char*>(h) + sizeof(BlockHeader);
+    }
+    
+    struct Counters
+    {
+        Counters() : cached_bytes(0), cached_blocks(0), peak_cached_bytes(0), hits(0), misses(0), 
+                     system_allocations(0), system_frees(0) { }
+        
+        std::atomic<std::size_t>    cached_bytes;
+        std::atomic<std::size_t>    cached_blocks;
+        std::atomic<std::size_t>    peak_cached_bytes;
+        std::atomic<uint64_t>       hits;
+        std::atomic<uint64_t>       misses;
+        std::atomic<uint64_t>       system_allocations;
+        std::atomic<uint64_t>       system_frees;
+    };
+    
+    typedef std::array<std::vector<BlockHeader*>, SizeClasses> FreeListsT;
+    
+    struct ThreadCache;
+    
+    struct PoolState
+    {
+        PoolState() : enabled(false), high_water_mark(vc::HostMemoryPool::DefaultHighWaterMark)
+        {
+            const char* env = std::getenv("VISIONCORE_HOST_POOL");
+            if(env != nullptr)
+            {
+                const std::size_t mb = std::strtoull(env, nullptr, 10);
+                enabled = mb > 0;
+                if(mb > 0) { high_water_mark = mb << 20; }
+            }
+        }
+        
+        std::atomic<bool>           enabled;
+        std::atomic<std::size_t>    high_water_mark;
+        Counters                    counters;
+        std::mutex                  mutex;          // shared lists
+        FreeListsT                  shared;
+        std::mutex                  caches_mutex;   // registry of live thread caches, for trim()
+        std::vector<ThreadCache*>   caches;
+    };
+    
+    PoolState& pool()
+    {
+        // never destroyed, blocks may be freed during static destruction
+        static PoolState* state = new PoolState();
+        return *state;
+    }
+    
+    void* systemAllocate(std::size_t bytes, std::size_t alignment, std::size_t& usable, BlockHeader*& header)
+    {
+        // header padding keeps the user pointer aligned
+        const std::size_t hsize = (sizeof(BlockHeader) + alignment - 1) / alignment * alignment;
+        void* base = nullptr;
+        char* user = nullptr;
+        
+#ifdef VISIONCORE_HAVE_CUDA
+        const cudaError err = cudaMallocHost(&base, hsize + bytes + alignment);
+        if(err != cudaSuccess) { throw vc::CUDAException(err, "Unable to cudaMallocHost"); }
+        user = reinterpret_cast<char*>((reinterpret_cast<std::uintptr_t>(base) + hsize + alignment - 1) / alignment * alignment);
+#elif defined(_MSC_VER)
+        base = _aligned_malloc(hsize + bytes, alignment);
+        if(base == nullptr) { throw std::bad_alloc(); }
+        user = static_cast<char*>(base) + hsize;
+#else
+        if(posix_memalign(&base, alignment, hsize + bytes) != 0) { throw std::bad_alloc(); }
+        user = static_cast<char*>(base) + hsize;
+#endif
+        
+        pool().counters.system_allocations++;
+        
+        header = reinterpret_cast<BlockHeader*>(user - sizeof(BlockHeader));
+        header->magic = BlockMagic;
+        header->base = base;
+        header->size = bytes;
+        header->map_length = 0;
+        header->alignment = (uint32_t)alignment;
+        header->size_class = NotPooled;
+        usable = bytes;
+        return user;
+    }
+    
+    void systemFree(BlockHeader* h) noexcept
+    {
+        void* base = h->base;
+        h->magic = 0;
+        
+#ifdef VISIONCORE_HAVE_CUDA
+        cudaFreeHost(base);
+#elif defined(_MSC_VER)
+        _aligned_free(base);
+#else
+        free(base);
+#endif
+        
+        pool().counters.system_frees++;
+    }
+    
+    BlockHeader* popBlock(std::vector<BlockHeader*>& list, std::size_t alignment)
+    {
+        for(std::size_t i = list.size() ; i > 0 ; --i)
+        {
+            BlockHeader* h = list[i - 1];
+            if(h->alignment >= alignment)
+            {
+                list.erase(list.begin() + (i - 1));
+                return h;
+            }
+        }
+        
+        return nullptr;
+    }
+    
+    void releaseLists(FreeListsT& lists)
+    {
+        Counters& c = pool().counters;
+        
+        for(auto& list : lists)
+        {
+            for(BlockHeader* h : list)
+            {
+                c.cached_bytes -= h->size;
+                c.cached_blocks--;
+                systemFree(h);
+            }
+            
+            list.clear();
+        }
+    }
+    
+    /**
+     * A few blocks per class without touching the shared lock, handed to the shared lists when the thread exits.
+     * Registered in the pool so trim() can empty it from another thread, the own lock is uncontended otherwise.
+     * Lock order: caches_mutex, then a cache's mutex, then the shared one.
+     */
+    struct ThreadCache
+    {
+        ThreadCache()
+        {
+            PoolState& ps = pool();
+            std::lock_guard<std::mutex> lock(ps.caches_mutex);
+            ps.caches.push_back(this);
+        }
+        
+        ~ThreadCache()
+        {
+            PoolState& ps = pool();
+            std::lock_guard<std::mutex> reg_lock(ps.caches_mutex);
+            ps.caches.erase(std::find(ps.caches.begin(), ps.caches.end(), this));
+            
+            std::lock_guard<std::mutex> own_lock(mutex);
+            std::lock_guard<std::mutex> lock(ps.mutex);
+            
+            for(std::size_t c = 0 ; c < SizeClasses ; ++c)
+            {
+                ps.shared[c].insert(ps.shared[c].end(), lists[c].begin(), lists[c].end());
+            }
+        }
+        
+        std::mutex mutex;
+        FreeListsT lists;
+    };
+    
+    ThreadCache& threadCache()
+    {
+        thread_local ThreadCache tc;
+        return tc;
+    }
+    
+    void updatePeak(Counters& c)
+    {
+        const std::size_t now = c.cached_bytes.load(std::memory_order_relaxed);
+        std::size_t peak = c.peak_cached_bytes.load(std::memory_order_relaxed);
+        while(now > peak && !c.peak_cached_bytes.compare_exchange_weak(peak, now)) { }
+    }
+
+    struct MapState
+    {
+        struct Range
+        {
+            std::size_t     bytes;
+            std::size_t     page;           // madvise granularity
+        };
+        
+        MapState() : threshold(0), huge_pages((int)vc::HugePages::Transparent), lazy_commit(true), live(0)
+        {
+            const char* env = std::getenv("VISIONCORE_HOST_MMAP");
+            if(env != nullptr)
+            {
+                threshold = std::strtoull(env, nullptr, 10) << 20;
+            }
+        }
+        
+        std::atomic<std::size_t>            threshold;
+        std::atomic<int>                    huge_pages;
+        std::atomic<bool>                   lazy_commit;
+        std::atomic<std::size_t>            live;       // mapped allocations
+        std::mutex                          mutex;
+        std::map<std::uintptr_t, Range>     ranges;     // user pointer -> range
+    };
+    
+    MapState& maps()
+    {
+        static MapState* state = new MapState();
+        return *state;
+    }
+    
+#ifdef VISIONCORE_HOST_MMAP
+    static constexpr std::size_t HugePageSize = std::size_t(2) << 20;
+    
+    /**
+     * Anonymous mapping of length bytes starting at a multiple of align (over-map & trim).
+     */
+    void* mapAligned(std::size_t length, std::size_t align, int flags)
+    {
+        const std::size_t page = (std::size_t)sysconf(_SC_PAGESIZE);
+        const std::size_t extra = align > page ? align : 0;
+        
+        void* raw = mmap(nullptr, length + extra, PROT_READ | PROT_WRITE, flags, -1, 0);
+        if(raw == MAP_FAILED) { return nullptr; }
+        
+        if(extra == 0) { return raw; }
+        
+        const std::uintptr_t r = reinterpret_cast<std::uintptr_t>(raw);
+        const std::uintptr_t a = (r + align - 1) / align * align;
+        if(a > r) { munmap(raw, a - r); }
+        if(r + extra > a) { munmap(reinterpret_cast<void*>(a + length), r + extra - a); }
+        return reinterpret_cast<void*>(a);
+    }
+    
+    void* mapAllocate(std::size_t bytes, std::size_t alignment, std::size_t& usable, BlockHeader*& header)
+    {
+        MapState& ms = maps();
+        const std::size_t page = (std::size_t)sysconf(_SC_PAGESIZE);
+        const vc::HugePages huge = (vc::HugePages)ms.huge_pages.load();
+        const std::size_t hsize = (sizeof(BlockHeader) + alignment - 1) / alignment * alignment;
+        const int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE;
+        
+        void* base = nullptr;
+        std::size_t length = 0;
+        std::size_t granularity = page;
+        
+#ifdef MAP_HUGETLB
+        if(huge == vc::HugePages::Explicit && alignment <= HugePageSize)
+        {
+            length = (hsize + bytes + HugePageSize - 1) / HugePageSize * HugePageSize;
+            // no MAP_NORESERVE, so a missing huge page reservation fails here instead of SIGBUS on touch
+            base = mapAligned(length, 0, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB);
+            granularity = HugePageSize;
+        }
+#endif // MAP_HUGETLB
+        
+        if(base == nullptr)
+        {
+            granularity = page;
+            const std::size_t align = std::max(huge != vc::HugePages::Off ? HugePageSize : page, alignment);
+            length = (hsize + bytes + page - 1) / page * page;
+            base = mapAligned(length, align, flags);
+            if(base == nullptr) { throw std::bad_alloc(); }
+            
+#ifdef MADV_HUGEPAGE
+            if(huge != vc::HugePages::Off) { madvise(base, length, MADV_HUGEPAGE); }
+#endif // MADV_HUGEPAGE
+        }
+        
+        char* user = static_cast<char*>(base) + hsize;
+        header = reinterpret_cast<BlockHeader*>(user - sizeof(BlockHeader));
+        header->magic = BlockMagic;
+        header->base = base;
+        header->size = bytes;
+        header->map_length = length;
+        header->alignment = (uint32_t)alignment;
+        header->size_class = Mapped;
+        usable = bytes;
+        
+        {
+            std::lock_guard<std::mutex> lock(ms.mutex);
+            ms.ranges[reinterpret_cast<std::uintptr_t>(user)] = MapState::Range{ bytes, granularity };
+        }
+        
+        ms.live++;
+        pool().counters.system_allocations++;
+        return user;
+    }
+    
+    void mapFree(BlockHeader* h) noexcept
+    {
+        MapState& ms = maps();
+        
+        {
+            std::lock_guard<std::mutex> lock(ms.mutex);
+            ms.ranges.erase(reinterpret_cast<std::uintptr_t>(userOf(h)));
+        }
+        
+        ms.live--;
+        h->magic = 0;
+        munmap(h->base, h->map_length);
+        pool().counters.system_frees++;
+    }
+#endif // VISIONCORE_HOST_MMAP
+    
+    struct NumaState
+    {
+        NumaState() : policy((int)vc::NumaPolicy::Default), node(0), threshold(std::size_t(16) << 20)
+        {
+            const char* env = std::getenv("VISIONCORE_HOST_NUMA");
+            if(env == nullptr) { return; }
+            
+            const std::string val(env);
+            if(val == "interleave")
+            {
+                policy = (int)vc::NumaPolicy::Interleave;
+            }
+            else if(val.compare(0, 5, "bind:") == 0)
+            {
+                policy = (int)vc::NumaPolicy::Bind;
+                node = std::atoi(val.c_str() + 5);
+            }
+        }
+        
+        std::atomic<int>            policy;
+        std::atomic<int>            node;
+        std::atomic<std::size_t>    threshold;
+    };
+    
+    NumaState& numa()
+    {
+        static NumaState* state = new NumaState();
+        return *state;
+    }
+    
+    /// Fresh system allocations only, recycled blocks have been touched already.
+    inline void placeNew(void* ptr, std::size_t bytes)
+    {
+        const NumaState& ns = numa();
+        const vc::NumaPolicy policy = (vc::NumaPolicy)ns.policy.load(std::memory_order_relaxed);
+        
+        if(policy != vc::NumaPolicy::Default && bytes >= ns.threshold.load(std::memory_order_relaxed))
+        {
+            vc::hostNumaPlace(ptr, bytes, policy, ns.node.load(std::memory_order_relaxed));
+        }
+    }
+    
+    /**
+     * Owner label & accounting, on every block handed out.
+     */
+    inline void* stamp(void* ptr)
+    {
+        BlockHeader* h = headerOf(ptr);
+        h->label = vc::memstats::currentLabel();
+        vc::memstats::recordAllocation(vc::MemoryTarget::Host, h->size, h->label);
+        return ptr;
+    }
+}
+
+void* vc::hostAllocate(std::size_t bytes, std::size_t alignment)
+{
+    PoolState& ps = pool();
+    std::size_t usable = 0;
+    BlockHeader* h = nullptr;
+    
+#ifdef VISIONCORE_HOST_MMAP
+    const std::size_t map_threshold = maps().threshold.load(std::memory_order_relaxed);
+    if(map_threshold > 0 && bytes >= map_threshold)
+    {
+        void* ret = mapAllocate(bytes, alignment, usable, h);
+        placeNew(ret, bytes);
+        
+        if(!maps().lazy_commit.load())
+        {
+            // commit up front, in parallel so the pages spread like the work will
+            hostMemset(ret, 0, bytes);
+        }
+        
+        return stamp(ret);
+    }
+#endif // VISIONCORE_HOST_MMAP
+    
+    if(!ps.enabled.load(std::memory_order_relaxed))
+    {
+        void* ret = systemAllocate(bytes, alignment, usable, h);
+        placeNew(ret, bytes);
+        return stamp(ret);
+    }
+    
+    std::size_t class_bytes = 0;
+    const int cls = sizeClass(bytes, class_bytes);
+    
+    {
+        ThreadCache& tc = threadCache();
+        std::lock_guard<std::mutex> lock(tc.mutex);
+        h = popBlock(tc.lists[cls], alignment);
+    }
+    
+    if(h == nullptr)
+    {
+        std::lock_guard<std::mutex> lock(ps.mutex);
+        h = popBlock(ps.shared[cls], alignment);
+    }
+    
+    if(h != nullptr)
+    {
+        ps.counters.hits++;
+        ps.counters.cached_bytes -= h->size;
+        ps.counters.cached_blocks--;
+        return stamp(userOf(h));
+    }
+    
+    ps.counters.misses++;
+    
+    // whole class, so the block can serve any request of the class later
+    void* ret = systemAllocate(class_bytes, alignment, usable, h);
+    h->size_class = cls;
+    placeNew(ret, class_bytes);
+    return stamp(ret);
+}
+
+void vc::hostDeallocate(void* ptr) noexcept
+{
+    if(ptr == nullptr) { return; }
+    
+    BlockHeader* h = headerOf(ptr);
+    PoolState& ps = pool();
+    
+    memstats::recordDeallocation(MemoryTarget::Host, h->size, h->label);
+    
+#ifdef VISIONCORE_HOST_MMAP
+    if(h->size_class == Mapped)
+    {
+        mapFree(h);
+        return;
+    }
+#endif // VISIONCORE_HOST_MMAP
+    
+    if(h->size_class < 0 || !ps.enabled.load(std::memory_order_relaxed) || 
+       ps.counters.cached_bytes.load(std::memory_order_relaxed) + h->size > ps.high_water_mark.load(std::memory_order_relaxed))
+    {
+        systemFree(h);
+        return;
+    }
+    
+    ps.counters.cached_bytes += h->size;
+    ps.counters.cached_blocks++;
+    updatePeak(ps.counters);
+    
+    try
+    {
+        {
+            ThreadCache& tc = threadCache();
+            std::lock_guard<std::mutex> lock(tc.mutex);
+            std::vector<BlockHeader*>& local = tc.lists[h->size_class];
+            
+            if(local.size() < ThreadCacheBlocks)
+            {
+                local.push_back(h);
+                return;
+            }
+        }
+        
+        std::lock_guard<std::mutex> lock(ps.mutex);
+        ps.shared[h->size_class].push_back(h);
+    }
+    catch(...)
+    {
+        ps.counters.cached_bytes -= h->size;
+        ps.counters.cached_blocks--;
+        systemFree(h);
+    }
+}
+
+std::size_t vc::hostAllocationSize(const void* ptr)
+{
+    return ptr != nullptr ? headerOf(ptr)->size : 0;
+}
+
+std::size_t vc::hostDefaultAlignment(std::size_t fallback)
+{
+    const char* env = std::getenv("VISIONCORE_HOST_ALIGNMENT");
+    if(env != nullptr)
+    {
+        const std::size_t alignment = std::strtoull(env, nullptr, 10);
+        if(alignment >= sizeof(void*) && (alignment & (alignment - 1)) == 0) { return alignment; }
+    }
+    
+    return fallback;
+}
+
+vc::HostMapSettings vc::getHostMapSettings()
+{
+    const MapState& ms = maps();
+    
+    HostMapSettings ret;
+    ret.threshold = ms.threshold.load();
+    ret.huge_pages = (HugePages)ms.huge_pages.load();
+    ret.lazy_commit = ms.lazy_commit.load();
+    return ret;
+}
+
+void vc::setHostMapSettings(const HostMapSettings& settings)
+{
+    MapState& ms = maps();
+    ms.threshold = settings.threshold;
+    ms.huge_pages = (int)settings.huge_pages;
+    ms.lazy_commit = settings.lazy_commit;
+}
+
+bool vc::hostIsMapped(const void* ptr)
+{
+    MapState& ms = maps();
+    if(ms.live.load(std::memory_order_relaxed) == 0) { return false; }
+    
+    const std::uintptr_t p = reinterpret_cast<std::uintptr_t>(ptr);
+    
+    std::lock_guard<std::mutex> lock(ms.mutex);
+    auto it = ms.ranges.upper_bound(p);
+    if(it == ms.ranges.begin()) { return false; }
+    --it;
+    return p < it->first + it->second.bytes;
+}
+
+bool vc::hostDiscard(void* ptr, std::size_t bytes)
+{
+#ifdef VISIONCORE_HOST_MMAP
+    MapState& ms = maps();
+    if(ms.live.load(std::memory_order_relaxed) == 0 || bytes == 0) { return false; }
+    
+    const std::uintptr_t p = reinterpret_cast<std::uintptr_t>(ptr);
+    std::size_t page = 0;
+    
+    {
+        std::lock_guard<std::mutex> lock(ms.mutex);
+        auto it = ms.ranges.upper_bound(p);
+        if(it == ms.ranges.begin()) { return false; }
+        --it;
+        if(p + bytes > it->first + it->second.bytes) { return false; }
+        page = it->second.page;
+    }
+    
+    const std::uintptr_t first = (p + page - 1) / page * page;
+    const std::uintptr_t last = (p + bytes) / page * page;
+    
+    if(last <= first)
+    {
+        std::memset(ptr, 0, bytes);
+        return true;
+    }
+    
+    std::memset(ptr, 0, first - p);
+    if(madvise(reinterpret_cast<void*>(first), last - first, MADV_DONTNEED) != 0)
+    {
+        std::memset(reinterpret_cast<void*>(first), 0, last - first);
+    }
+    std::memset(reinterpret_cast<void*>(last), 0, p + bytes - last);
+    return true;
+#else // VISIONCORE_HOST_MMAP
+    return false;
+#endif // VISIONCORE_HOST_MMAP
+}
+
+vc::HostNumaSettings vc::getHostNumaSettings()
+{
+    const NumaState& ns = numa();
+    
+    HostNumaSettings ret;
+    ret.policy = (NumaPolicy)ns.policy.load();
+    ret.node = ns.node.load();
+    ret.threshold = ns.threshold.load();
+    return ret;
+}
+
+void vc::setHostNumaSettings(const HostNumaSettings& settings)
+{
+    NumaState& ns = numa();
+    ns.policy = (int)settings.policy;
+    ns.node = settings.node;
+    ns.threshold = settings.threshold;
+}
+
+bool vc::hostNumaAvailable()
+{
+#ifdef VISIONCORE_HAVE_NUMA
+    static const bool available = numa_available() >= 0;
+    return available;
+#else // VISIONCORE_HAVE_NUMA
+    return false;
+#endif // VISIONCORE_HAVE_NUMA
+}
+
+std::size_t vc::hostNumaNodes()
+{
+#ifdef VISIONCORE_HAVE_NUMA
+    if(hostNumaAvailable())
+    {
+        return (std::size_t)numa_num_configured_nodes();
+    }
+#endif // VISIONCORE_HAVE_NUMA
+    
+    return 1;
+}
+
+bool vc::hostNumaPlace(void* ptr, std::size_t bytes, NumaPolicy policy, int node)
+{
+#ifdef VISIONCORE_HAVE_NUMA
+    if(!hostNumaAvailable()) { return false; }
+    
+    // policies apply to whole pages
+    const std::size_t page = (std::size_t)numa_pagesize();
+    const std::uintptr_t p = reinterpret_cast<std::uintptr_t>(ptr);
+    const std::uintptr_t first = (p + page - 1) / page * page;
+    const std::uintptr_t last = (p + bytes) / page * page;
+    if(last <= first) { return true; }
+    
+    void* start = reinterpret_cast<void*>(first);
+    
+    switch(policy)
+    {
+        case NumaPolicy::Interleave: 
+            numa_interleave_memory(start, last - first, numa_all_nodes_ptr); 
+            break;
+        case NumaPolicy::Bind: 
+            numa_tonode_memory(start, last - first, node); 
+            break;
+        default: 
+            numa_setlocal_memory(start, last - first); 
+            break;
+    }
+    
+    return true;
+#else // VISIONCORE_HAVE_NUMA
+    (void)ptr;
+    (void)bytes;
+    (void)policy;
+    (void)node;
+    return false;
+#endif // VISIONCORE_HAVE_NUMA
+}
+
+void vc::HostMemoryPool::setEnabled(bool enabled)
+{
+    pool().enabled = enabled;
+    
+    if(!enabled) { trim(); }
+}
+
+bool vc::HostMemoryPool::isEnabled()
+{
+    return pool().enabled.load(std::memory_order_relaxed);
+}
+
+void vc::HostMemoryPool::setHighWaterMark(std::size_t bytes)
+{
+    pool().high_water_mark = bytes;
+}
+
+std::size_t vc::HostMemoryPool::highWaterMark()
+{
+    return pool().high_water_mark.load(std::memory_order_relaxed);
+}
+
+void vc::HostMemoryPool::trim()
+{
+    PoolState& ps = pool();
+    
+    {
+        std::lock_guard<std::mutex> reg_lock(ps.caches_mutex);
+        for(ThreadCache* tc : ps.caches)
+        {
+            std::lock_guard<std::mutex> lock(tc->mutex);
+            releaseLists(tc->lists);
+        }
+    }
+    
+    std::lock_guard<std::mutex> lock(ps.mutex);
+    releaseLists(ps.shared);
+}
+
+vc::HostMemoryPoolStats vc::HostMemoryPool::stats()
+{
+    const Counters& c = pool().counters;
+    
+    HostMemoryPoolStats ret;
+    ret.cached_bytes = c.cached_bytes.load();
+    ret.cached_blocks = c.cached_blocks.load();
+    ret.peak_cached_bytes = c.peak_cached_bytes.load();
+    ret.hits = c.hits.load();
+    ret.misses = c.misses.load();
+    ret.system_allocations = c.system_allocations.load();
+    ret.system_frees = c.system_frees.load();
+    return ret;
+}
+
+void vc::HostMemoryPool::resetStats()
+{
+    Counters& c = pool().counters;
+    c.peak_cached_bytes = c.cached_bytes.load();
+    c.hits = 0;
+    c.misses = 0;
+    c.system_allocations = 0;
+    c.system_frees = 0;
+}
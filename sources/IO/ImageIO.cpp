@@ -37,6 +37,7 @@
 
 #include <VisionCore/Buffers/Buffer2D.hpp>
 #include <VisionCore/Buffers/Image2D.hpp>
+#include <VisionCore/Trace.hpp>
 
 #ifdef VISIONCORE_HAVE_CAMERA_DRIVERS
 #include <CameraDrivers.hpp>
@@ -144,7 +145,7 @@ struct ImageIOProxy<vc::Image2DView<T, vc::TargetHost>,OpenCVBackend>
 {
     static inline void save(const std::string& fn, const vc::Image2DView<T, vc::TargetHost>& input)
     {
-        cv::Mat cv_proxy(input.height(), input.width(), CV_MAKETYPE(vc::internal::OpenCVType<typename vc::type_traits<T>::ChannelType>::TypeCode, vc::type_traits<T>::ChannelCount), (void*)input.ptr());
+        cv::Mat cv_proxy(input.height(), input.width(), CV_MAKETYPE(vc::internal::OpenCVType<typename vc::type_traits<T>::ChannelType>::TypeCode, vc::type_traits<T>::ChannelCount), (void*)input.ptr(), input.pitch());
         cv::imwrite(fn, cv_proxy);
     }
 };
@@ -180,7 +181,7 @@ struct ImageIOProxy<vc::Image2DManaged<T, vc::TargetHost>,OpenCVBackend>
         cv::Mat cv_proxy(ret.height(), ret.width(), 
                          CV_MAKETYPE(vc::internal::OpenCVType<typename vc::type_traits<T>::ChannelType>::TypeCode,
                                      vc::type_traits<T>::ChannelCount), 
-                         (void*)ret.ptr());
+                         (void*)ret.ptr(), ret.pitch());
         
         // copy
         cv_tmp.copyTo(cv_proxy);
@@ -197,7 +198,7 @@ struct ImageIOProxy<vc::Buffer2DView<T, vc::TargetHost>,OpenCVBackend>
         cv::Mat cv_proxy(input.height(), input.width(), 
                          CV_MAKETYPE(vc::internal::OpenCVType<typename vc::type_traits<T>::ChannelType>::TypeCode,
                                      vc::type_traits<T>::ChannelCount), 
-                         (void*)input.ptr());
+                         (void*)input.ptr(), input.pitch());
         cv::imwrite(fn, cv_proxy);
     }
 };
@@ -234,7 +235,7 @@ struct ImageIOProxy<vc::Buffer2DManaged<T, vc::TargetHost>,OpenCVBackend>
         cv::Mat cv_proxy(ret.height(), ret.width(), 
                          CV_MAKETYPE(vc::internal::OpenCVType<typename vc::type_traits<T>::ChannelType>::TypeCode,
                                      vc::type_traits<T>::ChannelCount), 
-                         (void*)ret.ptr());
+                         (void*)ret.ptr(), ret.pitch());
         
         // copy
         cv_tmp.copyTo(cv_proxy);
@@ -247,12 +248,14 @@ struct ImageIOProxy<vc::Buffer2DManaged<T, vc::TargetHost>,OpenCVBackend>
 template<typename T>
 T vc::io::loadImage(const std::string& fn)
 {
+    VISIONCORE_TRACE_SCOPE("loadImage");
     return ImageIOProxy<T,OpenCVBackend>::load(fn);
 }
 
 template<typename T>
 void vc::io::saveImage(const std::string& fn, const T& input)
 {
+    VISIONCORE_TRACE_SCOPE("saveImage");
     ImageIOProxy<T,OpenCVBackend>::save(fn, input);
 }
 
@@ -0,0 +1,180 @@
+/**
+ * ****************************************************************************
+ * Copyright (c) 2017, Robert Lukierski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * ****************************************************************************
+ * Memory mapped files exposed as host buffers.
+ * ****************************************************************************
+ */
+
+#include <VisionCore/IO/MappedFile.hpp>
+
+#include <cerrno>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define VISIONCORE_HAVE_MMAP_FILES
+#endif
+
+#ifdef VISIONCORE_HAVE_MMAP_FILES
+static int adviceFor(vc::io::AccessHint hint)
+{
+    switch(hint)
+    {
+        case vc::io::AccessHint::Sequential: return MADV_SEQUENTIAL;
+        case vc::io::AccessHint::Random: return MADV_RANDOM;
+        case vc::io::AccessHint::WillNeed: return MADV_WILLNEED;
+        default: return MADV_NORMAL;
+    }
+}
+#endif // VISIONCORE_HAVE_MMAP_FILES
+
+vc::io::MappedFile::MappedFile() : memptr(nullptr), file_size(0), map_mode(MapMode::ReadOnly)
+{
+    
+}
+
+vc::io::MappedFile::MappedFile(const std::string& fn, MapMode mode, AccessHint hint) : MappedFile()
+{
+    open(fn, mode, hint);
+}
+
+vc::io::MappedFile::~MappedFile()
+{
+    close();
+}
+
+vc::io::MappedFile::MappedFile(MappedFile&& mf) : memptr(mf.memptr), file_size(mf.file_size), map_mode(mf.map_mode)
+{
+    mf.memptr = nullptr;
+    mf.file_size = 0;
+}
+
+vc::io::MappedFile& vc::io::MappedFile::operator=(MappedFile&& mf)
+{
+    if(this != &mf)
+    {
+        close();
+        memptr = mf.memptr;
+        file_size = mf.file_size;
+        map_mode = mf.map_mode;
+        mf.memptr = nullptr;
+        mf.file_size = 0;
+    }
+    
+    return *this;
+}
+
+void vc::io::MappedFile::open(const std::string& fn, MapMode mode, AccessHint hint)
+{
+    close();
+    
+#ifdef VISIONCORE_HAVE_MMAP_FILES
+    const int fd = ::open(fn.c_str(), O_RDONLY | O_CLOEXEC);
+    if(fd < 0)
+    {
+        throw std::runtime_error("Cannot open " + fn + ": " + std::strerror(errno));
+    }
+    
+    struct stat st;
+    if(::fstat(fd, &st) != 0)
+    {
+        const int err = errno;
+        ::close(fd);
+        throw std::runtime_error("Cannot stat " + fn + ": " + std::strerror(err));
+    }
+    
+    const std::size_t bytes = (std::size_t)st.st_size;
+    void* ptr = nullptr;
+    
+    if(bytes > 0)
+    {
+        const int prot = mode == MapMode::CopyOnWrite ? (PROT_READ | PROT_WRITE) : PROT_READ;
+        const int flags = mode == MapMode::CopyOnWrite ? MAP_PRIVATE : MAP_SHARED;
+        ptr = ::mmap(nullptr, bytes, prot, flags, fd, 0);
+    }
+    
+    const int err = errno;
+    ::close(fd); // the mapping keeps the file alive
+    
+    if(bytes == 0 || ptr == MAP_FAILED)
+    {
+        throw std::runtime_error("Cannot map " + fn + ": " + (bytes == 0 ? "empty file" : std::strerror(err)));
+    }
+    
+    memptr = ptr;
+    file_size = bytes;
+    map_mode = mode;
+    
+    if(hint != AccessHint::Normal)
+    {
+        advise(hint);
+    }
+#else // VISIONCORE_HAVE_MMAP_FILES
+    (void)mode;
+    (void)hint;
+    throw std::runtime_error("Memory mapped files not supported on this platform: " + fn);
+#endif // VISIONCORE_HAVE_MMAP_FILES
+}
+
+void vc::io::MappedFile::close()
+{
+#ifdef VISIONCORE_HAVE_MMAP_FILES
+    if(memptr != nullptr)
+    {
+        ::munmap(memptr, file_size);
+    }
+#endif // VISIONCORE_HAVE_MMAP_FILES
+    
+    memptr = nullptr;
+    file_size = 0;
+}
+
+void vc::io::MappedFile::advise(AccessHint hint, std::size_t offset, std::size_t length)
+{
+#ifdef VISIONCORE_HAVE_MMAP_FILES
+    if(!isOpened() || offset >= file_size) { return; }
+    
+    if(length == 0 || length > file_size - offset) { length = file_size - offset; }
+    
+    // madvise wants a page aligned start
+    const std::size_t page = (std::size_t)::sysconf(_SC_PAGESIZE);
+    const std::size_t start = offset / page * page;
+    
+    ::madvise(static_cast<char*>(memptr) + start, length + (offset - start), adviceFor(hint));
+#else // VISIONCORE_HAVE_MMAP_FILES
+    (void)hint;
+    (void)offset;
+    (void)length;
+#endif // VISIONCORE_HAVE_MMAP_FILES
+}
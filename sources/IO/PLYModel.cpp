@@ -34,6 +34,7 @@
  */
 
 #include <VisionCore/IO/PLYModel.hpp>
+#include <VisionCore/Trace.hpp>
 
 #include <algorithm>
 #include <fstream>
@@ -379,6 +380,7 @@ template<> struct ReadWriteHelper<vc::Surfel>
 template<typename T>
 bool vc::io::loadPLY(const std::string& plyfilename, std::vector<T,Eigen::aligned_allocator<T>>& vec, float scalePos, std::vector<std::vector<std::size_t>>* idx)
 {
+    VISIONCORE_TRACE_SCOPE("loadPLY");
     std::ifstream plyfile(plyfilename.c_str(), std::ios::binary);
     if (!plyfile.is_open()) 
     {
@@ -488,6 +490,7 @@ bool vc::io::loadPLY(const std::string& plyfilename, std::vector<T,Eigen::aligne
 template<typename T>
 bool vc::io::savePLY(const std::string& plyfilename, const std::vector<T,Eigen::aligned_allocator<T>>& vec, float scalePos, const std::vector<std::vector<std::size_t>>* idx)
 {
+    VISIONCORE_TRACE_SCOPE_1D("savePLY", vec.size(), vec.size() * sizeof(T));
     const std::size_t surfel_count = vec.size();
     
     std::ofstream fs(plyfilename.c_str());
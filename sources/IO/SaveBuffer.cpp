@@ -66,7 +66,11 @@ struct BinaryBufferSavingProxy<vc::Buffer2DView<T2, vc::TargetHost>>
     { 
         vc::io::File outf(fn.c_str(),"wb");
         
-        outf.write(b.ptr(), b.totalElements(), sizeof(T2));
+        // packed rows, the pitch may be padded
+        for(std::size_t y = 0 ; y < b.height() ; ++y)
+        {
+            outf.write(b.rowPtr(y), b.width(), sizeof(T2));
+        }
         
         outf.flush();
     }
@@ -40,12 +40,360 @@
 #include <VisionCore/Math/LossFunctions.hpp>
 
 #include <Image/JoinSplitHelpers.hpp>
+#include <Math/ConvolutionKernels.hpp>
 
+#include <limits>
 #include <numeric>
 
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define VISIONCORE_BUFFER_STATS_SSE
+#endif // SSE2
+
+namespace
+{
+    template<typename T>
+    inline vc::image::BufferStats<T> emptyStats()
+    {
+        vc::image::BufferStats<T> ret;
+        ret.min = std::numeric_limits<T>::max();
+        ret.max = std::numeric_limits<T>::lowest();
+        ret.sum = 0.0;
+        ret.sum_sq = 0.0;
+        ret.count = 0;
+        return ret;
+    }
+    
+    template<typename T>
+    inline vc::image::BufferStats<T> joinStats(const vc::image::BufferStats<T>& a, const vc::image::BufferStats<T>& b)
+    {
+        vc::image::BufferStats<T> ret;
+        ret.min = std::min(a.min, b.min);
+        ret.max = std::max(a.max, b.max);
+        ret.sum = a.sum + b.sum;
+        ret.sum_sq = a.sum_sq + b.sum_sq;
+        ret.count = a.count + b.count;
+        return ret;
+    }
+    
+    /**
+     * Branch free, so the compiler can vectorize it. Integers accumulate exactly, 
+     * NaNs never win min / max (as with std::min).
+     */
+    template<typename T, bool Masked>
+    inline void statsRow(const T* row, std::size_t n, T invalid, vc::image::BufferStats<T>& st)
+    {
+        typedef typename std::conditional<std::is_integral<T>::value, uint64_t, double>::type AccT;
+        
+        T vmin = st.min, vmax = st.max;
+        AccT sum = AccT(0), sum_sq = AccT(0);
+        std::size_t count = 0;
+        
+        for(std::size_t x = 0 ; x < n ; ++x)
+        {
+            const T v = row[x];
+            const bool valid = !Masked || (v != invalid && vc::isvalid(v));
+            const AccT a = valid ? AccT(v) : AccT(0);
+            
+            vmin = (valid && v < vmin) ? v : vmin;
+            vmax = (valid && v > vmax) ? v : vmax;
+            sum += a;
+            sum_sq += a * a;
+            count += valid ? 1 : 0;
+        }
+        
+        st.min = vmin;
+        st.max = vmax;
+        st.sum += double(sum);
+        st.sum_sq += double(sum_sq);
+        st.count += count;
+    }
+    
+#ifdef VISIONCORE_BUFFER_STATS_SSE
+    inline std::size_t laneCount(int mask)
+    {
+        unsigned int m = (unsigned int)mask;
+        m = m - ((m >> 1) & 0x5555u);
+        m = (m & 0x3333u) + ((m >> 2) & 0x3333u);
+        m = (m + (m >> 4)) & 0x0F0Fu;
+        return std::size_t((m + (m >> 8)) & 0x1Fu);
+    }
+    
+    /**
+     * Floats need doubles for the sums, which the compiler won't vectorize without fast-math.
+     */
+    template<bool Masked>
+    inline void statsRowSSE(const float* row, std::size_t n, float invalid, vc::image::BufferStats<float>& st)
+    {
+        const __m128 inv = _mm_set1_ps(invalid);
+        const __m128 highest = _mm_set1_ps(std::numeric_limits<float>::max());
+        const __m128 lowest = _mm_set1_ps(std::numeric_limits<float>::lowest());
+        
+        __m128 vmin = _mm_set1_ps(st.min), vmax = _mm_set1_ps(st.max);
+        __m128d sum_lo = _mm_setzero_pd(), sum_hi = _mm_setzero_pd();
+        __m128d sq_lo = _mm_setzero_pd(), sq_hi = _mm_setzero_pd();
+        std::size_t count = 0;
+        std::size_t x = 0;
+        
+        for( ; x + 4 <= n ; x += 4)
+        {
+            __m128 v = _mm_loadu_ps(row + x);
+            
+            if(Masked)
+            {
+                // v - v is 0 only for finite v
+                const __m128 finite = _mm_cmpeq_ps(_mm_sub_ps(v, v), _mm_setzero_ps());
+                const __m128 valid = _mm_andnot_ps(_mm_cmpeq_ps(v, inv), finite);
+                count += laneCount(_mm_movemask_ps(valid));
+                
+                vmin = _mm_min_ps(_mm_or_ps(_mm_and_ps(valid, v), _mm_andnot_ps(valid, highest)), vmin);
+                vmax = _mm_max_ps(_mm_or_ps(_mm_and_ps(valid, v), _mm_andnot_ps(valid, lowest)), vmax);
+                v = _mm_and_ps(valid, v);
+            }
+            else
+            {
+                // second operand returned for NaN
+                vmin = _mm_min_ps(v, vmin);
+                vmax = _mm_max_ps(v, vmax);
+            }
+            
+            const __m128d lo = _mm_cvtps_pd(v);
+            const __m128d hi = _mm_cvtps_pd(_mm_movehl_ps(v, v));
+            sum_lo = _mm_add_pd(sum_lo, lo);
+            sum_hi = _mm_add_pd(sum_hi, hi);
+            sq_lo = _mm_add_pd(sq_lo, _mm_mul_pd(lo, lo));
+            sq_hi = _mm_add_pd(sq_hi, _mm_mul_pd(hi, hi));
+        }
+        
+        if(!Masked) { count = x; }
+        
+        float lanes_min[4], lanes_max[4];
+        double lanes_sum[2], lanes_sq[2];
+        _mm_storeu_ps(lanes_min, vmin);
+        _mm_storeu_ps(lanes_max, vmax);
+        _mm_storeu_pd(lanes_sum, _mm_add_pd(sum_lo, sum_hi));
+        _mm_storeu_pd(lanes_sq, _mm_add_pd(sq_lo, sq_hi));
+        
+        for(std::size_t l = 0 ; l < 4 ; ++l)
+        {
+            st.min = std::min(st.min, lanes_min[l]);
+            st.max = std::max(st.max, lanes_max[l]);
+        }
+        
+        st.sum += lanes_sum[0] + lanes_sum[1];
+        st.sum_sq += lanes_sq[0] + lanes_sq[1];
+        st.count += count;
+        
+        statsRow<float,Masked>(row + x, n - x, invalid, st);
+    }
+    
+    /**
+     * 16 bit integer sums: 32 bit lane sums (flushed by the caller) and 64 bit lane squares.
+     */
+    struct IntegerSums
+    {
+        IntegerSums() : sum32(_mm_setzero_si128()), sq64(_mm_setzero_si128()), sum(0), sum_sq(0) { }
+        
+        inline void add(__m128i v)
+        {
+            const __m128i zero = _mm_setzero_si128();
+            sum32 = _mm_add_epi32(sum32, _mm_add_epi32(_mm_unpacklo_epi16(v, zero), _mm_unpackhi_epi16(v, zero)));
+            
+            // full 32 bit squares from the low & high halves of the products
+            const __m128i plo = _mm_mullo_epi16(v, v), phi = _mm_mulhi_epu16(v, v);
+            const __m128i sq_a = _mm_unpacklo_epi16(plo, phi), sq_b = _mm_unpackhi_epi16(plo, phi);
+            sq64 = _mm_add_epi64(sq64, _mm_add_epi64(_mm_unpacklo_epi32(sq_a, zero), _mm_unpackhi_epi32(sq_a, zero)));
+            sq64 = _mm_add_epi64(sq64, _mm_add_epi64(_mm_unpacklo_epi32(sq_b, zero), _mm_unpackhi_epi32(sq_b, zero)));
+        }
+        
+        inline void flush()
+        {
+            uint32_t lanes32[4];
+            uint64_t lanes64[2];
+            _mm_storeu_si128((__m128i*)lanes32, sum32);
+            _mm_storeu_si128((__m128i*)lanes64, sq64);
+            sum += uint64_t(lanes32[0]) + lanes32[1] + lanes32[2] + lanes32[3];
+            sum_sq += lanes64[0] + lanes64[1];
+            sum32 = _mm_setzero_si128();
+            sq64 = _mm_setzero_si128();
+        }
+        
+        // 2 values of at most 0xFFFF per lane & add, stays below 2^32
+        static constexpr std::size_t FlushInterval = 16384;
+        
+        __m128i     sum32;
+        __m128i     sq64;
+        uint64_t    sum;
+        uint64_t    sum_sq;
+    };
+    
+    template<bool Masked>
+    inline void statsRowSSE(const uint16_t* row, std::size_t n, uint16_t invalid, vc::image::BufferStats<uint16_t>& st)
+    {
+        // no unsigned 16 bit min / max in SSE2, compare with the sign bit flipped
+        const __m128i bias = _mm_set1_epi16(short(0x8000));
+        const __m128i inv = _mm_set1_epi16(short(invalid));
+        const __m128i ones = _mm_set1_epi16(-1);
+        
+        __m128i vmin = _mm_xor_si128(_mm_set1_epi16(short(st.min)), bias);
+        __m128i vmax = _mm_xor_si128(_mm_set1_epi16(short(st.max)), bias);
+        IntegerSums sums;
+        std::size_t count = 0;
+        std::size_t x = 0;
+        
+        for(std::size_t it = 0 ; x + 8 <= n ; x += 8, ++it)
+        {
+            __m128i v = _mm_loadu_si128((const __m128i*)(row + x));
+            
+            if(Masked)
+            {
+                const __m128i valid = _mm_xor_si128(_mm_cmpeq_epi16(v, inv), ones);
+                count += laneCount(_mm_movemask_epi8(valid)) / 2;
+                
+                // invalid lanes become 0xFFFF for min, 0 for max & sums
+                vmin = _mm_min_epi16(_mm_xor_si128(_mm_or_si128(v, _mm_xor_si128(valid, ones)), bias), vmin);
+                v = _mm_and_si128(v, valid);
+                vmax = _mm_max_epi16(_mm_xor_si128(v, bias), vmax);
+            }
+            else
+            {
+                vmin = _mm_min_epi16(_mm_xor_si128(v, bias), vmin);
+                vmax = _mm_max_epi16(_mm_xor_si128(v, bias), vmax);
+            }
+            
+            sums.add(v);
+            if(it % IntegerSums::FlushInterval == IntegerSums::FlushInterval - 1) { sums.flush(); }
+        }
+        
+        sums.flush();
+        if(!Masked) { count = x; }
+        
+        uint16_t lanes_min[8], lanes_max[8];
+        _mm_storeu_si128((__m128i*)lanes_min, _mm_xor_si128(vmin, bias));
+        _mm_storeu_si128((__m128i*)lanes_max, _mm_xor_si128(vmax, bias));
+        
+        uint16_t tmin = st.min, tmax = st.max;
+        for(std::size_t l = 0 ; l < 8 ; ++l)
+        {
+            tmin = std::min(tmin, lanes_min[l]);
+            tmax = std::max(tmax, lanes_max[l]);
+        }
+        
+        // masked lanes hold 0xFFFF / 0, which never beat a valid value or the initial limits
+        st.min = tmin;
+        st.max = tmax;
+        
+        st.sum += double(sums.sum);
+        st.sum_sq += double(sums.sum_sq);
+        st.count += count;
+        
+        statsRow<uint16_t,Masked>(row + x, n - x, invalid, st);
+    }
+    
+    template<bool Masked>
+    inline void statsRowSSE(const uint8_t* row, std::size_t n, uint8_t invalid, vc::image::BufferStats<uint8_t>& st)
+    {
+        const __m128i inv = _mm_set1_epi8(char(invalid));
+        const __m128i ones = _mm_set1_epi8(-1);
+        const __m128i zero = _mm_setzero_si128();
+        
+        __m128i vmin = _mm_set1_epi8(char(st.min)), vmax = _mm_set1_epi8(char(st.max));
+        IntegerSums sums;
+        std::size_t count = 0;
+        std::size_t x = 0;
+        
+        for(std::size_t it = 0 ; x + 16 <= n ; x += 16, ++it)
+        {
+            __m128i v = _mm_loadu_si128((const __m128i*)(row + x));
+            
+            if(Masked)
+            {
+                const __m128i valid = _mm_xor_si128(_mm_cmpeq_epi8(v, inv), ones);
+                count += laneCount(_mm_movemask_epi8(valid));
+                
+                vmin = _mm_min_epu8(_mm_or_si128(v, _mm_xor_si128(valid, ones)), vmin);
+                v = _mm_and_si128(v, valid);
+                vmax = _mm_max_epu8(v, vmax);
+            }
+            else
+            {
+                vmin = _mm_min_epu8(v, vmin);
+                vmax = _mm_max_epu8(v, vmax);
+            }
+            
+            sums.add(_mm_unpacklo_epi8(v, zero));
+            sums.add(_mm_unpackhi_epi8(v, zero));
+            if(it % (IntegerSums::FlushInterval / 2) == IntegerSums::FlushInterval / 2 - 1) { sums.flush(); }
+        }
+        
+        sums.flush();
+        if(!Masked) { count = x; }
+        
+        uint8_t lanes_min[16], lanes_max[16];
+        _mm_storeu_si128((__m128i*)lanes_min, vmin);
+        _mm_storeu_si128((__m128i*)lanes_max, vmax);
+        
+        uint8_t tmin = st.min, tmax = st.max;
+        for(std::size_t l = 0 ; l < 16 ; ++l)
+        {
+            tmin = std::min(tmin, lanes_min[l]);
+            tmax = std::max(tmax, lanes_max[l]);
+        }
+        
+        st.min = tmin;
+        st.max = tmax;
+        
+        st.sum += double(sums.sum);
+        st.sum_sq += double(sums.sum_sq);
+        st.count += count;
+        
+        statsRow<uint8_t,Masked>(row + x, n - x, invalid, st);
+    }
+#endif // VISIONCORE_BUFFER_STATS_SSE
+    
+    template<typename T, bool Masked>
+    struct StatsRowKernel
+    {
+        static inline void run(const T* row, std::size_t n, T invalid, vc::image::BufferStats<T>& st)
+        {
+            statsRow<T,Masked>(row, n, invalid, st);
+        }
+    };
+    
+#ifdef VISIONCORE_BUFFER_STATS_SSE
+    template<typename T, bool Masked>
+    struct StatsRowKernelSSE
+    {
+        static inline void run(const T* row, std::size_t n, T invalid, vc::image::BufferStats<T>& st)
+        {
+            statsRowSSE<Masked>(row, n, invalid, st);
+        }
+    };
+    
+    template<bool Masked> struct StatsRowKernel<float,Masked> : StatsRowKernelSSE<float,Masked> { };
+    template<bool Masked> struct StatsRowKernel<uint16_t,Masked> : StatsRowKernelSSE<uint16_t,Masked> { };
+    template<bool Masked> struct StatsRowKernel<uint8_t,Masked> : StatsRowKernelSSE<uint8_t,Masked> { };
+#endif // VISIONCORE_BUFFER_STATS_SSE
+    
+    template<typename T, bool Masked>
+    vc::image::BufferStats<T> calcStats(const vc::Buffer2DView<T, vc::TargetHost>& buf_in, T invalid)
+    {
+        return vc::launchParallelReduceRows(buf_in.width(), buf_in.height(), emptyStats<T>(),
+                                            [&](std::size_t y, std::size_t x_begin, std::size_t x_end, vc::image::BufferStats<T>& st)
+        {
+            StatsRowKernel<T,Masked>::run(buf_in.rowPtr(y) + x_begin, x_end - x_begin, invalid, st);
+        }, 
+        [&](const vc::image::BufferStats<T>& a, const vc::image::BufferStats<T>& b)
+        {
+            return joinStats(a, b);
+        });
+    }
+}
+
 template<typename T, typename Target>
 void vc::image::rescaleBufferInplace(vc::Buffer1DView< T, Target>& buf_in, T alpha, T beta, T clamp_min, T clamp_max)
 {
+    VISIONCORE_TRACE_SCOPE_1D("rescaleBufferInplace", buf_in.size(), 2 * buf_in.bytes());
     std::transform(buf_in.ptr(), buf_in.ptr() + buf_in.size(), buf_in.ptr(), [&](T val) -> T 
     {
         return clamp(val * alpha + beta, clamp_min, clamp_max); 
@@ -67,12 +415,17 @@ void vc::image::rescaleBufferInplaceMinMax(vc::Buffer2DView<T, Target>& buf_in,
 template<typename T1, typename T2, typename Target>
 void vc::image::rescaleBuffer(const vc::Buffer2DView<T1, Target>& buf_in, vc::Buffer2DView<T2, Target>& buf_out, float alpha, float beta, float clamp_min, float clamp_max)
 {
-    vc::launchParallelFor(buf_in.width(), buf_in.height(), [&](std::size_t x, std::size_t y)
+    VISIONCORE_TRACE_SCOPE_2D("rescaleBuffer", buf_out.width(), buf_out.height(), buf_out.area() * (sizeof(T1) + sizeof(T2)));
+    vc::launchParallelForRows(std::min(buf_in.width(), buf_out.width()), std::min(buf_in.height(), buf_out.height()), 
+                              [&](std::size_t y, std::size_t x_begin, std::size_t x_end)
     {
-        if(buf_in.inBounds(x,y) && buf_out.inBounds(x,y))
+        const T1* row_in = buf_in.rowPtr(y);
+        T2* row_out = buf_out.rowPtr(y);
+        
+        for(std::size_t x = x_begin ; x < x_end ; ++x)
         {
-            const T2 val = vc::image::convertPixel<T1,T2>(buf_in(x,y));
-            buf_out(x,y) = clamp(val * alpha + beta, clamp_min, clamp_max); 
+            const T2 val = vc::image::convertPixel<T1,T2>(row_in[x]);
+            row_out[x] = clamp(val * alpha + beta, clamp_min, clamp_max); 
         }
     });
 }
@@ -80,15 +433,29 @@ void vc::image::rescaleBuffer(const vc::Buffer2DView<T1, Target>& buf_in, vc::Bu
 template<typename T, typename Target>
 void vc::image::normalizeBufferInplace(vc::Buffer2DView< T, Target >& buf_in)
 {
-    const T min_val = calcBufferMin(buf_in);
-    const T max_val = calcBufferMax(buf_in);
+    VISIONCORE_TRACE_SCOPE_2D("normalizeBufferInplace", buf_in.width(), buf_in.height(), 3 * buf_in.area() * sizeof(T));
+    const BufferStats<T> stats = calcBufferStats(buf_in);
+    const T alpha = T(1.0) / (stats.max - stats.min);
+    const T beta = -stats.min * alpha;
 
-    rescaleBufferInplace(buf_in, T(1.0f) / (max_val - min_val), -min_val * (T(1.0)/(max_val - min_val)));
+    // clamp() is fminf/fmaxf calls, selects vectorize (and still take NaN to 1)
+    vc::launchParallelForRows(buf_in.width(), buf_in.height(), [&](std::size_t y, std::size_t x_begin, std::size_t x_end)
+    {
+        T* row = buf_in.rowPtr(y);
+        
+        for(std::size_t x = x_begin ; x < x_end ; ++x)
+        {
+            T val = row[x] * alpha + beta;
+            val = val < T(1.0) ? val : T(1.0);
+            row[x] = val > T(0.0) ? val : T(0.0);
+        }
+    });
 }
 
 template<typename T, typename Target>
 void vc::image::clampBuffer(vc::Buffer1DView<T, Target>& buf_io, T a, T b)
 {
+    VISIONCORE_TRACE_SCOPE_1D("clampBuffer", buf_io.size(), 2 * buf_io.bytes());
     vc::launchParallelFor(buf_io.size(), [&](std::size_t idx)
     {
         if(buf_io.inBounds(idx))
@@ -101,11 +468,14 @@ void vc::image::clampBuffer(vc::Buffer1DView<T, Target>& buf_io, T a, T b)
 template<typename T, typename Target>
 void vc::image::clampBuffer(vc::Buffer2DView<T, Target>& buf_io, T a, T b)
 {
-    vc::launchParallelFor(buf_io.width(), buf_io.height(), [&](std::size_t x, std::size_t y)
+    VISIONCORE_TRACE_SCOPE_2D("clampBuffer", buf_io.width(), buf_io.height(), 2 * buf_io.area() * sizeof(T));
+    vc::launchParallelForRows(buf_io.width(), buf_io.height(), [&](std::size_t y, std::size_t x_begin, std::size_t x_end)
     {
-        if(buf_io.inBounds(x,y))
+        T* row = buf_io.rowPtr(y);
+        
+        for(std::size_t x = x_begin ; x < x_end ; ++x)
         {
-            buf_io(x,y) = clamp(buf_io(x,y), a, b); 
+            row[x] = clamp(row[x], a, b); 
         }
     });
 }
@@ -113,6 +483,7 @@ void vc::image::clampBuffer(vc::Buffer2DView<T, Target>& buf_io, T a, T b)
 template<typename T, typename Target>
 T vc::image::calcBufferMin(const vc::Buffer1DView< T, Target >& buf_in)
 {
+    VISIONCORE_TRACE_SCOPE_1D("calcBufferMin", buf_in.size(), buf_in.bytes());
     const T* ret = std::min_element(buf_in.ptr(), buf_in.ptr() + buf_in.size());
     return *ret;
 }
@@ -120,6 +491,7 @@ T vc::image::calcBufferMin(const vc::Buffer1DView< T, Target >& buf_in)
 template<typename T, typename Target>
 T vc::image::calcBufferMax(const vc::Buffer1DView< T, Target >& buf_in)
 {
+    VISIONCORE_TRACE_SCOPE_1D("calcBufferMax", buf_in.size(), buf_in.bytes());
     const T* ret = std::max_element(buf_in.ptr(), buf_in.ptr() + buf_in.size());
     return *ret;
 }
@@ -127,6 +499,7 @@ T vc::image::calcBufferMax(const vc::Buffer1DView< T, Target >& buf_in)
 template<typename T, typename Target>
 T vc::image::calcBufferMean(const vc::Buffer1DView< T, Target >& buf_in)
 {
+    VISIONCORE_TRACE_SCOPE_1D("calcBufferMean", buf_in.size(), buf_in.bytes());
     T sum = std::accumulate(buf_in.ptr(), buf_in.ptr() + buf_in.size(), vc::zero<T>());
     return sum / (T)buf_in.size();
 }
@@ -134,100 +507,119 @@ T vc::image::calcBufferMean(const vc::Buffer1DView< T, Target >& buf_in)
 template<typename T, typename Target>
 T vc::image::calcBufferMin(const vc::Buffer2DView< T, Target >& buf_in)
 {
-    T minval = std::numeric_limits<T>::max();
-    
-    for(std::size_t y = 0 ; y < buf_in.height() ; ++y)
-    {
-        for(std::size_t x = 0 ; x < buf_in.width() ; ++x)
-        {
-            minval = std::min(minval, buf_in(x,y));
-        }
-    }
-    
-    return minval;
+    return calcBufferStats(buf_in).min;
 }
 
 template<typename T, typename Target>
 T vc::image::calcBufferMax(const vc::Buffer2DView< T, Target >& buf_in)
 {
-    T maxval = std::numeric_limits<T>::lowest();
-    
-    for(std::size_t y = 0 ; y < buf_in.height() ; ++y)
-    {
-        for(std::size_t x = 0 ; x < buf_in.width() ; ++x)
-        {
-            maxval = std::max(maxval, buf_in(x,y));
-        }
-    }
-    
-    return maxval;
+    return calcBufferStats(buf_in).max;
 }
 
 template<typename T, typename Target>
 T vc::image::calcBufferMean(const vc::Buffer2DView< T, Target >& buf_in)
 {
-    T sum = vc::zero<T>();
-    
-    for(std::size_t y = 0 ; y < buf_in.height() ; ++y)
+    return T(calcBufferStats(buf_in).mean());
+}
+
+template<typename T, typename Target>
+vc::image::BufferStats<T> vc::image::calcBufferStats(const vc::Buffer2DView< T, Target >& buf_in)
+{
+    VISIONCORE_TRACE_SCOPE_2D("calcBufferStats", buf_in.width(), buf_in.height(), buf_in.area() * sizeof(T));
+    return calcStats<T,false>(buf_in, T(0));
+}
+
+template<typename T, typename Target>
+vc::image::BufferStats<T> vc::image::calcBufferStats(const vc::Buffer2DView< T, Target >& buf_in, T invalid_value)
+{
+    VISIONCORE_TRACE_SCOPE_2D("calcBufferStats", buf_in.width(), buf_in.height(), buf_in.area() * sizeof(T));
+    return calcStats<T,true>(buf_in, invalid_value);
+}
+
+namespace
+{
+    template<typename T>
+    inline void downsampleHalfRow(const T* row_top, const T* row_bottom, T* row_out, std::size_t x_begin, std::size_t x_end)
     {
-        for(std::size_t x = 0 ; x < buf_in.width() ; ++x)
+        for(std::size_t x = x_begin ; x < x_end ; ++x)
         {
-            sum += buf_in(x,y);
+            const T* tl = row_top + 2*x;
+            const T* bl = row_bottom + 2*x;
+            
+            row_out[x] = (T)(*tl + *(tl+1) + *bl + *(bl+1)) / 4;
         }
     }
     
-    return sum / (T)buf_in.area();
+    /**
+     * Integer images sum in 32 bits and round instead of wrapping, see ConvolutionKernels.hpp.
+     */
+    inline void downsampleHalfRow(const uint8_t* row_top, const uint8_t* row_bottom, uint8_t* row_out, std::size_t x_begin, std::size_t x_end)
+    {
+        vc::math::internal::selectConvolutionKernels().halfU8(row_top + 2*x_begin, row_bottom + 2*x_begin, row_out + x_begin, x_end - x_begin);
+    }
+    
+    inline void downsampleHalfRow(const uint16_t* row_top, const uint16_t* row_bottom, uint16_t* row_out, std::size_t x_begin, std::size_t x_end)
+    {
+        vc::math::internal::selectConvolutionKernels().halfU16(row_top + 2*x_begin, row_bottom + 2*x_begin, row_out + x_begin, x_end - x_begin);
+    }
 }
 
 template<typename T, typename Target>
 void vc::image::downsampleHalf(const vc::Buffer2DView<T, Target>& buf_in, vc::Buffer2DView<T, Target>& buf_out)
 {
+    VISIONCORE_TRACE_SCOPE_2D("downsampleHalf", buf_out.width(), buf_out.height(), 5 * buf_out.area() * sizeof(T));
     if(!( (buf_in.width()/2 == buf_out.width()) && (buf_in.height()/2 == buf_out.height())))
     {
         throw std::runtime_error("In/Out dimensions don't match");
     }
     
-    vc::launchParallelFor(buf_out.width(), buf_out.height(), [&](std::size_t x, std::size_t y)
+    vc::launchParallelForRows(buf_out.width(), buf_out.height(), [&](std::size_t y, std::size_t x_begin, std::size_t x_end)
     {
-            const T* tl = buf_in.ptr(2*x,2*y);
-            const T* bl = buf_in.ptr(2*x,2*y+1);
-            
-            buf_out(x,y) = (T)(*tl + *(tl+1) + *bl + *(bl+1)) / 4;
+        downsampleHalfRow(buf_in.rowPtr(2*y), buf_in.rowPtr(2*y+1), buf_out.rowPtr(y), x_begin, x_end);
     });
 }
 
 template<typename T, typename Target>
 void vc::image::downsampleHalfNoInvalid(const vc::Buffer2DView<T, Target>& buf_in, vc::Buffer2DView<T, Target>& buf_out)
 {
+    VISIONCORE_TRACE_SCOPE_2D("downsampleHalfNoInvalid", buf_out.width(), buf_out.height(), 5 * buf_out.area() * sizeof(T));
     if(!( (buf_in.width()/2 == buf_out.width()) && (buf_in.height()/2 == buf_out.height())))
     {
         throw std::runtime_error("In/Out dimensions don't match");
     }
     
-    vc::launchParallelFor(buf_out.width(), buf_out.height(), [&](std::size_t x, std::size_t y)
+    vc::launchParallelForRows(buf_out.width(), buf_out.height(), [&](std::size_t y, std::size_t x_begin, std::size_t x_end)
     {
-        const T* tl = buf_in.ptr(2*x,2*y);
-        const T* bl = buf_in.ptr(2*x,2*y+1);
-        const T v1 = *tl;
-        const T v2 = *(tl+1);
-        const T v3 = *bl;
-        const T v4 = *(bl+1);
-        
-        int n = 0;
-        T sum = 0;
+        const T* row_top = buf_in.rowPtr(2*y);
+        const T* row_bottom = buf_in.rowPtr(2*y+1);
+        T* row_out = buf_out.rowPtr(y);
         
-        if(vc::isvalid(v1)) { sum += v1; n++; }
-        if(vc::isvalid(v2)) { sum += v2; n++; }
-        if(vc::isvalid(v3)) { sum += v3; n++; }
-        if(vc::isvalid(v4)) { sum += v4; n++; }
-        
-        buf_out(x,y) = n > 0 ? (T)(sum / (T)n) : vc::getInvalid<T>();
+        for(std::size_t x = x_begin ; x < x_end ; ++x)
+        {
+            const T* tl = row_top + 2*x;
+            const T* bl = row_bottom + 2*x;
+            const T v1 = *tl;
+            const T v2 = *(tl+1);
+            const T v3 = *bl;
+            const T v4 = *(bl+1);
+            
+            int n = 0;
+            T sum = 0;
+            
+            if(vc::isvalid(v1)) { sum += v1; n++; }
+            if(vc::isvalid(v2)) { sum += v2; n++; }
+            if(vc::isvalid(v3)) { sum += v3; n++; }
+            if(vc::isvalid(v4)) { sum += v4; n++; }
+            
+            row_out[x] = n > 0 ? (T)(sum / (T)n) : vc::getInvalid<T>();
+        }
     });
 }
 
 template<typename T, typename Target>
 void vc::image::leaveQuarter(const vc::Buffer2DView<T, Target>& buf_in, vc::Buffer2DView<T, Target>& buf_out)
 {
+    VISIONCORE_TRACE_SCOPE_2D("leaveQuarter", buf_out.width(), buf_out.height(), 2 * buf_out.area() * sizeof(T));
     dim3 gridDim, blockDim;
     
     if(!( (buf_in.width()/2 == buf_out.width()) && (buf_in.height()/2 == buf_out.height())))
@@ -235,87 +627,147 @@ void vc::image::leaveQuarter(const vc::Buffer2DView<T, Target>& buf_in, vc::Buff
         throw std::runtime_error("In/Out dimensions don't match");
     }
     
-    vc::launchParallelFor(buf_out.width(), buf_out.height(), [&](std::size_t x, std::size_t y)
+    vc::launchParallelForRows(buf_out.width(), buf_out.height(), [&](std::size_t y, std::size_t x_begin, std::size_t x_end)
     {
-        buf_out(x,y) = buf_in(2*x,2*y);
+        const T* row_in = buf_in.rowPtr(2*y);
+        T* row_out = buf_out.rowPtr(y);
+        
+        for(std::size_t x = x_begin ; x < x_end ; ++x)
+        {
+            row_out[x] = row_in[2*x];
+        }
     });
 }
 
 template<typename TCOMP, typename Target>
 void vc::image::join(const vc::Buffer2DView<typename vc::type_traits<TCOMP>::ChannelType, Target>& buf_in1, const vc::Buffer2DView<typename vc::type_traits<TCOMP>::ChannelType, Target>& buf_in2, vc::Buffer2DView<TCOMP, Target>& buf_out)
 {
+    VISIONCORE_TRACE_SCOPE_2D("join", buf_out.width(), buf_out.height(), 2 * buf_out.area() * sizeof(TCOMP));
     assert((buf_out.width() == buf_in1.width()) && (buf_out.height() == buf_in1.height()));
     assert((buf_in1.width() == buf_in2.width()) && (buf_in1.height() == buf_in2.height()));
     
-    vc::launchParallelFor(buf_out.width(), buf_out.height(), [&](std::size_t x, std::size_t y)
+    vc::launchParallelForRows(buf_out.width(), buf_out.height(), [&](std::size_t y, std::size_t x_begin, std::size_t x_end)
     {
-        ::internal::JoinSplitHelper<TCOMP>::join(buf_in1(x,y), buf_in2(x,y), buf_out(x,y));
+        const auto* row_in1 = buf_in1.rowPtr(y);
+        const auto* row_in2 = buf_in2.rowPtr(y);
+        TCOMP* row_out = buf_out.rowPtr(y);
+        
+        for(std::size_t x = x_begin ; x < x_end ; ++x)
+        {
+            ::internal::JoinSplitHelper<TCOMP>::join(row_in1[x], row_in2[x], row_out[x]);
+        }
     });
 }
 
 template<typename TCOMP, typename Target>
 void vc::image::join(const vc::Buffer2DView<typename vc::type_traits<TCOMP>::ChannelType, Target>& buf_in1, const vc::Buffer2DView<typename vc::type_traits<TCOMP>::ChannelType, Target>& buf_in2, const vc::Buffer2DView<typename vc::type_traits<TCOMP>::ChannelType, Target>& buf_in3, vc::Buffer2DView<TCOMP, Target>& buf_out)
 {
+    VISIONCORE_TRACE_SCOPE_2D("join", buf_out.width(), buf_out.height(), 2 * buf_out.area() * sizeof(TCOMP));
     assert((buf_out.width() == buf_in1.width()) && (buf_out.height() == buf_in1.height()));
     assert((buf_in1.width() == buf_in2.width()) && (buf_in1.height() == buf_in2.height()));
     assert((buf_in2.width() == buf_in3.width()) && (buf_in2.height() == buf_in3.height()));
     
-    vc::launchParallelFor(buf_out.width(), buf_out.height(), [&](std::size_t x, std::size_t y)
+    vc::launchParallelForRows(buf_out.width(), buf_out.height(), [&](std::size_t y, std::size_t x_begin, std::size_t x_end)
     {
-        ::internal::JoinSplitHelper<TCOMP>::join(buf_in1(x,y), buf_in2(x,y), buf_in3(x,y), buf_out(x,y));
+        const auto* row_in1 = buf_in1.rowPtr(y);
+        const auto* row_in2 = buf_in2.rowPtr(y);
+        const auto* row_in3 = buf_in3.rowPtr(y);
+        TCOMP* row_out = buf_out.rowPtr(y);
+        
+        for(std::size_t x = x_begin ; x < x_end ; ++x)
+        {
+            ::internal::JoinSplitHelper<TCOMP>::join(row_in1[x], row_in2[x], row_in3[x], row_out[x]);
+        }
     });
 }
 
 template<typename TCOMP, typename Target>
 void vc::image::join(const vc::Buffer2DView<typename vc::type_traits<TCOMP>::ChannelType, Target>& buf_in1, const vc::Buffer2DView<typename vc::type_traits<TCOMP>::ChannelType, Target>& buf_in2, const vc::Buffer2DView<typename vc::type_traits<TCOMP>::ChannelType, Target>& buf_in3, const vc::Buffer2DView<typename vc::type_traits<TCOMP>::ChannelType, Target>& buf_in4, vc::Buffer2DView<TCOMP, Target>& buf_out)
 {
+    VISIONCORE_TRACE_SCOPE_2D("join", buf_out.width(), buf_out.height(), 2 * buf_out.area() * sizeof(TCOMP));
     assert((buf_out.width() == buf_in1.width()) && (buf_out.height() == buf_in1.height()));
     assert((buf_in1.width() == buf_in2.width()) && (buf_in1.height() == buf_in2.height()));
     assert((buf_in2.width() == buf_in3.width()) && (buf_in2.height() == buf_in3.height()));
     assert((buf_in3.width() == buf_in4.width()) && (buf_in3.height() == buf_in4.height()));
     
-    vc::launchParallelFor(buf_out.width(), buf_out.height(), [&](std::size_t x, std::size_t y)
+    vc::launchParallelForRows(buf_out.width(), buf_out.height(), [&](std::size_t y, std::size_t x_begin, std::size_t x_end)
     {
-        ::internal::JoinSplitHelper<TCOMP>::join(buf_in1(x,y), buf_in2(x,y), buf_in3(x,y), buf_in4(x,y), buf_out(x,y));
+        const auto* row_in1 = buf_in1.rowPtr(y);
+        const auto* row_in2 = buf_in2.rowPtr(y);
+        const auto* row_in3 = buf_in3.rowPtr(y);
+        const auto* row_in4 = buf_in4.rowPtr(y);
+        TCOMP* row_out = buf_out.rowPtr(y);
+        
+        for(std::size_t x = x_begin ; x < x_end ; ++x)
+        {
+            ::internal::JoinSplitHelper<TCOMP>::join(row_in1[x], row_in2[x], row_in3[x], row_in4[x], row_out[x]);
+        }
     });
 }
 
 template<typename TCOMP, typename Target>
 void vc::image::split(const vc::Buffer2DView<TCOMP, Target>& buf_in, vc::Buffer2DView<typename vc::type_traits<TCOMP>::ChannelType, Target>& buf_out1, vc::Buffer2DView<typename vc::type_traits<TCOMP>::ChannelType, Target>& buf_out2)
 {
+    VISIONCORE_TRACE_SCOPE_2D("split", buf_in.width(), buf_in.height(), 2 * buf_in.area() * sizeof(TCOMP));
     assert((buf_in.width() == buf_out1.width()) && (buf_in.height() == buf_out1.height()));
     assert((buf_out1.width() == buf_out2.width()) && (buf_out1.height() == buf_out2.height()));
     
-    vc::launchParallelFor(buf_in.width(), buf_in.height(), [&](std::size_t x, std::size_t y)
+    vc::launchParallelForRows(buf_in.width(), buf_in.height(), [&](std::size_t y, std::size_t x_begin, std::size_t x_end)
     {
-        ::internal::JoinSplitHelper<TCOMP>::split(buf_in(x,y), buf_out1(x,y), buf_out2(x,y));
+        const TCOMP* row_in = buf_in.rowPtr(y);
+        auto* row_out1 = buf_out1.rowPtr(y);
+        auto* row_out2 = buf_out2.rowPtr(y);
+        
+        for(std::size_t x = x_begin ; x < x_end ; ++x)
+        {
+            ::internal::JoinSplitHelper<TCOMP>::split(row_in[x], row_out1[x], row_out2[x]);
+        }
     });
 }
 
 template<typename TCOMP, typename Target>
 void vc::image::split(const vc::Buffer2DView<TCOMP, Target>& buf_in, vc::Buffer2DView<typename vc::type_traits<TCOMP>::ChannelType, Target>& buf_out1, vc::Buffer2DView<typename vc::type_traits<TCOMP>::ChannelType, Target>& buf_out2, vc::Buffer2DView<typename vc::type_traits<TCOMP>::ChannelType, Target>& buf_out3)
 {
+    VISIONCORE_TRACE_SCOPE_2D("split", buf_in.width(), buf_in.height(), 2 * buf_in.area() * sizeof(TCOMP));
     assert((buf_in.width() == buf_out1.width()) && (buf_in.height() == buf_out1.height()));
     assert((buf_out1.width() == buf_out2.width()) && (buf_out1.height() == buf_out2.height()));
     assert((buf_out2.width() == buf_out3.width()) && (buf_out2.height() == buf_out3.height()));
     
-    vc::launchParallelFor(buf_in.width(), buf_in.height(), [&](std::size_t x, std::size_t y)
+    vc::launchParallelForRows(buf_in.width(), buf_in.height(), [&](std::size_t y, std::size_t x_begin, std::size_t x_end)
     {
-        ::internal::JoinSplitHelper<TCOMP>::split(buf_in(x,y), buf_out1(x,y), buf_out2(x,y), buf_out3(x,y));
+        const TCOMP* row_in = buf_in.rowPtr(y);
+        auto* row_out1 = buf_out1.rowPtr(y);
+        auto* row_out2 = buf_out2.rowPtr(y);
+        auto* row_out3 = buf_out3.rowPtr(y);
+        
+        for(std::size_t x = x_begin ; x < x_end ; ++x)
+        {
+            ::internal::JoinSplitHelper<TCOMP>::split(row_in[x], row_out1[x], row_out2[x], row_out3[x]);
+        }
     });
 }
 
 template<typename TCOMP, typename Target>
 void vc::image::split(const vc::Buffer2DView<TCOMP, Target>& buf_in, vc::Buffer2DView<typename vc::type_traits<TCOMP>::ChannelType, Target>& buf_out1, vc::Buffer2DView<typename vc::type_traits<TCOMP>::ChannelType, Target>& buf_out2, vc::Buffer2DView<typename vc::type_traits<TCOMP>::ChannelType, Target>& buf_out3, vc::Buffer2DView<typename vc::type_traits<TCOMP>::ChannelType, Target>& buf_out4)
 {
+    VISIONCORE_TRACE_SCOPE_2D("split", buf_in.width(), buf_in.height(), 2 * buf_in.area() * sizeof(TCOMP));
     assert((buf_in.width() == buf_out1.width()) && (buf_in.height() == buf_out1.height()));
     assert((buf_out1.width() == buf_out2.width()) && (buf_out1.height() == buf_out2.height()));
     assert((buf_out2.width() == buf_out3.width()) && (buf_out2.height() == buf_out3.height()));
     assert((buf_out3.width() == buf_out4.width()) && (buf_out3.height() == buf_out4.height()));
     
-    vc::launchParallelFor(buf_in.width(), buf_in.height(), [&](std::size_t x, std::size_t y)
+    vc::launchParallelForRows(buf_in.width(), buf_in.height(), [&](std::size_t y, std::size_t x_begin, std::size_t x_end)
     {
-        ::internal::JoinSplitHelper<TCOMP>::split(buf_in(x,y), buf_out1(x,y), buf_out2(x,y), buf_out3(x,y), buf_out4(x,y));
+        const TCOMP* row_in = buf_in.rowPtr(y);
+        auto* row_out1 = buf_out1.rowPtr(y);
+        auto* row_out2 = buf_out2.rowPtr(y);
+        auto* row_out3 = buf_out3.rowPtr(y);
+        auto* row_out4 = buf_out4.rowPtr(y);
+        
+        for(std::size_t x = x_begin ; x < x_end ; ++x)
+        {
+            ::internal::JoinSplitHelper<TCOMP>::split(row_in[x], row_out1[x], row_out2[x], row_out3[x], row_out4[x]);
+        }
     });
 }
 
@@ -325,6 +777,7 @@ void vc::image::split(const vc::Buffer2DView<TCOMP, Target>& buf_in, vc::Buffer2
 template<typename T, typename Target>
 void vc::image::fillBuffer(vc::Buffer1DView<T, Target>& buf_in, const typename vc::type_traits<T>::ChannelType& v)
 {
+    VISIONCORE_TRACE_SCOPE_1D("fillBuffer", buf_in.size(), buf_in.bytes());
     std::transform(buf_in.ptr(), buf_in.ptr() + buf_in.size(), buf_in.ptr(), [&](T val) -> T 
     {
         return vc::internal::type_dispatcher_helper<T>::fill(v);
@@ -337,9 +790,12 @@ void vc::image::fillBuffer(vc::Buffer1DView<T, Target>& buf_in, const typename v
 template<typename T, typename Target>
 void vc::image::fillBuffer(vc::Buffer2DView<T, Target>& buf_in, const typename vc::type_traits<T>::ChannelType& v)
 {
-    vc::launchParallelFor(buf_in.width(), buf_in.height(), [&](std::size_t x, std::size_t y)
+    VISIONCORE_TRACE_SCOPE_2D("fillBuffer", buf_in.width(), buf_in.height(), buf_in.area() * sizeof(T));
+    const T fill_value = vc::internal::type_dispatcher_helper<T>::fill(v);
+    
+    vc::launchParallelForRows(buf_in.width(), buf_in.height(), [&](std::size_t y, std::size_t x_begin, std::size_t x_end)
     {
-        buf_in(x,y) = vc::internal::type_dispatcher_helper<T>::fill(v);
+        std::fill(buf_in.rowPtr(y) + x_begin, buf_in.rowPtr(y) + x_end, fill_value);
     });
 }
 
@@ -349,6 +805,7 @@ void vc::image::fillBuffer(vc::Buffer2DView<T, Target>& buf_in, const typename v
 template<typename T, typename Target>
 void vc::image::invertBuffer(vc::Buffer1DView<T, Target>& buf_io)
 {
+    VISIONCORE_TRACE_SCOPE_1D("invertBuffer", buf_io.size(), 2 * buf_io.bytes());
     //typedef typename vc::type_traits<T>::ChannelType Scalar;
     
     std::transform(buf_io.ptr(), buf_io.ptr() + buf_io.size(), buf_io.ptr(), [&](T val) -> T 
@@ -363,9 +820,15 @@ void vc::image::invertBuffer(vc::Buffer1DView<T, Target>& buf_io)
 template<typename T, typename Target>
 void vc::image::invertBuffer(vc::Buffer2DView<T, Target>& buf_io)
 {
-    vc::launchParallelFor(buf_io.width(), buf_io.height(), [&](std::size_t x, std::size_t y)
+    VISIONCORE_TRACE_SCOPE_2D("invertBuffer", buf_io.width(), buf_io.height(), 2 * buf_io.area() * sizeof(T));
+    vc::launchParallelForRows(buf_io.width(), buf_io.height(), [&](std::size_t y, std::size_t x_begin, std::size_t x_end)
     {
-        buf_io(x,y) = ::internal::JoinSplitHelper<T>::invertedValue(buf_io(x,y));
+        T* row = buf_io.rowPtr(y);
+        
+        for(std::size_t x = x_begin ; x < x_end ; ++x)
+        {
+            row[x] = ::internal::JoinSplitHelper<T>::invertedValue(row[x]);
+        }
     });
 }
 
@@ -375,19 +838,15 @@ void vc::image::invertBuffer(vc::Buffer2DView<T, Target>& buf_io)
 template<typename T, typename Target>
 void vc::image::thresholdBuffer(const vc::Buffer2DView<T, Target>& buf_in, vc::Buffer2DView<T, Target>& buf_out, T thr, T val_below, T val_above)
 {
-    vc::launchParallelFor(buf_in.width(), buf_in.height(), [&](std::size_t x, std::size_t y)
+    VISIONCORE_TRACE_SCOPE_2D("thresholdBuffer", buf_out.width(), buf_out.height(), 2 * buf_out.area() * sizeof(T));
+    vc::launchParallelForRows(buf_in.width(), buf_in.height(), [&](std::size_t y, std::size_t x_begin, std::size_t x_end)
     {
-        if(buf_in.inBounds(x,y)) // is valid
+        const T* row_in = buf_in.rowPtr(y);
+        T* row_out = buf_out.rowPtr(y);
+        
+        for(std::size_t x = x_begin ; x < x_end ; ++x)
         {
-            const T& val = buf_in(x,y);
-            if(val < thr)
-            {
-                buf_out(x,y) = val_below;
-            }
-            else
-            {
-                buf_out(x,y) = val_above;
-            }
+            row_out[x] = row_in[x] < thr ? val_below : val_above;
         }
     });
 }
@@ -398,11 +857,15 @@ void vc::image::thresholdBuffer(const vc::Buffer2DView<T, Target>& buf_in, vc::B
 template<typename T, typename Target>
 void vc::image::thresholdBuffer(const vc::Buffer2DView<T, Target>& buf_in, vc::Buffer2DView<T, Target>& buf_out, T thr, T val_below, T val_above, T minval, T maxval, bool saturation)
 {
-    vc::launchParallelFor(buf_in.width(), buf_in.height(), [&](std::size_t x, std::size_t y)
+    VISIONCORE_TRACE_SCOPE_2D("thresholdBuffer", buf_out.width(), buf_out.height(), 2 * buf_out.area() * sizeof(T));
+    vc::launchParallelForRows(buf_in.width(), buf_in.height(), [&](std::size_t y, std::size_t x_begin, std::size_t x_end)
     {
-        if(buf_in.inBounds(x,y)) // is valid
+        const T* row_in = buf_in.rowPtr(y);
+        T* row_out = buf_out.rowPtr(y);
+        
+        for(std::size_t x = x_begin ; x < x_end ; ++x)
         {
-            T val = buf_in(x,y);
+            T val = row_in[x];
             
             if(saturation)
             {
@@ -411,14 +874,7 @@ void vc::image::thresholdBuffer(const vc::Buffer2DView<T, Target>& buf_in, vc::B
             
             const T relative_val = (val - minval) / (maxval - minval);
             
-            if(relative_val < thr)
-            {
-                buf_out(x,y) = val_below;
-            }
-            else
-            {
-                buf_out(x,y) = val_above;
-            }
+            row_out[x] = relative_val < thr ? val_below : val_above;
         }
     });
 }
@@ -429,17 +885,18 @@ void vc::image::thresholdBuffer(const vc::Buffer2DView<T, Target>& buf_in, vc::B
 template<typename T, typename Target>
 void vc::image::flipXBuffer(const vc::Buffer2DView<T, Target>& buf_in, vc::Buffer2DView<T, Target>& buf_out)
 {
+    VISIONCORE_TRACE_SCOPE_2D("flipXBuffer", buf_out.width(), buf_out.height(), 2 * buf_out.area() * sizeof(T));
     assert((buf_in.width() == buf_out.width()) && (buf_in.height() == buf_out.height()));
     
-    vc::launchParallelFor(buf_out.width(), buf_out.height(), [&](std::size_t x, std::size_t y)
+    vc::launchParallelForRows(buf_out.width(), std::min(buf_in.height(), buf_out.height()), 
+                              [&](std::size_t y, std::size_t x_begin, std::size_t x_end)
     {
-        if(buf_out.inBounds(x,y)) // is valid
+        const T* row_in = buf_in.rowPtr(y);
+        T* row_out = buf_out.rowPtr(y);
+        
+        for(std::size_t x = x_begin ; x < std::min(x_end, buf_in.width()) ; ++x)
         {
-            const std::size_t nx = ((buf_in.width() - 1) - x);
-            if(buf_in.inBounds(nx,y))
-            {
-                buf_out(x,y) = buf_in(nx,y);
-            }
+            row_out[x] = row_in[(buf_in.width() - 1) - x];
         }
     });
 }
@@ -450,32 +907,35 @@ void vc::image::flipXBuffer(const vc::Buffer2DView<T, Target>& buf_in, vc::Buffe
 template<typename T, typename Target>
 void vc::image::flipYBuffer(const vc::Buffer2DView<T, Target>& buf_in, vc::Buffer2DView<T, Target>& buf_out)
 {
+    VISIONCORE_TRACE_SCOPE_2D("flipYBuffer", buf_out.width(), buf_out.height(), 2 * buf_out.area() * sizeof(T));
     assert((buf_in.width() == buf_out.width()) && (buf_in.height() == buf_out.height()));
     
-    vc::launchParallelFor(buf_out.width(), buf_out.height(), [&](std::size_t x, std::size_t y)
+    vc::launchParallelForRows(std::min(buf_in.width(), buf_out.width()), std::min(buf_in.height(), buf_out.height()), 
+                              [&](std::size_t y, std::size_t x_begin, std::size_t x_end)
     {
-        if(buf_out.inBounds(x,y)) // is valid
-        {
-            const std::size_t ny = ((buf_in.height() - 1) - y);
-            if(buf_in.inBounds(x,ny))
-            {
-                buf_out(x,y) = buf_in(x,ny);
-            }
-        }
+        const T* row_in = buf_in.rowPtr((buf_in.height() - 1) - y);
+        T* row_out = buf_out.rowPtr(y);
+        
+        std::copy(row_in + x_begin, row_in + x_end, row_out + x_begin);
     });
 }
 
 template<typename T, typename Target>
 void vc::image::bufferSubstract(const vc::Buffer2DView<T, Target>& buf_in1, const vc::Buffer2DView<T, Target>& buf_in2, vc::Buffer2DView<T, Target>& buf_out)
 {
+    VISIONCORE_TRACE_SCOPE_2D("bufferSubstract", buf_out.width(), buf_out.height(), 3 * buf_out.area() * sizeof(T));
     assert((buf_in1.width() == buf_out.width()) && (buf_in1.height() == buf_out.height()));
     assert((buf_in2.width() == buf_out.width()) && (buf_in2.height() == buf_out.height()));
     
-    vc::launchParallelFor(buf_out.width(), buf_out.height(), [&](std::size_t x, std::size_t y)
+    vc::launchParallelForRows(buf_out.width(), buf_out.height(), [&](std::size_t y, std::size_t x_begin, std::size_t x_end)
     {
-        if(buf_out.inBounds(x,y)) // is valid
+        const T* row_in1 = buf_in1.rowPtr(y);
+        const T* row_in2 = buf_in2.rowPtr(y);
+        T* row_out = buf_out.rowPtr(y);
+        
+        for(std::size_t x = x_begin ; x < x_end ; ++x)
         {
-            buf_out(x,y) = buf_in1(x,y) - buf_in2(x,y);
+            row_out[x] = row_in1[x] - row_in2[x];
         }
     });
 }
@@ -483,14 +943,19 @@ void vc::image::bufferSubstract(const vc::Buffer2DView<T, Target>& buf_in1, cons
 template<typename T, typename Target>
 void vc::image::bufferSubstractL1(const vc::Buffer2DView<T, Target>& buf_in1, const vc::Buffer2DView<T, Target>& buf_in2, vc::Buffer2DView<T, Target>& buf_out)
 {
+    VISIONCORE_TRACE_SCOPE_2D("bufferSubstractL1", buf_out.width(), buf_out.height(), 3 * buf_out.area() * sizeof(T));
     assert((buf_in1.width() == buf_out.width()) && (buf_in1.height() == buf_out.height()));
     assert((buf_in2.width() == buf_out.width()) && (buf_in2.height() == buf_out.height()));
     
-    vc::launchParallelFor(buf_out.width(), buf_out.height(), [&](std::size_t x, std::size_t y)
+    vc::launchParallelForRows(buf_out.width(), buf_out.height(), [&](std::size_t y, std::size_t x_begin, std::size_t x_end)
     {
-        if(buf_out.inBounds(x,y)) // is valid
+        const T* row_in1 = buf_in1.rowPtr(y);
+        const T* row_in2 = buf_in2.rowPtr(y);
+        T* row_out = buf_out.rowPtr(y);
+        
+        for(std::size_t x = x_begin ; x < x_end ; ++x)
         {
-            buf_out(x,y) = vc::math::lossL1(buf_in1(x,y) - buf_in2(x,y));
+            row_out[x] = vc::math::lossL1(row_in1[x] - row_in2[x]);
         }
     });
 }
@@ -498,14 +963,19 @@ void vc::image::bufferSubstractL1(const vc::Buffer2DView<T, Target>& buf_in1, co
 template<typename T, typename Target>
 void vc::image::bufferSubstractL2(const vc::Buffer2DView<T, Target>& buf_in1, const vc::Buffer2DView<T, Target>& buf_in2, vc::Buffer2DView<T, Target>& buf_out)
 {
+    VISIONCORE_TRACE_SCOPE_2D("bufferSubstractL2", buf_out.width(), buf_out.height(), 3 * buf_out.area() * sizeof(T));
     assert((buf_in1.width() == buf_out.width()) && (buf_in1.height() == buf_out.height()));
     assert((buf_in2.width() == buf_out.width()) && (buf_in2.height() == buf_out.height()));
     
-    vc::launchParallelFor(buf_out.width(), buf_out.height(), [&](std::size_t x, std::size_t y)
+    vc::launchParallelForRows(buf_out.width(), buf_out.height(), [&](std::size_t y, std::size_t x_begin, std::size_t x_end)
     {
-        if(buf_out.inBounds(x,y)) // is valid
+        const T* row_in1 = buf_in1.rowPtr(y);
+        const T* row_in2 = buf_in2.rowPtr(y);
+        T* row_out = buf_out.rowPtr(y);
+        
+        for(std::size_t x = x_begin ; x < x_end ; ++x)
         {
-            buf_out(x,y) = vc::math::lossL2(buf_in1(x,y) - buf_in2(x,y));
+            row_out[x] = vc::math::lossL2(row_in1[x] - row_in2[x]);
         }
     });
 }
@@ -513,6 +983,7 @@ void vc::image::bufferSubstractL2(const vc::Buffer2DView<T, Target>& buf_in1, co
 template<typename T, typename Target>
 T vc::image::bufferSum(const vc::Buffer1DView<T, Target>& buf_in, const T& initial, unsigned int tbp)
 {
+    VISIONCORE_TRACE_SCOPE_1D("bufferSum", buf_in.size(), buf_in.bytes());
     return vc::launchParallelReduce(buf_in.size(), initial,
     [&](const std::size_t i, T& v)
     {
@@ -527,10 +998,16 @@ T vc::image::bufferSum(const vc::Buffer1DView<T, Target>& buf_in, const T& initi
 template<typename T, typename Target>
 T vc::image::bufferSum(const vc::Buffer2DView<T, Target>& buf_in, const T& initial, unsigned int tbp)
 {
-    return vc::launchParallelReduce(buf_in.width(), buf_in.height(), initial,
-    [&](const std::size_t x, const std::size_t y, T& v)
+    VISIONCORE_TRACE_SCOPE_2D("bufferSum", buf_in.width(), buf_in.height(), buf_in.area() * sizeof(T));
+    return vc::launchParallelReduceRows(buf_in.width(), buf_in.height(), initial,
+    [&](const std::size_t y, const std::size_t x_begin, const std::size_t x_end, T& v)
     {
-        v += buf_in(x,y);
+        const T* row = buf_in.rowPtr(y);
+        
+        for(std::size_t x = x_begin ; x < x_end ; ++x)
+        {
+            v += row[x];
+        }
     },
     [&](const T& v1, const T& v2)
     {
@@ -572,6 +1049,8 @@ template BUF_TYPE vc::image::calcBufferMean<BUF_TYPE, vc::TargetHost>(const vc::
 template BUF_TYPE vc::image::calcBufferMin<BUF_TYPE, vc::TargetHost>(const vc::Buffer2DView< BUF_TYPE, vc::TargetHost >& buf_in); \
 template BUF_TYPE vc::image::calcBufferMax<BUF_TYPE, vc::TargetHost>(const vc::Buffer2DView< BUF_TYPE, vc::TargetHost >& buf_in); \
 template BUF_TYPE vc::image::calcBufferMean<BUF_TYPE, vc::TargetHost>(const vc::Buffer2DView< BUF_TYPE, vc::TargetHost >& buf_in); \
+template vc::image::BufferStats<BUF_TYPE> vc::image::calcBufferStats<BUF_TYPE, vc::TargetHost>(const vc::Buffer2DView< BUF_TYPE, vc::TargetHost >& buf_in); \
+template vc::image::BufferStats<BUF_TYPE> vc::image::calcBufferStats<BUF_TYPE, vc::TargetHost>(const vc::Buffer2DView< BUF_TYPE, vc::TargetHost >& buf_in, BUF_TYPE invalid_value); \
 template void vc::image::thresholdBuffer<BUF_TYPE, vc::TargetHost>(const vc::Buffer2DView< BUF_TYPE, vc::TargetHost>& buf_in, vc::Buffer2DView<BUF_TYPE, vc::TargetHost>& buf_out, BUF_TYPE thr, BUF_TYPE val_below, BUF_TYPE val_above); \
 template void vc::image::thresholdBuffer<BUF_TYPE, vc::TargetHost>(const vc::Buffer2DView< BUF_TYPE, vc::TargetHost>& buf_in, vc::Buffer2DView<BUF_TYPE, vc::TargetHost>& buf_out, BUF_TYPE thr, BUF_TYPE val_below, BUF_TYPE val_above, BUF_TYPE minval, BUF_TYPE maxval, bool saturation);
 
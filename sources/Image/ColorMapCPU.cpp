@@ -48,6 +48,7 @@ std::size_t getColorMapSizeForwarder(vc::image::ColorMap cm) { return getColorMa
 template<typename T, typename TOUT, typename Target>
 void vc::image::createColorMap(ColorMap cm, const vc::Buffer1DView<T,Target>& img_in, const T& vmin, const T& vmax, vc::Buffer1DView<TOUT,Target>& img_out)
 {
+    VISIONCORE_TRACE_SCOPE_1D("createColorMap", img_out.size(), img_in.bytes() + img_out.bytes());
     const std::size_t cms = getColorMapSize(cm);
     const float3* data = getColorMapData(cm);
     
@@ -67,18 +68,20 @@ void vc::image::createColorMap(ColorMap cm, const vc::Buffer1DView<T,Target>& im
 template<typename T, typename TOUT, typename Target>
 void vc::image::createColorMap(ColorMap cm, const vc::Buffer2DView<T,Target>& img_in, const T& vmin, const T& vmax, vc::Buffer2DView<TOUT,Target>& img_out)
 {
+    VISIONCORE_TRACE_SCOPE_2D("createColorMap", img_out.width(), img_out.height(), img_out.area() * (sizeof(T) + sizeof(TOUT)));
     const std::size_t cms = getColorMapSize(cm);
     const float3* data = getColorMapData(cm);
     
-    vc::launchParallelFor(img_in.width(), img_in.height(), [&](std::size_t x, std::size_t y)
+    vc::launchParallelForRows(std::min(img_in.width(), img_out.width()), std::min(img_in.height(), img_out.height()), 
+                              [&](std::size_t y, std::size_t x_begin, std::size_t x_end)
     {
-        if(img_in.inBounds(x,y) && img_out.inBounds(x,y))
+        const T* row_in = img_in.rowPtr(y);
+        TOUT* row_out = img_out.rowPtr(y);
+        
+        for(std::size_t x = x_begin ; x < x_end ; ++x)
         {
-            const T& val_in = img_in(x,y);
-            TOUT& val_out = img_out(x,y);
-            
-            float3 result = getColorMapValuePreload(cms, data, vmin, vmax, val_in);
-            val_out = ConvertToTarget<TOUT>::run(result);
+            float3 result = getColorMapValuePreload(cms, data, vmin, vmax, row_in[x]);
+            row_out[x] = ConvertToTarget<TOUT>::run(result);
         }
     });
 }
@@ -42,16 +42,23 @@
 template<typename T>
 void vc::image::computeGradient(const vc::Buffer2DView<T,vc::TargetHost>& img_in, vc::Buffer2DView<Eigen::Matrix<T,2,1>, vc::TargetHost>& grad_img)
 {
-    tbb::parallel_for(tbb::blocked_range2d<std::size_t>(1, img_in.height() - 1, 1, img_in.width() - 1), [&](const tbb::blocked_range2d<std::size_t>& r)
+    VISIONCORE_TRACE_SCOPE_2D("computeGradient", img_in.width(), img_in.height(), img_in.area() * (sizeof(T) + 2 * sizeof(T)));
+    if(img_in.width() < 3 || img_in.height() < 3) { return; }
+    
+    // interior only, offset by one
+    vc::launchParallelForRows(img_in.width() - 2, img_in.height() - 2, [&](std::size_t yi, std::size_t x_begin, std::size_t x_end)
     {
-        for(std::size_t y = r.rows().begin() ; y != r.rows().end() ; ++y )
+        const std::size_t y = yi + 1;
+        const T* row_prev = img_in.rowPtr(y-1);
+        const T* row = img_in.rowPtr(y);
+        const T* row_next = img_in.rowPtr(y+1);
+        Eigen::Matrix<T,2,1>* row_grad = grad_img.rowPtr(y);
+        
+        for(std::size_t x = x_begin + 1 ; x != x_end + 1 ; ++x ) 
         {
-            for(std::size_t x = r.cols().begin() ; x != r.cols().end() ; ++x ) 
-            {
-                Eigen::Matrix<T,2,1>& grad = grad_img(x,y);
-                grad(0) = img_in(x+1,y) - img_in(x-1,y); // dX
-                grad(1) = img_in(x,y+1) - img_in(x,y-1); // dY
-            }
+            Eigen::Matrix<T,2,1>& grad = row_grad[x];
+            grad(0) = row[x+1] - row[x-1]; // dX
+            grad(1) = row_next[x] - row_prev[x]; // dY
         }
     });
 }
@@ -235,6 +242,7 @@ static void contour_tracing(vc::Buffer2DView<T,vc::TargetHost>& input, vc::image
 template<typename T,typename T2>
 vc::image::BlobID vc::image::blobDetector(vc::Buffer2DView<T,vc::TargetHost>& img_thr, vc::image::BlobImageT& output, BlobMapT<T2>& bmap, T valid_val, bool do_contour)
 {
+    VISIONCORE_TRACE_SCOPE_2D("blobDetector", img_thr.width(), img_thr.height(), img_thr.area() * (sizeof(T) + sizeof(vc::image::BlobID)));
     BlobID cur_label = 1;
     
     // clear output
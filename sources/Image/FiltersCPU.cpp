@@ -37,73 +37,135 @@
 
 #include <VisionCore/LaunchUtils.hpp>
 
-template<typename T, typename Target>
-void vc::image::bilateral(const vc::Buffer2DView<T,Target>& img_in, vc::Buffer2DView<T,Target>& img_out, 
-                          const T& gs, const T& gr, std::size_t dim)
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include <Image/StencilHelpers.hpp>
+
+namespace
 {
-    vc::launchParallelFor(img_in.width(), img_in.height(), [&](std::size_t x, std::size_t y)
+    /**
+     * Spatial weights of the (2 dim + 1)^2 window, row major, computed once per call.
+     */
+    template<typename T>
+    std::vector<T> bilateralSpatialWeights(const T& gs, std::size_t dim)
+    {
+        const int d = (int)dim;
+        std::vector<T> sw;
+        sw.reserve((2 * dim + 1) * (2 * dim + 1));
+        
+        for(int r = -d; r <= d; ++r ) 
+        {
+            for(int c = -d; c <= d; ++c ) 
+            {
+                const T sd2 = r*r + c*c;
+                sw.push_back(std::exp(-(sd2) / (T(2.0) * gs * gs)));
+            }
+        }
+        
+        return sw;
+    }
+    
+    /**
+     * One output pixel, fetch(c, r) reads the tap at offset (c, r). With UseMinval only taps q >= minval 
+     * count, otherwise all of them, so NaN taps propagate as they always did.
+     * The interior passes plain row pointers, the border goes through the border policy.
+     */
+    template<bool UseMinval, typename T, typename FetchFunction>
+    inline T bilateralPixel(const T& p, const T* sw, int dim, const T& gr, const T& minval, FetchFunction fetch)
     {
-        const T& p = img_in(x,y);
+        const T inv_2gr2 = T(1.0) / (T(2.0) * gr * gr);
         T sum = T(0.0);
         T sumw = T(0.0);
         
-        for(int r = -(int)dim; r <= (int)dim; ++r ) 
+        for(int r = -dim; r <= dim; ++r ) 
         {
-            for(int c = -(int)dim; c <= (int)dim; ++c ) 
+            for(int c = -dim; c <= dim; ++c, ++sw ) 
             {
-                const T& q = img_in.getWithClampedRange(x+c, y+r);
-                const T sd2 = r*r + c*c;
-                const T id = p-q;
-                const T id2 = id*id;
-                const T sw = exp(-(sd2) / (T(2.0) * gs * gs));
-                const T iw = exp(-(id2) / (T(2.0) * gr * gr));
-                const T w = sw*iw;
-                sumw += w;
-                sum += w * q;
+                const T q = fetch(c, r);
+                if(!UseMinval || q >= minval) 
+                {
+                    const T id = p-q;
+                    const T w = *sw * std::exp(-(id*id) * inv_2gr2);
+                    sumw += w;
+                    sum += w * q;
+                }
             }
         }
         
-        img_out(x,y) = (T)(sum / sumw);
-    });
+        return sum / sumw;
+    }
+    
+    template<bool UseMinval, typename T>
+    void bilateralStencil(const vc::Buffer2DView<T,vc::TargetHost>& img_in, vc::Buffer2DView<T,vc::TargetHost>& img_out, 
+                          const T& gs, const T& gr, const T& minval, std::size_t dim, 
+                          vc::BorderMode border, const T& border_value)
+    {
+        const std::vector<T> sw = bilateralSpatialWeights(gs, dim);
+        const ::internal::BorderReader<T> reader{img_in, border, border_value};
+        
+        const std::ptrdiff_t pitch = img_in.pitch() / sizeof(T);
+        
+        // with minval, pixels below it have no valid taps (0/0 as before)
+        const T invalid = std::numeric_limits<T>::quiet_NaN();
+        
+        ::internal::launchStencil(img_in.width(), img_in.height(), dim, dim, border, 
+                                  [&](std::size_t y, std::size_t x_begin, std::size_t x_end)
+        {
+            const T* row_in = img_in.rowPtr(y);
+            T* row_out = img_out.rowPtr(y);
+            
+            for(std::size_t x = x_begin ; x < x_end ; ++x)
+            {
+                const T* center = row_in + x;
+                row_out[x] = (UseMinval && !(*center >= minval)) ? invalid : 
+                    bilateralPixel<UseMinval>(*center, sw.data(), (int)dim, gr, minval, [&](int c, int r) { return center[r * pitch + c]; });
+            }
+        },
+        [&](std::size_t x, std::size_t y)
+        {
+            const T& p = img_in(x, y);
+            img_out(x, y) = (UseMinval && !(p >= minval)) ? invalid : 
+                bilateralPixel<UseMinval>(p, sw.data(), (int)dim, gr, minval, [&](int c, int r) { return reader((int)x + c, (int)y + r); });
+        });
+    }
+}
+
+template<typename T, typename Target>
+void vc::image::bilateral(const vc::Buffer2DView<T,Target>& img_in, vc::Buffer2DView<T,Target>& img_out, 
+                          const T& gs, const T& gr, std::size_t dim)
+{
+    bilateral(img_in, img_out, gs, gr, dim, vc::BorderMode::Clamp);
 }
 
 template<typename T, typename Target>
 void vc::image::bilateral(const vc::Buffer2DView<T,Target>& img_in, vc::Buffer2DView<T,Target>& img_out, 
                           const T& gs, const T& gr, const T& minval, std::size_t dim)
 {
-    vc::launchParallelFor(img_in.width(), img_in.height(), [&](std::size_t x, std::size_t y)
-    {
-            const T& p = img_in(x,y);
-            T sum = T(0.0);
-            T sumw = T(0.0);
-            
-            if( p >= minval) {
-                for(int r = -(int)dim; r <= (int)dim; ++r ) 
-                {
-                    for(int c = -(int)dim; c <= (int)dim; ++c ) 
-                    {
-                        const T& q = img_in.getWithClampedRange(x+c, y+r);
-                        if(q >= minval) 
-                        {
-                            const T sd2 = r*r + c*c;
-                            const T id = p-q;
-                            const T id2 = id*id;
-                            const T sw = exp(-(sd2) / (T(2.0) * gs * gs));
-                            const T iw = exp(-(id2) / (T(2.0) * gr * gr));
-                            const T w = sw*iw;
-                            sumw += w;
-                            sum += w * q;
-                        }
-                    }
-                }
-            }
-            
-            img_out(x,y) = (T)(sum / sumw);
-    });
+    bilateral(img_in, img_out, gs, gr, minval, dim, vc::BorderMode::Clamp);
+}
+
+template<typename T>
+void vc::image::bilateral(const vc::Buffer2DView<T,vc::TargetHost>& img_in, vc::Buffer2DView<T,vc::TargetHost>& img_out, 
+                          const T& gs, const T& gr, std::size_t dim, vc::BorderMode border, const T& border_value)
+{
+    VISIONCORE_TRACE_SCOPE_2D("bilateral", img_in.width(), img_in.height(), 2 * img_in.area() * sizeof(T));
+    bilateralStencil<false>(img_in, img_out, gs, gr, T(0.0), dim, border, border_value);
+}
+
+template<typename T>
+void vc::image::bilateral(const vc::Buffer2DView<T,vc::TargetHost>& img_in, vc::Buffer2DView<T,vc::TargetHost>& img_out, 
+                          const T& gs, const T& gr, const T& minval, std::size_t dim, vc::BorderMode border, const T& border_value)
+{
+    VISIONCORE_TRACE_SCOPE_2D("bilateral", img_in.width(), img_in.height(), 2 * img_in.area() * sizeof(T));
+    bilateralStencil<true>(img_in, img_out, gs, gr, minval, dim, border, border_value);
 }
 
 #define GEN_IMPL(OUR_TYPE) \
 template void vc::image::bilateral<OUR_TYPE,vc::TargetHost>(const vc::Buffer2DView<OUR_TYPE,vc::TargetHost>& img_in, vc::Buffer2DView<OUR_TYPE,vc::TargetHost>& img_out, const OUR_TYPE& gs, const OUR_TYPE& gr, std::size_t dim); \
-template void vc::image::bilateral<OUR_TYPE,vc::TargetHost>(const vc::Buffer2DView<OUR_TYPE,vc::TargetHost>& img_in, vc::Buffer2DView<OUR_TYPE,vc::TargetHost>& img_out, const OUR_TYPE& gs, const OUR_TYPE& gr, const OUR_TYPE& minval, std::size_t dim);
+template void vc::image::bilateral<OUR_TYPE,vc::TargetHost>(const vc::Buffer2DView<OUR_TYPE,vc::TargetHost>& img_in, vc::Buffer2DView<OUR_TYPE,vc::TargetHost>& img_out, const OUR_TYPE& gs, const OUR_TYPE& gr, const OUR_TYPE& minval, std::size_t dim); \
+template void vc::image::bilateral<OUR_TYPE>(const vc::Buffer2DView<OUR_TYPE,vc::TargetHost>& img_in, vc::Buffer2DView<OUR_TYPE,vc::TargetHost>& img_out, const OUR_TYPE& gs, const OUR_TYPE& gr, std::size_t dim, vc::BorderMode border, const OUR_TYPE& border_value); \
+template void vc::image::bilateral<OUR_TYPE>(const vc::Buffer2DView<OUR_TYPE,vc::TargetHost>& img_in, vc::Buffer2DView<OUR_TYPE,vc::TargetHost>& img_out, const OUR_TYPE& gs, const OUR_TYPE& gr, const OUR_TYPE& minval, std::size_t dim, vc::BorderMode border, const OUR_TYPE& border_value);
 
 GEN_IMPL(float)
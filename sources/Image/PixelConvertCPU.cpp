@@ -37,100 +37,297 @@
 
 #include <VisionCore/LaunchUtils.hpp>
 
-template<typename T_IN, typename T_OUT, typename Target>
-void vc::image::convertBuffer(const vc::Buffer2DView<T_IN, Target>& buf_in, vc::Buffer2DView<T_OUT, Target>& buf_out)
+#include <algorithm>
+#include <type_traits>
+
+#include <VisionCore/CPUFeatures.hpp>
+
+#define VISIONCORE_CONVERT_KERNELS convertKernelsGeneric
+#include <Image/PixelConvertKernelsImpl.hpp>
+
+namespace
 {
-    vc::launchParallelFor(buf_in.width(), buf_in.height(), [&](std::size_t x, std::size_t y)
+    typedef vc::image::internal::ConvertKernels ConvertKernels;
+
+    const ConvertKernels& selectConvertKernels()
+    {
+#ifdef VISIONCORE_HAVE_CPU_DISPATCH
+        switch(vc::getCPULevel())
+        {
+            case vc::CPULevel::AVX512: return vc::image::internal::convertKernelsAVX512;
+            case vc::CPULevel::AVX2: return vc::image::internal::convertKernelsAVX2;
+            case vc::CPULevel::SSE42: return vc::image::internal::convertKernelsSSE42;
+            default: break;
+        }
+#endif // VISIONCORE_HAVE_CPU_DISPATCH
+        return vc::image::internal::convertKernelsGeneric;
+    }
+
+    inline float roundingBias(vc::image::ConvertRounding rounding)
+    {
+        return rounding == vc::image::ConvertRounding::Nearest ? 0.5f : 0.0f;
+    }
+
+    inline uint8_t saturatePixel(float v, float bias) { return saturateU8(v, bias); }
+    inline uchar3 saturatePixel(const float3& v, float bias) { return make_uchar3(saturateU8(v.x, bias), saturateU8(v.y, bias), saturateU8(v.z, bias)); }
+    inline uchar4 saturatePixel(const float4& v, float bias) { return make_uchar4(saturateU8(v.x, bias), saturateU8(v.y, bias), saturateU8(v.z, bias), saturateU8(v.w, bias)); }
+
+    template<typename T> struct FloatPixel;
+    template<> struct FloatPixel<uint8_t> { typedef float Type; };
+    template<> struct FloatPixel<uchar3> { typedef float3 Type; };
+    template<> struct FloatPixel<uchar4> { typedef float4 Type; };
+
+    /**
+     * Row conversion, generic version goes through convertPixel.
+     */
+    template<typename T_IN, typename T_OUT, typename Enable = void>
+    struct ConvertRow
+    {
+        static inline void run(const ConvertKernels&, const T_IN* in, T_OUT* out, std::size_t n, vc::image::ConvertRounding)
+        {
+            for(std::size_t x = 0 ; x < n ; ++x)
+            {
+                out[x] = vc::image::convertPixel<T_OUT, T_IN>(in[x]);
+            }
+        }
+    };
+
+    /**
+     * Single precision to 8 bit channels, with the rounding policy applied.
+     */
+    template<typename T_IN, typename T_OUT>
+    struct ConvertRow<T_IN, T_OUT, typename std::enable_if<std::is_same<typename vc::type_traits<T_IN>::ChannelType, float>::value &&
+                                                           std::is_same<typename vc::type_traits<T_OUT>::ChannelType, uint8_t>::value>::type>
+    {
+        static inline void run(const ConvertKernels&, const T_IN* in, T_OUT* out, std::size_t n, vc::image::ConvertRounding rounding)
+        {
+            const float bias = roundingBias(rounding);
+            for(std::size_t x = 0 ; x < n ; ++x)
+            {
+                out[x] = saturatePixel(vc::image::convertPixel<typename FloatPixel<T_OUT>::Type, T_IN>(in[x]), bias);
+            }
+        }
+    };
+
+    /// Same channel count, channel-wise 8 bit to float
+    template<typename T_IN, typename T_OUT>
+    struct ConvertRowU8ToF32
+    {
+        static_assert(sizeof(T_IN) * sizeof(float) == sizeof(T_OUT), "Channel count mismatch");
+
+        static inline void run(const ConvertKernels& k, const T_IN* in, T_OUT* out, std::size_t n, vc::image::ConvertRounding)
+        {
+            k.u8ToF32(reinterpret_cast<const uint8_t*>(in), reinterpret_cast<float*>(out), n * sizeof(T_IN));
+        }
+    };
+
+    /// Same channel count, channel-wise float to 8 bit
+    template<typename T_IN, typename T_OUT>
+    struct ConvertRowF32ToU8
+    {
+        static_assert(sizeof(T_IN) == sizeof(T_OUT) * sizeof(float), "Channel count mismatch");
+
+        static inline void run(const ConvertKernels& k, const T_IN* in, T_OUT* out, std::size_t n, vc::image::ConvertRounding rounding)
+        {
+            k.f32ToU8(reinterpret_cast<const float*>(in), reinterpret_cast<uint8_t*>(out), n * sizeof(T_OUT), roundingBias(rounding));
+        }
+    };
+
+    /// Grey float to 8 bit colour, blocks go through the vector kernel and then get broadcast
+    template<typename T_OUT>
+    struct ConvertRowF32ToColour
+    {
+        static inline void run(const ConvertKernels& k, const float* in, T_OUT* out, std::size_t n, vc::image::ConvertRounding rounding)
+        {
+            static constexpr std::size_t BlockSize = 256;
+            const float bias = roundingBias(rounding);
+            uint8_t grey[BlockSize];
+            for(std::size_t i = 0 ; i < n ; i += BlockSize)
+            {
+                const std::size_t count = std::min(n - i, BlockSize);
+                k.f32ToU8(in + i, grey, count, bias);
+                for(std::size_t k = 0 ; k < count ; ++k)
+                {
+                    out[i + k] = vc::image::convertPixel<T_OUT, uint8_t>(grey[k]);
+                }
+            }
+        }
+    };
+
+    template<> struct ConvertRow<uint8_t, float> : ConvertRowU8ToF32<uint8_t, float> { };
+    template<> struct ConvertRow<uchar3, float3> : ConvertRowU8ToF32<uchar3, float3> { };
+    template<> struct ConvertRow<uchar4, float4> : ConvertRowU8ToF32<uchar4, float4> { };
+    template<> struct ConvertRow<uchar3, Eigen::Vector3f> : ConvertRowU8ToF32<uchar3, Eigen::Vector3f> { };
+    template<> struct ConvertRow<uchar4, Eigen::Vector4f> : ConvertRowU8ToF32<uchar4, Eigen::Vector4f> { };
+
+    template<> struct ConvertRow<float, uint8_t> : ConvertRowF32ToU8<float, uint8_t> { };
+    template<> struct ConvertRow<float3, uchar3> : ConvertRowF32ToU8<float3, uchar3> { };
+    template<> struct ConvertRow<float4, uchar4> : ConvertRowF32ToU8<float4, uchar4> { };
+    template<> struct ConvertRow<Eigen::Vector3f, uchar3> : ConvertRowF32ToU8<Eigen::Vector3f, uchar3> { };
+    template<> struct ConvertRow<Eigen::Vector4f, uchar4> : ConvertRowF32ToU8<Eigen::Vector4f, uchar4> { };
+    template<> struct ConvertRow<float, uchar3> : ConvertRowF32ToColour<uchar3> { };
+    template<> struct ConvertRow<float, uchar4> : ConvertRowF32ToColour<uchar4> { };
+
+    template<> struct ConvertRow<uint16_t, float>
+    {
+        static inline void run(const ConvertKernels& k, const uint16_t* in, float* out, std::size_t n, vc::image::ConvertRounding) { k.u16ToF32(in, out, n); }
+    };
+
+    template<> struct ConvertRow<uchar3, uchar4>
     {
-        if(buf_in.inBounds(x,y) && buf_out.inBounds(x,y)) // is valid
+        static inline void run(const ConvertKernels& k, const uchar3* in, uchar4* out, std::size_t n, vc::image::ConvertRounding)
         {
-            buf_out(x,y) = vc::image::convertPixel<T_OUT, T_IN>(buf_in(x,y));
+            k.rgbToRGBA(reinterpret_cast<const uint8_t*>(in), reinterpret_cast<uint8_t*>(out), n);
         }
+    };
+
+    template<> struct ConvertRow<uchar4, uchar3>
+    {
+        static inline void run(const ConvertKernels& k, const uchar4* in, uchar3* out, std::size_t n, vc::image::ConvertRounding)
+        {
+            k.rgbaToRGB(reinterpret_cast<const uint8_t*>(in), reinterpret_cast<uint8_t*>(out), n);
+        }
+    };
+
+    template<> struct ConvertRow<uchar3, uint8_t>
+    {
+        static inline void run(const ConvertKernels& k, const uchar3* in, uint8_t* out, std::size_t n, vc::image::ConvertRounding)
+        {
+            k.rgbToGrey(reinterpret_cast<const uint8_t*>(in), out, n);
+        }
+    };
+
+    template<> struct ConvertRow<uchar4, uint8_t>
+    {
+        static inline void run(const ConvertKernels& k, const uchar4* in, uint8_t* out, std::size_t n, vc::image::ConvertRounding)
+        {
+            k.rgbaToGrey(reinterpret_cast<const uint8_t*>(in), out, n);
+        }
+    };
+
+    template<> struct ConvertRow<uchar3, float>
+    {
+        static inline void run(const ConvertKernels& k, const uchar3* in, float* out, std::size_t n, vc::image::ConvertRounding)
+        {
+            k.rgbToGreyF32(reinterpret_cast<const uint8_t*>(in), out, n);
+        }
+    };
+
+    template<> struct ConvertRow<uchar4, float>
+    {
+        static inline void run(const ConvertKernels& k, const uchar4* in, float* out, std::size_t n, vc::image::ConvertRounding)
+        {
+            k.rgbaToGreyF32(reinterpret_cast<const uint8_t*>(in), out, n);
+        }
+    };
+}
+
+template<typename T_IN, typename T_OUT>
+void vc::image::convertBuffer(const vc::Buffer2DView<T_IN, vc::TargetHost>& buf_in, vc::Buffer2DView<T_OUT, vc::TargetHost>& buf_out,
+                              vc::image::ConvertRounding rounding)
+{
+    VISIONCORE_TRACE_SCOPE_2D("convertBuffer", buf_out.width(), buf_out.height(), buf_out.area() * (sizeof(T_IN) + sizeof(T_OUT)));
+    const ConvertKernels& kernels = selectConvertKernels();
+    vc::launchParallelForRows(std::min(buf_in.width(), buf_out.width()), std::min(buf_in.height(), buf_out.height()),
+                              [&](std::size_t y, std::size_t x_begin, std::size_t x_end)
+    {
+        ConvertRow<T_IN, T_OUT>::run(kernels, buf_in.rowPtr(y) + x_begin, buf_out.rowPtr(y) + x_begin, x_end - x_begin, rounding);
     });
 }
 
+template<typename T_IN, typename T_OUT, typename Target>
+void vc::image::convertBuffer(const vc::Buffer2DView<T_IN, Target>& buf_in, vc::Buffer2DView<T_OUT, Target>& buf_out)
+{
+    vc::image::convertBuffer(buf_in, buf_out, vc::image::ConvertRounding::Truncate);
+}
+
+#define CONVERT_BUFFER_FUNCS(T_IN, T_OUT) \
+template void vc::image::convertBuffer<T_IN, T_OUT>(const vc::Buffer2DView<T_IN, vc::TargetHost>& buf_in, vc::Buffer2DView<T_OUT, vc::TargetHost>& buf_out); \
+template void vc::image::convertBuffer<T_IN, T_OUT>(const vc::Buffer2DView<T_IN, vc::TargetHost>& buf_in, vc::Buffer2DView<T_OUT, vc::TargetHost>& buf_out, vc::image::ConvertRounding rounding);
+
 // all conversions
-template void vc::image::convertBuffer<uint8_t, uchar3>(const vc::Buffer2DView<uint8_t, vc::TargetHost>& buf_in, vc::Buffer2DView<uchar3, vc::TargetHost>& buf_out);
-template void vc::image::convertBuffer<uint8_t, uchar4>(const vc::Buffer2DView<uint8_t, vc::TargetHost>& buf_in, vc::Buffer2DView<uchar4, vc::TargetHost>& buf_out);
-template void vc::image::convertBuffer<uint8_t, float>(const vc::Buffer2DView<uint8_t, vc::TargetHost>& buf_in, vc::Buffer2DView<float, vc::TargetHost>& buf_out);
-template void vc::image::convertBuffer<uint8_t, float3>(const vc::Buffer2DView<uint8_t, vc::TargetHost>& buf_in, vc::Buffer2DView<float3, vc::TargetHost>& buf_out);
-template void vc::image::convertBuffer<uint8_t, float4>(const vc::Buffer2DView<uint8_t, vc::TargetHost>& buf_in, vc::Buffer2DView<float4, vc::TargetHost>& buf_out);
-template void vc::image::convertBuffer<uint8_t, Eigen::Vector3f>(const vc::Buffer2DView<uint8_t, vc::TargetHost>& buf_in, vc::Buffer2DView<Eigen::Vector3f, vc::TargetHost>& buf_out);
-template void vc::image::convertBuffer<uint8_t, Eigen::Vector4f>(const vc::Buffer2DView<uint8_t, vc::TargetHost>& buf_in, vc::Buffer2DView<Eigen::Vector4f, vc::TargetHost>& buf_out);
-//template void vc::image::convertBuffer<uint8_t, uint16_t>(const vc::Buffer2DView<uint8_t, vc::TargetHost>& buf_in, vc::Buffer2DView<uint16_t, vc::TargetHost>& buf_out);
-
-template void vc::image::convertBuffer<float, uint8_t>(const vc::Buffer2DView<float, vc::TargetHost>& buf_in, vc::Buffer2DView<uint8_t, vc::TargetHost>& buf_out);
-template void vc::image::convertBuffer<float, uchar3>(const vc::Buffer2DView<float, vc::TargetHost>& buf_in, vc::Buffer2DView<uchar3, vc::TargetHost>& buf_out);
-template void vc::image::convertBuffer<float, uchar4>(const vc::Buffer2DView<float, vc::TargetHost>& buf_in, vc::Buffer2DView<uchar4, vc::TargetHost>& buf_out);
-template void vc::image::convertBuffer<float, float3>(const vc::Buffer2DView<float, vc::TargetHost>& buf_in, vc::Buffer2DView<float3, vc::TargetHost>& buf_out);
-template void vc::image::convertBuffer<float, float4>(const vc::Buffer2DView<float, vc::TargetHost>& buf_in, vc::Buffer2DView<float4, vc::TargetHost>& buf_out);
-template void vc::image::convertBuffer<float, Eigen::Vector3f>(const vc::Buffer2DView<float, vc::TargetHost>& buf_in, vc::Buffer2DView<Eigen::Vector3f, vc::TargetHost>& buf_out);
-template void vc::image::convertBuffer<float, Eigen::Vector4f>(const vc::Buffer2DView<float, vc::TargetHost>& buf_in, vc::Buffer2DView<Eigen::Vector4f, vc::TargetHost>& buf_out);
-//template void vc::image::convertBuffer<float, uint16_t>(const vc::Buffer2DView<float, vc::TargetHost>& buf_in, vc::Buffer2DView<uint16_t, vc::TargetHost>& buf_out);
-template void vc::image::convertBuffer<float, double>(const vc::Buffer2DView<float, vc::TargetHost>& buf_in, vc::Buffer2DView<double, vc::TargetHost>& buf_out);
-
-template void vc::image::convertBuffer<double, uint8_t>(const vc::Buffer2DView<double, vc::TargetHost>& buf_in, vc::Buffer2DView<uint8_t, vc::TargetHost>& buf_out);
-template void vc::image::convertBuffer<double, uchar3>(const vc::Buffer2DView<double, vc::TargetHost>& buf_in, vc::Buffer2DView<uchar3, vc::TargetHost>& buf_out);
-template void vc::image::convertBuffer<double, uchar4>(const vc::Buffer2DView<double, vc::TargetHost>& buf_in, vc::Buffer2DView<uchar4, vc::TargetHost>& buf_out);
-template void vc::image::convertBuffer<double, float3>(const vc::Buffer2DView<double, vc::TargetHost>& buf_in, vc::Buffer2DView<float3, vc::TargetHost>& buf_out);
-template void vc::image::convertBuffer<double, float4>(const vc::Buffer2DView<double, vc::TargetHost>& buf_in, vc::Buffer2DView<float4, vc::TargetHost>& buf_out);
-template void vc::image::convertBuffer<double, Eigen::Vector3f>(const vc::Buffer2DView<double, vc::TargetHost>& buf_in, vc::Buffer2DView<Eigen::Vector3f, vc::TargetHost>& buf_out);
-template void vc::image::convertBuffer<double, Eigen::Vector4f>(const vc::Buffer2DView<double, vc::TargetHost>& buf_in, vc::Buffer2DView<Eigen::Vector4f, vc::TargetHost>& buf_out);
-template void vc::image::convertBuffer<double, float>(const vc::Buffer2DView<double, vc::TargetHost>& buf_in, vc::Buffer2DView<float, vc::TargetHost>& buf_out);
-
-template void vc::image::convertBuffer<uchar3, uint8_t>(const vc::Buffer2DView<uchar3, vc::TargetHost>& buf_in, vc::Buffer2DView<uint8_t, vc::TargetHost>& buf_out);
-template void vc::image::convertBuffer<uchar3, uchar4>(const vc::Buffer2DView<uchar3, vc::TargetHost>& buf_in, vc::Buffer2DView<uchar4, vc::TargetHost>& buf_out);
-template void vc::image::convertBuffer<uchar3, float>(const vc::Buffer2DView<uchar3, vc::TargetHost>& buf_in, vc::Buffer2DView<float, vc::TargetHost>& buf_out);
-template void vc::image::convertBuffer<uchar3, float3>(const vc::Buffer2DView<uchar3, vc::TargetHost>& buf_in, vc::Buffer2DView<float3, vc::TargetHost>& buf_out);
-template void vc::image::convertBuffer<uchar3, float4>(const vc::Buffer2DView<uchar3, vc::TargetHost>& buf_in, vc::Buffer2DView<float4, vc::TargetHost>& buf_out);
-template void vc::image::convertBuffer<uchar3, Eigen::Vector3f>(const vc::Buffer2DView<uchar3, vc::TargetHost>& buf_in, vc::Buffer2DView<Eigen::Vector3f, vc::TargetHost>& buf_out);
-template void vc::image::convertBuffer<uchar3, Eigen::Vector4f>(const vc::Buffer2DView<uchar3, vc::TargetHost>& buf_in, vc::Buffer2DView<Eigen::Vector4f, vc::TargetHost>& buf_out);
-//template void vc::image::convertBuffer<uchar3, uint16_t>(const vc::Buffer2DView<uchar3, vc::TargetHost>& buf_in, vc::Buffer2DView<uint16_t, vc::TargetHost>& buf_out);
-
-template void vc::image::convertBuffer<uchar4, uint8_t>(const vc::Buffer2DView<uchar4, vc::TargetHost>& buf_in, vc::Buffer2DView<uint8_t, vc::TargetHost>& buf_out);
-template void vc::image::convertBuffer<uchar4, uchar3>(const vc::Buffer2DView<uchar4, vc::TargetHost>& buf_in, vc::Buffer2DView<uchar3, vc::TargetHost>& buf_out);
-template void vc::image::convertBuffer<uchar4, float>(const vc::Buffer2DView<uchar4, vc::TargetHost>& buf_in, vc::Buffer2DView<float, vc::TargetHost>& buf_out);
-template void vc::image::convertBuffer<uchar4, float3>(const vc::Buffer2DView<uchar4, vc::TargetHost>& buf_in, vc::Buffer2DView<float3, vc::TargetHost>& buf_out);
-template void vc::image::convertBuffer<uchar4, float4>(const vc::Buffer2DView<uchar4, vc::TargetHost>& buf_in, vc::Buffer2DView<float4, vc::TargetHost>& buf_out);
-template void vc::image::convertBuffer<uchar4, Eigen::Vector3f>(const vc::Buffer2DView<uchar4, vc::TargetHost>& buf_in, vc::Buffer2DView<Eigen::Vector3f, vc::TargetHost>& buf_out);
-template void vc::image::convertBuffer<uchar4, Eigen::Vector4f>(const vc::Buffer2DView<uchar4, vc::TargetHost>& buf_in, vc::Buffer2DView<Eigen::Vector4f, vc::TargetHost>& buf_out);
-//template void vc::image::convertBuffer<uchar4, uint16_t>(vc::Buffer2DView<uchar4, vc::TargetHost>& buf_in, vc::Buffer2DView<uint16_t, vc::TargetHost>& buf_out);
-
-template void vc::image::convertBuffer<float3, uint8_t>(const vc::Buffer2DView<float3, vc::TargetHost>& buf_in, vc::Buffer2DView<uint8_t, vc::TargetHost>& buf_out);
-template void vc::image::convertBuffer<float3, uchar3>(const vc::Buffer2DView<float3, vc::TargetHost>& buf_in, vc::Buffer2DView<uchar3, vc::TargetHost>& buf_out);
-template void vc::image::convertBuffer<float3, uchar4>(const vc::Buffer2DView<float3, vc::TargetHost>& buf_in, vc::Buffer2DView<uchar4, vc::TargetHost>& buf_out);
-template void vc::image::convertBuffer<float3, float>(const vc::Buffer2DView<float3, vc::TargetHost>& buf_in, vc::Buffer2DView<float, vc::TargetHost>& buf_out);
-template void vc::image::convertBuffer<float3, float4>(const vc::Buffer2DView<float3, vc::TargetHost>& buf_in, vc::Buffer2DView<float4, vc::TargetHost>& buf_out);
-template void vc::image::convertBuffer<float3, Eigen::Vector3f>(const vc::Buffer2DView<float3, vc::TargetHost>& buf_in, vc::Buffer2DView<Eigen::Vector3f, vc::TargetHost>& buf_out);
-template void vc::image::convertBuffer<float3, Eigen::Vector4f>(const vc::Buffer2DView<float3, vc::TargetHost>& buf_in, vc::Buffer2DView<Eigen::Vector4f, vc::TargetHost>& buf_out);
-//template void vc::image::convertBuffer<float3, uint16_t>(const vc::Buffer2DView<float3, vc::TargetHost>& buf_in, vc::Buffer2DView<uint16_t, vc::TargetHost>& buf_out);
-
-template void vc::image::convertBuffer<float4, uint8_t>(const vc::Buffer2DView<float4, vc::TargetHost>& buf_in, vc::Buffer2DView<uint8_t, vc::TargetHost>& buf_out);
-template void vc::image::convertBuffer<float4, uchar3>(const vc::Buffer2DView<float4, vc::TargetHost>& buf_in, vc::Buffer2DView<uchar3, vc::TargetHost>& buf_out);
-template void vc::image::convertBuffer<float4, uchar4>(const vc::Buffer2DView<float4, vc::TargetHost>& buf_in, vc::Buffer2DView<uchar4, vc::TargetHost>& buf_out);
-template void vc::image::convertBuffer<float4, float>(const vc::Buffer2DView<float4, vc::TargetHost>& buf_in, vc::Buffer2DView<float, vc::TargetHost>& buf_out);
-template void vc::image::convertBuffer<float4, float3>(const vc::Buffer2DView<float4, vc::TargetHost>& buf_in, vc::Buffer2DView<float3, vc::TargetHost>& buf_out);
-template void vc::image::convertBuffer<float4, Eigen::Vector3f>(const vc::Buffer2DView<float4, vc::TargetHost>& buf_in, vc::Buffer2DView<Eigen::Vector3f, vc::TargetHost>& buf_out);
-template void vc::image::convertBuffer<float4, Eigen::Vector4f>(const vc::Buffer2DView<float4, vc::TargetHost>& buf_in, vc::Buffer2DView<Eigen::Vector4f, vc::TargetHost>& buf_out);
-//template void vc::image::convertBuffer<float4, uint16_t>(const vc::Buffer2DView<float4, vc::TargetHost>& buf_in, vc::Buffer2DView<uint16_t, vc::TargetHost>& buf_out);
-
-template void vc::image::convertBuffer<Eigen::Vector3f, uint8_t>(const vc::Buffer2DView<Eigen::Vector3f, vc::TargetHost>& buf_in, vc::Buffer2DView<uint8_t, vc::TargetHost>& buf_out);
-template void vc::image::convertBuffer<Eigen::Vector3f, uchar3>(const vc::Buffer2DView<Eigen::Vector3f, vc::TargetHost>& buf_in, vc::Buffer2DView<uchar3, vc::TargetHost>& buf_out);
-template void vc::image::convertBuffer<Eigen::Vector3f, uchar4>(const vc::Buffer2DView<Eigen::Vector3f, vc::TargetHost>& buf_in, vc::Buffer2DView<uchar4, vc::TargetHost>& buf_out);
-template void vc::image::convertBuffer<Eigen::Vector3f, float>(const vc::Buffer2DView<Eigen::Vector3f, vc::TargetHost>& buf_in, vc::Buffer2DView<float, vc::TargetHost>& buf_out);
-template void vc::image::convertBuffer<Eigen::Vector3f, float3>(const vc::Buffer2DView<Eigen::Vector3f, vc::TargetHost>& buf_in, vc::Buffer2DView<float3, vc::TargetHost>& buf_out);
-template void vc::image::convertBuffer<Eigen::Vector3f, float4>(const vc::Buffer2DView<Eigen::Vector3f, vc::TargetHost>& buf_in, vc::Buffer2DView<float4, vc::TargetHost>& buf_out);
-template void vc::image::convertBuffer<Eigen::Vector3f, Eigen::Vector4f>(const vc::Buffer2DView<Eigen::Vector3f, vc::TargetHost>& buf_in, vc::Buffer2DView<Eigen::Vector4f, vc::TargetHost>& buf_out);
-//template void vc::image::convertBuffer<Eigen::Vector3f, uint16_t>(const vc::Buffer2DView<Eigen::Vector3f, vc::TargetHost>& buf_in, vc::Buffer2DView<uint16_t, vc::TargetHost>& buf_out);
-
-template void vc::image::convertBuffer<Eigen::Vector4f, uint8_t>(const vc::Buffer2DView<Eigen::Vector4f, vc::TargetHost>& buf_in, vc::Buffer2DView<uint8_t, vc::TargetHost>& buf_out);
-template void vc::image::convertBuffer<Eigen::Vector4f, uchar3>(const vc::Buffer2DView<Eigen::Vector4f, vc::TargetHost>& buf_in, vc::Buffer2DView<uchar3, vc::TargetHost>& buf_out);
-template void vc::image::convertBuffer<Eigen::Vector4f, uchar4>(const vc::Buffer2DView<Eigen::Vector4f, vc::TargetHost>& buf_in, vc::Buffer2DView<uchar4, vc::TargetHost>& buf_out);
-template void vc::image::convertBuffer<Eigen::Vector4f, float>(const vc::Buffer2DView<Eigen::Vector4f, vc::TargetHost>& buf_in, vc::Buffer2DView<float, vc::TargetHost>& buf_out);
-template void vc::image::convertBuffer<Eigen::Vector4f, float3>(const vc::Buffer2DView<Eigen::Vector4f, vc::TargetHost>& buf_in, vc::Buffer2DView<float3, vc::TargetHost>& buf_out);
-template void vc::image::convertBuffer<Eigen::Vector4f, float4>(const vc::Buffer2DView<Eigen::Vector4f, vc::TargetHost>& buf_in, vc::Buffer2DView<float4, vc::TargetHost>& buf_out);
-template void vc::image::convertBuffer<Eigen::Vector4f, Eigen::Vector3f>(const vc::Buffer2DView<Eigen::Vector4f, vc::TargetHost>& buf_in, vc::Buffer2DView<Eigen::Vector3f, vc::TargetHost>& buf_out);
-//template void vc::image::convertBuffer<Eigen::Vector4f, uint16_t>(const vc::Buffer2DView<Eigen::Vector4f, vc::TargetHost>& buf_in, vc::Buffer2DView<uint16_t, vc::TargetHost>& buf_out);
+CONVERT_BUFFER_FUNCS(uint8_t, uchar3)
+CONVERT_BUFFER_FUNCS(uint8_t, uchar4)
+CONVERT_BUFFER_FUNCS(uint8_t, float)
+CONVERT_BUFFER_FUNCS(uint8_t, float3)
+CONVERT_BUFFER_FUNCS(uint8_t, float4)
+CONVERT_BUFFER_FUNCS(uint8_t, Eigen::Vector3f)
+CONVERT_BUFFER_FUNCS(uint8_t, Eigen::Vector4f)
+//CONVERT_BUFFER_FUNCS(uint8_t, uint16_t)
+
+CONVERT_BUFFER_FUNCS(float, uint8_t)
+CONVERT_BUFFER_FUNCS(float, uchar3)
+CONVERT_BUFFER_FUNCS(float, uchar4)
+CONVERT_BUFFER_FUNCS(float, float3)
+CONVERT_BUFFER_FUNCS(float, float4)
+CONVERT_BUFFER_FUNCS(float, Eigen::Vector3f)
+CONVERT_BUFFER_FUNCS(float, Eigen::Vector4f)
+//CONVERT_BUFFER_FUNCS(float, uint16_t)
+CONVERT_BUFFER_FUNCS(float, double)
+
+CONVERT_BUFFER_FUNCS(double, uint8_t)
+CONVERT_BUFFER_FUNCS(double, uchar3)
+CONVERT_BUFFER_FUNCS(double, uchar4)
+CONVERT_BUFFER_FUNCS(double, float3)
+CONVERT_BUFFER_FUNCS(double, float4)
+CONVERT_BUFFER_FUNCS(double, Eigen::Vector3f)
+CONVERT_BUFFER_FUNCS(double, Eigen::Vector4f)
+CONVERT_BUFFER_FUNCS(double, float)
+
+CONVERT_BUFFER_FUNCS(uchar3, uint8_t)
+CONVERT_BUFFER_FUNCS(uchar3, uchar4)
+CONVERT_BUFFER_FUNCS(uchar3, float)
+CONVERT_BUFFER_FUNCS(uchar3, float3)
+CONVERT_BUFFER_FUNCS(uchar3, float4)
+CONVERT_BUFFER_FUNCS(uchar3, Eigen::Vector3f)
+CONVERT_BUFFER_FUNCS(uchar3, Eigen::Vector4f)
+//CONVERT_BUFFER_FUNCS(uchar3, uint16_t)
+
+CONVERT_BUFFER_FUNCS(uchar4, uint8_t)
+CONVERT_BUFFER_FUNCS(uchar4, uchar3)
+CONVERT_BUFFER_FUNCS(uchar4, float)
+CONVERT_BUFFER_FUNCS(uchar4, float3)
+CONVERT_BUFFER_FUNCS(uchar4, float4)
+CONVERT_BUFFER_FUNCS(uchar4, Eigen::Vector3f)
+CONVERT_BUFFER_FUNCS(uchar4, Eigen::Vector4f)
+//CONVERT_BUFFER_FUNCS(uchar4, uint16_t)
+
+CONVERT_BUFFER_FUNCS(float3, uint8_t)
+CONVERT_BUFFER_FUNCS(float3, uchar3)
+CONVERT_BUFFER_FUNCS(float3, uchar4)
+CONVERT_BUFFER_FUNCS(float3, float)
+CONVERT_BUFFER_FUNCS(float3, float4)
+CONVERT_BUFFER_FUNCS(float3, Eigen::Vector3f)
+CONVERT_BUFFER_FUNCS(float3, Eigen::Vector4f)
+//CONVERT_BUFFER_FUNCS(float3, uint16_t)
+
+CONVERT_BUFFER_FUNCS(float4, uint8_t)
+CONVERT_BUFFER_FUNCS(float4, uchar3)
+CONVERT_BUFFER_FUNCS(float4, uchar4)
+CONVERT_BUFFER_FUNCS(float4, float)
+CONVERT_BUFFER_FUNCS(float4, float3)
+CONVERT_BUFFER_FUNCS(float4, Eigen::Vector3f)
+CONVERT_BUFFER_FUNCS(float4, Eigen::Vector4f)
+//CONVERT_BUFFER_FUNCS(float4, uint16_t)
+
+CONVERT_BUFFER_FUNCS(Eigen::Vector3f, uint8_t)
+CONVERT_BUFFER_FUNCS(Eigen::Vector3f, uchar3)
+CONVERT_BUFFER_FUNCS(Eigen::Vector3f, uchar4)
+CONVERT_BUFFER_FUNCS(Eigen::Vector3f, float)
+CONVERT_BUFFER_FUNCS(Eigen::Vector3f, float3)
+CONVERT_BUFFER_FUNCS(Eigen::Vector3f, float4)
+CONVERT_BUFFER_FUNCS(Eigen::Vector3f, Eigen::Vector4f)
+//CONVERT_BUFFER_FUNCS(Eigen::Vector3f, uint16_t)
+
+CONVERT_BUFFER_FUNCS(Eigen::Vector4f, uint8_t)
+CONVERT_BUFFER_FUNCS(Eigen::Vector4f, uchar3)
+CONVERT_BUFFER_FUNCS(Eigen::Vector4f, uchar4)
+CONVERT_BUFFER_FUNCS(Eigen::Vector4f, float)
+CONVERT_BUFFER_FUNCS(Eigen::Vector4f, float3)
+CONVERT_BUFFER_FUNCS(Eigen::Vector4f, float4)
+CONVERT_BUFFER_FUNCS(Eigen::Vector4f, Eigen::Vector3f)
+//CONVERT_BUFFER_FUNCS(Eigen::Vector4f, uint16_t)
 
 // special
-template void vc::image::convertBuffer<uint16_t, float>(const vc::Buffer2DView<uint16_t, vc::TargetHost>& buf_in, vc::Buffer2DView<float, vc::TargetHost>& buf_out);
+CONVERT_BUFFER_FUNCS(uint16_t, float)
+
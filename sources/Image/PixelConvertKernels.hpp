@@ -0,0 +1,86 @@
+/**
+ * ****************************************************************************
+ * Copyright (c) 2016, Robert Lukierski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * ****************************************************************************
+ * Pixel conversion row kernels, one table per CPU level.
+ * ****************************************************************************
+ */
+
+#ifndef VISIONCORE_PIXEL_CONVERT_KERNELS_HPP
+#define VISIONCORE_PIXEL_CONVERT_KERNELS_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace vc
+{
+
+namespace image
+{
+
+namespace internal
+{
+
+/**
+ * Row kernels over n elements (element-wise ones) or n pixels (packed RGB / RGBA ones).
+ * Plain pointers only, so that the tables built for higher CPU levels don't pull in
+ * any inline code that could be shared with (and picked instead of) the baseline build.
+ */
+struct ConvertKernels
+{
+    /// p / 255, bit exact with convertPixel
+    void (*u8ToF32)(const uint8_t* in, float* out, std::size_t n);
+    void (*u16ToF32)(const uint16_t* in, float* out, std::size_t n);
+    /// p * 255 saturated, NaN to 0, bias 0 truncates and 0.5 rounds to nearest
+    void (*f32ToU8)(const float* in, uint8_t* out, std::size_t n, float bias);
+    void (*rgbToRGBA)(const uint8_t* in, uint8_t* out, std::size_t n);
+    void (*rgbaToRGB)(const uint8_t* in, uint8_t* out, std::size_t n);
+    /// channel average, alpha ignored
+    void (*rgbToGrey)(const uint8_t* in, uint8_t* out, std::size_t n);
+    void (*rgbaToGrey)(const uint8_t* in, uint8_t* out, std::size_t n);
+    void (*rgbToGreyF32)(const uint8_t* in, float* out, std::size_t n);
+    void (*rgbaToGreyF32)(const uint8_t* in, float* out, std::size_t n);
+};
+
+extern const ConvertKernels convertKernelsGeneric;
+
+#ifdef VISIONCORE_HAVE_CPU_DISPATCH
+extern const ConvertKernels convertKernelsSSE42;
+extern const ConvertKernels convertKernelsAVX2;
+extern const ConvertKernels convertKernelsAVX512;
+#endif // VISIONCORE_HAVE_CPU_DISPATCH
+
+}
+
+}
+
+}
+
+#endif // VISIONCORE_PIXEL_CONVERT_KERNELS_HPP
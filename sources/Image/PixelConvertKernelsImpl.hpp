@@ -0,0 +1,423 @@
+/**
+ * ****************************************************************************
+ * Copyright (c) 2016, Robert Lukierski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * ****************************************************************************
+ * Pixel conversion row kernels, compiled once per CPU level.
+ *
+ * Include in a translation unit built with the flags of the level, after defining
+ * VISIONCORE_CONVERT_KERNELS to the name of the table from PixelConvertKernels.hpp.
+ * ****************************************************************************
+ */
+
+#ifndef VISIONCORE_PIXEL_CONVERT_KERNELS_IMPL_HPP
+#define VISIONCORE_PIXEL_CONVERT_KERNELS_IMPL_HPP
+
+#include <Image/PixelConvertKernels.hpp>
+
+#ifndef VISIONCORE_CONVERT_KERNELS
+#error "Define VISIONCORE_CONVERT_KERNELS to the table name first"
+#endif // VISIONCORE_CONVERT_KERNELS
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define VISIONCORE_CONVERT_SSE2
+#endif // SSE2
+
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#define VISIONCORE_CONVERT_SSSE3
+#endif // SSSE3
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define VISIONCORE_CONVERT_AVX2
+#endif // AVX2
+
+#if defined(__AVX512F__) && defined(__AVX512BW__)
+#define VISIONCORE_CONVERT_AVX512
+#endif // AVX512
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define VISIONCORE_CONVERT_NEON
+#endif // NEON
+
+namespace
+{
+    /**
+     * [0,1] to 8 bit. Written so that NaN ends up as 0, like max / min in the vector kernels.
+     */
+    inline uint8_t saturateU8(float v, float bias)
+    {
+        v *= 255.0f;
+        v = v > 0.0f ? v : 0.0f;
+        v = v < 255.0f ? v : 255.0f;
+        return static_cast<uint8_t>(v + bias);
+    }
+
+    template<int Channels>
+    inline unsigned int sumRGB(const uint8_t* px)
+    {
+        return static_cast<unsigned int>(px[0]) + px[1] + px[2];
+    }
+
+#if defined(VISIONCORE_CONVERT_SSE2)
+    inline __m128i loadSSE(const uint8_t* ptr) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr)); }
+    inline void storeSSE(uint8_t* ptr, __m128i v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(ptr), v); }
+
+    /// 4 floats scaled, saturated and rounded to int32 lanes in [0,255]
+    inline __m128i scaleToU8SSE(const float* ptr, __m128 bias)
+    {
+        const __m128 scale = _mm_set1_ps(255.0f);
+        const __m128 v = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(ptr), scale), _mm_setzero_ps()), scale);
+        return _mm_cvttps_epi32(_mm_add_ps(v, bias));
+    }
+#endif // SSE2
+
+#if defined(VISIONCORE_CONVERT_AVX512)
+    /**
+     * Every lane, for the _maskz_ forms. The plain AVX-512 conversions and min / max merge into
+     * _mm512_undefined_*(), which gcc 12 reports as maybe-uninitialized at -O2, the zeroing forms
+     * with a full mask compile to the same instructions.
+     */
+    constexpr __mmask16 AllLanes512 = 0xFFFF;
+#endif // AVX512
+
+#if defined(VISIONCORE_CONVERT_SSSE3)
+    /**
+     * 16 pixels of 3 or 4 channels as 4 registers of 4 int32 lanes, channel bytes in order,
+     * top byte undefined for 4 channels and zero for 3.
+     */
+    template<int Channels> inline void loadPixels16(const uint8_t* ptr, __m128i (&px)[4]);
+
+    template<> inline void loadPixels16<3>(const uint8_t* ptr, __m128i (&px)[4])
+    {
+        const __m128i shuf = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+        const __m128i x = loadSSE(ptr), y = loadSSE(ptr + 16), z = loadSSE(ptr + 32);
+        px[0] = _mm_shuffle_epi8(x, shuf);
+        px[1] = _mm_shuffle_epi8(_mm_alignr_epi8(y, x, 12), shuf);
+        px[2] = _mm_shuffle_epi8(_mm_alignr_epi8(z, y, 8), shuf);
+        px[3] = _mm_shuffle_epi8(_mm_srli_si128(z, 4), shuf);
+    }
+
+    template<> inline void loadPixels16<4>(const uint8_t* ptr, __m128i (&px)[4])
+    {
+        for(int k = 0 ; k < 4 ; ++k) { px[k] = loadSSE(ptr + k * 16); }
+    }
+
+    /// x + y + z of every int32 lane
+    inline __m128i sumRGBSSE(__m128i px)
+    {
+        const __m128i weights = _mm_set1_epi32(0x00010101);
+        return _mm_madd_epi16(_mm_maddubs_epi16(px, weights), _mm_set1_epi16(1));
+    }
+#endif // SSSE3
+
+#if defined(VISIONCORE_CONVERT_NEON)
+    template<int Channels> inline uint8x16x3_t loadPixels16NEON(const uint8_t* ptr);
+    template<> inline uint8x16x3_t loadPixels16NEON<3>(const uint8_t* ptr) { return vld3q_u8(ptr); }
+    template<> inline uint8x16x3_t loadPixels16NEON<4>(const uint8_t* ptr)
+    {
+        const uint8x16x4_t v = vld4q_u8(ptr);
+        uint8x16x3_t ret;
+        ret.val[0] = v.val[0]; ret.val[1] = v.val[1]; ret.val[2] = v.val[2];
+        return ret;
+    }
+
+    inline uint32x4_t scaleToU8NEON(const float* ptr, float32x4_t bias)
+    {
+        const float32x4_t scale = vdupq_n_f32(255.0f);
+        // NaN survives min / max here, but the conversion turns it into 0
+        const float32x4_t v = vminq_f32(vmaxq_f32(vmulq_f32(vld1q_f32(ptr), scale), vdupq_n_f32(0.0f)), scale);
+        return vcvtq_u32_f32(vaddq_f32(v, bias));
+    }
+#endif // NEON
+
+    /**
+     * 8 bit to [0,1]. Divides rather than multiplies by the reciprocal, so the result
+     * is bit exact with convertPixel.
+     */
+    inline void rowU8ToF32(const uint8_t* in, float* out, std::size_t n)
+    {
+        std::size_t i = 0;
+#if defined(VISIONCORE_CONVERT_AVX512)
+        const __m512 scale = _mm512_set1_ps(255.0f);
+        for( ; i + 16 <= n ; i += 16)
+        {
+            const __m512i v = _mm512_maskz_cvtepu8_epi32(AllLanes512, loadSSE(in + i));
+            _mm512_storeu_ps(out + i, _mm512_div_ps(_mm512_maskz_cvtepi32_ps(AllLanes512, v), scale));
+        }
+#elif defined(VISIONCORE_CONVERT_AVX2)
+        const __m256 scale = _mm256_set1_ps(255.0f);
+        for( ; i + 8 <= n ; i += 8)
+        {
+            const __m256i v = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(in + i)));
+            _mm256_storeu_ps(out + i, _mm256_div_ps(_mm256_cvtepi32_ps(v), scale));
+        }
+#elif defined(VISIONCORE_CONVERT_SSE2)
+        const __m128 scale = _mm_set1_ps(255.0f);
+        const __m128i zero = _mm_setzero_si128();
+        for( ; i + 16 <= n ; i += 16)
+        {
+            const __m128i v = loadSSE(in + i);
+            const __m128i lo = _mm_unpacklo_epi8(v, zero), hi = _mm_unpackhi_epi8(v, zero);
+            _mm_storeu_ps(out + i,      _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)), scale));
+            _mm_storeu_ps(out + i + 4,  _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)), scale));
+            _mm_storeu_ps(out + i + 8,  _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)), scale));
+            _mm_storeu_ps(out + i + 12, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)), scale));
+        }
+#elif defined(VISIONCORE_CONVERT_NEON)
+        const float32x4_t scale = vdupq_n_f32(255.0f);
+        for( ; i + 16 <= n ; i += 16)
+        {
+            const uint8x16_t v = vld1q_u8(in + i);
+            const uint16x8_t lo = vmovl_u8(vget_low_u8(v)), hi = vmovl_u8(vget_high_u8(v));
+            vst1q_f32(out + i,      vdivq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(lo))), scale));
+            vst1q_f32(out + i + 4,  vdivq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(lo))), scale));
+            vst1q_f32(out + i + 8,  vdivq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(hi))), scale));
+            vst1q_f32(out + i + 12, vdivq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(hi))), scale));
+        }
+#endif
+        for( ; i < n ; ++i) { out[i] = in[i] / 255.0f; }
+    }
+
+    inline void rowU16ToF32(const uint16_t* in, float* out, std::size_t n)
+    {
+        std::size_t i = 0;
+#if defined(VISIONCORE_CONVERT_AVX512)
+        for( ; i + 16 <= n ; i += 16)
+        {
+            const __m512i v = _mm512_maskz_cvtepu16_epi32(AllLanes512, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i)));
+            _mm512_storeu_ps(out + i, _mm512_maskz_cvtepi32_ps(AllLanes512, v));
+        }
+#elif defined(VISIONCORE_CONVERT_AVX2)
+        for( ; i + 8 <= n ; i += 8)
+        {
+            const __m256i v = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i)));
+            _mm256_storeu_ps(out + i, _mm256_cvtepi32_ps(v));
+        }
+#elif defined(VISIONCORE_CONVERT_SSE2)
+        const __m128i zero = _mm_setzero_si128();
+        for( ; i + 8 <= n ; i += 8)
+        {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+            _mm_storeu_ps(out + i,     _mm_cvtepi32_ps(_mm_unpacklo_epi16(v, zero)));
+            _mm_storeu_ps(out + i + 4, _mm_cvtepi32_ps(_mm_unpackhi_epi16(v, zero)));
+        }
+#elif defined(VISIONCORE_CONVERT_NEON)
+        for( ; i + 8 <= n ; i += 8)
+        {
+            const uint16x8_t v = vld1q_u16(in + i);
+            vst1q_f32(out + i,     vcvtq_f32_u32(vmovl_u16(vget_low_u16(v))));
+            vst1q_f32(out + i + 4, vcvtq_f32_u32(vmovl_u16(vget_high_u16(v))));
+        }
+#endif
+        for( ; i < n ; ++i) { out[i] = in[i]; }
+    }
+
+    inline void rowF32ToU8(const float* in, uint8_t* out, std::size_t n, float bias)
+    {
+        std::size_t i = 0;
+#if defined(VISIONCORE_CONVERT_AVX512)
+        const __m512 scale = _mm512_set1_ps(255.0f), zero = _mm512_setzero_ps(), vbias = _mm512_set1_ps(bias);
+        for( ; i + 16 <= n ; i += 16)
+        {
+            // max(NaN, 0) returns the second operand, so NaN goes to 0
+            const __m512 v = _mm512_maskz_min_ps(AllLanes512, _mm512_maskz_max_ps(AllLanes512, _mm512_mul_ps(_mm512_loadu_ps(in + i), scale), zero), scale);
+            storeSSE(out + i, _mm512_maskz_cvtepi32_epi8(AllLanes512, _mm512_maskz_cvttps_epi32(AllLanes512, _mm512_add_ps(v, vbias))));
+        }
+#elif defined(VISIONCORE_CONVERT_AVX2)
+        const __m256 scale = _mm256_set1_ps(255.0f), zero = _mm256_setzero_ps(), vbias = _mm256_set1_ps(bias);
+        for( ; i + 16 <= n ; i += 16)
+        {
+            // max(NaN, 0) returns the second operand, so NaN goes to 0
+            const __m256 a = _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(in + i), scale), zero), scale);
+            const __m256 b = _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(in + i + 8), scale), zero), scale);
+            const __m256i ab = _mm256_packs_epi32(_mm256_cvttps_epi32(_mm256_add_ps(a, vbias)),
+                                                  _mm256_cvttps_epi32(_mm256_add_ps(b, vbias)));
+            // packs works per 128 bit lane, put the 16 bit values back in order
+            const __m256i ordered = _mm256_permute4x64_epi64(ab, 0xD8);
+            storeSSE(out + i, _mm_packus_epi16(_mm256_castsi256_si128(ordered), _mm256_extracti128_si256(ordered, 1)));
+        }
+#elif defined(VISIONCORE_CONVERT_SSE2)
+        const __m128 vbias = _mm_set1_ps(bias);
+        for( ; i + 16 <= n ; i += 16)
+        {
+            const __m128i ab = _mm_packs_epi32(scaleToU8SSE(in + i, vbias), scaleToU8SSE(in + i + 4, vbias));
+            const __m128i cd = _mm_packs_epi32(scaleToU8SSE(in + i + 8, vbias), scaleToU8SSE(in + i + 12, vbias));
+            storeSSE(out + i, _mm_packus_epi16(ab, cd));
+        }
+#elif defined(VISIONCORE_CONVERT_NEON)
+        const float32x4_t vbias = vdupq_n_f32(bias);
+        for( ; i + 8 <= n ; i += 8)
+        {
+            const uint16x8_t ab = vcombine_u16(vmovn_u32(scaleToU8NEON(in + i, vbias)), vmovn_u32(scaleToU8NEON(in + i + 4, vbias)));
+            vst1_u8(out + i, vmovn_u16(ab));
+        }
+#endif
+        for( ; i < n ; ++i) { out[i] = saturateU8(in[i], bias); }
+    }
+
+    inline void rowRGBToRGBA(const uint8_t* in, uint8_t* out, std::size_t n)
+    {
+        std::size_t i = 0;
+#if defined(VISIONCORE_CONVERT_SSSE3)
+        const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+        for( ; i + 16 <= n ; i += 16)
+        {
+            __m128i px[4];
+            loadPixels16<3>(in + i * 3, px);
+            for(int k = 0 ; k < 4 ; ++k) { storeSSE(out + i * 4 + k * 16, _mm_or_si128(px[k], alpha)); }
+        }
+#elif defined(VISIONCORE_CONVERT_NEON)
+        for( ; i + 16 <= n ; i += 16)
+        {
+            const uint8x16x3_t v = vld3q_u8(in + i * 3);
+            uint8x16x4_t o;
+            o.val[0] = v.val[0]; o.val[1] = v.val[1]; o.val[2] = v.val[2]; o.val[3] = vdupq_n_u8(255);
+            vst4q_u8(out + i * 4, o);
+        }
+#endif
+        for( ; i < n ; ++i)
+        {
+            out[i * 4] = in[i * 3]; out[i * 4 + 1] = in[i * 3 + 1]; out[i * 4 + 2] = in[i * 3 + 2]; out[i * 4 + 3] = 255;
+        }
+    }
+
+    inline void rowRGBAToRGB(const uint8_t* in, uint8_t* out, std::size_t n)
+    {
+        std::size_t i = 0;
+#if defined(VISIONCORE_CONVERT_SSSE3)
+        const __m128i shuf = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+        for( ; i + 16 <= n ; i += 16)
+        {
+            // 4 x 12 packed bytes into 3 full registers
+            const __m128i a = _mm_shuffle_epi8(loadSSE(in + i * 4), shuf);
+            const __m128i b = _mm_shuffle_epi8(loadSSE(in + i * 4 + 16), shuf);
+            const __m128i c = _mm_shuffle_epi8(loadSSE(in + i * 4 + 32), shuf);
+            const __m128i d = _mm_shuffle_epi8(loadSSE(in + i * 4 + 48), shuf);
+            storeSSE(out + i * 3,      _mm_or_si128(a, _mm_slli_si128(b, 12)));
+            storeSSE(out + i * 3 + 16, _mm_or_si128(_mm_srli_si128(b, 4), _mm_slli_si128(c, 8)));
+            storeSSE(out + i * 3 + 32, _mm_or_si128(_mm_srli_si128(c, 8), _mm_slli_si128(d, 4)));
+        }
+#elif defined(VISIONCORE_CONVERT_NEON)
+        for( ; i + 16 <= n ; i += 16)
+        {
+            vst3q_u8(out + i * 3, loadPixels16NEON<4>(in + i * 4));
+        }
+#endif
+        for( ; i < n ; ++i)
+        {
+            out[i * 3] = in[i * 4]; out[i * 3 + 1] = in[i * 4 + 1]; out[i * 3 + 2] = in[i * 4 + 2];
+        }
+    }
+
+    /**
+     * Channel average of 3 or 4 channel 8 bit pixels (alpha ignored), truncated like convertPixel.
+     * sum / 3 == (sum * 43691) >> 17 for all sums up to 3 * 255.
+     */
+    template<int Channels>
+    inline void rowGreyU8(const uint8_t* in, uint8_t* out, std::size_t n)
+    {
+        std::size_t i = 0;
+#if defined(VISIONCORE_CONVERT_SSSE3)
+        const __m128i div3 = _mm_set1_epi16(static_cast<short>(43691));
+        for( ; i + 16 <= n ; i += 16)
+        {
+            __m128i px[4];
+            loadPixels16<Channels>(in + i * Channels, px);
+            const __m128i lo = _mm_packs_epi32(sumRGBSSE(px[0]), sumRGBSSE(px[1]));
+            const __m128i hi = _mm_packs_epi32(sumRGBSSE(px[2]), sumRGBSSE(px[3]));
+            storeSSE(out + i, _mm_packus_epi16(_mm_srli_epi16(_mm_mulhi_epu16(lo, div3), 1),
+                                               _mm_srli_epi16(_mm_mulhi_epu16(hi, div3), 1)));
+        }
+#elif defined(VISIONCORE_CONVERT_NEON)
+        const uint16x4_t div3 = vdup_n_u16(43691);
+        for( ; i + 16 <= n ; i += 16)
+        {
+            const uint8x16x3_t v = loadPixels16NEON<Channels>(in + i * Channels);
+            const uint16x8_t lo = vaddw_u8(vaddl_u8(vget_low_u8(v.val[0]), vget_low_u8(v.val[1])), vget_low_u8(v.val[2]));
+            const uint16x8_t hi = vaddw_u8(vaddl_u8(vget_high_u8(v.val[0]), vget_high_u8(v.val[1])), vget_high_u8(v.val[2]));
+            const uint16x8_t qlo = vcombine_u16(vshrn_n_u32(vmull_u16(vget_low_u16(lo), div3), 16),
+                                                vshrn_n_u32(vmull_u16(vget_high_u16(lo), div3), 16));
+            const uint16x8_t qhi = vcombine_u16(vshrn_n_u32(vmull_u16(vget_low_u16(hi), div3), 16),
+                                                vshrn_n_u32(vmull_u16(vget_high_u16(hi), div3), 16));
+            vst1q_u8(out + i, vcombine_u8(vmovn_u16(vshrq_n_u16(qlo, 1)), vmovn_u16(vshrq_n_u16(qhi, 1))));
+        }
+#endif
+        for( ; i < n ; ++i) { out[i] = sumRGB<Channels>(in + i * Channels) / 3; }
+    }
+
+    template<int Channels>
+    inline void rowGreyF32(const uint8_t* in, float* out, std::size_t n)
+    {
+        std::size_t i = 0;
+#if defined(VISIONCORE_CONVERT_SSSE3)
+        const __m128 scale = _mm_set1_ps(3.0f * 255.0f);
+        for( ; i + 16 <= n ; i += 16)
+        {
+            __m128i px[4];
+            loadPixels16<Channels>(in + i * Channels, px);
+            for(int k = 0 ; k < 4 ; ++k)
+            {
+                _mm_storeu_ps(out + i + k * 4, _mm_div_ps(_mm_cvtepi32_ps(sumRGBSSE(px[k])), scale));
+            }
+        }
+#elif defined(VISIONCORE_CONVERT_NEON)
+        const float32x4_t scale = vdupq_n_f32(3.0f * 255.0f);
+        for( ; i + 16 <= n ; i += 16)
+        {
+            const uint8x16x3_t v = loadPixels16NEON<Channels>(in + i * Channels);
+            const uint16x8_t lo = vaddw_u8(vaddl_u8(vget_low_u8(v.val[0]), vget_low_u8(v.val[1])), vget_low_u8(v.val[2]));
+            const uint16x8_t hi = vaddw_u8(vaddl_u8(vget_high_u8(v.val[0]), vget_high_u8(v.val[1])), vget_high_u8(v.val[2]));
+            vst1q_f32(out + i,      vdivq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(lo))), scale));
+            vst1q_f32(out + i + 4,  vdivq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(lo))), scale));
+            vst1q_f32(out + i + 8,  vdivq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(hi))), scale));
+            vst1q_f32(out + i + 12, vdivq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(hi))), scale));
+        }
+#endif
+        for( ; i < n ; ++i) { out[i] = float(sumRGB<Channels>(in + i * Channels)) / (3.0f * 255.0f); }
+    }
+}
+
+const vc::image::internal::ConvertKernels vc::image::internal::VISIONCORE_CONVERT_KERNELS =
+{
+    &rowU8ToF32,
+    &rowU16ToF32,
+    &rowF32ToU8,
+    &rowRGBToRGBA,
+    &rowRGBAToRGB,
+    &rowGreyU8<3>,
+    &rowGreyU8<4>,
+    &rowGreyF32<3>,
+    &rowGreyF32<4>
+};
+
+#endif // VISIONCORE_PIXEL_CONVERT_KERNELS_IMPL_HPP
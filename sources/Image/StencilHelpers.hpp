@@ -0,0 +1,146 @@
+/**
+ * ****************************************************************************
+ * Copyright (c) 2017, Robert Lukierski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ****************************************************************************
+ * Stencil helpers, interior / border split and border reads.
+ * ****************************************************************************
+ */
+
+#ifndef VISIONCORE_STENCIL_HELPERS_HPP
+#define VISIONCORE_STENCIL_HELPERS_HPP
+
+#include <algorithm>
+
+#include <VisionCore/Platform.hpp>
+#include <VisionCore/Buffers/BorderMode.hpp>
+#include <VisionCore/Buffers/Buffer2D.hpp>
+#include <VisionCore/LaunchUtils.hpp>
+
+namespace internal
+{
+
+/**
+ * Brings an index back into [0, size), false if the tap reads the constant instead.
+ * Same rules as the view helpers (indexReflectedX & co.), repeated until the index is inside, 
+ * so any offset is fine, also for stencils wider than the image. Done in int, the view helpers 
+ * compare against the unsigned extents. Skip never reads outside, treated as Clamp.
+ */
+inline bool borderIndex(int& i, int size, vc::BorderMode mode)
+{
+    if(i >= 0 && i < size) { return true; }
+    
+    switch(mode)
+    {
+        case vc::BorderMode::Reflect: 
+            while(i < 0 || i >= size) { i = i < 0 ? -i - 1 : 2 * size - i - 1; } 
+            return true;
+        case vc::BorderMode::Wrap: 
+            i %= size; 
+            if(i < 0) { i += size; } 
+            return true;
+        case vc::BorderMode::Constant: 
+            return false;
+        default: 
+            i = i < 0 ? 0 : size - 1; 
+            return true;
+    }
+}
+
+template<typename ViewT>
+inline bool borderIndexX(const ViewT& img, int& x, vc::BorderMode mode)
+{
+    return borderIndex(x, (int)img.width(), mode);
+}
+
+template<typename ViewT>
+inline bool borderIndexY(const ViewT& img, int& y, vc::BorderMode mode)
+{
+    return borderIndex(y, (int)img.height(), mode);
+}
+
+/**
+ * Reads taps with the border policy, only for the border pixels, the interior reads rows directly.
+ */
+template<typename T>
+struct BorderReader
+{
+    const vc::Buffer2DView<T,vc::TargetHost>& img;
+    vc::BorderMode mode;
+    T value;
+    
+    inline T operator()(int x, int y) const
+    {
+        if(!borderIndexX(img, x, mode) || !borderIndexY(img, y, mode)) { return value; }
+        return img.rowPtr(y)[x];
+    }
+};
+
+/**
+ * Runs a stencil of radius_x by radius_y over the image, in parallel over the rows.
+ * interior(y, x_begin, x_end) gets the spans where all taps are inside the image (no checks needed),
+ * border(x, y) the remaining pixels one by one. With BorderMode::Skip border is never called.
+ * Both stay inside the span the row launch hands out, also if that is only part of a row.
+ */
+template<typename InteriorFunction, typename BorderFunction>
+inline void launchStencil(std::size_t width, std::size_t height, std::size_t radius_x, std::size_t radius_y, 
+                          vc::BorderMode mode, InteriorFunction interior, BorderFunction border)
+{
+    const bool do_border = mode != vc::BorderMode::Skip;
+    
+    vc::launchParallelForRows(width, height, [&](std::size_t y, std::size_t x_begin, std::size_t x_end)
+    {
+        // the part of [x_begin, x_end) where all taps are inside the image, may be empty
+        const std::size_t in_begin = std::max(x_begin, radius_x);
+        const std::size_t in_end = std::min(x_end, width > radius_x ? width - radius_x : std::size_t(0));
+        
+        if(y >= radius_y && y + radius_y < height && in_begin < in_end)
+        {
+            if(do_border)
+            {
+                for(std::size_t x = x_begin ; x < in_begin ; ++x) { border(x, y); }
+            }
+            
+            interior(y, in_begin, in_end);
+            
+            if(do_border)
+            {
+                for(std::size_t x = in_end ; x < x_end ; ++x) { border(x, y); }
+            }
+        }
+        else if(do_border)
+        {
+            for(std::size_t x = x_begin ; x < x_end ; ++x) { border(x, y); }
+        }
+    });
+}
+
+}
+
+#endif // VISIONCORE_STENCIL_HELPERS_HPP
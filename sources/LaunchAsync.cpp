@@ -0,0 +1,171 @@
+/**
+ * ****************************************************************************
+ * Copyright (c) 2017, Robert Lukierski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * ****************************************************************************
+ * Asynchronous CPU launches - events, futures and dependencies.
+ * ****************************************************************************
+ */
+
+#include <VisionCore/LaunchAsync.hpp>
+#include <VisionCore/ThreadPool.hpp>
+
+#include <atomic>
+
+namespace
+{
+    /**
+     * Waits for dependencies, the last one to arrive submits the task. Holds the ExecutionContext 
+     * current at submission until the task has run (or was skipped).
+     */
+    struct JoinCounter : public std::enable_shared_from_this<JoinCounter>
+    {
+        JoinCounter(std::size_t count, std::function<void()>&& t, const std::shared_ptr<vc::detail::AsyncState>& s) 
+            : remaining(count), task(std::move(t)), st(s), token(new vc::ExecutionContext::AsyncToken(vc::ExecutionContext::current()))
+        { 
+            // decided at submission, the last dependency can complete on any thread
+            vc::ExecutionContext* ctx = token->context();
+            pool = (ctx != nullptr && ctx->pool() != nullptr) ? ctx->pool() : &vc::ThreadPool::global();
+        }
+        
+        void arrive(const std::exception_ptr& e)
+        {
+            if(e)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if(!error) { error = e; }
+            }
+            
+            if(remaining.fetch_sub(1) == 1)
+            {
+                if(error)
+                {
+                    st->complete(error);
+                    token.reset();
+                }
+                else
+                {
+                    std::shared_ptr<JoinCounter> self = shared_from_this();
+                    pool->submit([self]()
+                    {
+                        {
+                            vc::ExecutionContextScope scope(self->token->context());
+                            self->task();
+                        }
+                        
+                        // last, the context may be destroyed right after
+                        self->token.reset();
+                    });
+                }
+            }
+        }
+        
+        std::atomic<std::size_t>                                remaining;
+        std::mutex                                              mutex;
+        std::exception_ptr                                      error;
+        std::function<void()>                                   task;
+        std::shared_ptr<vc::detail::AsyncState>                 st;
+        std::unique_ptr<vc::ExecutionContext::AsyncToken>       token;
+        vc::ThreadPool*                                         pool;
+    };
+}
+
+void vc::detail::AsyncState::complete(std::exception_ptr error)
+{
+    std::vector<std::function<void()>> to_run;
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        done = true;
+        err = error;
+        to_run.swap(continuations);
+        cv.notify_all();
+    }
+    
+    for(auto& fn : to_run)
+    {
+        fn();
+    }
+}
+
+void vc::detail::AsyncState::onComplete(std::function<void()> fn)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if(!done)
+        {
+            continuations.push_back(std::move(fn));
+            return;
+        }
+    }
+    
+    fn();
+}
+
+void vc::detail::AsyncState::wait() const
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [&](){ return done; });
+}
+
+bool vc::detail::AsyncState::ready() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return done;
+}
+
+std::exception_ptr vc::detail::AsyncState::error() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return err;
+}
+
+void vc::detail::submitWhenReady(const std::vector<LaunchEvent>& deps, std::function<void()> task, 
+                                 const std::shared_ptr<AsyncState>& st)
+{
+    // +1 so nothing is submitted before all continuations are registered
+    std::shared_ptr<JoinCounter> join = std::make_shared<JoinCounter>(deps.size() + 1, std::move(task), st);
+    
+    for(const LaunchEvent& ev : deps)
+    {
+        if(!ev.state)
+        {
+            join->arrive(std::exception_ptr());
+            continue;
+        }
+        
+        std::shared_ptr<AsyncState> dep = ev.state;
+        dep->onComplete([join, dep]()
+        {
+            join->arrive(dep->error());
+        });
+    }
+    
+    join->arrive(std::exception_ptr());
+}
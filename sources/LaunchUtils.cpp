@@ -0,0 +1,93 @@
+/**
+ * ****************************************************************************
+ * Copyright (c) 2017, Robert Lukierski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * ****************************************************************************
+ * Launching parallel processing - backend selection.
+ * ****************************************************************************
+ */
+
+#include <VisionCore/LaunchUtils.hpp>
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+namespace
+{
+    vc::LaunchBackend defaultLaunchBackend()
+    {
+        const char* env = std::getenv("VISIONCORE_LAUNCH_BACKEND");
+        if(env != nullptr)
+        {
+            if(std::strcmp(env, "serial") == 0) { return vc::LaunchBackend::Serial; }
+            if(std::strcmp(env, "pool") == 0) { return vc::LaunchBackend::ThreadPool; }
+#ifdef VISIONCORE_HAVE_TBB
+            if(std::strcmp(env, "tbb") == 0) { return vc::LaunchBackend::TBB; }
+#endif // VISIONCORE_HAVE_TBB
+        }
+        
+#ifdef VISIONCORE_HAVE_TBB
+        return vc::LaunchBackend::TBB;
+#else // VISIONCORE_HAVE_TBB
+        return vc::LaunchBackend::ThreadPool;
+#endif // VISIONCORE_HAVE_TBB
+    }
+    
+    std::atomic<vc::LaunchBackend>& currentLaunchBackend()
+    {
+        static std::atomic<vc::LaunchBackend> backend(defaultLaunchBackend());
+        return backend;
+    }
+}
+
+vc::LaunchBackend vc::getLaunchBackend()
+{
+    return currentLaunchBackend().load(std::memory_order_relaxed);
+}
+
+void vc::setLaunchBackend(vc::LaunchBackend lb)
+{
+    if(!isLaunchBackendAvailable(lb))
+    {
+        throw std::runtime_error("Launch backend not available in this build");
+    }
+    
+    currentLaunchBackend().store(lb);
+}
+
+bool vc::isLaunchBackendAvailable(vc::LaunchBackend lb)
+{
+#ifndef VISIONCORE_HAVE_TBB
+    if(lb == vc::LaunchBackend::TBB) { return false; }
+#endif // VISIONCORE_HAVE_TBB
+    
+    return true;
+}
@@ -37,6 +37,392 @@
 
 #include <VisionCore/LaunchUtils.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include <VisionCore/CPUFeatures.hpp>
+
+#include <Image/StencilHelpers.hpp>
+
+#define VISIONCORE_CONVOLUTION_KERNELS convolutionKernelsGeneric
+#include <Math/ConvolutionKernelsImpl.hpp>
+
+const vc::math::internal::ConvolutionKernels& vc::math::internal::selectConvolutionKernels()
+{
+#ifdef VISIONCORE_HAVE_CPU_DISPATCH
+    switch(vc::getCPULevel())
+    {
+        case vc::CPULevel::AVX512: return convolutionKernelsAVX512;
+        case vc::CPULevel::AVX2: return convolutionKernelsAVX2;
+        default: break;
+    }
+#endif // VISIONCORE_HAVE_CPU_DISPATCH
+    return convolutionKernelsGeneric;
+}
+
+namespace
+{
+    typedef vc::math::internal::ConvolutionKernels ConvolutionKernels;
+    using vc::math::internal::selectConvolutionKernels;
+    using vc::math::internal::FixedPointBits;
+    
+    /**
+     * Accumulation and line buffer type of the separable convolution.
+     */
+    template<typename T> struct SeparableAcc { typedef float Type; };
+    template<> struct SeparableAcc<double> { typedef double Type; };
+    
+    inline void widenLine(const ConvolutionKernels& k, const uint8_t* in, float* out, std::size_t n) { k.u8ToF32(in, out, n); }
+    inline void widenLine(const ConvolutionKernels& k, const uint16_t* in, float* out, std::size_t n) { k.u16ToF32(in, out, n); }
+    inline void widenLine(const ConvolutionKernels&, const float* in, float* out, std::size_t n) { std::copy(in, in + n, out); }
+    inline void widenLine(const ConvolutionKernels&, const double* in, double* out, std::size_t n) { std::copy(in, in + n, out); }
+    inline void widenLine(const ConvolutionKernels&, const uint8_t* in, uint8_t* out, std::size_t n) { std::copy(in, in + n, out); }
+    inline void widenLine(const ConvolutionKernels&, const uint16_t* in, uint16_t* out, std::size_t n) { std::copy(in, in + n, out); }
+    
+    inline void narrowLine(const ConvolutionKernels& k, const float* in, uint8_t* out, std::size_t n) { k.f32ToU8(in, out, n); }
+    inline void narrowLine(const ConvolutionKernels& k, const float* in, uint16_t* out, std::size_t n) { k.f32ToU16(in, out, n); }
+    inline void narrowLine(const ConvolutionKernels&, const float* in, float* out, std::size_t n) { std::copy(in, in + n, out); }
+    inline void narrowLine(const ConvolutionKernels&, const double* in, double* out, std::size_t n) { std::copy(in, in + n, out); }
+    
+    inline void scaleLine(const ConvolutionKernels& k, const float* in, float* out, std::size_t n, float kv) { k.scaleF32(in, out, n, kv); }
+    inline void scaleLine(const ConvolutionKernels& k, const double* in, double* out, std::size_t n, double kv) { k.scaleF64(in, out, n, kv); }
+    inline void axpyLine(const ConvolutionKernels& k, const float* in, float* out, std::size_t n, float kv) { k.axpyF32(in, out, n, kv); }
+    inline void axpyLine(const ConvolutionKernels& k, const double* in, double* out, std::size_t n, double kv) { k.axpyF64(in, out, n, kv); }
+    
+    inline void fixedRow(const ConvolutionKernels& k, const uint8_t* in, int16_t* out, std::size_t n, const int32_t* c, std::size_t taps) 
+    { 
+        k.rowU8ToI16(in, out, n, c, taps); 
+    }
+    
+    inline void fixedColumn(const ConvolutionKernels& k, const int16_t* const* lines, uint8_t* out, std::size_t n, const int32_t* c, std::size_t taps) 
+    { 
+        k.colI16ToU8(lines, out, n, c, taps); 
+    }
+    
+    /**
+     * Per thread line buffers, grow to the largest image seen and stay.
+     */
+    template<typename AccT>
+    struct LineBuffers
+    {
+        std::vector<AccT> padded;   // one input row with the border
+        std::vector<AccT> lines;    // ring of row filtered lines, one per tap of the column kernel
+        std::vector<AccT> acc;      // column pass accumulator
+        std::vector<const AccT*> rows; // lines of the current output row
+    };
+    
+    template<typename AccT>
+    LineBuffers<AccT>& threadLineBuffers()
+    {
+        thread_local LineBuffers<AccT> lb;
+        return lb;
+    }
+    
+    /**
+     * One input row (or nullptr for a Constant border row) widened into padded[radius, radius + width)
+     * and the border columns filled in as the mode says.
+     */
+    template<typename T, typename AccT>
+    void padRow(const ConvolutionKernels& k, const vc::Buffer2DView<T,vc::TargetHost>& img, const T* row_in, 
+                std::size_t radius, vc::BorderMode mode, AccT value, AccT* padded)
+    {
+        const std::size_t width = img.width();
+        
+        if(row_in == nullptr)
+        {
+            std::fill(padded, padded + width + 2 * radius, value);
+            return;
+        }
+        
+        widenLine(k, row_in, padded + radius, width);
+        
+        for(std::size_t i = 0 ; i < radius ; ++i)
+        {
+            int xl = (int)i - (int)radius, xr = (int)(width + i);
+            padded[i] = ::internal::borderIndexX(img, xl, mode) ? padded[radius + xl] : value;
+            padded[radius + width + i] = ::internal::borderIndexX(img, xr, mode) ? padded[radius + xr] : value;
+        }
+    }
+    
+    /**
+     * Row pass over a padded row, one line kernel call per tap, each a plain axpy over the row.
+     */
+    template<typename AccT>
+    void filterRow(const ConvolutionKernels& k, const AccT* padded, std::size_t width, const AccT* kern, std::size_t radius, AccT* row_out)
+    {
+        scaleLine(k, padded, row_out, width, kern[0]);
+        for(std::size_t t = 1 ; t < 2 * radius + 1 ; ++t)
+        {
+            axpyLine(k, padded + t, row_out, width, kern[t]);
+        }
+    }
+    
+    /**
+     * Row pass into a per thread ring of lines, column pass as soon as the lines of an output row are there.
+     * Bands of rows run in parallel, each re-filters radius_y rows above and below.
+     * 
+     * fetch(j, line) row filters input row j (may be outside the image) into line, column(y, rows) gets 
+     * the 2 radius_y + 1 lines around y starting at x_begin. With skip rows closer than radius_y to the 
+     * top or bottom are left out.
+     */
+    template<typename LineT, typename FetchFunction, typename ColumnFunction>
+    void separableBands(std::size_t width, std::size_t height, std::size_t radius_y, std::size_t x_begin, bool skip,
+                        FetchFunction fetch, ColumnFunction column)
+    {
+        const std::ptrdiff_t lines = 2 * radius_y + 1;
+        
+        // every band re-filters radius_y rows above and below, keep that small compared to the band
+        const std::size_t band = std::max<std::size_t>(8 * radius_y, 4 * vc::LaunchTileY);
+        
+        vc::launchParallelForTiles(width, height, [&](std::size_t, std::size_t, std::size_t y_begin, std::size_t y_end)
+        {
+            LineBuffers<LineT>& lb = threadLineBuffers<LineT>();
+            lb.lines.resize(lines * width);
+            lb.rows.resize(lines);
+            
+            // line of input row j lives in the ring slot j mod lines
+            auto line = [&](std::ptrdiff_t j) -> LineT*
+            {
+                return lb.lines.data() + (((j % lines) + lines) % lines) * width;
+            };
+            
+            for(std::ptrdiff_t j = (std::ptrdiff_t)y_begin - (std::ptrdiff_t)radius_y ; j < (std::ptrdiff_t)(y_begin + radius_y) ; ++j)
+            {
+                fetch(j, line(j));
+            }
+            
+            for(std::size_t y = y_begin ; y < y_end ; ++y)
+            {
+                const std::ptrdiff_t top = (std::ptrdiff_t)y - (std::ptrdiff_t)radius_y;
+                fetch(top + lines - 1, line(top + lines - 1));
+                
+                if(skip && (y < radius_y || y + radius_y >= height)) { continue; }
+                
+                for(std::ptrdiff_t t = 0 ; t < lines ; ++t)
+                {
+                    lb.rows[t] = line(top + t) + x_begin;
+                }
+                
+                column(y, lb.rows.data());
+            }
+        }, width, band);
+    }
+    
+    /**
+     * Columns the Skip border mode writes, it computes as Clamp.
+     */
+    inline void skipSpan(std::size_t width, std::size_t radius_x, vc::BorderMode border, std::size_t& x_begin, std::size_t& x_end)
+    {
+        const bool skip = border == vc::BorderMode::Skip;
+        x_begin = skip ? radius_x : 0;
+        x_end = skip ? std::max(width - std::min(width, radius_x), x_begin) : width;
+    }
+    
+    template<typename T, typename TK>
+    void separableFloat(const vc::Buffer2DView<T,vc::TargetHost>& img_in, vc::Buffer2DView<T,vc::TargetHost>& img_out, 
+                        const Eigen::Matrix<TK,Eigen::Dynamic,1>& kern_x, const Eigen::Matrix<TK,Eigen::Dynamic,1>& kern_y,
+                        vc::BorderMode border, const T& border_value)
+    {
+        typedef typename SeparableAcc<T>::Type AccT;
+        
+        const std::size_t width = img_in.width(), height = img_in.height();
+        const std::size_t radius_x = kern_x.size() / 2, radius_y = kern_y.size() / 2;
+        const std::vector<AccT> kx(kern_x.data(), kern_x.data() + kern_x.size());
+        const std::vector<AccT> ky(kern_y.data(), kern_y.data() + kern_y.size());
+        
+        const ConvolutionKernels& k = selectConvolutionKernels();
+        const AccT value = AccT(border_value);
+        
+        std::size_t x_begin, x_end;
+        skipSpan(width, radius_x, border, x_begin, x_end);
+        const std::size_t n = x_end - x_begin;
+        
+        separableBands<AccT>(width, height, radius_y, x_begin, border == vc::BorderMode::Skip, 
+                             [&](std::ptrdiff_t j, AccT* line)
+        {
+            LineBuffers<AccT>& lb = threadLineBuffers<AccT>();
+            lb.padded.resize(width + 2 * radius_x);
+            
+            int src = (int)j;
+            const T* row_in = ::internal::borderIndexY(img_in, src, border) ? img_in.rowPtr(src) : nullptr;
+            padRow(k, img_in, row_in, radius_x, border, value, lb.padded.data());
+            filterRow(k, lb.padded.data(), width, kx.data(), radius_x, line);
+        },
+        [&](std::size_t y, const AccT* const* rows)
+        {
+            std::vector<AccT>& acc = threadLineBuffers<AccT>().acc;
+            acc.resize(width);
+            
+            scaleLine(k, rows[0], acc.data(), n, ky[0]);
+            for(std::size_t t = 1 ; t < ky.size() ; ++t)
+            {
+                axpyLine(k, rows[t], acc.data(), n, ky[t]);
+            }
+            
+            narrowLine(k, acc.data(), img_out.rowPtr(y) + x_begin, n);
+        });
+    }
+    
+    /**
+     * Q14 taps, the largest one absorbs the rounding so that they add up to the rounded sum of the kernel,
+     * packed in pairs for the line kernels.
+     */
+    template<typename TK>
+    std::vector<int32_t> fixedPointKernel(const Eigen::Matrix<TK,Eigen::Dynamic,1>& kern)
+    {
+        const double one = double(1 << FixedPointBits);
+        std::vector<int16_t> q(kern.size());
+        double exact = 0.0;
+        Eigen::Index largest = 0;
+        int32_t sum = 0;
+        
+        for(Eigen::Index i = 0 ; i < kern.size() ; ++i)
+        {
+            q[i] = int16_t(std::lround(double(kern(i)) * one));
+            sum += q[i];
+            exact += double(kern(i));
+            if(std::abs(kern(i)) > std::abs(kern(largest))) { largest = i; }
+        }
+        
+        const int32_t rounding = int32_t(std::lround(exact * one)) - sum;
+        q[largest] = int16_t(q[largest] + rounding);
+        
+        std::vector<int32_t> pairs((q.size() + 1) / 2, 0);
+        for(std::size_t i = 0 ; i < q.size() ; ++i)
+        {
+            pairs[i / 2] |= int32_t(uint32_t(uint16_t(q[i])) << (16 * (i % 2)));
+        }
+        
+        return pairs;
+    }
+    
+    /**
+     * The fixed-point path takes blur-like kernels: row taps non-negative summing up to at most 1, so that 
+     * the 16 bit lines don't saturate, column taps summing up to at most 2 in absolute value.
+     */
+    template<typename TK>
+    bool fixedPointFits(const Eigen::Matrix<TK,Eigen::Dynamic,1>& kern_x, const Eigen::Matrix<TK,Eigen::Dynamic,1>& kern_y)
+    {
+        const double tolerance = 1e-5;
+        
+        if(kern_x.minCoeff() < TK(0) || double(kern_x.sum()) > 1.0 + tolerance) { return false; }
+        return double(kern_y.cwiseAbs().sum()) <= 2.0 - tolerance;
+    }
+    
+    template<typename T> struct FixedPointPixel : std::false_type { };
+    // uint16_t stays on the float path, Q14 taps on 16 bit pixels are off by several units
+    template<> struct FixedPointPixel<uint8_t> : std::true_type { };
+    
+    template<typename T, typename TK>
+    bool separableFixedPoint(const vc::Buffer2DView<T,vc::TargetHost>&, vc::Buffer2DView<T,vc::TargetHost>&, 
+                             const Eigen::Matrix<TK,Eigen::Dynamic,1>&, const Eigen::Matrix<TK,Eigen::Dynamic,1>&,
+                             vc::BorderMode, const T&, std::false_type)
+    {
+        return false;
+    }
+    
+    /**
+     * uint8_t images, Q14 taps, Q7 int16 lines and 32 bit sums, see ConvolutionKernels.hpp. 
+     * Returns false if the kernels don't fit, then it's the float path.
+     */
+    template<typename T, typename TK>
+    bool separableFixedPoint(const vc::Buffer2DView<T,vc::TargetHost>& img_in, vc::Buffer2DView<T,vc::TargetHost>& img_out, 
+                             const Eigen::Matrix<TK,Eigen::Dynamic,1>& kern_x, const Eigen::Matrix<TK,Eigen::Dynamic,1>& kern_y,
+                             vc::BorderMode border, const T& border_value, std::true_type)
+    {
+        if(!fixedPointFits(kern_x, kern_y)) { return false; }
+        
+        const std::size_t width = img_in.width(), height = img_in.height();
+        const std::size_t radius_x = kern_x.size() / 2, radius_y = kern_y.size() / 2;
+        const std::vector<int32_t> qx = fixedPointKernel(kern_x), qy = fixedPointKernel(kern_y);
+        
+        const ConvolutionKernels& k = selectConvolutionKernels();
+        
+        std::size_t x_begin, x_end;
+        skipSpan(width, radius_x, border, x_begin, x_end);
+        
+        separableBands<int16_t>(width, height, radius_y, x_begin, border == vc::BorderMode::Skip, 
+                                [&](std::ptrdiff_t j, int16_t* line)
+        {
+            LineBuffers<T>& lb = threadLineBuffers<T>();
+            lb.padded.resize(width + 2 * radius_x);
+            
+            int src = (int)j;
+            const T* row_in = ::internal::borderIndexY(img_in, src, border) ? img_in.rowPtr(src) : nullptr;
+            padRow(k, img_in, row_in, radius_x, border, border_value, lb.padded.data());
+            fixedRow(k, lb.padded.data(), line, width, qx.data(), kern_x.size());
+        },
+        [&](std::size_t y, const int16_t* const* rows)
+        {
+            fixedColumn(k, rows, img_out.rowPtr(y) + x_begin, x_end - x_begin, qy.data(), kern_y.size());
+        });
+        
+        return true;
+    }
+}
+
+namespace
+{
+    /**
+     * Dense kernel of kw by kh taps anchored at (kw/2, kh/2), kern(i, j) gives the taps, result multiplied by scale.
+     * Interior spans are a sum of shifted rows, one axpy line kernel per tap into a per thread
+     * accumulator, the border pixels go tap by tap through the border policy.
+     */
+    template<typename T, typename KernelFunction>
+    void denseStencil(const vc::Buffer2DView<T,vc::TargetHost>& img_in, vc::Buffer2DView<T,vc::TargetHost>& img_out, 
+                      int kw, int kh, KernelFunction kern, T scale, vc::BorderMode border, T border_value)
+    {
+        const int ax = kw / 2, ay = kh / 2;
+        const ConvolutionKernels& k = selectConvolutionKernels();
+        const ::internal::BorderReader<T> reader{img_in, border, border_value};
+        
+        ::internal::launchStencil(img_in.width(), img_in.height(), ax, ay, border, 
+                                  [&](std::size_t y, std::size_t x_begin, std::size_t x_end)
+        {
+            const std::size_t n = x_end - x_begin;
+            std::vector<T>& acc = threadLineBuffers<T>().acc;
+            acc.resize(n);
+            
+            for(int j = 0 ; j < kh ; ++j)
+            {
+                const T* row_in = img_in.rowPtr(y + j - ay) + x_begin - ax;
+                
+                for(int i = 0 ; i < kw ; ++i)
+                {
+                    if(i == 0 && j == 0)
+                    {
+                        scaleLine(k, row_in, acc.data(), n, kern(i, j));
+                    }
+                    else
+                    {
+                        axpyLine(k, row_in + i, acc.data(), n, kern(i, j));
+                    }
+                }
+            }
+            
+            scaleLine(k, acc.data(), img_out.rowPtr(y) + x_begin, n, scale);
+        },
+        [&](std::size_t x, std::size_t y)
+        {
+            T sum = vc::zero<T>();
+            
+            for(int j = 0 ; j < kh ; ++j)
+            {
+                for(int i = 0 ; i < kw ; ++i)
+                {
+                    sum += reader((int)x + i - ax, (int)y + j - ay) * kern(i, j);
+                }
+            }
+            
+            img_out(x,y) = sum * scale;
+        });
+    }
+}
+
 template<typename T, typename Target, typename T2>
 struct ConvolutionDispatcher;
 
@@ -48,19 +434,16 @@ struct ConvolutionDispatcher<_Scalar, Target, Eigen::Matrix<_Scalar, _Rows, _Col
     static void convolve1D(const vc::Buffer1DView<_Scalar,Target>& img_in, 
                            vc::Buffer1DView<_Scalar,Target>& img_out, const KernelT& kern)
     {
-        int split_x = _Rows/2;
+        const int split_x = _Rows/2;
+        const _Scalar kernsum = kern.col(0).sum();
         
         vc::launchParallelFor(img_in.size(), [&](std::size_t x)
         {
             _Scalar sum = vc::zero<_Scalar>();
-            _Scalar kernsum = vc::zero<_Scalar>();
 
             for(int px = -split_x ; px <= split_x ; ++px)
             {
-                const _Scalar& pix = img_in.getWithClampedRange((int)x + px);
-                const _Scalar& kv = kern( split_x + px , 0 );
-                sum += (pix * kv);
-                kernsum += kv;
+                sum += img_in.getWithClampedRange((int)x + px) * kern( split_x + px , 0 );
             }
             
             img_out(x) = sum / kernsum;
@@ -68,43 +451,90 @@ struct ConvolutionDispatcher<_Scalar, Target, Eigen::Matrix<_Scalar, _Rows, _Col
     }
     
     static void convolve2D(const vc::Buffer2DView<_Scalar,Target>& img_in, 
-                           vc::Buffer2DView<_Scalar,Target>& img_out, const KernelT& kern)
+                           vc::Buffer2DView<_Scalar,Target>& img_out, const KernelT& kern,
+                           vc::BorderMode border = vc::BorderMode::Clamp, _Scalar border_value = vc::zero<_Scalar>())
     {
-        int split_x = _Rows/2, split_y = _Cols/2;
-        
-        vc::launchParallelFor(img_in.width(), img_in.height(), [&](std::size_t x, std::size_t y)
-        {
-            _Scalar sum = vc::zero<_Scalar>();
-            _Scalar kernsum = vc::zero<_Scalar>();
-            
-            for(int py = -split_y ; py <= split_y ; ++py)
-            {
-                for(int px = -split_x ; px <= split_x ; ++px)
-                {
-                    const _Scalar& pix = img_in.getWithClampedRange((int)x + px, (int)y + py);
-                    const _Scalar& kv = kern( split_x + px , split_y + py );
-                    sum += (pix * kv);
-                    kernsum += kv;
-                }
-            }
-            
-            img_out(x,y) = sum / kernsum;
-        });
+        // kernel rows go along x
+        denseStencil(img_in, img_out, _Rows, _Cols, [&](int i, int j) { return kern(i, j); }, 
+                     _Scalar(1.0) / kern.sum(), border, border_value);
     }
 };
 
 template<typename T, typename Target, typename T2>
 void vc::math::convolve(const vc::Buffer1DView<T,Target>& img_in, vc::Buffer1DView<T,Target>& img_out, const T2& kern)
 {
+    VISIONCORE_TRACE_SCOPE_1D("convolve", img_in.size(), img_in.bytes() + img_out.bytes());
     return ConvolutionDispatcher<T,Target,T2>::convolve1D(img_in, img_out, kern);
 }
 
 template<typename T, typename Target, typename T2>
 void vc::math::convolve(const vc::Buffer2DView<T,Target>& img_in, vc::Buffer2DView<T,Target>& img_out, const T2& kern)
 {
+    VISIONCORE_TRACE_SCOPE_2D("convolve", img_in.width(), img_in.height(), 2 * img_in.area() * sizeof(T));
     return ConvolutionDispatcher<T,Target,T2>::convolve2D(img_in, img_out, kern);
 }
 
+template<typename T, typename T2>
+void vc::math::convolve(const vc::Buffer2DView<T,vc::TargetHost>& img_in, vc::Buffer2DView<T,vc::TargetHost>& img_out, const T2& kern,
+                        vc::BorderMode border, const T& border_value)
+{
+    VISIONCORE_TRACE_SCOPE_2D("convolve", img_in.width(), img_in.height(), 2 * img_in.area() * sizeof(T));
+    return ConvolutionDispatcher<T,vc::TargetHost,T2>::convolve2D(img_in, img_out, kern, border, border_value);
+}
+
+template<typename T>
+void vc::math::correlate(const vc::Buffer2DView<T,vc::TargetHost>& img_in, vc::Buffer2DView<T,vc::TargetHost>& img_out, 
+                         const vc::Buffer2DView<T,vc::TargetHost>& kern, vc::BorderMode border, const T& border_value)
+{
+    if(kern.width() == 0 || kern.height() == 0)
+    {
+        throw std::runtime_error("Empty kernel");
+    }
+    
+    if(img_in.width() != img_out.width() || img_in.height() != img_out.height())
+    {
+        throw std::runtime_error("In/Out dimensions don't match");
+    }
+    
+    VISIONCORE_TRACE_SCOPE_2D("correlate", img_in.width(), img_in.height(), 2 * img_in.area() * sizeof(T));
+    denseStencil(img_in, img_out, (int)kern.width(), (int)kern.height(), [&](int i, int j) { return kern(i, j); }, 
+                 T(1.0), border, border_value);
+}
+
+template<typename T, typename TK>
+void vc::math::convolveSeparable(const vc::Buffer2DView<T,vc::TargetHost>& img_in, vc::Buffer2DView<T,vc::TargetHost>& img_out, 
+                                 const Eigen::Matrix<TK,Eigen::Dynamic,1>& kern_x, const Eigen::Matrix<TK,Eigen::Dynamic,1>& kern_y,
+                                 vc::BorderMode border, const T& border_value)
+{
+    if(kern_x.size() % 2 == 0 || kern_y.size() % 2 == 0)
+    {
+        throw std::runtime_error("Kernel length has to be odd");
+    }
+    
+    if(img_in.width() != img_out.width() || img_in.height() != img_out.height())
+    {
+        throw std::runtime_error("In/Out dimensions don't match");
+    }
+    
+    VISIONCORE_TRACE_SCOPE_2D("convolveSeparable", img_in.width(), img_in.height(), img_in.area() * sizeof(T) * 2);
+    if(!separableFixedPoint(img_in, img_out, kern_x, kern_y, border, border_value, FixedPointPixel<T>()))
+    {
+        separableFloat(img_in, img_out, kern_x, kern_y, border, border_value);
+    }
+}
+
+template<typename T>
+void vc::math::boxFilter(const vc::Buffer2DView<T,vc::TargetHost>& img_in, vc::Buffer2DView<T,vc::TargetHost>& img_out, 
+                         std::size_t radius_x, std::size_t radius_y, vc::BorderMode border, const T& border_value)
+{
+    typedef typename SeparableAcc<T>::Type TK;
+    typedef Eigen::Matrix<TK,Eigen::Dynamic,1> KernelT;
+    
+    const KernelT kern_x = KernelT::Constant(2 * radius_x + 1, TK(1.0) / TK(2 * radius_x + 1));
+    const KernelT kern_y = KernelT::Constant(2 * radius_y + 1, TK(1.0) / TK(2 * radius_y + 1));
+    convolveSeparable(img_in, img_out, kern_x, kern_y, border, border_value);
+}
+
 // 1D CPU float
 template void vc::math::convolve<float,vc::TargetHost, Eigen::Matrix<float,3,1> >(const vc::Buffer1DView<float,vc::TargetHost>& img_in, vc::Buffer1DView<float,vc::TargetHost>& img_out, const Eigen::Matrix<float,3,1>& kern);
 template void vc::math::convolve<float,vc::TargetHost, Eigen::Matrix<float,5,1> >(const vc::Buffer1DView<float,vc::TargetHost>& img_in, vc::Buffer1DView<float,vc::TargetHost>& img_out, const Eigen::Matrix<float,5,1>& kern);
@@ -128,3 +558,31 @@ template void vc::math::convolve<double,vc::TargetHost, Eigen::Matrix<double,3,3
 template void vc::math::convolve<double,vc::TargetHost, Eigen::Matrix<double,5,5> >(const vc::Buffer2DView<double,vc::TargetHost>& img_in, vc::Buffer2DView<double,vc::TargetHost>& img_out, const Eigen::Matrix<double,5,5>& kern);
 template void vc::math::convolve<double,vc::TargetHost, Eigen::Matrix<double,7,7> >(const vc::Buffer2DView<double,vc::TargetHost>& img_in, vc::Buffer2DView<double,vc::TargetHost>& img_out, const Eigen::Matrix<double,7,7>& kern);
 template void vc::math::convolve<double,vc::TargetHost, Eigen::Matrix<double,9,9> >(const vc::Buffer2DView<double,vc::TargetHost>& img_in, vc::Buffer2DView<double,vc::TargetHost>& img_out, const Eigen::Matrix<double,9,9>& kern);
+
+// 2D CPU float with border
+template void vc::math::convolve<float, Eigen::Matrix<float,3,3> >(const vc::Buffer2DView<float,vc::TargetHost>& img_in, vc::Buffer2DView<float,vc::TargetHost>& img_out, const Eigen::Matrix<float,3,3>& kern, vc::BorderMode border, const float& border_value);
+template void vc::math::convolve<float, Eigen::Matrix<float,5,5> >(const vc::Buffer2DView<float,vc::TargetHost>& img_in, vc::Buffer2DView<float,vc::TargetHost>& img_out, const Eigen::Matrix<float,5,5>& kern, vc::BorderMode border, const float& border_value);
+template void vc::math::convolve<float, Eigen::Matrix<float,7,7> >(const vc::Buffer2DView<float,vc::TargetHost>& img_in, vc::Buffer2DView<float,vc::TargetHost>& img_out, const Eigen::Matrix<float,7,7>& kern, vc::BorderMode border, const float& border_value);
+template void vc::math::convolve<float, Eigen::Matrix<float,9,9> >(const vc::Buffer2DView<float,vc::TargetHost>& img_in, vc::Buffer2DView<float,vc::TargetHost>& img_out, const Eigen::Matrix<float,9,9>& kern, vc::BorderMode border, const float& border_value);
+
+// 2D CPU double with border
+template void vc::math::convolve<double, Eigen::Matrix<double,3,3> >(const vc::Buffer2DView<double,vc::TargetHost>& img_in, vc::Buffer2DView<double,vc::TargetHost>& img_out, const Eigen::Matrix<double,3,3>& kern, vc::BorderMode border, const double& border_value);
+template void vc::math::convolve<double, Eigen::Matrix<double,5,5> >(const vc::Buffer2DView<double,vc::TargetHost>& img_in, vc::Buffer2DView<double,vc::TargetHost>& img_out, const Eigen::Matrix<double,5,5>& kern, vc::BorderMode border, const double& border_value);
+template void vc::math::convolve<double, Eigen::Matrix<double,7,7> >(const vc::Buffer2DView<double,vc::TargetHost>& img_in, vc::Buffer2DView<double,vc::TargetHost>& img_out, const Eigen::Matrix<double,7,7>& kern, vc::BorderMode border, const double& border_value);
+template void vc::math::convolve<double, Eigen::Matrix<double,9,9> >(const vc::Buffer2DView<double,vc::TargetHost>& img_in, vc::Buffer2DView<double,vc::TargetHost>& img_out, const Eigen::Matrix<double,9,9>& kern, vc::BorderMode border, const double& border_value);
+
+// Dense runtime kernel CPU
+template void vc::math::correlate<float>(const vc::Buffer2DView<float,vc::TargetHost>& img_in, vc::Buffer2DView<float,vc::TargetHost>& img_out, const vc::Buffer2DView<float,vc::TargetHost>& kern, vc::BorderMode border, const float& border_value);
+template void vc::math::correlate<double>(const vc::Buffer2DView<double,vc::TargetHost>& img_in, vc::Buffer2DView<double,vc::TargetHost>& img_out, const vc::Buffer2DView<double,vc::TargetHost>& kern, vc::BorderMode border, const double& border_value);
+
+// Separable CPU
+template void vc::math::convolveSeparable<uint8_t, float>(const vc::Buffer2DView<uint8_t,vc::TargetHost>& img_in, vc::Buffer2DView<uint8_t,vc::TargetHost>& img_out, const Eigen::Matrix<float,Eigen::Dynamic,1>& kern_x, const Eigen::Matrix<float,Eigen::Dynamic,1>& kern_y, vc::BorderMode border, const uint8_t& border_value);
+template void vc::math::convolveSeparable<uint16_t, float>(const vc::Buffer2DView<uint16_t,vc::TargetHost>& img_in, vc::Buffer2DView<uint16_t,vc::TargetHost>& img_out, const Eigen::Matrix<float,Eigen::Dynamic,1>& kern_x, const Eigen::Matrix<float,Eigen::Dynamic,1>& kern_y, vc::BorderMode border, const uint16_t& border_value);
+template void vc::math::convolveSeparable<float, float>(const vc::Buffer2DView<float,vc::TargetHost>& img_in, vc::Buffer2DView<float,vc::TargetHost>& img_out, const Eigen::Matrix<float,Eigen::Dynamic,1>& kern_x, const Eigen::Matrix<float,Eigen::Dynamic,1>& kern_y, vc::BorderMode border, const float& border_value);
+template void vc::math::convolveSeparable<double, double>(const vc::Buffer2DView<double,vc::TargetHost>& img_in, vc::Buffer2DView<double,vc::TargetHost>& img_out, const Eigen::Matrix<double,Eigen::Dynamic,1>& kern_x, const Eigen::Matrix<double,Eigen::Dynamic,1>& kern_y, vc::BorderMode border, const double& border_value);
+
+// Box CPU
+template void vc::math::boxFilter<uint8_t>(const vc::Buffer2DView<uint8_t,vc::TargetHost>& img_in, vc::Buffer2DView<uint8_t,vc::TargetHost>& img_out, std::size_t radius_x, std::size_t radius_y, vc::BorderMode border, const uint8_t& border_value);
+template void vc::math::boxFilter<uint16_t>(const vc::Buffer2DView<uint16_t,vc::TargetHost>& img_in, vc::Buffer2DView<uint16_t,vc::TargetHost>& img_out, std::size_t radius_x, std::size_t radius_y, vc::BorderMode border, const uint16_t& border_value);
+template void vc::math::boxFilter<float>(const vc::Buffer2DView<float,vc::TargetHost>& img_in, vc::Buffer2DView<float,vc::TargetHost>& img_out, std::size_t radius_x, std::size_t radius_y, vc::BorderMode border, const float& border_value);
+template void vc::math::boxFilter<double>(const vc::Buffer2DView<double,vc::TargetHost>& img_in, vc::Buffer2DView<double,vc::TargetHost>& img_out, std::size_t radius_x, std::size_t radius_y, vc::BorderMode border, const double& border_value);
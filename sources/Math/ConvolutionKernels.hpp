@@ -0,0 +1,102 @@
+/**
+ * ****************************************************************************
+ * Copyright (c) 2017, Robert Lukierski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ****************************************************************************
+ * Convolution line kernels, one table per CPU level.
+ * ****************************************************************************
+ */
+
+#ifndef VISIONCORE_CONVOLUTION_KERNELS_HPP
+#define VISIONCORE_CONVOLUTION_KERNELS_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace vc
+{
+
+namespace math
+{
+
+namespace internal
+{
+
+/**
+ * Fixed-point coefficients of the integer kernels, 1.0 is 1 << FixedPointBits.
+ */
+constexpr int FixedPointBits = 14;
+
+/**
+ * Element-wise line kernels over n elements, plain pointers only (see PixelConvertKernels.hpp).
+ * 
+ * The fixed-point ones take taps Q14 coefficients packed in pairs for pmaddwd, c[p] has tap 2p in
+ * the low and tap 2p + 1 in the high 16 bits (0 past the end). in has n + taps - 1 elements (row), 
+ * or there are taps lines of n elements (column). Products are summed in 32 bits and rounded half up, 
+ * the stores saturate. Lines are int16, u8 pixels as Q7.
+ */
+struct ConvolutionKernels
+{
+    /// out = k * in
+    void (*scaleF32)(const float* in, float* out, std::size_t n, float k);
+    void (*scaleF64)(const double* in, double* out, std::size_t n, double k);
+    /// out += k * in
+    void (*axpyF32)(const float* in, float* out, std::size_t n, float k);
+    void (*axpyF64)(const double* in, double* out, std::size_t n, double k);
+    void (*u8ToF32)(const uint8_t* in, float* out, std::size_t n);
+    void (*u16ToF32)(const uint16_t* in, float* out, std::size_t n);
+    /// rounded to nearest and saturated, NaN to 0
+    void (*f32ToU8)(const float* in, uint8_t* out, std::size_t n);
+    void (*f32ToU16)(const float* in, uint16_t* out, std::size_t n);
+    /// out[x] = sum c[t] * in[x + t] >> 7, Q7 line
+    void (*rowU8ToI16)(const uint8_t* in, int16_t* out, std::size_t n, const int32_t* c, std::size_t taps);
+    /// out[x] = sum c[t] * lines[t][x] >> 21, from Q7 lines
+    void (*colI16ToU8)(const int16_t* const* lines, uint8_t* out, std::size_t n, const int32_t* c, std::size_t taps);
+    /// out[x] = (top[2x] + top[2x+1] + bottom[2x] + bottom[2x+1] + 2) >> 2, n output pixels
+    void (*halfU8)(const uint8_t* top, const uint8_t* bottom, uint8_t* out, std::size_t n);
+    void (*halfU16)(const uint16_t* top, const uint16_t* bottom, uint16_t* out, std::size_t n);
+};
+
+extern const ConvolutionKernels convolutionKernelsGeneric;
+
+#ifdef VISIONCORE_HAVE_CPU_DISPATCH
+extern const ConvolutionKernels convolutionKernelsAVX2;
+extern const ConvolutionKernels convolutionKernelsAVX512;
+#endif // VISIONCORE_HAVE_CPU_DISPATCH
+
+/// Table for the current CPU level (see CPUFeatures.hpp).
+const ConvolutionKernels& selectConvolutionKernels();
+
+}
+
+}
+
+}
+
+#endif // VISIONCORE_CONVOLUTION_KERNELS_HPP
@@ -0,0 +1,451 @@
+/**
+ * ****************************************************************************
+ * Copyright (c) 2017, Robert Lukierski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ****************************************************************************
+ * Convolution line kernels, compiled once per CPU level.
+ *
+ * Include in a translation unit built with the flags of the level, after defining
+ * VISIONCORE_CONVOLUTION_KERNELS to the name of the table from ConvolutionKernels.hpp.
+ * ****************************************************************************
+ */
+
+#ifndef VISIONCORE_CONVOLUTION_KERNELS_IMPL_HPP
+#define VISIONCORE_CONVOLUTION_KERNELS_IMPL_HPP
+
+#include <Math/ConvolutionKernels.hpp>
+
+#ifndef VISIONCORE_CONVOLUTION_KERNELS
+#error "Define VISIONCORE_CONVOLUTION_KERNELS to the table name first"
+#endif // VISIONCORE_CONVOLUTION_KERNELS
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define VISIONCORE_CONVOLUTION_SSE2
+#endif // SSE2
+
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#define VISIONCORE_CONVOLUTION_AVX2
+#endif // AVX2
+
+#if defined(__AVX512F__) && defined(__AVX512BW__)
+#define VISIONCORE_CONVOLUTION_AVX512
+#endif // AVX512
+
+namespace
+{
+    inline float saturateF32(float v, float vmax)
+    {
+        v = v + 0.5f;
+        v = v > 0.0f ? v : 0.0f;
+        return v < vmax ? v : vmax;
+    }
+    
+    void scaleF32(const float* in, float* out, std::size_t n, float k)
+    {
+        std::size_t i = 0;
+#if defined(VISIONCORE_CONVOLUTION_AVX512)
+        const __m512 k16 = _mm512_set1_ps(k);
+        for( ; i + 16 <= n ; i += 16) { _mm512_storeu_ps(out + i, _mm512_mul_ps(k16, _mm512_loadu_ps(in + i))); }
+#endif
+#if defined(VISIONCORE_CONVOLUTION_AVX2)
+        const __m256 k8 = _mm256_set1_ps(k);
+        for( ; i + 8 <= n ; i += 8) { _mm256_storeu_ps(out + i, _mm256_mul_ps(k8, _mm256_loadu_ps(in + i))); }
+#endif
+#if defined(VISIONCORE_CONVOLUTION_SSE2)
+        const __m128 k4 = _mm_set1_ps(k);
+        for( ; i + 4 <= n ; i += 4) { _mm_storeu_ps(out + i, _mm_mul_ps(k4, _mm_loadu_ps(in + i))); }
+#endif
+        for( ; i < n ; ++i) { out[i] = k * in[i]; }
+    }
+    
+    void scaleF64(const double* in, double* out, std::size_t n, double k)
+    {
+        std::size_t i = 0;
+#if defined(VISIONCORE_CONVOLUTION_AVX512)
+        const __m512d k8 = _mm512_set1_pd(k);
+        for( ; i + 8 <= n ; i += 8) { _mm512_storeu_pd(out + i, _mm512_mul_pd(k8, _mm512_loadu_pd(in + i))); }
+#endif
+#if defined(VISIONCORE_CONVOLUTION_AVX2)
+        const __m256d k4 = _mm256_set1_pd(k);
+        for( ; i + 4 <= n ; i += 4) { _mm256_storeu_pd(out + i, _mm256_mul_pd(k4, _mm256_loadu_pd(in + i))); }
+#endif
+#if defined(VISIONCORE_CONVOLUTION_SSE2)
+        const __m128d k2 = _mm_set1_pd(k);
+        for( ; i + 2 <= n ; i += 2) { _mm_storeu_pd(out + i, _mm_mul_pd(k2, _mm_loadu_pd(in + i))); }
+#endif
+        for( ; i < n ; ++i) { out[i] = k * in[i]; }
+    }
+    
+    void axpyF32(const float* in, float* out, std::size_t n, float k)
+    {
+        std::size_t i = 0;
+#if defined(VISIONCORE_CONVOLUTION_AVX512)
+        const __m512 k16 = _mm512_set1_ps(k);
+        for( ; i + 16 <= n ; i += 16) 
+        { 
+            _mm512_storeu_ps(out + i, _mm512_fmadd_ps(k16, _mm512_loadu_ps(in + i), _mm512_loadu_ps(out + i))); 
+        }
+#endif
+#if defined(VISIONCORE_CONVOLUTION_AVX2)
+        const __m256 k8 = _mm256_set1_ps(k);
+        for( ; i + 8 <= n ; i += 8) 
+        { 
+            _mm256_storeu_ps(out + i, _mm256_fmadd_ps(k8, _mm256_loadu_ps(in + i), _mm256_loadu_ps(out + i))); 
+        }
+#endif
+#if defined(VISIONCORE_CONVOLUTION_SSE2)
+        const __m128 k4 = _mm_set1_ps(k);
+        for( ; i + 4 <= n ; i += 4) 
+        { 
+            _mm_storeu_ps(out + i, _mm_add_ps(_mm_mul_ps(k4, _mm_loadu_ps(in + i)), _mm_loadu_ps(out + i))); 
+        }
+#endif
+        for( ; i < n ; ++i) { out[i] += k * in[i]; }
+    }
+    
+    void axpyF64(const double* in, double* out, std::size_t n, double k)
+    {
+        std::size_t i = 0;
+#if defined(VISIONCORE_CONVOLUTION_AVX512)
+        const __m512d k8 = _mm512_set1_pd(k);
+        for( ; i + 8 <= n ; i += 8) 
+        { 
+            _mm512_storeu_pd(out + i, _mm512_fmadd_pd(k8, _mm512_loadu_pd(in + i), _mm512_loadu_pd(out + i))); 
+        }
+#endif
+#if defined(VISIONCORE_CONVOLUTION_AVX2)
+        const __m256d k4 = _mm256_set1_pd(k);
+        for( ; i + 4 <= n ; i += 4) 
+        { 
+            _mm256_storeu_pd(out + i, _mm256_fmadd_pd(k4, _mm256_loadu_pd(in + i), _mm256_loadu_pd(out + i))); 
+        }
+#endif
+#if defined(VISIONCORE_CONVOLUTION_SSE2)
+        const __m128d k2 = _mm_set1_pd(k);
+        for( ; i + 2 <= n ; i += 2) 
+        { 
+            _mm_storeu_pd(out + i, _mm_add_pd(_mm_mul_pd(k2, _mm_loadu_pd(in + i)), _mm_loadu_pd(out + i))); 
+        }
+#endif
+        for( ; i < n ; ++i) { out[i] += k * in[i]; }
+    }
+    
+    void u8ToF32(const uint8_t* in, float* out, std::size_t n)
+    {
+        std::size_t i = 0;
+#if defined(VISIONCORE_CONVOLUTION_AVX2)
+        for( ; i + 8 <= n ; i += 8)
+        {
+            const __m128i v = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(in + i));
+            _mm256_storeu_ps(out + i, _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(v)));
+        }
+#endif
+#if defined(VISIONCORE_CONVOLUTION_SSE2)
+        const __m128i zero = _mm_setzero_si128();
+        for( ; i + 8 <= n ; i += 8)
+        {
+            const __m128i v = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(in + i)), zero);
+            _mm_storeu_ps(out + i, _mm_cvtepi32_ps(_mm_unpacklo_epi16(v, zero)));
+            _mm_storeu_ps(out + i + 4, _mm_cvtepi32_ps(_mm_unpackhi_epi16(v, zero)));
+        }
+#endif
+        for( ; i < n ; ++i) { out[i] = float(in[i]); }
+    }
+    
+    void u16ToF32(const uint16_t* in, float* out, std::size_t n)
+    {
+        std::size_t i = 0;
+#if defined(VISIONCORE_CONVOLUTION_AVX2)
+        for( ; i + 8 <= n ; i += 8)
+        {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+            _mm256_storeu_ps(out + i, _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(v)));
+        }
+#endif
+#if defined(VISIONCORE_CONVOLUTION_SSE2)
+        const __m128i zero = _mm_setzero_si128();
+        for( ; i + 8 <= n ; i += 8)
+        {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+            _mm_storeu_ps(out + i, _mm_cvtepi32_ps(_mm_unpacklo_epi16(v, zero)));
+            _mm_storeu_ps(out + i + 4, _mm_cvtepi32_ps(_mm_unpackhi_epi16(v, zero)));
+        }
+#endif
+        for( ; i < n ; ++i) { out[i] = float(in[i]); }
+    }
+    
+    void f32ToU8(const float* in, uint8_t* out, std::size_t n)
+    {
+        std::size_t i = 0;
+#if defined(VISIONCORE_CONVOLUTION_SSE2)
+        const __m128 half = _mm_set1_ps(0.5f), vmax = _mm_set1_ps(255.0f);
+        for( ; i + 16 <= n ; i += 16)
+        {
+            __m128i q[4];
+            for(int j = 0 ; j < 4 ; ++j)
+            {
+                const __m128 v = _mm_add_ps(_mm_loadu_ps(in + i + 4 * j), half);
+                q[j] = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(v, _mm_setzero_ps()), vmax));
+            }
+            
+            const __m128i w = _mm_packus_epi16(_mm_packs_epi32(q[0], q[1]), _mm_packs_epi32(q[2], q[3]));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), w);
+        }
+#endif
+        for( ; i < n ; ++i) { out[i] = uint8_t(saturateF32(in[i], 255.0f)); }
+    }
+    
+    void f32ToU16(const float* in, uint16_t* out, std::size_t n)
+    {
+        std::size_t i = 0;
+#if defined(VISIONCORE_CONVOLUTION_SSE2)
+        // no packus_epi32 in SSE2, shift to the signed range and back
+        const __m128 half = _mm_set1_ps(0.5f), vmax = _mm_set1_ps(65535.0f);
+        const __m128i bias32 = _mm_set1_epi32(32768), bias16 = _mm_set1_epi16(-32768);
+        for( ; i + 8 <= n ; i += 8)
+        {
+            const __m128 v0 = _mm_add_ps(_mm_loadu_ps(in + i), half);
+            const __m128 v1 = _mm_add_ps(_mm_loadu_ps(in + i + 4), half);
+            const __m128i q0 = _mm_sub_epi32(_mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(v0, _mm_setzero_ps()), vmax)), bias32);
+            const __m128i q1 = _mm_sub_epi32(_mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(v1, _mm_setzero_ps()), vmax)), bias32);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_xor_si128(_mm_packs_epi32(q0, q1), bias16));
+        }
+#endif
+        for( ; i < n ; ++i) { out[i] = uint16_t(saturateF32(in[i], 65535.0f)); }
+    }
+    
+    using vc::math::internal::FixedPointBits;
+    
+    inline int16_t saturateI16(int32_t v)
+    {
+        return int16_t(v < -32768 ? -32768 : (v > 32767 ? 32767 : v));
+    }
+    
+    inline int32_t saturateU(int32_t v, int32_t vmax)
+    {
+        return v < 0 ? 0 : (v > vmax ? vmax : v);
+    }
+    
+    // taps t and t + 1 for madd_epi16 on interleaved lines, an odd last tap pairs with 0
+    // tap t of the pairs the fixed-point kernels take
+    inline int32_t tapAt(const int32_t* c, std::size_t t)
+    {
+        return int16_t(uint32_t(c[t / 2]) >> (16 * (t % 2)));
+    }
+    
+#if defined(VISIONCORE_CONVOLUTION_AVX2)
+    // lo / hi += a * tap 2p + b * tap 2p + 1, k is the pair, lanes interleaved as the packs undo it
+    inline void maddPair(__m256i a, __m256i b, __m256i k, __m256i& lo, __m256i& hi)
+    {
+        lo = _mm256_add_epi32(lo, _mm256_madd_epi16(_mm256_unpacklo_epi16(a, b), k));
+        hi = _mm256_add_epi32(hi, _mm256_madd_epi16(_mm256_unpackhi_epi16(a, b), k));
+    }
+    
+    inline __m256i loadU8x16(const uint8_t* p) { return _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))); }
+    inline __m256i loadI16x16(const void* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+#endif
+    
+#if defined(VISIONCORE_CONVOLUTION_SSE2)
+    inline void maddPair(__m128i a, __m128i b, __m128i k, __m128i& lo, __m128i& hi)
+    {
+        lo = _mm_add_epi32(lo, _mm_madd_epi16(_mm_unpacklo_epi16(a, b), k));
+        hi = _mm_add_epi32(hi, _mm_madd_epi16(_mm_unpackhi_epi16(a, b), k));
+    }
+    
+    inline __m128i loadU8x8(const uint8_t* p) { return _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)), _mm_setzero_si128()); }
+    inline __m128i loadI16x8(const void* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+#endif
+    
+    void rowU8ToI16(const uint8_t* in, int16_t* out, std::size_t n, const int32_t* c, std::size_t taps)
+    {
+        constexpr int shift = FixedPointBits - 7;
+        std::size_t i = 0;
+#if defined(VISIONCORE_CONVOLUTION_AVX2)
+        const __m256i round8 = _mm256_set1_epi32(1 << (shift - 1));
+        for( ; i + 16 <= n ; i += 16)
+        {
+            __m256i lo = round8, hi = round8;
+            std::size_t t = 0;
+            for( ; t + 1 < taps ; t += 2) { maddPair(loadU8x16(in + i + t), loadU8x16(in + i + t + 1), _mm256_set1_epi32(c[t / 2]), lo, hi); }
+            if(t < taps) { const __m256i a = loadU8x16(in + i + t); maddPair(a, a, _mm256_set1_epi32(c[t / 2]), lo, hi); }
+            
+            const __m256i v = _mm256_packs_epi32(_mm256_srai_epi32(lo, shift), _mm256_srai_epi32(hi, shift));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), v);
+        }
+#endif
+#if defined(VISIONCORE_CONVOLUTION_SSE2)
+        const __m128i round4 = _mm_set1_epi32(1 << (shift - 1));
+        for( ; i + 8 <= n ; i += 8)
+        {
+            __m128i lo = round4, hi = round4;
+            std::size_t t = 0;
+            for( ; t + 1 < taps ; t += 2) { maddPair(loadU8x8(in + i + t), loadU8x8(in + i + t + 1), _mm_set1_epi32(c[t / 2]), lo, hi); }
+            if(t < taps) { const __m128i a = loadU8x8(in + i + t); maddPair(a, a, _mm_set1_epi32(c[t / 2]), lo, hi); }
+            
+            const __m128i v = _mm_packs_epi32(_mm_srai_epi32(lo, shift), _mm_srai_epi32(hi, shift));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), v);
+        }
+#endif
+        for( ; i < n ; ++i)
+        {
+            int32_t s = 1 << (shift - 1);
+            for(std::size_t t = 0 ; t < taps ; ++t) { s += tapAt(c, t) * in[i + t]; }
+            out[i] = saturateI16(s >> shift);
+        }
+    }
+    
+    void colI16ToU8(const int16_t* const* lines, uint8_t* out, std::size_t n, const int32_t* c, std::size_t taps)
+    {
+        constexpr int shift = FixedPointBits + 7;
+        std::size_t i = 0;
+#if defined(VISIONCORE_CONVOLUTION_AVX2)
+        const __m256i round8 = _mm256_set1_epi32(1 << (shift - 1));
+        for( ; i + 16 <= n ; i += 16)
+        {
+            __m256i lo = round8, hi = round8;
+            std::size_t t = 0;
+            for( ; t + 1 < taps ; t += 2) { maddPair(loadI16x16(lines[t] + i), loadI16x16(lines[t + 1] + i), _mm256_set1_epi32(c[t / 2]), lo, hi); }
+            if(t < taps) { const __m256i a = loadI16x16(lines[t] + i); maddPair(a, a, _mm256_set1_epi32(c[t / 2]), lo, hi); }
+            
+            const __m256i v = _mm256_packs_epi32(_mm256_srai_epi32(lo, shift), _mm256_srai_epi32(hi, shift));
+            // packs work per 128-bit lane, gather the low halves
+            const __m256i u = _mm256_permute4x64_epi64(_mm256_packus_epi16(v, v), 0x08);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm256_castsi256_si128(u));
+        }
+#endif
+#if defined(VISIONCORE_CONVOLUTION_SSE2)
+        const __m128i round4 = _mm_set1_epi32(1 << (shift - 1));
+        for( ; i + 8 <= n ; i += 8)
+        {
+            __m128i lo = round4, hi = round4;
+            std::size_t t = 0;
+            for( ; t + 1 < taps ; t += 2) { maddPair(loadI16x8(lines[t] + i), loadI16x8(lines[t + 1] + i), _mm_set1_epi32(c[t / 2]), lo, hi); }
+            if(t < taps) { const __m128i a = loadI16x8(lines[t] + i); maddPair(a, a, _mm_set1_epi32(c[t / 2]), lo, hi); }
+            
+            const __m128i v = _mm_packs_epi32(_mm_srai_epi32(lo, shift), _mm_srai_epi32(hi, shift));
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(v, v));
+        }
+#endif
+        for( ; i < n ; ++i)
+        {
+            int32_t s = 1 << (shift - 1);
+            for(std::size_t t = 0 ; t < taps ; ++t) { s += tapAt(c, t) * lines[t][i]; }
+            out[i] = uint8_t(saturateU(s >> shift, 255));
+        }
+    }
+    
+    void halfU8(const uint8_t* top, const uint8_t* bottom, uint8_t* out, std::size_t n)
+    {
+        std::size_t i = 0;
+#if defined(VISIONCORE_CONVOLUTION_AVX2)
+        const __m256i ones = _mm256_set1_epi8(1), two16 = _mm256_set1_epi16(2);
+        for( ; i + 16 <= n ; i += 16)
+        {
+            // pmaddubsw against 1s sums the horizontal pairs into 16 bits
+            const __m256i t = _mm256_maddubs_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(top + 2 * i)), ones);
+            const __m256i b = _mm256_maddubs_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(bottom + 2 * i)), ones);
+            const __m256i v = _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(t, b), two16), 2);
+            const __m256i u = _mm256_permute4x64_epi64(_mm256_packus_epi16(v, v), 0x08);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm256_castsi256_si128(u));
+        }
+#endif
+#if defined(VISIONCORE_CONVOLUTION_SSE2)
+        const __m128i mask8 = _mm_set1_epi16(0x00FF), two8 = _mm_set1_epi16(2);
+        for( ; i + 8 <= n ; i += 8)
+        {
+            const __m128i t = _mm_loadu_si128(reinterpret_cast<const __m128i*>(top + 2 * i));
+            const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bottom + 2 * i));
+            const __m128i st = _mm_add_epi16(_mm_and_si128(t, mask8), _mm_srli_epi16(t, 8));
+            const __m128i sb = _mm_add_epi16(_mm_and_si128(b, mask8), _mm_srli_epi16(b, 8));
+            const __m128i v = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(st, sb), two8), 2);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(v, v));
+        }
+#endif
+        for( ; i < n ; ++i)
+        {
+            out[i] = uint8_t((top[2 * i] + top[2 * i + 1] + bottom[2 * i] + bottom[2 * i + 1] + 2) >> 2);
+        }
+    }
+    
+    void halfU16(const uint16_t* top, const uint16_t* bottom, uint16_t* out, std::size_t n)
+    {
+        std::size_t i = 0;
+#if defined(VISIONCORE_CONVOLUTION_AVX2)
+        const __m256i mask8 = _mm256_set1_epi32(0xFFFF), two8 = _mm256_set1_epi32(2);
+        for( ; i + 8 <= n ; i += 8)
+        {
+            const __m256i t = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(top + 2 * i));
+            const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bottom + 2 * i));
+            const __m256i st = _mm256_add_epi32(_mm256_and_si256(t, mask8), _mm256_srli_epi32(t, 16));
+            const __m256i sb = _mm256_add_epi32(_mm256_and_si256(b, mask8), _mm256_srli_epi32(b, 16));
+            const __m256i v = _mm256_srli_epi32(_mm256_add_epi32(_mm256_add_epi32(st, sb), two8), 2);
+            const __m256i u = _mm256_permute4x64_epi64(_mm256_packus_epi32(v, v), 0x08);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm256_castsi256_si128(u));
+        }
+#endif
+#if defined(VISIONCORE_CONVOLUTION_SSE2)
+        const __m128i mask4 = _mm_set1_epi32(0xFFFF), two4 = _mm_set1_epi32(2 - 4 * 32768);
+        const __m128i bias8 = _mm_set1_epi16(-32768);
+        for( ; i + 4 <= n ; i += 4)
+        {
+            const __m128i t = _mm_loadu_si128(reinterpret_cast<const __m128i*>(top + 2 * i));
+            const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bottom + 2 * i));
+            const __m128i st = _mm_add_epi32(_mm_and_si128(t, mask4), _mm_srli_epi32(t, 16));
+            const __m128i sb = _mm_add_epi32(_mm_and_si128(b, mask4), _mm_srli_epi32(b, 16));
+            // biased into the signed range before the pack, as in f32ToU16
+            const __m128i v = _mm_srai_epi32(_mm_add_epi32(_mm_add_epi32(st, sb), two4), 2);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(out + i), _mm_xor_si128(_mm_packs_epi32(v, v), bias8));
+        }
+#endif
+        for( ; i < n ; ++i)
+        {
+            out[i] = uint16_t((top[2 * i] + top[2 * i + 1] + bottom[2 * i] + bottom[2 * i + 1] + 2) >> 2);
+        }
+    }
+}
+
+const vc::math::internal::ConvolutionKernels vc::math::internal::VISIONCORE_CONVOLUTION_KERNELS =
+{
+    &scaleF32,
+    &scaleF64,
+    &axpyF32,
+    &axpyF64,
+    &u8ToF32,
+    &u16ToF32,
+    &f32ToU8,
+    &f32ToU16,
+    &rowU8ToI16,
+    &colI16ToU8,
+    &halfU8,
+    &halfU16
+};
+
+#endif // VISIONCORE_CONVOLUTION_KERNELS_IMPL_HPP
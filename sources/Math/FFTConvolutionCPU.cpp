@@ -0,0 +1,387 @@
+/**
+ * ****************************************************************************
+ * Copyright (c) 2017, Robert Lukierski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * ****************************************************************************
+ * Large kernel convolution through the FFT.
+ * ****************************************************************************
+ */
+
+#include <VisionCore/Math/FFTConvolution.hpp>
+#include <VisionCore/Math/Convolution.hpp>
+#include <VisionCore/Math/Fourier.hpp>
+
+#include <VisionCore/LaunchUtils.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+#include <Image/StencilHelpers.hpp>
+
+namespace
+{
+    /**
+     * Costs in units of one direct tap, correlate() runs at 0.37-0.54 ns a tap on one AVX-512 core.
+     * Each tile point pays for the fill, the spectral product and the readout, 2-4 ns measured, 
+     * each tile for its dispatch and setup, 3-6 us measured.
+     * The transforms cost a few taps per point and log2 of the tile size, forward and inverse
+     * together, twice that once a tile and its spectrum do not fit in L2 any more. Those two 
+     * are estimates, the measurements above ran without FFTW.
+     */
+    constexpr double DirectCostPerTap = 1.0;
+    constexpr double FFTCostPerPoint = 6.0;
+    constexpr double FFTCostPerPointLog2 = 4.0;
+    constexpr double FFTOutOfCacheFactor = 2.0;
+    constexpr std::size_t TileCacheBytes = 512 * 1024;
+    constexpr double TileOverhead = 8192.0;
+    
+    /**
+     * Transform sizes FFTW does well, 2^a 3^b 5^c from min_size up to the first one >= max_size.
+     */
+    std::vector<std::size_t> goodFFTSizes(std::size_t min_size, std::size_t max_size)
+    {
+        std::vector<std::size_t> sizes;
+        std::size_t limit = 1;
+        while(limit < max_size) { limit *= 2; }
+        
+        for(std::size_t p2 = 1 ; p2 <= limit ; p2 *= 2)
+        {
+            for(std::size_t p3 = p2 ; p3 <= limit ; p3 *= 3)
+            {
+                for(std::size_t p5 = p3 ; p5 <= limit ; p5 *= 5)
+                {
+                    if(p5 >= min_size) { sizes.push_back(p5); }
+                }
+            }
+        }
+        
+        std::sort(sizes.begin(), sizes.end());
+        
+        // nothing past the first size that covers max_size
+        const auto last = std::lower_bound(sizes.begin(), sizes.end(), max_size);
+        if(last != sizes.end()) { sizes.erase(last + 1, sizes.end()); }
+        
+        return sizes;
+    }
+    
+    /**
+     * Overlap-save tiling, tiles of tile_w by tile_h samples give valid_w by valid_h output pixels.
+     */
+    struct TilePlan
+    {
+        std::size_t tile_w = 0, tile_h = 0;
+        std::size_t valid_w = 0, valid_h = 0;
+        std::size_t tiles_x = 0, tiles_y = 0;
+        double cost = 0.0;
+    };
+    
+    TilePlan planTiles(std::size_t width, std::size_t height, std::size_t kw, std::size_t kh, std::size_t sample_bytes)
+    {
+        const std::vector<std::size_t> sizes_x = goodFFTSizes(kw, width + kw - 1);
+        const std::vector<std::size_t> sizes_y = goodFFTSizes(kh, height + kh - 1);
+        
+        TilePlan best;
+        best.cost = std::numeric_limits<double>::infinity();
+        
+        for(std::size_t tw : sizes_x)
+        {
+            for(std::size_t th : sizes_y)
+            {
+                TilePlan p;
+                p.tile_w = tw;
+                p.tile_h = th;
+                p.valid_w = tw - kw + 1;
+                p.valid_h = th - kh + 1;
+                p.tiles_x = (width + p.valid_w - 1) / p.valid_w;
+                p.tiles_y = (height + p.valid_h - 1) / p.valid_h;
+                
+                // real tile and the half spectrum
+                const double points = double(tw * th);
+                const double per_point_log2 = FFTCostPerPointLog2 * (2 * tw * th * sample_bytes > TileCacheBytes ? FFTOutOfCacheFactor : 1.0);
+                p.cost = double(p.tiles_x * p.tiles_y) * (points * (FFTCostPerPoint + per_point_log2 * std::log2(points)) + TileOverhead);
+                
+                if(p.cost < best.cost) { best = p; }
+            }
+        }
+        
+        return best;
+    }
+    
+    inline double directCost(std::size_t width, std::size_t height, std::size_t kw, std::size_t kh)
+    {
+        return double(width * height) * double(kw * kh) * DirectCostPerTap;
+    }
+}
+
+template<typename T>
+struct vc::math::FFTConvolution<T>::Impl
+{
+    typedef std::complex<T> ComplexT;
+    
+    /**
+     * One tile in flight, with its plans.
+     */
+    struct Workspace
+    {
+        // makeFFT() and the plan destructor hold the FFTW planner lock themselves
+        Workspace(std::size_t tw, std::size_t th) : tile(tw, th), freq(tw / 2 + 1, th)
+        {
+            forward = vc::math::makeFFT(tile, freq, true);
+            inverse = vc::math::makeFFT(freq, tile, false);
+        }
+        
+        vc::Buffer2DManaged<T,vc::TargetHost>           tile;
+        vc::Buffer2DManaged<ComplexT,vc::TargetHost>    freq;
+        std::unique_ptr<vc::math::PersistentFFT>        forward;
+        std::unique_ptr<vc::math::PersistentFFT>        inverse;
+    };
+    
+    Impl(const vc::Buffer2DView<T,vc::TargetHost>& kern, bool correlation, vc::math::ConvolutionMethod m) 
+        : kernel(kern.width(), kern.height()), forced(m)
+    {
+        if(kern.width() == 0 || kern.height() == 0)
+        {
+            throw std::runtime_error("Empty kernel");
+        }
+        
+        // convolution is correlation with the flipped kernel
+        for(std::size_t j = 0 ; j < kern.height() ; ++j)
+        {
+            for(std::size_t i = 0 ; i < kern.width() ; ++i)
+            {
+                kernel(i, j) = correlation ? kern(i, j) : kern(kern.width() - 1 - i, kern.height() - 1 - j);
+            }
+        }
+    }
+    
+    std::unique_ptr<Workspace> acquire()
+    {
+        {
+            std::lock_guard<std::mutex> lock(workspace_mutex);
+            if(!workspaces.empty())
+            {
+                std::unique_ptr<Workspace> ws = std::move(workspaces.back());
+                workspaces.pop_back();
+                return ws;
+            }
+        }
+        
+        return std::unique_ptr<Workspace>(new Workspace(plan.tile_w, plan.tile_h));
+    }
+    
+    void release(std::unique_ptr<Workspace> ws)
+    {
+        std::lock_guard<std::mutex> lock(workspace_mutex);
+        workspaces.push_back(std::move(ws));
+    }
+    
+    /**
+     * Tiles and kernel spectrum for this image size, kept until the size changes.
+     */
+    void prepare(std::size_t w, std::size_t h)
+    {
+        if(spectrum && w == width && h == height) { return; }
+        
+        width = w;
+        height = h;
+        plan = planTiles(w, h, kernel.width(), kernel.height(), sizeof(T));
+        workspaces.clear();
+        
+        // zero padded kernel at the origin, correlation is the product with the conjugate,
+        // the inverse transform is not normalised so fold 1 / N in here as well
+        std::unique_ptr<Workspace> ws = acquire();
+        ws->tile.memset(0);
+        for(std::size_t j = 0 ; j < kernel.height() ; ++j)
+        {
+            std::copy(kernel.rowPtr(j), kernel.rowPtr(j) + kernel.width(), ws->tile.rowPtr(j));
+        }
+        ws->forward->execute();
+        
+        const T norm = T(1.0) / T(plan.tile_w * plan.tile_h);
+        spectrum.reset(new vc::Buffer2DManaged<ComplexT,vc::TargetHost>(ws->freq.width(), ws->freq.height()));
+        for(std::size_t y = 0 ; y < ws->freq.height() ; ++y)
+        {
+            for(std::size_t x = 0 ; x < ws->freq.width() ; ++x)
+            {
+                (*spectrum)(x, y) = std::conj(ws->freq(x, y)) * norm;
+            }
+        }
+        
+        release(std::move(ws));
+    }
+    
+    void runFFT(const vc::Buffer2DView<T,vc::TargetHost>& img_in, vc::Buffer2DView<T,vc::TargetHost>& img_out,
+                vc::BorderMode border, const T& border_value)
+    {
+        prepare(img_in.width(), img_in.height());
+        
+        const int ax = (int)kernel.width() / 2, ay = (int)kernel.height() / 2;
+        const int w = (int)width, h = (int)height;
+        
+        // Skip leaves the pixels whose footprint leaves the image alone, as correlate()
+        const bool skip = border == vc::BorderMode::Skip;
+        const int out_x_begin = skip ? ax : 0, out_x_end = skip ? w - ax : w;
+        const int out_y_begin = skip ? ay : 0, out_y_end = skip ? h - ay : h;
+        if(out_x_end <= out_x_begin || out_y_end <= out_y_begin) { return; }
+        
+        vc::launchParallelFor(plan.tiles_x * plan.tiles_y, [&](std::size_t t)
+        {
+            std::unique_ptr<Workspace> ws = acquire();
+            vc::Buffer2DManaged<T,vc::TargetHost>& tile = ws->tile;
+            vc::Buffer2DManaged<ComplexT,vc::TargetHost>& freq = ws->freq;
+            
+            const int x0 = (int)((t % plan.tiles_x) * plan.valid_w);
+            const int y0 = (int)((t / plan.tiles_x) * plan.valid_h);
+            const int tw = (int)plan.tile_w, th = (int)plan.tile_h;
+            
+            // input samples from (x0 - ax, y0 - ay), columns [c_begin, c_end) are inside the image
+            const int c_begin = std::min(std::max(ax - x0, 0), tw);
+            const int c_end = std::min(std::max(w + ax - x0, c_begin), tw);
+            
+            for(int r = 0 ; r < th ; ++r)
+            {
+                T* row_tile = tile.rowPtr(r);
+                int sy = y0 - ay + r;
+                
+                if(!::internal::borderIndexY(img_in, sy, border))
+                {
+                    std::fill(row_tile, row_tile + tw, border_value);
+                    continue;
+                }
+                
+                const T* row_in = img_in.rowPtr(sy);
+                std::copy(row_in + x0 - ax + c_begin, row_in + x0 - ax + c_end, row_tile + c_begin);
+                
+                auto edge = [&](int c)
+                {
+                    int sx = x0 - ax + c;
+                    row_tile[c] = ::internal::borderIndexX(img_in, sx, border) ? row_in[sx] : border_value;
+                };
+                
+                for(int c = 0 ; c < c_begin ; ++c) { edge(c); }
+                for(int c = c_end ; c < tw ; ++c) { edge(c); }
+            }
+            
+            ws->forward->execute();
+            
+            for(std::size_t y = 0 ; y < freq.height() ; ++y)
+            {
+                ComplexT* row_freq = freq.rowPtr(y);
+                const ComplexT* row_kern = spectrum->rowPtr(y);
+                
+                for(std::size_t x = 0 ; x < freq.width() ; ++x)
+                {
+                    row_freq[x] *= row_kern[x];
+                }
+            }
+            
+            ws->inverse->execute();
+            
+            // the first valid_w by valid_h samples saw no wrap around
+            const int x_begin = std::max(x0, out_x_begin), x_end = std::min(x0 + (int)plan.valid_w, out_x_end);
+            const int y_begin = std::max(y0, out_y_begin), y_end = std::min(y0 + (int)plan.valid_h, out_y_end);
+            
+            for(int y = y_begin ; y < y_end ; ++y)
+            {
+                const T* row_tile = tile.rowPtr(y - y0);
+                if(x_end > x_begin)
+                {
+                    std::copy(row_tile + x_begin - x0, row_tile + x_end - x0, img_out.rowPtr(y) + x_begin);
+                }
+            }
+            
+            release(std::move(ws));
+        });
+    }
+    
+    vc::Buffer2DManaged<T,vc::TargetHost>   kernel;
+    vc::math::ConvolutionMethod             forced;
+    std::mutex                              call_mutex;
+    
+    // state for the last image size
+    std::size_t                                                     width = 0;
+    std::size_t                                                     height = 0;
+    TilePlan                                                        plan;
+    std::unique_ptr<vc::Buffer2DManaged<ComplexT,vc::TargetHost>>   spectrum;
+    std::vector<std::unique_ptr<Workspace>>                         workspaces;
+    std::mutex                                                      workspace_mutex;
+};
+
+template<typename T>
+vc::math::FFTConvolution<T>::FFTConvolution(const vc::Buffer2DView<T,vc::TargetHost>& kern, bool correlation, 
+                                            vc::math::ConvolutionMethod method)
+    : impl(new Impl(kern, correlation, method))
+{
+    
+}
+
+template<typename T>
+vc::math::FFTConvolution<T>::~FFTConvolution()
+{
+    
+}
+
+template<typename T>
+vc::math::ConvolutionMethod vc::math::FFTConvolution<T>::method(std::size_t width, std::size_t height) const
+{
+    if(impl->forced != ConvolutionMethod::Auto) { return impl->forced; }
+    
+    const std::size_t kw = impl->kernel.width(), kh = impl->kernel.height();
+    const double fft_cost = planTiles(width, height, kw, kh, sizeof(T)).cost;
+    return fft_cost < directCost(width, height, kw, kh) ? ConvolutionMethod::FFT : ConvolutionMethod::Direct;
+}
+
+template<typename T>
+void vc::math::FFTConvolution<T>::operator()(const vc::Buffer2DView<T,vc::TargetHost>& img_in, vc::Buffer2DView<T,vc::TargetHost>& img_out,
+                                             vc::BorderMode border, const T& border_value)
+{
+    if(img_in.width() != img_out.width() || img_in.height() != img_out.height())
+    {
+        throw std::runtime_error("In/Out dimensions don't match");
+    }
+    
+    std::lock_guard<std::mutex> lock(impl->call_mutex);
+    
+    if(method(img_in.width(), img_in.height()) == ConvolutionMethod::Direct)
+    {
+        vc::math::correlate(img_in, img_out, impl->kernel, border, border_value);
+        return;
+    }
+    
+    VISIONCORE_TRACE_SCOPE_2D("fftConvolve", img_in.width(), img_in.height(), 2 * img_in.area() * sizeof(T));
+    impl->runFFT(img_in, img_out, border, border_value);
+}
+
+template class vc::math::FFTConvolution<float>;
+template class vc::math::FFTConvolution<double>;
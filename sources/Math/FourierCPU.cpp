@@ -36,8 +36,21 @@
 #include <VisionCore/Math/Fourier.hpp>
 #include <VisionCore/LaunchUtils.hpp>
 
+#include <mutex>
+#include <utility>
+
 #include <fftw3.h>
 
+/**
+ * The FFTW planner is not thread safe, executing plans is. Every plan made or destroyed in
+ * this file goes through this lock, whoever the caller is.
+ */
+static std::mutex& plannerMutex()
+{
+    static std::mutex m;
+    return m;
+}
+
 template<typename T>
 struct ToFFTWType { };
 
@@ -58,14 +71,25 @@ struct plan_wrapper<double> : public vc::math::PersistentFFT
 
     plan_wrapper(const plan_wrapper&) = delete; // no copies
     plan_wrapper& operator=(const plan_wrapper& other) = delete; // no copies
-    plan_wrapper(plan_wrapper&& other) noexcept : p(std::move(other.p)) { }
-    plan_wrapper& operator=(plan_wrapper&& other) { p = std::move(other.p); return *this; }
+    plan_wrapper(plan_wrapper&& other) noexcept : p(other.p) { other.p = nullptr; }
+    plan_wrapper& operator=(plan_wrapper&& other) { std::swap(p, other.p); return *this; }
 
     plan_wrapper() : p(nullptr) { }
     plan_wrapper(FFTWPT _p) : p(_p) { }
-    ~plan_wrapper() { if(p != nullptr) { fftw_destroy_plan(p); } }
+    ~plan_wrapper() 
+    { 
+        if(p != nullptr) 
+        { 
+            std::lock_guard<std::mutex> lock(plannerMutex());
+            fftw_destroy_plan(p); 
+        } 
+    }
 
-    virtual void execute() { fftw_execute(p); }
+    virtual void execute() 
+    { 
+        VISIONCORE_TRACE_SCOPE("PersistentFFT::execute");
+        fftw_execute(p); 
+    }
 
     FFTWPT p;
 };
@@ -77,14 +101,25 @@ struct plan_wrapper<float> : public vc::math::PersistentFFT
 
     plan_wrapper(const plan_wrapper&) = delete; // no copies
     plan_wrapper& operator=(const plan_wrapper& other) = delete; // no copies
-    plan_wrapper(plan_wrapper&& other) noexcept : p(std::move(other.p)) { }
-    plan_wrapper& operator=(plan_wrapper&& other) { p = std::move(other.p); return *this; }
+    plan_wrapper(plan_wrapper&& other) noexcept : p(other.p) { other.p = nullptr; }
+    plan_wrapper& operator=(plan_wrapper&& other) { std::swap(p, other.p); return *this; }
 
     plan_wrapper() : p(nullptr) { }
     plan_wrapper(FFTWPT _p) : p(_p) { }
-    ~plan_wrapper() { if(p != nullptr) { fftwf_destroy_plan(p); } }
+    ~plan_wrapper() 
+    { 
+        if(p != nullptr) 
+        { 
+            std::lock_guard<std::mutex> lock(plannerMutex());
+            fftwf_destroy_plan(p); 
+        } 
+    }
 
-    virtual void execute() { fftwf_execute(p); }
+    virtual void execute() 
+    { 
+        VISIONCORE_TRACE_SCOPE("PersistentFFT::execute");
+        fftwf_execute(p); 
+    }
 
     FFTWPT p;
 };
@@ -178,10 +213,11 @@ struct PlanHelper<FTT::R2C, T_COMPLEX, float>
         return plan_wrapper<T_REAL>(fftwf_plan_dft_r2c_1d(N, idata, odata, FFTW_ESTIMATE));
     }
 
-    static inline plan_wrapper<T_REAL> makePlan2D(std::size_t W, std::size_t H, FFTWRealT* idata, FFTWComplexT* odata, int dir = FFTW_FORWARD)
+    static inline plan_wrapper<T_REAL> makePlan2D(int H, int W, FFTWRealT* idata, int ipitch, FFTWComplexT* odata, int opitch, int dir = FFTW_FORWARD)
     {
         (void)dir;
-        return plan_wrapper<T_REAL>(fftwf_plan_dft_r2c_2d(W, H, idata, odata, FFTW_ESTIMATE));
+        int n[] = { H, W }, inembed[] = { H, ipitch }, onembed[] = { H, opitch };
+        return plan_wrapper<T_REAL>(fftwf_plan_many_dft_r2c(2, n, 1, idata, inembed, 1, 0, odata, onembed, 1, 0, FFTW_ESTIMATE));
     }
 };
 
@@ -198,10 +234,11 @@ struct PlanHelper<FTT::R2C, T_COMPLEX, double>
         return plan_wrapper<T_REAL>(fftw_plan_dft_r2c_1d(N, idata, odata, FFTW_ESTIMATE));
     }
 
-    static inline plan_wrapper<T_REAL> makePlan2D(std::size_t W, std::size_t H, FFTWRealT* idata, FFTWComplexT* odata, int dir = FFTW_FORWARD)
+    static inline plan_wrapper<T_REAL> makePlan2D(int H, int W, FFTWRealT* idata, int ipitch, FFTWComplexT* odata, int opitch, int dir = FFTW_FORWARD)
     {
         (void)dir;
-        return plan_wrapper<T_REAL>(fftw_plan_dft_r2c_2d(W, H, idata, odata, FFTW_ESTIMATE));
+        int n[] = { H, W }, inembed[] = { H, ipitch }, onembed[] = { H, opitch };
+        return plan_wrapper<T_REAL>(fftw_plan_many_dft_r2c(2, n, 1, idata, inembed, 1, 0, odata, onembed, 1, 0, FFTW_ESTIMATE));
     }
 };
 
@@ -219,10 +256,11 @@ struct PlanHelper<FTT::C2R, T_COMPLEX, float>
         return plan_wrapper<T_REAL>(fftwf_plan_dft_c2r_1d(N, idata, odata, FFTW_ESTIMATE));
     }
 
-    static inline plan_wrapper<T_REAL> makePlan2D(std::size_t W, std::size_t H, FFTWComplexT* idata, FFTWRealT* odata, int dir = FFTW_FORWARD)
+    static inline plan_wrapper<T_REAL> makePlan2D(int H, int W, FFTWComplexT* idata, int ipitch, FFTWRealT* odata, int opitch, int dir = FFTW_FORWARD)
     {
         (void)dir;
-        return plan_wrapper<T_REAL>(fftwf_plan_dft_c2r_2d(W, H, idata, odata, FFTW_ESTIMATE));
+        int n[] = { H, W }, inembed[] = { H, ipitch }, onembed[] = { H, opitch };
+        return plan_wrapper<T_REAL>(fftwf_plan_many_dft_c2r(2, n, 1, idata, inembed, 1, 0, odata, onembed, 1, 0, FFTW_ESTIMATE));
     }
 };
 
@@ -239,10 +277,11 @@ struct PlanHelper<FTT::C2R, T_COMPLEX, double>
         return plan_wrapper<T_REAL>(fftw_plan_dft_c2r_1d(N, idata, odata, FFTW_ESTIMATE));
     }
 
-    static inline plan_wrapper<T_REAL> makePlan2D(std::size_t W, std::size_t H, FFTWComplexT* idata, FFTWRealT* odata, int dir = FFTW_FORWARD)
+    static inline plan_wrapper<T_REAL> makePlan2D(int H, int W, FFTWComplexT* idata, int ipitch, FFTWRealT* odata, int opitch, int dir = FFTW_FORWARD)
     {
         (void)dir;
-        return plan_wrapper<T_REAL>(fftw_plan_dft_c2r_2d(W, H, idata, odata, FFTW_ESTIMATE));
+        int n[] = { H, W }, inembed[] = { H, ipitch }, onembed[] = { H, opitch };
+        return plan_wrapper<T_REAL>(fftw_plan_many_dft_c2r(2, n, 1, idata, inembed, 1, 0, odata, onembed, 1, 0, FFTW_ESTIMATE));
     }
 };
 
@@ -259,9 +298,10 @@ struct PlanHelper<FTT::C2C, T_COMPLEX, float>
         return plan_wrapper<T_REAL>(fftwf_plan_dft_1d(N, idata, odata, dir, FFTW_ESTIMATE));
     }
 
-    static inline plan_wrapper<T_REAL> makePlan2D(std::size_t W, std::size_t H, FFTWComplexT* idata, FFTWComplexT* odata, int dir = FFTW_FORWARD)
+    static inline plan_wrapper<T_REAL> makePlan2D(int H, int W, FFTWComplexT* idata, int ipitch, FFTWComplexT* odata, int opitch, int dir = FFTW_FORWARD)
     {
-        return plan_wrapper<T_REAL>(fftwf_plan_dft_2d(W, H, idata, odata, dir, FFTW_ESTIMATE));
+        int n[] = { H, W }, inembed[] = { H, ipitch }, onembed[] = { H, opitch };
+        return plan_wrapper<T_REAL>(fftwf_plan_many_dft(2, n, 1, idata, inembed, 1, 0, odata, onembed, 1, 0, dir, FFTW_ESTIMATE));
     }
 };
 
@@ -277,9 +317,10 @@ struct PlanHelper<FTT::C2C, T_COMPLEX, double>
         return plan_wrapper<T_REAL>(fftw_plan_dft_1d(N, idata, odata, dir, FFTW_ESTIMATE));
     }
 
-    static inline plan_wrapper<T_REAL> makePlan2D(std::size_t W, std::size_t H, FFTWComplexT* idata, FFTWComplexT* odata, int dir = FFTW_FORWARD)
+    static inline plan_wrapper<T_REAL> makePlan2D(int H, int W, FFTWComplexT* idata, int ipitch, FFTWComplexT* odata, int opitch, int dir = FFTW_FORWARD)
     {
-        return plan_wrapper<T_REAL>(fftw_plan_dft_2d(W, H, idata, odata, dir, FFTW_ESTIMATE));
+        int n[] = { H, W }, inembed[] = { H, ipitch }, onembed[] = { H, opitch };
+        return plan_wrapper<T_REAL>(fftw_plan_many_dft(2, n, 1, idata, inembed, 1, 0, odata, onembed, 1, 0, dir, FFTW_ESTIMATE));
     }
 };
 
@@ -296,15 +337,24 @@ struct ProperPlan
         typedef typename ToFFTWType<typename TransformDirection<T_INPUT,T_OUTPUT>::FirstArgT>::FFTWType FFTWFirstArgT;
         typedef typename ToFFTWType<typename TransformDirection<T_INPUT,T_OUTPUT>::SecondArgT>::FFTWType FFTWSecondArgT;
 
+        std::lock_guard<std::mutex> lock(plannerMutex());
         return PlanHelperT::makePlan1D(N, reinterpret_cast<FFTWFirstArgT*>(buf_in), reinterpret_cast<FFTWSecondArgT*>(buf_out), fwd == true ? FFTW_FORWARD : FFTW_BACKWARD);
     }
 
-    static plan_wrapper<T_REAL> makePlan2D(std::size_t W, std::size_t H, T_INPUT* buf_in, T_OUTPUT* buf_out, bool fwd)
+    template<typename Target>
+    static plan_wrapper<T_REAL> makePlan2D(const vc::Buffer2DView<T_INPUT, Target>& buf_in, vc::Buffer2DView<T_OUTPUT, Target>& buf_out, bool fwd)
     {
         typedef typename ToFFTWType<typename TransformDirection<T_INPUT,T_OUTPUT>::FirstArgT>::FFTWType FFTWFirstArgT;
         typedef typename ToFFTWType<typename TransformDirection<T_INPUT,T_OUTPUT>::SecondArgT>::FFTWType FFTWSecondArgT;
 
-        return PlanHelperT::makePlan2D(W, H, reinterpret_cast<FFTWFirstArgT*>(buf_in), reinterpret_cast<FFTWSecondArgT*>(buf_out), fwd == true ? FFTW_FORWARD : FFTW_BACKWARD);
+        // logical size is the real side for R2C / C2R, rows may be padded
+        const int H = (int)std::max(buf_in.height(), buf_out.height());
+        const int W = (int)std::max(buf_in.width(), buf_out.width());
+        
+        std::lock_guard<std::mutex> lock(plannerMutex());
+        return PlanHelperT::makePlan2D(H, W, reinterpret_cast<FFTWFirstArgT*>(const_cast<T_INPUT*>(buf_in.ptr())), (int)buf_in.elementPitch(),
+                                       reinterpret_cast<FFTWSecondArgT*>(buf_out.ptr()), (int)buf_out.elementPitch(), 
+                                       fwd == true ? FFTW_FORWARD : FFTW_BACKWARD);
     }
 };
 
@@ -312,6 +362,7 @@ template<typename T_INPUT, typename T_OUTPUT, typename Target>
 void vc::math::fft(int npoint, const vc::Buffer1DView<T_INPUT, Target >& buf_in,
                    vc::Buffer1DView<T_OUTPUT, Target >& buf_out, bool forward)
 {
+    VISIONCORE_TRACE_SCOPE_1D("fft", npoint, npoint * (sizeof(T_INPUT) + sizeof(T_OUTPUT)));
     typedef ProperPlan<T_INPUT, T_OUTPUT> ProperPlanT;
 
     plan_wrapper<typename ProperPlanT::T_REAL> p = ProperPlanT::makePlan1D(npoint, const_cast<T_INPUT*>(buf_in.ptr()), buf_out.ptr(), forward);
@@ -323,9 +374,10 @@ template<typename T_INPUT, typename T_OUTPUT, typename Target>
 void vc::math::fft(const vc::Buffer2DView<T_INPUT, Target>& buf_in,
                            vc::Buffer2DView<T_OUTPUT, Target>& buf_out, bool forward)
 {
+    VISIONCORE_TRACE_SCOPE_2D("fft", buf_in.width(), buf_in.height(), buf_in.area() * (sizeof(T_INPUT) + sizeof(T_OUTPUT)));
     typedef ProperPlan<T_INPUT, T_OUTPUT> ProperPlanT;
 
-    plan_wrapper<typename ProperPlanT::T_REAL> p = ProperPlanT::makePlan2D(buf_in.width(), buf_in.height(), const_cast<T_INPUT*>(buf_in.ptr()), buf_out.ptr(), forward);
+    plan_wrapper<typename ProperPlanT::T_REAL> p = ProperPlanT::makePlan2D(buf_in, buf_out, forward);
 
     p.execute();
 }
@@ -334,6 +386,7 @@ template<typename T_INPUT, typename T_OUTPUT, typename Target>
 std::unique_ptr<vc::math::PersistentFFT> vc::math::makeFFT(int npoint, const vc::Buffer1DView<T_INPUT, Target >& buf_in,
                                                            vc::Buffer1DView<T_OUTPUT, Target >& buf_out, bool forward)
 {
+    VISIONCORE_TRACE_SCOPE_1D("makeFFT", npoint, 0);
     typedef ProperPlan<T_INPUT, T_OUTPUT> ProperPlanT;
     typedef plan_wrapper<typename ProperPlanT::T_REAL> PlanT;
 
@@ -344,10 +397,11 @@ template<typename T_INPUT, typename T_OUTPUT, typename Target>
 std::unique_ptr<vc::math::PersistentFFT> vc::math::makeFFT(const vc::Buffer2DView<T_INPUT, Target>& buf_in,
                                                            vc::Buffer2DView<T_OUTPUT, Target>& buf_out, bool forward)
 {
+    VISIONCORE_TRACE_SCOPE_2D("makeFFT", buf_in.width(), buf_in.height(), 0);
     typedef ProperPlan<T_INPUT, T_OUTPUT> ProperPlanT;
     typedef plan_wrapper<typename ProperPlanT::T_REAL> PlanT;
 
-    return std::unique_ptr<vc::math::PersistentFFT>(new PlanT(ProperPlanT::makePlan2D(buf_in.width(), buf_in.height(), const_cast<T_INPUT*>(buf_in.ptr()), buf_out.ptr(), forward)));
+    return std::unique_ptr<vc::math::PersistentFFT>(new PlanT(ProperPlanT::makePlan2D(buf_in, buf_out, forward)));
 }
 
 template<typename T_COMPLEX, typename Target>
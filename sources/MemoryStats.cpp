@@ -0,0 +1,333 @@
+/**
+ * ****************************************************************************
+ * Copyright (c) 2017, Robert Lukierski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * ****************************************************************************
+ * Allocation and transfer accounting per memory target.
+ * ****************************************************************************
+ */
+
+#include <VisionCore/MemoryStats.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+
+namespace
+{
+    static constexpr std::size_t Targets = (std::size_t)vc::MemoryTarget::Count;
+    
+    struct AtomicCounters
+    {
+        AtomicCounters() : live_bytes(0), peak_bytes(0), allocations(0), deallocations(0), copies_in(0), bytes_copied_in(0) { }
+        
+        void allocate(std::size_t bytes)
+        {
+            const std::size_t now = live_bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+            std::size_t peak = peak_bytes.load(std::memory_order_relaxed);
+            while(now > peak && !peak_bytes.compare_exchange_weak(peak, now, std::memory_order_relaxed)) { }
+            allocations.fetch_add(1, std::memory_order_relaxed);
+        }
+        
+        void deallocate(std::size_t bytes)
+        {
+            live_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+            deallocations.fetch_add(1, std::memory_order_relaxed);
+        }
+        
+        void copied(std::size_t bytes)
+        {
+            copies_in.fetch_add(1, std::memory_order_relaxed);
+            bytes_copied_in.fetch_add(bytes, std::memory_order_relaxed);
+        }
+        
+        vc::memstats::Counters snapshot() const
+        {
+            vc::memstats::Counters ret;
+            ret.live_bytes = live_bytes.load();
+            ret.peak_bytes = peak_bytes.load();
+            ret.allocations = allocations.load();
+            ret.deallocations = deallocations.load();
+            ret.copies_in = copies_in.load();
+            ret.bytes_copied_in = bytes_copied_in.load();
+            return ret;
+        }
+        
+        void reset()
+        {
+            peak_bytes = live_bytes.load();
+            allocations = 0;
+            deallocations = 0;
+            copies_in = 0;
+            bytes_copied_in = 0;
+        }
+        
+        std::atomic<std::size_t>    live_bytes;
+        std::atomic<std::size_t>    peak_bytes;
+        std::atomic<uint64_t>       allocations;
+        std::atomic<uint64_t>       deallocations;
+        std::atomic<uint64_t>       copies_in;
+        std::atomic<uint64_t>       bytes_copied_in;
+    };
+    
+    struct Tracked
+    {
+        std::size_t     bytes;
+        uint32_t        label;
+    };
+    
+    struct State
+    {
+        State() : label_count(1), label_names(1) 
+        {
+            for(auto& t : transfers) { for(auto& v : t) { v = 0; } }
+        }
+        
+        std::array<AtomicCounters, Targets>                                 totals;
+        std::array<std::array<AtomicCounters, vc::memstats::MaxLabels>, Targets> per_label;
+        std::array<std::array<std::atomic<uint64_t>, Targets>, Targets>     transfers;
+        
+        std::mutex                                                          mutex;      // labels & tracked
+        std::atomic<uint32_t>                                               label_count;
+        std::vector<std::string>                                            label_names;
+        std::unordered_map<std::string, uint32_t>                           label_ids;
+        std::array<std::unordered_map<const void*, Tracked>, Targets>       tracked;
+    };
+    
+    State& state()
+    {
+        // never destroyed, memory may be freed during static destruction
+        static State* st = new State();
+        return *st;
+    }
+    
+    thread_local uint32_t current_label = 0;
+    
+    uint32_t labelId(const char* label)
+    {
+        if(label == nullptr || *label == '\0') { return 0; }
+        
+        State& st = state();
+        std::lock_guard<std::mutex> lock(st.mutex);
+        
+        auto it = st.label_ids.find(label);
+        if(it != st.label_ids.end()) { return it->second; }
+        
+        if(st.label_names.size() >= vc::memstats::MaxLabels) { return 0; }
+        
+        const uint32_t id = (uint32_t)st.label_names.size();
+        st.label_names.push_back(label);
+        st.label_ids.emplace(label, id);
+        st.label_count = id + 1;
+        return id;
+    }
+    
+    std::string formatBytes(uint64_t bytes)
+    {
+        static const char* units[] = { "B", "KiB", "MiB", "GiB", "TiB" };
+        double v = (double)bytes;
+        std::size_t u = 0;
+        while(v >= 1024.0 && u < 4) { v /= 1024.0; ++u; }
+        
+        std::ostringstream os;
+        os << std::fixed << std::setprecision(u == 0 ? 0 : 1) << v << " " << units[u];
+        return os.str();
+    }
+}
+
+const char* vc::memoryTargetName(MemoryTarget target)
+{
+    switch(target)
+    {
+        case MemoryTarget::Host: return "Host";
+        case MemoryTarget::CUDA: return "CUDA";
+        case MemoryTarget::OpenCL: return "OpenCL";
+        default: return "?";
+    }
+}
+
+vc::memstats::LabelScope::LabelScope(const char* label) : previous(current_label)
+{
+    current_label = labelId(label);
+}
+
+vc::memstats::LabelScope::~LabelScope()
+{
+    current_label = previous;
+}
+
+uint32_t vc::memstats::currentLabel()
+{
+    return current_label;
+}
+
+void vc::memstats::recordAllocation(MemoryTarget target, std::size_t bytes, uint32_t label)
+{
+    State& st = state();
+    st.totals[(std::size_t)target].allocate(bytes);
+    st.per_label[(std::size_t)target][label < MaxLabels ? label : 0].allocate(bytes);
+}
+
+void vc::memstats::recordDeallocation(MemoryTarget target, std::size_t bytes, uint32_t label)
+{
+    State& st = state();
+    st.totals[(std::size_t)target].deallocate(bytes);
+    st.per_label[(std::size_t)target][label < MaxLabels ? label : 0].deallocate(bytes);
+}
+
+void vc::memstats::trackAllocation(MemoryTarget target, const void* key, std::size_t bytes)
+{
+    const uint32_t label = current_label;
+    
+    {
+        State& st = state();
+        std::lock_guard<std::mutex> lock(st.mutex);
+        st.tracked[(std::size_t)target][key] = Tracked{ bytes, label };
+    }
+    
+    recordAllocation(target, bytes, label);
+}
+
+void vc::memstats::untrackAllocation(MemoryTarget target, const void* key)
+{
+    Tracked t;
+    
+    {
+        State& st = state();
+        std::lock_guard<std::mutex> lock(st.mutex);
+        auto& map = st.tracked[(std::size_t)target];
+        auto it = map.find(key);
+        if(it == map.end()) { return; }
+        t = it->second;
+        map.erase(it);
+    }
+    
+    recordDeallocation(target, t.bytes, t.label);
+}
+
+void vc::memstats::recordTransfer(MemoryTarget from, MemoryTarget to, std::size_t bytes)
+{
+    State& st = state();
+    st.transfers[(std::size_t)from][(std::size_t)to].fetch_add(bytes, std::memory_order_relaxed);
+    st.totals[(std::size_t)to].copied(bytes);
+    st.per_label[(std::size_t)to][current_label].copied(bytes);
+}
+
+vc::memstats::Counters vc::memstats::counters(MemoryTarget target)
+{
+    return state().totals[(std::size_t)target].snapshot();
+}
+
+vc::memstats::Counters vc::memstats::counters(MemoryTarget target, const std::string& label)
+{
+    State& st = state();
+    uint32_t id = 0;
+    
+    if(!label.empty())
+    {
+        std::lock_guard<std::mutex> lock(st.mutex);
+        auto it = st.label_ids.find(label);
+        if(it == st.label_ids.end()) { return Counters(); }
+        id = it->second;
+    }
+    
+    return st.per_label[(std::size_t)target][id].snapshot();
+}
+
+uint64_t vc::memstats::transferredBytes(MemoryTarget from, MemoryTarget to)
+{
+    return state().transfers[(std::size_t)from][(std::size_t)to].load();
+}
+
+std::vector<std::string> vc::memstats::labels()
+{
+    State& st = state();
+    std::lock_guard<std::mutex> lock(st.mutex);
+    return st.label_names;
+}
+
+void vc::memstats::resetCounters()
+{
+    State& st = state();
+    
+    for(std::size_t t = 0 ; t < Targets ; ++t)
+    {
+        st.totals[t].reset();
+        for(auto& c : st.per_label[t]) { c.reset(); }
+        for(auto& v : st.transfers[t]) { v = 0; }
+    }
+}
+
+void vc::memstats::writeReport(std::ostream& os)
+{
+    const std::vector<std::string> names = labels();
+    
+    auto row = [&](const std::string& name, const Counters& c)
+    {
+        os << "  " << std::left << std::setw(24) << name << std::right
+           << " live " << std::setw(11) << formatBytes(c.live_bytes)
+           << "  peak " << std::setw(11) << formatBytes(c.peak_bytes)
+           << "  allocs " << std::setw(8) << c.allocations
+           << "  frees " << std::setw(8) << c.deallocations
+           << "  copied in " << std::setw(11) << formatBytes(c.bytes_copied_in) 
+           << " (" << c.copies_in << ")\n";
+    };
+    
+    for(std::size_t t = 0 ; t < Targets ; ++t)
+    {
+        const MemoryTarget target = (MemoryTarget)t;
+        const Counters total = counters(target);
+        if(total.peak_bytes == 0 && total.allocations == 0 && total.copies_in == 0) { continue; }
+        
+        os << memoryTargetName(target) << ":\n";
+        row("total", total);
+        
+        for(std::size_t l = 0 ; l < names.size() ; ++l)
+        {
+            const Counters c = state().per_label[t][l].snapshot();
+            if(c.peak_bytes == 0 && c.allocations == 0 && c.copies_in == 0) { continue; }
+            row(l == 0 ? std::string("(unlabelled)") : names[l], c);
+        }
+    }
+    
+    for(std::size_t f = 0 ; f < Targets ; ++f)
+    {
+        for(std::size_t t = 0 ; t < Targets ; ++t)
+        {
+            const uint64_t bytes = transferredBytes((MemoryTarget)f, (MemoryTarget)t);
+            if(bytes == 0) { continue; }
+            os << memoryTargetName((MemoryTarget)f) << " -> " << memoryTargetName((MemoryTarget)t) 
+               << ": " << formatBytes(bytes) << "\n";
+        }
+    }
+}
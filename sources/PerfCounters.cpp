@@ -0,0 +1,419 @@
+/**
+ * ****************************************************************************
+ * Copyright (c) 2017, Robert Lukierski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * ****************************************************************************
+ * Hardware performance counters (Linux perf_event_open).
+ * ****************************************************************************
+ */
+
+#include <VisionCore/PerfCounters.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#ifdef VISIONCORE_HAVE_PERF_COUNTERS
+#include <dirent.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif // VISIONCORE_HAVE_PERF_COUNTERS
+
+namespace
+{
+    static const char* CounterNames[vc::perf::CounterCount] = 
+    { 
+        "cycles", "instructions", "llc_misses", "branch_misses", "task_clock_ns" 
+    };
+    
+#ifdef VISIONCORE_HAVE_PERF_COUNTERS
+    typedef std::array<int, vc::perf::CounterCount> ThreadFDs;
+    
+    struct EventConfig
+    {
+        uint32_t type;
+        uint64_t config;
+    };
+    
+    // preferred event first, fallback second (type 0 / config 0 if none)
+    static const EventConfig Events[vc::perf::CounterCount][2] = 
+    {
+        { { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES }, { PERF_TYPE_HARDWARE, PERF_COUNT_HW_REF_CPU_CYCLES } },
+        { { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS }, { 0, 0 } },
+        { { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) }, 
+          { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES } },
+        { { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES }, { 0, 0 } },
+        { { PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK }, { 0, 0 } }
+    };
+    
+    int openEvent(const EventConfig& cfg, pid_t tid)
+    {
+        if(cfg.type == 0 && cfg.config == 0) { return -1; }
+        
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = cfg.type;
+        attr.config = cfg.config;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        
+        return (int)syscall(__NR_perf_event_open, &attr, tid, -1, -1, PERF_FLAG_FD_CLOEXEC);
+    }
+    
+    uint64_t readEvent(int fd)
+    {
+        struct
+        {
+            uint64_t value;
+            uint64_t time_enabled;
+            uint64_t time_running;
+        } data;
+        
+        if(fd < 0 || ::read(fd, &data, sizeof(data)) != (ssize_t)sizeof(data) || data.time_running == 0)
+        {
+            return 0;
+        }
+        
+        if(data.time_running == data.time_enabled)
+        {
+            return data.value;
+        }
+        
+        // multiplexed, extrapolate
+        return (uint64_t)((double)data.value * (double)data.time_enabled / (double)data.time_running);
+    }
+    
+    std::vector<pid_t> processThreads()
+    {
+        std::vector<pid_t> ret;
+        
+        DIR* dir = opendir("/proc/self/task");
+        if(dir == nullptr) { return ret; }
+        
+        while(struct dirent* ent = readdir(dir))
+        {
+            if(ent->d_name[0] != '.')
+            {
+                ret.push_back((pid_t)std::stol(ent->d_name));
+            }
+        }
+        
+        closedir(dir);
+        return ret;
+    }
+    
+    // start time (field 22 of /proc/self/task/<tid>/stat), tells a recycled tid apart, 0 if gone
+    uint64_t threadStartTime(pid_t tid)
+    {
+        char path[64];
+        std::snprintf(path, sizeof(path), "/proc/self/task/%d/stat", (int)tid);
+        
+        std::FILE* f = std::fopen(path, "r");
+        if(f == nullptr) { return 0; }
+        
+        char buf[1024];
+        const std::size_t len = std::fread(buf, 1, sizeof(buf) - 1, f);
+        std::fclose(f);
+        buf[len] = '\0';
+        
+        // comm may contain spaces and parentheses, fields restart after the last ')'
+        const char* p = std::strrchr(buf, ')');
+        if(p == nullptr) { return 0; }
+        
+        // state is field 3, starttime field 22
+        for(int field = 2 ; field < 22 && p != nullptr ; ++field)
+        {
+            p = std::strchr(p + 1, ' ');
+        }
+        
+        return p != nullptr ? std::strtoull(p + 1, nullptr, 10) : 0;
+    }
+#endif // VISIONCORE_HAVE_PERF_COUNTERS
+}
+
+const char* vc::perf::counterName(Counter c)
+{
+    return (std::size_t)c < CounterCount ? CounterNames[(std::size_t)c] : "unknown";
+}
+
+bool vc::perf::isSupported()
+{
+#ifdef VISIONCORE_HAVE_PERF_COUNTERS
+    return true;
+#else // VISIONCORE_HAVE_PERF_COUNTERS
+    return false;
+#endif // VISIONCORE_HAVE_PERF_COUNTERS
+}
+
+vc::perf::Sample::Sample()
+{
+    std::fill(values, values + CounterCount, 0);
+    std::fill(valid, valid + CounterCount, false);
+}
+
+bool vc::perf::Sample::any() const
+{
+    return std::find(valid, valid + CounterCount, true) != valid + CounterCount;
+}
+
+double vc::perf::Sample::ipc() const
+{
+    if(!has(Counter::Cycles) || !has(Counter::Instructions) || get(Counter::Cycles) == 0)
+    {
+        return 0.0;
+    }
+    
+    return (double)get(Counter::Instructions) / (double)get(Counter::Cycles);
+}
+
+vc::perf::Sample vc::perf::Sample::operator-(const Sample& other) const
+{
+    Sample ret;
+    
+    for(std::size_t i = 0 ; i < CounterCount ; ++i)
+    {
+        ret.valid[i] = valid[i] && other.valid[i];
+        ret.values[i] = (ret.valid[i] && values[i] > other.values[i]) ? values[i] - other.values[i] : 0;
+    }
+    
+    return ret;
+}
+
+vc::perf::Sample& vc::perf::Sample::operator+=(const Sample& other)
+{
+    for(std::size_t i = 0 ; i < CounterCount ; ++i)
+    {
+        values[i] += other.values[i];
+        valid[i] = valid[i] || other.valid[i];
+    }
+    
+    return *this;
+}
+
+struct vc::perf::Counters::Impl
+{
+#ifdef VISIONCORE_HAVE_PERF_COUNTERS
+    struct Tracked
+    {
+        pid_t       tid;
+        uint64_t    start;
+        ThreadFDs   fds;
+    };
+    
+    ~Impl()
+    {
+        for(const Tracked& t : threads)
+        {
+            closeFDs(t.fds);
+        }
+    }
+    
+    static void closeFDs(const ThreadFDs& fds)
+    {
+        for(int fd : fds)
+        {
+            if(fd >= 0) { close(fd); }
+        }
+    }
+    
+    void addThread(pid_t tid, uint64_t start)
+    {
+        Tracked t;
+        t.tid = tid;
+        t.start = start;
+        
+        for(std::size_t i = 0 ; i < CounterCount ; ++i)
+        {
+            t.fds[i] = openEvent(Events[i][0], tid);
+            if(t.fds[i] < 0)
+            {
+                t.fds[i] = openEvent(Events[i][1], tid);
+            }
+        }
+        
+        // the first thread decides what is available
+        if(!seeded)
+        {
+            for(std::size_t i = 0 ; i < CounterCount ; ++i)
+            {
+                available[i] = t.fds[i] >= 0;
+            }
+            
+            seeded = true;
+        }
+        
+        threads.push_back(t);
+    }
+    
+    // keep the final counts of a thread that is gone, then release its descriptors
+    void retire(const Tracked& t)
+    {
+        for(std::size_t i = 0 ; i < CounterCount ; ++i)
+        {
+            if(available[i])
+            {
+                retired[i] += readEvent(t.fds[i]);
+            }
+        }
+        
+        closeFDs(t.fds);
+    }
+    
+    std::vector<Tracked>                    threads;
+    std::array<uint64_t, CounterCount>      retired{};
+    bool                                    seeded = false;
+#endif // VISIONCORE_HAVE_PERF_COUNTERS
+    std::array<bool, CounterCount>  available{};
+    mutable std::mutex              mutex;
+};
+
+vc::perf::Counters::Counters(Mode mode) : cmode(mode), impl(new Impl())
+{
+#ifdef VISIONCORE_HAVE_PERF_COUNTERS
+    const pid_t self = (pid_t)syscall(SYS_gettid);
+    
+    // calling thread first
+    impl->addThread(self, threadStartTime(self));
+    
+    if(cmode == Mode::Process)
+    {
+        rescan();
+    }
+#endif // VISIONCORE_HAVE_PERF_COUNTERS
+}
+
+vc::perf::Counters::~Counters()
+{
+    
+}
+
+bool vc::perf::Counters::available(Counter c) const
+{
+    return (std::size_t)c < CounterCount && impl->available[(std::size_t)c];
+}
+
+std::size_t vc::perf::Counters::threads() const
+{
+#ifdef VISIONCORE_HAVE_PERF_COUNTERS
+    std::lock_guard<std::mutex> lock(impl->mutex);
+    return impl->threads.size();
+#else // VISIONCORE_HAVE_PERF_COUNTERS
+    return 0;
+#endif // VISIONCORE_HAVE_PERF_COUNTERS
+}
+
+void vc::perf::Counters::rescan()
+{
+#ifdef VISIONCORE_HAVE_PERF_COUNTERS
+    if(cmode != Mode::Process) { return; }
+    
+    const std::vector<pid_t> current = processThreads();
+    std::vector<uint64_t> starts(current.size());
+    for(std::size_t i = 0 ; i < current.size() ; ++i)
+    {
+        starts[i] = threadStartTime(current[i]);
+    }
+    
+    std::lock_guard<std::mutex> lock(impl->mutex);
+    
+    // drop threads that exited, or whose tid now belongs to a different thread
+    std::vector<Impl::Tracked>& threads = impl->threads;
+    auto gone = std::stable_partition(threads.begin(), threads.end(), [&](const Impl::Tracked& t)
+    {
+        const auto it = std::find(current.begin(), current.end(), t.tid);
+        return it != current.end() && starts[it - current.begin()] == t.start;
+    });
+    
+    for(auto it = gone ; it != threads.end() ; ++it)
+    {
+        impl->retire(*it);
+    }
+    
+    threads.erase(gone, threads.end());
+    
+    for(std::size_t i = 0 ; i < current.size() ; ++i)
+    {
+        const pid_t tid = current[i];
+        if(std::find_if(threads.begin(), threads.end(), [&](const Impl::Tracked& t) { return t.tid == tid; }) == threads.end())
+        {
+            impl->addThread(tid, starts[i]);
+        }
+    }
+#endif // VISIONCORE_HAVE_PERF_COUNTERS
+}
+
+vc::perf::Sample vc::perf::Counters::read() const
+{
+    Sample ret;
+    
+    for(std::size_t i = 0 ; i < CounterCount ; ++i)
+    {
+        ret.valid[i] = impl->available[i];
+    }
+    
+#ifdef VISIONCORE_HAVE_PERF_COUNTERS
+    std::lock_guard<std::mutex> lock(impl->mutex);
+    for(std::size_t i = 0 ; i < CounterCount ; ++i)
+    {
+        if(ret.valid[i])
+        {
+            ret.values[i] = impl->retired[i];
+        }
+    }
+    
+    for(const Impl::Tracked& t : impl->threads)
+    {
+        for(std::size_t i = 0 ; i < CounterCount ; ++i)
+        {
+            if(ret.valid[i])
+            {
+                ret.values[i] += readEvent(t.fds[i]);
+            }
+        }
+    }
+#endif // VISIONCORE_HAVE_PERF_COUNTERS
+    
+    return ret;
+}
+
+vc::perf::Counters& vc::perf::processCounters()
+{
+    static Counters counters(Counters::Mode::Process);
+    return counters;
+}
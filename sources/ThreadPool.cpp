@@ -0,0 +1,288 @@
+/**
+ * ****************************************************************************
+ * Copyright (c) 2017, Robert Lukierski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * ****************************************************************************
+ * Portable work-stealing thread pool.
+ * ****************************************************************************
+ */
+
+#include <VisionCore/ThreadPool.hpp>
+
+#include <cstdlib>
+#include <string>
+
+namespace
+{
+    thread_local const vc::ThreadPool* tl_pool = nullptr;
+    thread_local std::size_t tl_worker_index = 0;
+    
+    std::size_t defaultWorkers()
+    {
+        const char* env = std::getenv("VISIONCORE_NUM_THREADS");
+        if(env != nullptr)
+        {
+            const long total = std::strtol(env, nullptr, 10);
+            if(total > 0)
+            {
+                return (std::size_t)total - 1;
+            }
+        }
+        
+        const std::size_t hw = std::thread::hardware_concurrency();
+        return hw > 1 ? hw - 1 : 0;
+    }
+    
+    /**
+     * One parallelFor: threads grab chunk indices until they run out.
+     */
+    struct ChunkJob
+    {
+        ChunkJob(std::size_t c, const std::function<void(std::size_t)>& f) : next(0), done(0), chunks(c), fn(&f) { }
+        
+        void work()
+        {
+            for(;;)
+            {
+                const std::size_t c = next.fetch_add(1);
+                if(c >= chunks) { break; }
+                
+                try
+                {
+                    (*fn)(c);
+                }
+                catch(...)
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if(!error) { error = std::current_exception(); }
+                }
+                
+                if(done.fetch_add(1) + 1 == chunks)
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    cv.notify_all();
+                }
+            }
+        }
+        
+        void wait()
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [&](){ return done.load() == chunks; });
+        }
+        
+        std::atomic<std::size_t>                 next;
+        std::atomic<std::size_t>                 done;
+        const std::size_t                        chunks;
+        const std::function<void(std::size_t)>*  fn;
+        std::mutex                               mutex;
+        std::condition_variable                  cv;
+        std::exception_ptr                       error;
+    };
+    
+    std::mutex global_mutex;
+    std::atomic<vc::ThreadPool*> global_pool(nullptr);
+}
+
+vc::ThreadPool::ThreadPool(std::size_t nworkers, ThreadInitT thread_init) : pending(0), next_queue(0), finish(false)
+{
+    if(nworkers == 0)
+    {
+        nworkers = defaultWorkers();
+    }
+    
+    queues.reserve(nworkers);
+    for(std::size_t i = 0 ; i < nworkers ; ++i)
+    {
+        queues.emplace_back(new Queue());
+    }
+    
+    threads.reserve(nworkers);
+    for(std::size_t i = 0 ; i < nworkers ; ++i)
+    {
+        threads.emplace_back([this,i,thread_init]()
+        { 
+            if(thread_init) { thread_init(i); }
+            workerLoop(i); 
+        });
+    }
+}
+
+vc::ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+        finish = true;
+    }
+    sleep_cv.notify_all();
+    
+    for(auto& t : threads)
+    {
+        t.join();
+    }
+}
+
+void vc::ThreadPool::submit(TaskT task)
+{
+    if(threads.empty())
+    {
+        task();
+        return;
+    }
+    
+    // workers push to their own deque, everybody else round-robins
+    const std::size_t qidx = isWorkerThread() ? tl_worker_index : (next_queue.fetch_add(1) % queues.size());
+    
+    {
+        std::lock_guard<std::mutex> lock(queues[qidx]->mutex);
+        queues[qidx]->tasks.push_back(std::move(task));
+    }
+    
+    pending.fetch_add(1);
+    
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+    }
+    sleep_cv.notify_one();
+}
+
+bool vc::ThreadPool::isWorkerThread() const
+{
+    return tl_pool == this;
+}
+
+bool vc::ThreadPool::popTask(std::size_t self, TaskT& task)
+{
+    // own queue - LIFO
+    {
+        Queue& q = *queues[self];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if(!q.tasks.empty())
+        {
+            task = std::move(q.tasks.back());
+            q.tasks.pop_back();
+            return true;
+        }
+    }
+    
+    // steal - FIFO
+    for(std::size_t i = 1 ; i < queues.size() ; ++i)
+    {
+        Queue& q = *queues[(self + i) % queues.size()];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if(!q.tasks.empty())
+        {
+            task = std::move(q.tasks.front());
+            q.tasks.pop_front();
+            return true;
+        }
+    }
+    
+    return false;
+}
+
+void vc::ThreadPool::workerLoop(std::size_t idx)
+{
+    tl_pool = this;
+    tl_worker_index = idx;
+    
+    for(;;)
+    {
+        TaskT task;
+        
+        if(popTask(idx, task))
+        {
+            pending.fetch_sub(1);
+            
+            try
+            {
+                task();
+            }
+            catch(...)
+            {
+                // fire and forget - nobody to report to
+            }
+            
+            continue;
+        }
+        
+        std::unique_lock<std::mutex> lock(sleep_mutex);
+        sleep_cv.wait(lock, [&](){ return finish.load() || pending.load() > 0; });
+        
+        if(finish.load() && pending.load() == 0)
+        {
+            return;
+        }
+    }
+}
+
+void vc::ThreadPool::runChunks(std::size_t chunks, const std::function<void(std::size_t)>& fn)
+{
+    std::shared_ptr<ChunkJob> job = std::make_shared<ChunkJob>(chunks, fn);
+    
+    // helpers that find nothing left to do just return, the caller can finish everything alone
+    const std::size_t helpers = std::min(chunks - 1, workers());
+    for(std::size_t i = 0 ; i < helpers ; ++i)
+    {
+        submit([job](){ job->work(); });
+    }
+    
+    job->work();
+    job->wait();
+    
+    if(job->error)
+    {
+        std::rethrow_exception(job->error);
+    }
+}
+
+vc::ThreadPool& vc::ThreadPool::global()
+{
+    vc::ThreadPool* pool = global_pool.load(std::memory_order_acquire);
+    
+    if(pool == nullptr)
+    {
+        std::lock_guard<std::mutex> lock(global_mutex);
+        pool = global_pool.load(std::memory_order_relaxed);
+        if(pool == nullptr)
+        {
+            pool = new vc::ThreadPool();
+            global_pool.store(pool, std::memory_order_release);
+        }
+    }
+    
+    return *pool;
+}
+
+void vc::ThreadPool::setGlobalWorkers(std::size_t nworkers)
+{
+    std::lock_guard<std::mutex> lock(global_mutex);
+    vc::ThreadPool* old_pool = global_pool.exchange(new vc::ThreadPool(nworkers == 0 ? defaultWorkers() : nworkers));
+    delete old_pool;
+}
@@ -0,0 +1,284 @@
+/**
+ * ****************************************************************************
+ * Copyright (c) 2017, Robert Lukierski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * ****************************************************************************
+ * Hot-path tracing, exported as Chrome trace JSON (chrome://tracing, Perfetto).
+ * ****************************************************************************
+ */
+
+#include <VisionCore/Trace.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+
+namespace
+{
+    /**
+     * Events of one thread, kept alive by the registry after the thread exits.
+     */
+    struct ThreadBuffer
+    {
+        std::mutex                      mutex;
+        std::vector<vc::trace::Event>   events;
+    };
+    
+    struct Registry
+    {
+        Registry() : epoch(std::chrono::steady_clock::now()), enabled(true), counters(false), next_thread_id(0) { }
+        
+        std::chrono::steady_clock::time_point       epoch;
+        std::atomic<bool>                           enabled;
+        std::atomic<bool>                           counters;
+        std::atomic<uint32_t>                       next_thread_id;
+        std::mutex                                  mutex;
+        std::vector<std::shared_ptr<ThreadBuffer>>  buffers;
+    };
+    
+    Registry& registry()
+    {
+        static Registry reg;
+        return reg;
+    }
+    
+    struct ThreadState
+    {
+        ThreadState() : buffer(std::make_shared<ThreadBuffer>()), scope(nullptr)
+        {
+            Registry& reg = registry();
+            thread_id = reg.next_thread_id.fetch_add(1);
+            
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            reg.buffers.push_back(buffer);
+        }
+        
+        std::shared_ptr<ThreadBuffer>   buffer;
+        uint32_t                        thread_id;
+        const char*                     scope;
+    };
+    
+    ThreadState& threadState()
+    {
+        thread_local ThreadState ts;
+        return ts;
+    }
+    
+    void writeEscaped(std::ostream& os, const char* str)
+    {
+        for(const char* c = str ; *c != '\0' ; ++c)
+        {
+            if(*c == '"' || *c == '\\') { os << '\\'; }
+            os << *c;
+        }
+    }
+}
+
+void vc::trace::setEnabled(bool enabled)
+{
+    registry().enabled = enabled;
+}
+
+bool vc::trace::isEnabled()
+{
+    return registry().enabled.load(std::memory_order_relaxed);
+}
+
+bool vc::trace::setHardwareCounters(bool enabled)
+{
+    if(!enabled)
+    {
+        registry().counters = false;
+        return false;
+    }
+    
+    // pick up pool workers started so far
+    perf::Counters& pc = perf::processCounters();
+    pc.rescan();
+    
+    const bool any = pc.read().any();
+    registry().counters = any;
+    return any;
+}
+
+bool vc::trace::hardwareCounters()
+{
+    return registry().counters.load(std::memory_order_relaxed);
+}
+
+uint64_t vc::trace::now()
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - registry().epoch).count();
+}
+
+void vc::trace::record(const Event& ev)
+{
+    ThreadState& ts = threadState();
+    
+    std::lock_guard<std::mutex> lock(ts.buffer->mutex);
+    ts.buffer->events.push_back(ev);
+    ts.buffer->events.back().thread_id = ts.thread_id;
+}
+
+void vc::trace::clear()
+{
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    
+    for(auto& buf : reg.buffers)
+    {
+        std::lock_guard<std::mutex> buf_lock(buf->mutex);
+        buf->events.clear();
+    }
+}
+
+std::vector<vc::trace::Event> vc::trace::events()
+{
+    std::vector<Event> ret;
+    
+    {
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        
+        for(auto& buf : reg.buffers)
+        {
+            std::lock_guard<std::mutex> buf_lock(buf->mutex);
+            ret.insert(ret.end(), buf->events.begin(), buf->events.end());
+        }
+    }
+    
+    std::stable_sort(ret.begin(), ret.end(), [](const Event& e1, const Event& e2)
+    {
+        return e1.start_ns < e2.start_ns;
+    });
+    
+    return ret;
+}
+
+const char* vc::trace::currentScope()
+{
+    const char* scope = threadState().scope;
+    return scope != nullptr ? scope : "launch";
+}
+
+void vc::trace::writeChromeTrace(std::ostream& os)
+{
+    const std::vector<Event> evs = events();
+    
+    os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    
+    for(std::size_t i = 0 ; i < evs.size() ; ++i)
+    {
+        const Event& ev = evs[i];
+        
+        if(i > 0) { os << ","; }
+        
+        // Chrome trace timestamps are in microseconds
+        os << "\n{\"name\":\""; 
+        writeEscaped(os, ev.name);
+        os << "\",\"cat\":\"";
+        writeEscaped(os, ev.category);
+        os << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << ev.thread_id 
+           << ",\"ts\":" << (ev.start_ns / 1000) << "." << (ev.start_ns % 1000) / 100
+           << ",\"dur\":" << (ev.duration_ns / 1000) << "." << (ev.duration_ns % 1000) / 100
+           << ",\"args\":{\"width\":" << ev.width << ",\"height\":" << ev.height << ",\"bytes\":" << ev.bytes;
+        
+        for(std::size_t c = 0 ; c < perf::CounterCount ; ++c)
+        {
+            if(ev.counters.valid[c])
+            {
+                os << ",\"" << perf::counterName((perf::Counter)c) << "\":" << ev.counters.values[c];
+            }
+        }
+        
+        if(ev.counters.ipc() > 0.0)
+        {
+            os << ",\"ipc\":" << ev.counters.ipc();
+        }
+        
+        os << "}}";
+    }
+    
+    os << "\n]}\n";
+}
+
+bool vc::trace::saveChromeTrace(const std::string& filename)
+{
+    std::ofstream ofs(filename);
+    if(!ofs.is_open()) { return false; }
+    
+    writeChromeTrace(ofs);
+    return ofs.good();
+}
+
+vc::trace::Scope::Scope(const char* name, const char* category, std::size_t width, std::size_t height, std::size_t bytes)
+    : parent(nullptr), active(isEnabled()), counted(false)
+{
+    if(!active) { return; }
+    
+    ThreadState& ts = threadState();
+    parent = ts.scope;
+    ts.scope = name;
+    
+    ev.name = name;
+    ev.category = category;
+    ev.thread_id = 0;
+    ev.width = (uint32_t)width;
+    ev.height = (uint32_t)height;
+    ev.bytes = bytes;
+    ev.duration_ns = 0;
+    
+    // counters of the outermost operation only, nested ones would count twice in the totals
+    counted = hardwareCounters() && parent == nullptr && std::strcmp(category, "op") == 0;
+    if(counted)
+    {
+        ev.counters = perf::processCounters().read();
+    }
+    
+    ev.start_ns = now();
+}
+
+vc::trace::Scope::~Scope()
+{
+    if(!active) { return; }
+    
+    ev.duration_ns = now() - ev.start_ns;
+    
+    if(counted)
+    {
+        ev.counters = perf::processCounters().read() - ev.counters;
+    }
+    
+    threadState().scope = parent;
+    record(ev);
+}
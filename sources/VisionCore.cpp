@@ -36,8 +36,18 @@
 #include <VisionCore/Platform.hpp>
 #include <VisionCore/CUDAException.hpp>
 #include <VisionCore/MemoryPolicy.hpp>
+#include <VisionCore/ExecutionContext.hpp>
+#include <VisionCore/LaunchAsync.hpp>
 #include <VisionCore/LaunchUtils.hpp>
+#include <VisionCore/ThreadPool.hpp>
+#include <VisionCore/HostCopy.hpp>
+#include <VisionCore/HostMemory.hpp>
+#include <VisionCore/MemoryStats.hpp>
+#include <VisionCore/CPUFeatures.hpp>
+#include <VisionCore/PerfCounters.hpp>
+#include <VisionCore/Trace.hpp>
 
+#include <VisionCore/Buffers/BorderMode.hpp>
 #include <VisionCore/Buffers/Buffer1D.hpp>
 #include <VisionCore/Buffers/Buffer2D.hpp>
 #include <VisionCore/Buffers/Buffer3D.hpp>
@@ -47,10 +57,12 @@
 #include <VisionCore/Buffers/Image2D.hpp>
 #include <VisionCore/Buffers/ImagePyramid.hpp>
 #include <VisionCore/Buffers/PyramidBase.hpp>
+#include <VisionCore/Buffers/SharedBuffer.hpp>
 #include <VisionCore/Buffers/Volume.hpp>
 #include <VisionCore/Control/PID.hpp>
 #include <VisionCore/Control/VelocityProfile.hpp>
 #include <VisionCore/Image/BufferOps.hpp>
+#include <VisionCore/Image/BufferExpr.hpp>
 #include <VisionCore/Image/ColorMap.hpp>
 #include <VisionCore/Image/ConnectedComponents.hpp>
 #include <VisionCore/Image/Filters.hpp>
@@ -58,11 +70,13 @@
 #include <VisionCore/Image/PixelConvert.hpp>
 #include <VisionCore/IO/File.hpp>
 #include <VisionCore/IO/ImageIO.hpp>
+#include <VisionCore/IO/MappedFile.hpp>
 #include <VisionCore/IO/PLYModel.hpp>
 #include <VisionCore/Math/Angles.hpp>
 #include <VisionCore/Math/Convolution.hpp>
 #include <VisionCore/Math/DenavitHartenberg.hpp>
 #include <VisionCore/Math/Divergence.hpp>
+#include <VisionCore/Math/FFTConvolution.hpp>
 #include <VisionCore/Math/Fitting.hpp>
 #include <VisionCore/Math/Fourier.hpp>
 #include <VisionCore/Math/HammingDistance.hpp>
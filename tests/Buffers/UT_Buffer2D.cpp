@@ -43,6 +43,7 @@
 #include <sstream>
 #include <iomanip>
 #include <vector>
+#include <thread>
 #include <cmath>
 #include <valarray>
 
@@ -53,6 +54,7 @@
 #include <glog/logging.h>
 
 #include <VisionCore/Buffers/Buffer2D.hpp>
+#include <VisionCore/Buffers/SharedBuffer.hpp>
 #include <BufferTestHelpers.hpp>
 
 static constexpr std::size_t BufferSizeX = 1025;
@@ -85,7 +87,9 @@ TYPED_TEST(Test_Buffer2D, CPU)
     ASSERT_TRUE(bufcpu.isValid()) << "Wrong managed state";
     ASSERT_EQ(bufcpu.width(), BufferSizeX) << "Wrong managed width size";
     ASSERT_EQ(bufcpu.height(), BufferSizeY) << "Wrong managed height size";
-    ASSERT_EQ(bufcpu.bytes(), BufferSizeX * BufferSizeY * sizeof(BufferElementT)) << "Wrong managed size bytes";
+    ASSERT_GE(bufcpu.pitch(), BufferSizeX * sizeof(BufferElementT)) << "Wrong managed pitch";
+    ASSERT_EQ(bufcpu.pitch() % sizeof(BufferElementT), 0u) << "Pitch not a multiple of the element size";
+    ASSERT_EQ(bufcpu.bytes(), bufcpu.pitch() * BufferSizeY) << "Wrong managed size bytes";
     
     for(std::size_t y = 0 ; y < bufcpu.height() ; ++y)
     {
@@ -113,3 +117,134 @@ TYPED_TEST(Test_Buffer2D, CPU)
         }
     }
 }
+
+TEST(Test_Buffer2DAligned, CPU)
+{
+    const std::size_t previous = vc::TargetHost::alignment();
+    ASSERT_THROW(vc::TargetHost::setAlignment(48), std::invalid_argument);
+    
+    for(std::size_t alignment : { vc::TargetHost::CacheLineAlignment, vc::TargetHost::PageAlignment })
+    {
+        vc::TargetHost::setAlignment(alignment);
+        
+        vc::Buffer2DManaged<float, vc::TargetHost> buf1(BufferSizeX, BufferSizeY);
+        vc::Buffer2DManaged<Eigen::Vector3f, vc::TargetHost> buf3(BufferSizeX, BufferSizeY);
+        
+        ASSERT_EQ((std::uintptr_t)buf1.ptr() % alignment, 0u) << "Base not aligned";
+        ASSERT_EQ(buf1.pitch() % vc::TargetHost::CacheLineAlignment, 0u) << "Rows not aligned";
+        ASSERT_EQ(buf1.pitch(), 1040 * sizeof(float)) << "Pitch padded too much";
+        
+        // 12 byte elements, rows aligned with an exact element pitch
+        ASSERT_EQ((std::uintptr_t)buf3.ptr() % alignment, 0u) << "Base not aligned";
+        ASSERT_EQ(buf3.pitch() % vc::TargetHost::CacheLineAlignment, 0u) << "Rows not aligned";
+        ASSERT_EQ(buf3.pitch() % sizeof(Eigen::Vector3f), 0u) << "Inexact element pitch";
+    }
+    
+    vc::TargetHost::setAlignment(previous);
+    
+    // copies between packed and padded layouts
+    std::vector<float> packed(BufferSizeX * BufferSizeY);
+    for(std::size_t i = 0 ; i < packed.size() ; ++i) { packed[i] = float(i); }
+    
+    vc::Buffer2DView<float, vc::TargetHost> packed_view(packed.data(), BufferSizeX, BufferSizeY);
+    vc::Buffer2DManaged<float, vc::TargetHost> padded(BufferSizeX, BufferSizeY);
+    ASSERT_GT(padded.pitch(), packed_view.pitch());
+    padded.copyFrom(packed_view);
+    
+    std::vector<float> back(packed.size(), -1.0f);
+    vc::Buffer2DView<float, vc::TargetHost> back_view(back.data(), BufferSizeX, BufferSizeY);
+    back_view.copyFrom(padded);
+    
+    for(std::size_t y = 0 ; y < BufferSizeY ; ++y)
+    {
+        for(std::size_t x = 0 ; x < BufferSizeX ; ++x)
+        {
+            ASSERT_EQ(padded(x,y), float(y * BufferSizeX + x));
+        }
+    }
+    
+    ASSERT_TRUE(packed == back) << "Round trip failed";
+}
+
+TEST(Test_Buffer2DShared, CopyOnWrite)
+{
+    vc::Buffer2DManaged<float, vc::TargetHost> owner(BufferSizeX, BufferSizeY);
+    owner.fill(1.0f);
+    const float* original = owner.ptr();
+    
+    // adopted without a copy
+    vc::Buffer2DShared<float> frame(std::move(owner));
+    ASSERT_EQ(frame->ptr(), original);
+    ASSERT_TRUE(frame.unique());
+    
+    // consumers share it
+    vc::Buffer2DShared<float> recorder = frame;
+    vc::Buffer2DShared<float> visualizer = frame;
+    ASSERT_EQ(frame.useCount(), 3);
+    ASSERT_EQ(recorder->ptr(), original);
+    ASSERT_EQ(visualizer.view().ptr(), original);
+    
+    // the writer gets its own copy, the readers keep the old contents
+    frame.edit()(5,7) = 2.0f;
+    ASSERT_NE(frame->ptr(), original);
+    ASSERT_TRUE(frame.unique());
+    ASSERT_EQ(recorder.useCount(), 2);
+    ASSERT_EQ(frame->get(5,7), 2.0f);
+    ASSERT_EQ(frame->get(6,7), 1.0f);
+    ASSERT_EQ(recorder->get(5,7), 1.0f);
+    
+    // no further copies once unique
+    const float* copy = frame->ptr();
+    frame.edit()(0,0) = 3.0f;
+    ASSERT_EQ(frame->ptr(), copy);
+    
+    // overwrite doesn't copy the contents, only detaches
+    visualizer.overwrite().fill(4.0f);
+    ASSERT_TRUE(recorder.unique());
+    ASSERT_EQ(recorder->ptr(), original);
+    ASSERT_EQ(recorder->get(0,0), 1.0f);
+    ASSERT_EQ(visualizer->get(0,0), 4.0f);
+    
+    // views work wherever a const view is expected
+    const vc::Buffer2DView<float, vc::TargetHost>& view = recorder;
+    ASSERT_EQ(view.width(), BufferSizeX);
+    
+    vc::Buffer2DShared<float> empty;
+    ASSERT_FALSE(empty.isValid());
+    ASSERT_FALSE(empty->isValid());
+    ASSERT_THROW(empty.edit(), std::runtime_error);
+    
+    vc::Image2DShared<float> image(64, 48);
+    image.edit().fill(5.0f);
+    vc::Image2DShared<float> image_copy = image;
+    image_copy.edit()(0,0) = 6.0f;
+    ASSERT_EQ(image->get(0,0), 5.0f);
+    ASSERT_EQ(image_copy->get(1,0), 5.0f);
+}
+
+TEST(Test_Buffer2DShared, ReleasedOnAnotherThread)
+{
+    vc::Buffer2DShared<float> frame(BufferSizeX, BufferSizeY);
+    frame.overwrite().fill(1.0f);
+    const float* original = frame->ptr();
+    
+    double sum = 0.0;
+    std::thread reader([&sum](vc::Buffer2DShared<float> mine)
+    {
+        for(std::size_t y = 0 ; y < mine->height() ; ++y)
+        {
+            for(std::size_t x = 0 ; x < mine->width() ; ++x)
+            {
+                sum += mine->get(x,y);
+            }
+        }
+    }, frame);
+    
+    // no join first, unique() orders the reads before the writes in place
+    while(!frame.unique()) { std::this_thread::yield(); }
+    frame.edit().fill(2.0f);
+    ASSERT_EQ(frame->ptr(), original);
+    
+    reader.join();
+    ASSERT_EQ(sum, double(BufferSizeX * BufferSizeY));
+}
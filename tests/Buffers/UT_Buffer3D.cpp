@@ -81,7 +81,9 @@ TEST_F(Test_Buffer3D, CPU)
     ASSERT_EQ(bufcpu.width(), BufferSizeX) << "Wrong managed width size";
     ASSERT_EQ(bufcpu.height(), BufferSizeY) << "Wrong managed height size";
     ASSERT_EQ(bufcpu.depth(), BufferSizeZ) << "Wrong managed depth size";
-    ASSERT_EQ(bufcpu.bytes(), BufferSizeX * BufferSizeY * BufferSizeZ * sizeof(BufferElementT)) << "Wrong managed size bytes";
+    ASSERT_GE(bufcpu.pitch(), BufferSizeX * sizeof(BufferElementT)) << "Wrong managed pitch";
+    ASSERT_EQ(bufcpu.planePitch(), bufcpu.pitch() * BufferSizeY) << "Wrong managed plane pitch";
+    ASSERT_EQ(bufcpu.bytes(), bufcpu.planePitch() * BufferSizeZ) << "Wrong managed size bytes";
     
     for(std::size_t z = 0 ; z < bufcpu.depth() ; ++z)
     {
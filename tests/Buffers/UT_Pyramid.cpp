@@ -86,3 +86,73 @@ TEST_F(Test_Pyramid, ImageCPU)
     EXPECT_EQ(pyr[1].width(), (std::size_t)160);
     EXPECT_EQ(pyr[1].height(), (std::size_t)120);
 }
+
+TEST_F(Test_Pyramid, SingleSlab)
+{
+    vc::BufferPyramidManaged<float,4,vc::TargetHost> pyr(643,481);
+    const vc::PyramidSlab<vc::TargetHost>& slab = pyr.memory();
+    
+    ASSERT_EQ(slab.levels(), 4u);
+    
+    const uint8_t* base = static_cast<const uint8_t*>(slab.rawPtr());
+    for(std::size_t l = 0 ; l < 4 ; ++l)
+    {
+        const uint8_t* lp = static_cast<const uint8_t*>(pyr[l].rawPtr());
+        
+        // level inside the slab, aligned, not overlapping the next one
+        ASSERT_EQ(lp - base, (std::ptrdiff_t)slab.offset(l));
+        ASSERT_EQ(reinterpret_cast<uintptr_t>(lp) % vc::TargetHost::alignment(), 0u);
+        ASSERT_EQ(pyr[l].pitch(), vc::TargetHost::pitchFor<float>(643 >> l));
+        ASSERT_LE(slab.offset(l) + pyr[l].pitch() * pyr[l].height(), l + 1 < 4 ? slab.offset(l + 1) : slab.bytes());
+    }
+    
+    pyr.memset(0);
+    
+    vc::BufferPyramidManaged<float,4,vc::TargetHost> other(643,481);
+    for(std::size_t l = 0 ; l < 4 ; ++l)
+    {
+        for(std::size_t y = 0 ; y < other[l].height() ; ++y)
+        {
+            for(std::size_t x = 0 ; x < other[l].width() ; ++x)
+            {
+                other[l](x,y) = float(l * 1000000 + y * 1000 + x);
+            }
+        }
+    }
+    
+    pyr.copyFrom(other);
+    
+    for(std::size_t l = 0 ; l < 4 ; ++l)
+    {
+        for(std::size_t y = 0 ; y < pyr[l].height() ; ++y)
+        {
+            for(std::size_t x = 0 ; x < pyr[l].width() ; ++x)
+            {
+                ASSERT_EQ(pyr[l](x,y), float(l * 1000000 + y * 1000 + x));
+            }
+        }
+    }
+    
+    // moves take the slab along
+    vc::BufferPyramidManaged<float,4,vc::TargetHost> moved(std::move(pyr));
+    ASSERT_EQ(moved.memory().rawPtr(), (const void*)base);
+    ASSERT_EQ(pyr.memory().rawPtr(), nullptr);
+}
+
+TEST_F(Test_Pyramid, RuntimeSingleSlab)
+{
+    // 8 levels requested, only 5 fit
+    vc::RuntimeBufferPyramidManaged<uint8_t,vc::TargetHost> pyr(8, 31, 17);
+    ASSERT_EQ(pyr.memory().levels(), 5u);
+    ASSERT_EQ(pyr[4].width(), 1u);
+    ASSERT_EQ(pyr[5].rawPtr(), nullptr);
+    
+    vc::RuntimeBufferPyramidManaged<uint8_t,vc::TargetHost> other(8, 31, 17);
+    other.memset(7);
+    pyr.copyFrom(other);
+    
+    for(std::size_t l = 0 ; l < 5 ; ++l)
+    {
+        ASSERT_EQ(pyr[l](pyr[l].width() - 1, pyr[l].height() - 1), 7);
+    }
+}
@@ -0,0 +1,148 @@
+/**
+ * ****************************************************************************
+ * Copyright (c) 2017, Robert Lukierski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ****************************************************************************
+ * Memory mapped file tests.
+ * ****************************************************************************
+ */
+
+// system
+#include <stdint.h>
+#include <stddef.h>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <vector>
+
+// testing framework & libraries
+#include <gtest/gtest.h>
+
+#include <VisionCore/IO/MappedFile.hpp>
+
+static constexpr std::size_t SizeX = 37;
+static constexpr std::size_t SizeY = 23;
+static constexpr std::size_t SizeZ = 5;
+static constexpr std::size_t HeaderBytes = 16;
+
+class Test_MappedFile : public ::testing::Test
+{
+public:   
+    Test_MappedFile() : fn(::testing::TempDir() + "vc_mapped_file.bin")
+    {
+        // a small header, then packed floats
+        std::vector<float> data(SizeX * SizeY * SizeZ);
+        for(std::size_t i = 0 ; i < data.size() ; ++i) { data[i] = float(i); }
+        
+        std::ofstream ofs(fn, std::ios::binary);
+        const char header[HeaderBytes] = "VCDATA";
+        ofs.write(header, HeaderBytes);
+        ofs.write(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(float));
+    }
+    
+    virtual ~Test_MappedFile()
+    {
+        std::remove(fn.c_str());
+    }
+    
+    std::string fn;
+};
+
+TEST_F(Test_MappedFile, Views) 
+{
+    vc::io::MappedFile mf(fn, vc::io::MapMode::ReadOnly, vc::io::AccessHint::Sequential);
+    ASSERT_TRUE(mf.isOpened());
+    ASSERT_EQ(mf.size(), HeaderBytes + SizeX * SizeY * SizeZ * sizeof(float));
+    
+    const vc::Buffer2DView<float,vc::TargetHost> b2d = mf.buffer2D<float>(HeaderBytes, SizeX, SizeY);
+    ASSERT_EQ(b2d.pitch(), SizeX * sizeof(float));
+    for(std::size_t y = 0 ; y < SizeY ; ++y)
+    {
+        for(std::size_t x = 0 ; x < SizeX ; ++x)
+        {
+            ASSERT_EQ(b2d(x,y), float(y * SizeX + x));
+        }
+    }
+    
+    const vc::VolumeView<float,vc::TargetHost> vol = mf.volume<float>(HeaderBytes, SizeX, SizeY, SizeZ);
+    ASSERT_EQ(vol.planePitch(), SizeX * SizeY * sizeof(float));
+    ASSERT_EQ(vol(SizeX - 1, SizeY - 1, SizeZ - 1), float(SizeX * SizeY * SizeZ - 1));
+    
+    // every other row of the first plane
+    const vc::Buffer2DView<float,vc::TargetHost> strided = mf.buffer2D<float>(HeaderBytes, SizeX, SizeY / 2, SizeX * sizeof(float) * 2);
+    ASSERT_EQ(strided(3, 4), float(8 * SizeX + 3));
+    
+    const vc::Buffer1DView<char,vc::TargetHost> header = mf.buffer1D<char>(0, HeaderBytes);
+    ASSERT_EQ(std::string(header.ptr()), "VCDATA");
+    
+    mf.advise(vc::io::AccessHint::Random, 100, 1000);
+}
+
+TEST_F(Test_MappedFile, Bounds) 
+{
+    vc::io::MappedFile mf(fn);
+    
+    ASSERT_THROW(mf.buffer3D<float>(HeaderBytes, SizeX, SizeY, SizeZ + 1), std::out_of_range);
+    ASSERT_THROW(mf.buffer2D<float>(mf.size() + 4, 1, 1), std::out_of_range);
+    ASSERT_THROW(mf.buffer2D<float>(HeaderBytes + 1, 1, 1), std::invalid_argument);
+    ASSERT_THROW(mf.buffer2D<float>(HeaderBytes, SizeX, 2, SizeX), std::invalid_argument);
+    ASSERT_THROW(vc::io::MappedFile(fn + ".missing"), std::runtime_error);
+}
+
+TEST_F(Test_MappedFile, Overflow) 
+{
+    vc::io::MappedFile mf(fn);
+    
+    // huge * sizeof(float) wraps around to 0
+    const std::size_t huge = std::numeric_limits<std::size_t>::max() / sizeof(float) + 1;
+    ASSERT_THROW(mf.buffer1D<float>(HeaderBytes, huge), std::out_of_range);
+    ASSERT_THROW(mf.buffer2D<float>(HeaderBytes, huge, 1), std::out_of_range);
+    ASSERT_THROW(mf.buffer2D<float>(HeaderBytes, 1, huge), std::out_of_range);
+    ASSERT_THROW(mf.buffer3D<float>(HeaderBytes, 1, huge, 1), std::out_of_range);
+    ASSERT_THROW(mf.buffer3D<float>(HeaderBytes, 1, 1, huge), std::out_of_range);
+}
+
+TEST_F(Test_MappedFile, CopyOnWrite) 
+{
+    {
+        vc::io::MappedFile mf(fn, vc::io::MapMode::CopyOnWrite);
+        vc::Buffer2DView<float,vc::TargetHost> b2d = mf.buffer2D<float>(HeaderBytes, SizeX, SizeY);
+        b2d(0,0) = -1.0f;
+        ASSERT_EQ(b2d(0,0), -1.0f);
+        
+        vc::io::MappedFile moved(std::move(mf));
+        ASSERT_FALSE(mf.isOpened());
+        ASSERT_EQ(moved.buffer2D<float>(HeaderBytes, SizeX, SizeY)(0,0), -1.0f);
+    }
+    
+    // the file is untouched
+    vc::io::MappedFile mf(fn);
+    ASSERT_EQ(mf.buffer2D<float>(HeaderBytes, SizeX, SizeY)(0,0), 0.0f);
+}
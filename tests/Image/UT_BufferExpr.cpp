@@ -0,0 +1,156 @@
+/**
+ * ****************************************************************************
+ * Copyright (c) 2017, Robert Lukierski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ****************************************************************************
+ * Lazy buffer expression tests.
+ * ****************************************************************************
+ */
+
+// system
+#include <stdint.h>
+#include <stddef.h>
+#include <random>
+
+// testing framework & libraries
+#include <gtest/gtest.h>
+
+// google logger
+#include <glog/logging.h>
+
+#include <VisionCore/Image/BufferExpr.hpp>
+
+static constexpr std::size_t BufferSizeX = 301;
+static constexpr std::size_t BufferSizeY = 67;
+
+using namespace vc::image::expr;
+
+class Test_BufferExpr : public ::testing::Test
+{
+public:
+    Test_BufferExpr() : buf_a(BufferSizeX, BufferSizeY), buf_b(BufferSizeX, BufferSizeY), buf_bytes(BufferSizeX, BufferSizeY)
+    {
+        std::mt19937 gen(1234);
+        std::uniform_real_distribution<float> dist(-2.0f, 2.0f);
+        
+        for(std::size_t y = 0 ; y < BufferSizeY ; ++y)
+        {
+            for(std::size_t x = 0 ; x < BufferSizeX ; ++x)
+            {
+                buf_a(x,y) = dist(gen);
+                buf_b(x,y) = dist(gen);
+                buf_bytes(x,y) = (uint8_t)(gen() & 0xFF);
+            }
+        }
+    }
+    
+    vc::Buffer2DManaged<float, vc::TargetHost> buf_a;
+    vc::Buffer2DManaged<float, vc::TargetHost> buf_b;
+    vc::Buffer2DManaged<uint8_t, vc::TargetHost> buf_bytes;
+};
+
+TEST_F(Test_BufferExpr, FusedPipeline)
+{
+    vc::Buffer2DManaged<uint8_t, vc::TargetHost> buf_out(BufferSizeX, BufferSizeY);
+    
+    evaluate(clamp(scale(buf_a, 100.0f, 128.0f), 0.0f, 255.0f).cast<uint8_t>(), buf_out);
+    
+    for(std::size_t y = 0 ; y < BufferSizeY ; ++y)
+    {
+        for(std::size_t x = 0 ; x < BufferSizeX ; ++x)
+        {
+            const float expected = std::min(std::max(buf_a(x,y) * 100.0f + 128.0f, 0.0f), 255.0f);
+            ASSERT_EQ(buf_out(x,y), (uint8_t)expected) << "Mismatch at " << x << " , " << y;
+        }
+    }
+}
+
+TEST_F(Test_BufferExpr, Arithmetic)
+{
+    vc::Buffer2DManaged<float, vc::TargetHost> buf_out(BufferSizeX, BufferSizeY);
+    
+    evaluate(abs(lazy(buf_a) - buf_b) * 0.5f + 2.0f / (max(buf_a, buf_b) + 3.0f) - min(buf_a, 1.0f * lazy(buf_b)), buf_out);
+    
+    for(std::size_t y = 0 ; y < BufferSizeY ; ++y)
+    {
+        for(std::size_t x = 0 ; x < BufferSizeX ; ++x)
+        {
+            const float a = buf_a(x,y), b = buf_b(x,y);
+            const float expected = std::abs(a - b) * 0.5f + 2.0f / (std::max(a, b) + 3.0f) - std::min(a, 1.0f * b);
+            ASSERT_FLOAT_EQ(buf_out(x,y), expected) << "Mismatch at " << x << " , " << y;
+        }
+    }
+}
+
+TEST_F(Test_BufferExpr, ConvertAndThreshold)
+{
+    vc::Buffer2DManaged<float, vc::TargetHost> buf_out(BufferSizeX, BufferSizeY);
+    
+    evaluate(threshold(lazy(buf_bytes).convert<float>(), 0.5f, 0.0f, 1.0f) + buf_bytes, buf_out);
+    
+    for(std::size_t y = 0 ; y < BufferSizeY ; ++y)
+    {
+        for(std::size_t x = 0 ; x < BufferSizeX ; ++x)
+        {
+            const float expected = (buf_bytes(x,y) / 255.0f < 0.5f ? 0.0f : 1.0f) + buf_bytes(x,y);
+            ASSERT_EQ(buf_out(x,y), expected) << "Mismatch at " << x << " , " << y;
+        }
+    }
+}
+
+TEST_F(Test_BufferExpr, InplaceAndCommonArea)
+{
+    vc::Buffer2DManaged<float, vc::TargetHost> buf_ref(BufferSizeX, BufferSizeY);
+    buf_ref.copyFrom(buf_a);
+    
+    // output is also an input
+    evaluate(lazy(buf_a) * buf_a, buf_a);
+    
+    // only the common area is touched
+    vc::Buffer2DManaged<float, vc::TargetHost> buf_out(BufferSizeX + 5, BufferSizeY + 3);
+    for(std::size_t y = 0 ; y < buf_out.height() ; ++y)
+    {
+        for(std::size_t x = 0 ; x < buf_out.width() ; ++x)
+        {
+            buf_out(x,y) = -1.0f;
+        }
+    }
+    
+    const vc::Buffer2DView<float, vc::TargetHost> buf_narrow(buf_a.ptr(), BufferSizeX - 1, BufferSizeY, buf_a.pitch());
+    evaluate(lazy(buf_narrow) + buf_b, buf_out);
+    
+    for(std::size_t y = 0 ; y < buf_out.height() ; ++y)
+    {
+        for(std::size_t x = 0 ; x < buf_out.width() ; ++x)
+        {
+            const float expected = (x < BufferSizeX - 1 && y < BufferSizeY) ? buf_ref(x,y) * buf_ref(x,y) + buf_b(x,y) : -1.0f;
+            ASSERT_EQ(buf_out(x,y), expected) << "Mismatch at " << x << " , " << y;
+        }
+    }
+}
@@ -0,0 +1,255 @@
+/**
+ * ****************************************************************************
+ * Copyright (c) 2017, Robert Lukierski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ****************************************************************************
+ * Buffer operations tests.
+ * ****************************************************************************
+ */
+
+// system
+#include <stdint.h>
+#include <stddef.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// testing framework & libraries
+#include <gtest/gtest.h>
+
+// google logger
+#include <glog/logging.h>
+
+#include <VisionCore/CPUFeatures.hpp>
+#include <VisionCore/Image/BufferOps.hpp>
+
+static constexpr std::size_t BufferSizeX = 1023;
+static constexpr std::size_t BufferSizeY = 769;
+
+TEST(Test_BufferOps, StatsFloat)
+{
+    vc::Buffer2DManaged<float, vc::TargetHost> buf(BufferSizeX, BufferSizeY);
+    
+    double sum = 0.0, sum_sq = 0.0;
+    for(std::size_t y = 0 ; y < BufferSizeY ; ++y)
+    {
+        for(std::size_t x = 0 ; x < BufferSizeX ; ++x)
+        {
+            const float v = float((x * 7 + y * 13) % 1000) * 0.01f - 3.0f;
+            buf(x,y) = v;
+            sum += v;
+            sum_sq += double(v) * double(v);
+        }
+    }
+    
+    buf(17,3) = -100.0f;
+    buf(BufferSizeX - 1, BufferSizeY - 1) = 200.0f;
+    sum += -100.0 - (float((17 * 7 + 3 * 13) % 1000) * 0.01f - 3.0f);
+    sum += 200.0 - (float(((BufferSizeX - 1) * 7 + (BufferSizeY - 1) * 13) % 1000) * 0.01f - 3.0f);
+    
+    const vc::image::BufferStats<float> stats = vc::image::calcBufferStats(buf);
+    ASSERT_EQ(stats.count, BufferSizeX * BufferSizeY);
+    ASSERT_EQ(stats.min, -100.0f);
+    ASSERT_EQ(stats.max, 200.0f);
+    ASSERT_NEAR(stats.sum, sum, 1e-3);
+    ASSERT_EQ(vc::image::calcBufferMin(buf), -100.0f);
+    ASSERT_EQ(vc::image::calcBufferMax(buf), 200.0f);
+    ASSERT_NEAR(vc::image::calcBufferMean(buf), sum / double(stats.count), 1e-5);
+    
+    // invalid values & non-finite ones masked out
+    buf(5,5) = std::numeric_limits<float>::quiet_NaN();
+    buf(6,5) = std::numeric_limits<float>::infinity();
+    buf(7,5) = -1000.0f;
+    buf(8,5) = -1000.0f;
+    
+    const vc::image::BufferStats<float> masked = vc::image::calcBufferStats(buf, -1000.0f);
+    ASSERT_EQ(masked.count, BufferSizeX * BufferSizeY - 4);
+    ASSERT_EQ(masked.min, -100.0f);
+    ASSERT_EQ(masked.max, 200.0f);
+    ASSERT_TRUE(std::isfinite(masked.sum));
+    
+    // NaNs never win min / max
+    const vc::image::BufferStats<float> unmasked = vc::image::calcBufferStats(buf);
+    ASSERT_EQ(unmasked.min, -1000.0f);
+    ASSERT_EQ(unmasked.max, std::numeric_limits<float>::infinity());
+}
+
+TEST(Test_BufferOps, StatsUInt16)
+{
+    vc::Buffer2DManaged<uint16_t, vc::TargetHost> buf(BufferSizeX, BufferSizeY);
+    
+    uint64_t sum = 0, sum_sq = 0, count = 0;
+    uint16_t vmin = std::numeric_limits<uint16_t>::max(), vmax = 0;
+    for(std::size_t y = 0 ; y < BufferSizeY ; ++y)
+    {
+        for(std::size_t x = 0 ; x < BufferSizeX ; ++x)
+        {
+            // 0 = no depth
+            const uint16_t v = (x + y) % 5 == 0 ? 0 : uint16_t(500 + (x * y) % 60000);
+            buf(x,y) = v;
+            
+            if(v != 0)
+            {
+                vmin = std::min(vmin, v);
+                vmax = std::max(vmax, v);
+                sum += v;
+                sum_sq += uint64_t(v) * v;
+                count++;
+            }
+        }
+    }
+    
+    const vc::image::BufferStats<uint16_t> stats = vc::image::calcBufferStats(buf, uint16_t(0));
+    ASSERT_EQ(stats.count, count);
+    ASSERT_EQ(stats.min, vmin);
+    ASSERT_EQ(stats.max, vmax);
+    ASSERT_EQ(stats.sum, double(sum));
+    ASSERT_EQ(stats.sum_sq, double(sum_sq));
+    ASSERT_NEAR(stats.variance(), double(sum_sq) / count - (double(sum) / count) * (double(sum) / count), 1.0);
+    
+    ASSERT_EQ(vc::image::calcBufferMin(buf), 0);
+    
+    vc::Buffer2DManaged<uint16_t, vc::TargetHost> empty(0, 0);
+    const vc::image::BufferStats<uint16_t> none = vc::image::calcBufferStats(empty);
+    ASSERT_EQ(none.count, 0u);
+    ASSERT_EQ(none.mean(), 0.0);
+}
+
+TEST(Test_BufferOps, StatsUInt8)
+{
+    for(std::size_t w : { std::size_t(1), std::size_t(15), std::size_t(16), std::size_t(33), BufferSizeX })
+    {
+        vc::Buffer2DManaged<uint8_t, vc::TargetHost> buf(w, 31);
+        
+        uint64_t sum = 0, sum_sq = 0, count = 0;
+        uint8_t vmin = 255, vmax = 0;
+        for(std::size_t y = 0 ; y < buf.height() ; ++y)
+        {
+            for(std::size_t x = 0 ; x < w ; ++x)
+            {
+                const uint8_t v = uint8_t((x * 31 + y * 17) % 256);
+                buf(x,y) = v;
+                
+                if(v != 255)
+                {
+                    vmin = std::min(vmin, v);
+                    vmax = std::max(vmax, v);
+                    sum += v;
+                    sum_sq += uint64_t(v) * v;
+                    count++;
+                }
+            }
+        }
+        
+        const vc::image::BufferStats<uint8_t> stats = vc::image::calcBufferStats(buf, uint8_t(255));
+        ASSERT_EQ(stats.count, count) << "Width " << w;
+        ASSERT_EQ(stats.min, vmin) << "Width " << w;
+        ASSERT_EQ(stats.max, vmax) << "Width " << w;
+        ASSERT_EQ(stats.sum, double(sum)) << "Width " << w;
+        ASSERT_EQ(stats.sum_sq, double(sum_sq)) << "Width " << w;
+    }
+}
+
+TEST(Test_BufferOps, Normalize)
+{
+    vc::Buffer2DManaged<float, vc::TargetHost> buf(BufferSizeX, BufferSizeY);
+    
+    for(std::size_t y = 0 ; y < BufferSizeY ; ++y)
+    {
+        for(std::size_t x = 0 ; x < BufferSizeX ; ++x)
+        {
+            buf(x,y) = float(x + y) * 2.0f + 10.0f;
+        }
+    }
+    
+    vc::image::normalizeBufferInplace(buf);
+    
+    ASSERT_FLOAT_EQ(buf(0,0), 0.0f);
+    ASSERT_FLOAT_EQ(buf(BufferSizeX - 1, BufferSizeY - 1), 1.0f);
+    ASSERT_NEAR(buf(10,0), 20.0f / (2.0f * (BufferSizeX + BufferSizeY - 2)), 1e-6);
+}
+
+/**
+ * Rounded 2x2 mean, values near the top of the range used to wrap around.
+ */
+template<typename T>
+static void checkPyramid(std::size_t w, std::size_t h)
+{
+    const int vmax = std::numeric_limits<T>::max();
+    vc::ImagePyramidManaged<T,3,vc::TargetHost> pyr(w, h);
+    
+    for(std::size_t y = 0 ; y < h ; ++y)
+    {
+        for(std::size_t x = 0 ; x < w ; ++x)
+        {
+            pyr[0](x,y) = T(vmax - int((x * 7 + y * 13) % 97));
+        }
+    }
+    
+    const vc::CPULevel previous_level = vc::getCPULevel();
+    
+    for(vc::CPULevel level : { vc::CPULevel::Generic, vc::CPULevel::AVX2, vc::CPULevel::AVX512 })
+    {
+        if(!vc::isCPULevelAvailable(level)) { continue; }
+        
+        SCOPED_TRACE(vc::cpuLevelName(level));
+        vc::setCPULevel(level);
+        
+        for(std::size_t l = 1 ; l < 3 ; ++l) { pyr[l].memset(0); }
+        vc::image::fillPyramidBilinear(pyr);
+        
+        for(std::size_t l = 1 ; l < 3 ; ++l)
+        {
+            ASSERT_EQ(pyr[l].width(), pyr[l-1].width() / 2);
+            
+            for(std::size_t y = 0 ; y < pyr[l].height() ; ++y)
+            {
+                for(std::size_t x = 0 ; x < pyr[l].width() ; ++x)
+                {
+                    const int sum = pyr[l-1](2*x,2*y) + pyr[l-1](2*x+1,2*y) + pyr[l-1](2*x,2*y+1) + pyr[l-1](2*x+1,2*y+1);
+                    ASSERT_EQ(int(pyr[l](x,y)), (sum + 2) / 4) << "Level " << l << " at " << x << " , " << y;
+                }
+            }
+        }
+    }
+    
+    vc::setCPULevel(previous_level);
+}
+
+TEST(Test_BufferOps, PyramidUInt8)
+{
+    checkPyramid<uint8_t>(75, 42);
+    checkPyramid<uint8_t>(BufferSizeX, 40);
+}
+
+TEST(Test_BufferOps, PyramidUInt16)
+{
+    checkPyramid<uint16_t>(75, 42);
+    checkPyramid<uint16_t>(BufferSizeX, 40);
+}
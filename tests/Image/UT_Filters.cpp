@@ -0,0 +1,179 @@
+/**
+ * ****************************************************************************
+ * Copyright (c) 2017, Robert Lukierski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ****************************************************************************
+ * Image filters tests.
+ * ****************************************************************************
+ */
+
+// system
+#include <stdint.h>
+#include <stddef.h>
+#include <cmath>
+#include <limits>
+#include <random>
+
+// testing framework & libraries
+#include <gtest/gtest.h>
+
+// google logger
+#include <glog/logging.h>
+
+#include <VisionCore/Image/Filters.hpp>
+
+/**
+ * Straightforward bilateral, in double, taps through the view border helpers.
+ */
+static double bilateralReference(const vc::Buffer2DView<float,vc::TargetHost>& buf, int x, int y, double gs, double gr, 
+                                 double minval, int dim, vc::BorderMode border, float value)
+{
+    const double p = buf(x, y);
+    double sum = 0.0, sumw = 0.0;
+    
+    for(int r = -dim ; r <= dim ; ++r)
+    {
+        for(int c = -dim ; c <= dim ; ++c)
+        {
+            const bool inside = x + c >= 0 && y + r >= 0 && x + c < (int)buf.width() && y + r < (int)buf.height();
+            double q = buf.getWithClampedRange(x + c, y + r);
+            if(border == vc::BorderMode::Reflect) { q = buf.getWithReflectedRange(x + c, y + r); }
+            if(border == vc::BorderMode::Constant && !inside) { q = value; }
+            if(q < minval) { continue; }
+            
+            const double w = std::exp(-double(r*r + c*c) / (2.0 * gs * gs)) * std::exp(-(p - q) * (p - q) / (2.0 * gr * gr));
+            sumw += w;
+            sum += w * q;
+        }
+    }
+    
+    return sum / sumw;
+}
+
+TEST(Test_Filters, Bilateral)
+{
+    const int dim = 2;
+    const float gs = 2.0f, gr = 0.1f, minval = 0.2f, value = 0.5f, sentinel = -1.0f;
+    
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+    vc::Buffer2DManaged<float,vc::TargetHost> buf_in(41, 23), buf_out(41, 23);
+    for(std::size_t y = 0 ; y < buf_in.height() ; ++y)
+    {
+        for(std::size_t x = 0 ; x < buf_in.width() ; ++x) { buf_in(x, y) = dist(gen); }
+    }
+    
+    for(vc::BorderMode border : { vc::BorderMode::Clamp, vc::BorderMode::Reflect, vc::BorderMode::Constant, vc::BorderMode::Skip })
+    {
+        for(bool use_minval : { false, true })
+        {
+            SCOPED_TRACE(::testing::Message() << (int)border << " minval " << use_minval);
+            
+            for(std::size_t y = 0 ; y < buf_out.height() ; ++y)
+            {
+                for(std::size_t x = 0 ; x < buf_out.width() ; ++x) { buf_out(x, y) = sentinel; }
+            }
+            
+            if(use_minval)
+            {
+                vc::image::bilateral(buf_in, buf_out, gs, gr, minval, dim, border, value);
+            }
+            else
+            {
+                vc::image::bilateral(buf_in, buf_out, gs, gr, (std::size_t)dim, border, value);
+            }
+            
+            for(int y = 0 ; y < (int)buf_in.height() ; ++y)
+            {
+                for(int x = 0 ; x < (int)buf_in.width() ; ++x)
+                {
+                    const bool interior = x >= dim && y >= dim && x + dim < (int)buf_in.width() && y + dim < (int)buf_in.height();
+                    
+                    if(border == vc::BorderMode::Skip && !interior)
+                    {
+                        ASSERT_EQ(buf_out(x, y), sentinel) << "Written at " << x << " , " << y;
+                    }
+                    else if(use_minval && buf_in(x, y) < minval)
+                    {
+                        ASSERT_TRUE(std::isnan(buf_out(x, y))) << "Below minval at " << x << " , " << y;
+                    }
+                    else
+                    {
+                        const double expected = bilateralReference(buf_in, x, y, gs, gr, use_minval ? minval : -1.0, dim, border, value);
+                        ASSERT_NEAR(buf_out(x, y), expected, 1e-5) << "Mismatch at " << x << " , " << y;
+                    }
+                }
+            }
+        }
+    }
+    
+    // the overloads without a border mode clamp
+    vc::Buffer2DManaged<float,vc::TargetHost> buf_clamp(41, 23);
+    vc::image::bilateral(buf_in, buf_out, gs, gr, dim);
+    vc::image::bilateral(buf_in, buf_clamp, gs, gr, (std::size_t)dim, vc::BorderMode::Clamp);
+    for(std::size_t y = 0 ; y < buf_in.height() ; ++y)
+    {
+        for(std::size_t x = 0 ; x < buf_in.width() ; ++x) { ASSERT_EQ(buf_out(x, y), buf_clamp(x, y)); }
+    }
+}
+
+TEST(Test_Filters, BilateralNaN)
+{
+    const int dim = 2;
+    const float gs = 2.0f, gr = 0.1f;
+    const int nx = 10, ny = 7;
+    
+    vc::Buffer2DManaged<float,vc::TargetHost> buf_in(21, 15), buf_out(21, 15);
+    for(std::size_t y = 0 ; y < buf_in.height() ; ++y)
+    {
+        for(std::size_t x = 0 ; x < buf_in.width() ; ++x) { buf_in(x, y) = 0.5f + 0.01f * float(x); }
+    }
+    buf_in(nx, ny) = std::numeric_limits<float>::quiet_NaN();
+    
+    // without minval every tap counts, a NaN spreads over its window
+    vc::image::bilateral(buf_in, buf_out, gs, gr, (std::size_t)dim);
+    for(int y = 0 ; y < (int)buf_in.height() ; ++y)
+    {
+        for(int x = 0 ; x < (int)buf_in.width() ; ++x)
+        {
+            const bool reaches = std::abs(x - nx) <= dim && std::abs(y - ny) <= dim;
+            ASSERT_EQ(std::isnan(buf_out(x, y)), reaches) << "At " << x << " , " << y;
+        }
+    }
+    
+    // with minval NaN fails q >= minval, it is skipped as a tap and gives NaN only at its own pixel
+    vc::image::bilateral(buf_in, buf_out, gs, gr, 0.0f, (std::size_t)dim);
+    for(int y = 0 ; y < (int)buf_in.height() ; ++y)
+    {
+        for(int x = 0 ; x < (int)buf_in.width() ; ++x)
+        {
+            ASSERT_EQ(std::isnan(buf_out(x, y)), x == nx && y == ny) << "At " << x << " , " << y;
+        }
+    }
+}
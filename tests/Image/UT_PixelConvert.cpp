@@ -0,0 +1,228 @@
+/**
+ * ****************************************************************************
+ * Copyright (c) 2017, Robert Lukierski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ****************************************************************************
+ * Pixel conversion tests.
+ * ****************************************************************************
+ */
+
+// system
+#include <stdint.h>
+#include <stddef.h>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+
+// testing framework & libraries
+#include <gtest/gtest.h>
+
+// google logger
+#include <glog/logging.h>
+
+#include <VisionCore/CPUFeatures.hpp>
+#include <VisionCore/Image/PixelConvert.hpp>
+
+// odd, so that every kernel runs its scalar tail too
+static constexpr std::size_t BufferSizeX = 301;
+static constexpr std::size_t BufferSizeY = 67;
+
+template<typename T>
+static void fillRandomBytes(vc::Buffer2DView<T, vc::TargetHost>& buf, std::mt19937& gen)
+{
+    std::uniform_int_distribution<int> dist(0, 255);
+    for(std::size_t y = 0 ; y < buf.height() ; ++y)
+    {
+        uint8_t* row = reinterpret_cast<uint8_t*>(buf.rowPtr(y));
+        for(std::size_t i = 0 ; i < buf.width() * sizeof(T) ; ++i) { row[i] = dist(gen); }
+    }
+}
+
+template<typename T>
+static void fillRandomFloats(vc::Buffer2DView<T, vc::TargetHost>& buf, std::mt19937& gen)
+{
+    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+    for(std::size_t y = 0 ; y < buf.height() ; ++y)
+    {
+        float* row = reinterpret_cast<float*>(buf.rowPtr(y));
+        for(std::size_t i = 0 ; i < buf.width() * sizeof(T) / sizeof(float) ; ++i) { row[i] = dist(gen); }
+    }
+}
+
+/**
+ * Bit exact against convertPixel.
+ */
+template<typename T_OUT, typename T_IN>
+static void checkConvert(const vc::Buffer2DView<T_IN, vc::TargetHost>& buf_in)
+{
+    vc::Buffer2DManaged<T_OUT, vc::TargetHost> buf_out(buf_in.width(), buf_in.height());
+    vc::image::convertBuffer(buf_in, buf_out);
+    
+    for(std::size_t y = 0 ; y < buf_in.height() ; ++y)
+    {
+        for(std::size_t x = 0 ; x < buf_in.width() ; ++x)
+        {
+            const T_OUT expected = vc::image::convertPixel<T_OUT, T_IN>(buf_in(x,y));
+            ASSERT_EQ(std::memcmp(&expected, &buf_out(x,y), sizeof(T_OUT)), 0) << "Mismatch at " << x << " , " << y;
+        }
+    }
+}
+
+TEST(Test_PixelConvert, FromBytes)
+{
+    std::mt19937 gen(1234);
+    vc::Buffer2DManaged<uint8_t, vc::TargetHost> buf_grey(BufferSizeX, BufferSizeY);
+    vc::Buffer2DManaged<uchar3, vc::TargetHost> buf_rgb(BufferSizeX, BufferSizeY);
+    vc::Buffer2DManaged<uchar4, vc::TargetHost> buf_rgba(BufferSizeX, BufferSizeY);
+    fillRandomBytes(buf_grey, gen);
+    fillRandomBytes(buf_rgb, gen);
+    fillRandomBytes(buf_rgba, gen);
+    
+    checkConvert<float>(buf_grey);
+    checkConvert<uchar3>(buf_grey);
+    checkConvert<float4>(buf_grey);
+    
+    checkConvert<uint8_t>(buf_rgb);
+    checkConvert<uchar4>(buf_rgb);
+    checkConvert<float>(buf_rgb);
+    checkConvert<float3>(buf_rgb);
+    checkConvert<Eigen::Vector3f>(buf_rgb);
+    
+    checkConvert<uint8_t>(buf_rgba);
+    checkConvert<uchar3>(buf_rgba);
+    checkConvert<float>(buf_rgba);
+    checkConvert<float4>(buf_rgba);
+    checkConvert<Eigen::Vector4f>(buf_rgba);
+}
+
+TEST(Test_PixelConvert, FromFloats)
+{
+    std::mt19937 gen(4321);
+    vc::Buffer2DManaged<float, vc::TargetHost> buf_grey(BufferSizeX, BufferSizeY);
+    vc::Buffer2DManaged<float3, vc::TargetHost> buf_rgb(BufferSizeX, BufferSizeY);
+    vc::Buffer2DManaged<float4, vc::TargetHost> buf_rgba(BufferSizeX, BufferSizeY);
+    vc::Buffer2DManaged<uint16_t, vc::TargetHost> buf_depth(BufferSizeX, BufferSizeY);
+    fillRandomFloats(buf_grey, gen);
+    fillRandomFloats(buf_rgb, gen);
+    fillRandomFloats(buf_rgba, gen);
+    fillRandomBytes(buf_depth, gen);
+    
+    checkConvert<uint8_t>(buf_grey);
+    checkConvert<uchar4>(buf_grey);
+    checkConvert<uchar3>(buf_rgb);
+    checkConvert<uint8_t>(buf_rgb);
+    checkConvert<uchar4>(buf_rgba);
+    checkConvert<float>(buf_depth);
+}
+
+TEST(Test_PixelConvert, RoundingAndSaturation)
+{
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    const float values[] = { -1.0f, 0.0f, 0.75f / 255.0f, 0.49f / 255.0f, 10.75f / 255.0f, 0.5f, 1.0f, 2.0f, nan };
+    const uint8_t truncated[] = { 0, 0, 0, 0, 10, 127, 255, 255, 0 };
+    const uint8_t nearest[] = { 0, 0, 1, 0, 11, 128, 255, 255, 0 };
+    static constexpr std::size_t Count = sizeof(values) / sizeof(values[0]);
+    
+    // enough pixels for the vector kernels
+    vc::Buffer2DManaged<float, vc::TargetHost> buf_in(Count * 8, 2);
+    vc::Buffer2DManaged<float4, vc::TargetHost> buf_in4(Count * 8, 2);
+    for(std::size_t y = 0 ; y < buf_in.height() ; ++y)
+    {
+        for(std::size_t x = 0 ; x < buf_in.width() ; ++x)
+        {
+            const float v = values[x % Count];
+            buf_in(x,y) = v;
+            buf_in4(x,y) = make_float4(v, v, v, v);
+        }
+    }
+    
+    vc::Buffer2DManaged<uint8_t, vc::TargetHost> buf_out(buf_in.width(), buf_in.height());
+    vc::Buffer2DManaged<uchar3, vc::TargetHost> buf_out3(buf_in.width(), buf_in.height());
+    vc::Buffer2DManaged<uchar4, vc::TargetHost> buf_out4(buf_in.width(), buf_in.height());
+    
+    for(vc::image::ConvertRounding rounding : { vc::image::ConvertRounding::Truncate, vc::image::ConvertRounding::Nearest })
+    {
+        const uint8_t* expected = rounding == vc::image::ConvertRounding::Nearest ? nearest : truncated;
+        
+        vc::image::convertBuffer(buf_in, buf_out, rounding);
+        vc::image::convertBuffer(buf_in, buf_out3, rounding);
+        vc::image::convertBuffer(buf_in4, buf_out4, rounding);
+        
+        for(std::size_t y = 0 ; y < buf_in.height() ; ++y)
+        {
+            for(std::size_t x = 0 ; x < buf_in.width() ; ++x)
+            {
+                const uint8_t e = expected[x % Count];
+                ASSERT_EQ(buf_out(x,y), e) << "Value " << values[x % Count];
+                ASSERT_EQ(buf_out3(x,y).x, e) << "Value " << values[x % Count];
+                ASSERT_EQ(buf_out3(x,y).z, e) << "Value " << values[x % Count];
+                ASSERT_EQ(buf_out4(x,y).x, e) << "Value " << values[x % Count];
+                ASSERT_EQ(buf_out4(x,y).w, e) << "Value " << values[x % Count];
+            }
+        }
+    }
+}
+
+TEST(Test_PixelConvert, AllCPULevels)
+{
+    const vc::CPULevel previous_level = vc::getCPULevel();
+    
+    std::mt19937 gen(5678);
+    vc::Buffer2DManaged<uint8_t, vc::TargetHost> buf_grey(BufferSizeX, BufferSizeY);
+    vc::Buffer2DManaged<uchar3, vc::TargetHost> buf_rgb(BufferSizeX, BufferSizeY);
+    vc::Buffer2DManaged<uchar4, vc::TargetHost> buf_rgba(BufferSizeX, BufferSizeY);
+    vc::Buffer2DManaged<float, vc::TargetHost> buf_float(BufferSizeX, BufferSizeY);
+    vc::Buffer2DManaged<uint16_t, vc::TargetHost> buf_depth(BufferSizeX, BufferSizeY);
+    fillRandomBytes(buf_grey, gen);
+    fillRandomBytes(buf_rgb, gen);
+    fillRandomBytes(buf_rgba, gen);
+    fillRandomFloats(buf_float, gen);
+    fillRandomBytes(buf_depth, gen);
+    
+    for(vc::CPULevel level : { vc::CPULevel::Generic, vc::CPULevel::SSE42, vc::CPULevel::AVX2, vc::CPULevel::AVX512 })
+    {
+        if(!vc::isCPULevelAvailable(level)) { continue; }
+        
+        SCOPED_TRACE(vc::cpuLevelName(level));
+        vc::setCPULevel(level);
+        
+        checkConvert<float>(buf_grey);
+        checkConvert<uint8_t>(buf_float);
+        checkConvert<float>(buf_depth);
+        checkConvert<uint8_t>(buf_rgb);
+        checkConvert<uint8_t>(buf_rgba);
+        checkConvert<float>(buf_rgb);
+        checkConvert<float>(buf_rgba);
+        checkConvert<uchar4>(buf_rgb);
+        checkConvert<uchar3>(buf_rgba);
+    }
+    
+    vc::setCPULevel(previous_level);
+}
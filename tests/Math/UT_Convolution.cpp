@@ -0,0 +1,359 @@
+/**
+ * ****************************************************************************
+ * Copyright (c) 2017, Robert Lukierski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ****************************************************************************
+ * Convolution tests.
+ * ****************************************************************************
+ */
+
+// system
+#include <stdint.h>
+#include <stddef.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <stdexcept>
+
+// testing framework & libraries
+#include <gtest/gtest.h>
+
+// google logger
+#include <glog/logging.h>
+
+#include <VisionCore/CPUFeatures.hpp>
+#include <VisionCore/Math/Convolution.hpp>
+
+template<typename T>
+class Test_Convolution : public ::testing::Test
+{
+public:
+    typedef typename std::conditional<std::is_same<T,double>::value, double, float>::type KernelScalar;
+    typedef Eigen::Matrix<KernelScalar,Eigen::Dynamic,1> KernelT;
+    
+    static void fill(vc::Buffer2DView<T,vc::TargetHost>& buf, std::mt19937& gen)
+    {
+        std::uniform_real_distribution<double> dist(0.0, std::is_integral<T>::value ? double(std::numeric_limits<T>::max()) : 1.0);
+        
+        for(std::size_t y = 0 ; y < buf.height() ; ++y)
+        {
+            for(std::size_t x = 0 ; x < buf.width() ; ++x)
+            {
+                buf(x,y) = T(dist(gen));
+            }
+        }
+    }
+    
+    /**
+     * Tap with the border mode, through the view helpers, so offsets up to the image size only.
+     */
+    static double tap(const vc::Buffer2DView<T,vc::TargetHost>& buf, int x, int y, vc::BorderMode border, T value)
+    {
+        const bool inside = x >= 0 && y >= 0 && x < (int)buf.width() && y < (int)buf.height();
+        
+        switch(border)
+        {
+            case vc::BorderMode::Reflect: return double(buf.getWithReflectedRange(x, y));
+            case vc::BorderMode::Wrap: return double(buf.getWithCircularRange(x, y));
+            case vc::BorderMode::Constant: return inside ? double(buf(x, y)) : double(value);
+            default: return double(buf.getWithClampedRange(x, y));
+        }
+    }
+    
+    /**
+     * Straightforward 2D version with the outer product kernel, in double.
+     * With BorderMode::Skip the border pixels have to keep what was there.
+     */
+    static void check(const vc::Buffer2DView<T,vc::TargetHost>& buf_in, const KernelT& kern_x, const KernelT& kern_y,
+                      vc::BorderMode border = vc::BorderMode::Clamp, T value = T(0))
+    {
+        const T sentinel = T(7);
+        vc::Buffer2DManaged<T,vc::TargetHost> buf_out(buf_in.width(), buf_in.height());
+        for(std::size_t y = 0 ; y < buf_out.height() ; ++y)
+        {
+            for(std::size_t x = 0 ; x < buf_out.width() ; ++x) { buf_out(x, y) = sentinel; }
+        }
+        
+        vc::math::convolveSeparable(buf_in, buf_out, kern_x, kern_y, border, value);
+        
+        const int rx = kern_x.size() / 2, ry = kern_y.size() / 2;
+        
+        for(int y = 0 ; y < (int)buf_in.height() ; ++y)
+        {
+            for(int x = 0 ; x < (int)buf_in.width() ; ++x)
+            {
+                if(border == vc::BorderMode::Skip && (x < rx || y < ry || x + rx >= (int)buf_in.width() || y + ry >= (int)buf_in.height()))
+                {
+                    ASSERT_EQ(buf_out(x,y), sentinel) << "Written at " << x << " , " << y;
+                    continue;
+                }
+                
+                double expected = 0.0;
+                for(int j = -ry ; j <= ry ; ++j)
+                {
+                    for(int i = -rx ; i <= rx ; ++i)
+                    {
+                        expected += double(kern_x(i + rx)) * double(kern_y(j + ry)) * tap(buf_in, x + i, y + j, border, value);
+                    }
+                }
+                
+                if(std::is_integral<T>::value)
+                {
+                    expected = std::min(std::max(expected, 0.0), double(std::numeric_limits<T>::max()));
+                    ASSERT_NEAR(double(buf_out(x,y)), expected, 1.0) << "Mismatch at " << x << " , " << y;
+                }
+                else
+                {
+                    ASSERT_NEAR(double(buf_out(x,y)), expected, 1e-4) << "Mismatch at " << x << " , " << y;
+                }
+            }
+        }
+    }
+};
+
+typedef ::testing::Types<uint8_t, uint16_t, float, double> ConvolutionTypes;
+TYPED_TEST_CASE(Test_Convolution, ConvolutionTypes);
+
+TYPED_TEST(Test_Convolution, Separable)
+{
+    typedef typename TestFixture::KernelT KernelT;
+    typedef typename TestFixture::KernelScalar KernelScalar;
+    
+    std::mt19937 gen(1234);
+    vc::Buffer2DManaged<TypeParam,vc::TargetHost> buf_in(131, 97);
+    TestFixture::fill(buf_in, gen);
+    
+    vc::Buffer2DManaged<TypeParam,vc::TargetHost> buf_tiny(7, 4);
+    TestFixture::fill(buf_tiny, gen);
+    
+    const vc::CPULevel previous_level = vc::getCPULevel();
+    
+    for(vc::CPULevel level : { vc::CPULevel::Generic, vc::CPULevel::SSE42, vc::CPULevel::AVX2, vc::CPULevel::AVX512 })
+    {
+        if(!vc::isCPULevelAvailable(level)) { continue; }
+        
+        SCOPED_TRACE(vc::cpuLevelName(level));
+        vc::setCPULevel(level);
+        
+        // identity
+        TestFixture::check(buf_in, KernelT(KernelT::Ones(1)), KernelT(KernelT::Ones(1)));
+        
+        // small, asymmetric and with negative taps, different in x and y
+        KernelT kern_x(3), kern_y(5);
+        kern_x << KernelScalar(0.25), KernelScalar(0.5), KernelScalar(0.25);
+        kern_y << KernelScalar(-0.1), KernelScalar(0.2), KernelScalar(0.6), KernelScalar(0.2), KernelScalar(0.1);
+        TestFixture::check(buf_in, kern_x, kern_y);
+        
+        // sigma 3 Gaussian, 19 taps, longer than the tiny image below
+        const KernelT gauss = vc::math::gaussianKernel<KernelScalar>(3.0);
+        ASSERT_EQ(gauss.size(), 19);
+        ASSERT_NEAR(gauss.sum(), 1.0, 1e-5);
+        TestFixture::check(buf_in, gauss, gauss);
+        TestFixture::check(buf_tiny, gauss, kern_y);
+        
+        // sigma 1 Gaussian and random normalised blurs, the fixed-point path for uint8_t
+        TestFixture::check(buf_in, vc::math::gaussianKernel<KernelScalar>(1.0), vc::math::gaussianKernel<KernelScalar>(1.0));
+        
+        std::uniform_real_distribution<double> tap_dist(0.0, 1.0);
+        for(int taps : { 7, 11 })
+        {
+            KernelT kern_random(taps);
+            for(int i = 0 ; i < taps ; ++i) { kern_random(i) = KernelScalar(tap_dist(gen)); }
+            kern_random /= kern_random.sum();
+            TestFixture::check(buf_in, kern_random, kern_random);
+        }
+        
+        // negative row taps, integer images take the float path and saturate
+        KernelT sharpen(3);
+        sharpen << KernelScalar(-0.5), KernelScalar(2.0), KernelScalar(-0.5);
+        TestFixture::check(buf_in, sharpen, kern_x);
+    }
+    
+    vc::setCPULevel(previous_level);
+}
+
+TYPED_TEST(Test_Convolution, SeparableBorders)
+{
+    typedef typename TestFixture::KernelT KernelT;
+    typedef typename TestFixture::KernelScalar KernelScalar;
+    
+    std::mt19937 gen(4321);
+    vc::Buffer2DManaged<TypeParam,vc::TargetHost> buf_in(67, 45);
+    TestFixture::fill(buf_in, gen);
+    
+    const KernelT gauss = vc::math::gaussianKernel<KernelScalar>(2.0);
+    KernelT kern_y(5);
+    kern_y << KernelScalar(-0.1), KernelScalar(0.2), KernelScalar(0.6), KernelScalar(0.2), KernelScalar(0.1);
+    
+    for(vc::BorderMode border : { vc::BorderMode::Clamp, vc::BorderMode::Reflect, vc::BorderMode::Wrap, vc::BorderMode::Constant, vc::BorderMode::Skip })
+    {
+        SCOPED_TRACE((int)border);
+        TestFixture::check(buf_in, gauss, kern_y, border, TypeParam(100));
+    }
+}
+
+/**
+ * Dense 2D convolve is float and double only.
+ */
+template<typename T>
+class Test_ConvolutionDense : public ::testing::Test { };
+
+typedef ::testing::Types<float, double> ConvolutionDenseTypes;
+TYPED_TEST_CASE(Test_ConvolutionDense, ConvolutionDenseTypes);
+
+TYPED_TEST(Test_ConvolutionDense, Borders)
+{
+    typedef Eigen::Matrix<TypeParam,5,5> KernelT;
+    typedef Test_Convolution<TypeParam> Helpers;
+    
+    std::mt19937 gen(99);
+    vc::Buffer2DManaged<TypeParam,vc::TargetHost> buf_in(53, 31), buf_out(53, 31);
+    Helpers::fill(buf_in, gen);
+    
+    KernelT kern;
+    for(int i = 0 ; i < kern.size() ; ++i) { kern(i) = TypeParam(1 + i % 7); }
+    const double kernsum = kern.sum();
+    
+    const vc::CPULevel previous_level = vc::getCPULevel();
+    
+    for(vc::CPULevel level : { vc::CPULevel::Generic, vc::CPULevel::AVX2, vc::CPULevel::AVX512 })
+    {
+        if(!vc::isCPULevelAvailable(level)) { continue; }
+        
+        SCOPED_TRACE(vc::cpuLevelName(level));
+        vc::setCPULevel(level);
+        
+        for(vc::BorderMode border : { vc::BorderMode::Clamp, vc::BorderMode::Reflect, vc::BorderMode::Wrap, vc::BorderMode::Constant, vc::BorderMode::Skip })
+        {
+            SCOPED_TRACE((int)border);
+            const TypeParam value(0.5), sentinel(-1.0);
+            
+            for(std::size_t y = 0 ; y < buf_out.height() ; ++y)
+            {
+                for(std::size_t x = 0 ; x < buf_out.width() ; ++x) { buf_out(x, y) = sentinel; }
+            }
+            
+            vc::math::convolve(buf_in, buf_out, kern, border, value);
+            
+            for(int y = 0 ; y < (int)buf_in.height() ; ++y)
+            {
+                for(int x = 0 ; x < (int)buf_in.width() ; ++x)
+                {
+                    if(border == vc::BorderMode::Skip && (x < 2 || y < 2 || x + 2 >= (int)buf_in.width() || y + 2 >= (int)buf_in.height()))
+                    {
+                        ASSERT_EQ(buf_out(x,y), sentinel) << "Written at " << x << " , " << y;
+                        continue;
+                    }
+                    
+                    // kernel rows go along x
+                    double expected = 0.0;
+                    for(int j = -2 ; j <= 2 ; ++j)
+                    {
+                        for(int i = -2 ; i <= 2 ; ++i)
+                        {
+                            expected += double(kern(i + 2, j + 2)) * Helpers::tap(buf_in, x + i, y + j, border, value);
+                        }
+                    }
+                    
+                    ASSERT_NEAR(double(buf_out(x,y)), expected / kernsum, 1e-5) << "Mismatch at " << x << " , " << y;
+                }
+            }
+        }
+    }
+    
+    vc::setCPULevel(previous_level);
+}
+
+TYPED_TEST(Test_Convolution, Box)
+{
+    typedef typename TestFixture::KernelT KernelT;
+    typedef typename TestFixture::KernelScalar KernelScalar;
+    
+    std::mt19937 gen(2468);
+    vc::Buffer2DManaged<TypeParam,vc::TargetHost> buf_in(83, 61), buf_out(83, 61), buf_ref(83, 61);
+    TestFixture::fill(buf_in, gen);
+    
+    const vc::CPULevel previous_level = vc::getCPULevel();
+    
+    for(vc::CPULevel level : { vc::CPULevel::Generic, vc::CPULevel::AVX2, vc::CPULevel::AVX512 })
+    {
+        if(!vc::isCPULevelAvailable(level)) { continue; }
+        
+        SCOPED_TRACE(vc::cpuLevelName(level));
+        vc::setCPULevel(level);
+        
+        const KernelT kern_x = KernelT::Constant(5, KernelScalar(1.0) / KernelScalar(5.0));
+        const KernelT kern_y = KernelT::Constant(3, KernelScalar(1.0) / KernelScalar(3.0));
+        TestFixture::check(buf_in, kern_x, kern_y, vc::BorderMode::Reflect);
+        
+        vc::math::boxFilter(buf_in, buf_out, 2, 1, vc::BorderMode::Reflect);
+        vc::math::convolveSeparable(buf_in, buf_ref, kern_x, kern_y, vc::BorderMode::Reflect);
+        
+        for(std::size_t y = 0 ; y < buf_in.height() ; ++y)
+        {
+            for(std::size_t x = 0 ; x < buf_in.width() ; ++x)
+            {
+                ASSERT_EQ(buf_out(x,y), buf_ref(x,y)) << "Mismatch at " << x << " , " << y;
+            }
+        }
+        
+        // flat stays flat, the rounded taps still add up to one
+        vc::Buffer2DManaged<TypeParam,vc::TargetHost> buf_flat(37, 29);
+        const TypeParam flat = std::is_integral<TypeParam>::value ? TypeParam(std::numeric_limits<TypeParam>::max() - 3) : TypeParam(0.75);
+        for(std::size_t y = 0 ; y < buf_flat.height() ; ++y)
+        {
+            for(std::size_t x = 0 ; x < buf_flat.width() ; ++x) { buf_flat(x,y) = flat; }
+        }
+        
+        vc::Buffer2DManaged<TypeParam,vc::TargetHost> buf_flat_out(37, 29);
+        vc::math::boxFilter(buf_flat, buf_flat_out, 3, 3);
+        
+        for(std::size_t y = 0 ; y < buf_flat.height() ; ++y)
+        {
+            for(std::size_t x = 0 ; x < buf_flat.width() ; ++x)
+            {
+                ASSERT_NEAR(double(buf_flat_out(x,y)), double(flat), 1e-5) << "Mismatch at " << x << " , " << y;
+            }
+        }
+    }
+    
+    vc::setCPULevel(previous_level);
+}
+
+TYPED_TEST(Test_Convolution, SeparableErrors)
+{
+    typedef typename TestFixture::KernelT KernelT;
+    
+    vc::Buffer2DManaged<TypeParam,vc::TargetHost> buf_in(16, 16), buf_out(16, 16), buf_small(8, 16);
+    
+    ASSERT_THROW(vc::math::convolveSeparable(buf_in, buf_out, KernelT(KernelT::Ones(2)), KernelT(KernelT::Ones(3))), std::runtime_error);
+    ASSERT_THROW(vc::math::convolveSeparable(buf_in, buf_out, KernelT(KernelT::Ones(3)), KernelT(KernelT::Ones(0))), std::runtime_error);
+    ASSERT_THROW(vc::math::convolveSeparable(buf_in, buf_small, KernelT(KernelT::Ones(3)), KernelT(KernelT::Ones(3))), std::runtime_error);
+}
@@ -0,0 +1,187 @@
+/**
+ * ****************************************************************************
+ * Copyright (c) 2017, Robert Lukierski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ****************************************************************************
+ * FFT convolution tests.
+ * ****************************************************************************
+ */
+
+// system
+#include <stdint.h>
+#include <stddef.h>
+#include <cmath>
+#include <random>
+
+// testing framework & libraries
+#include <gtest/gtest.h>
+
+// google logger
+#include <glog/logging.h>
+
+#include <VisionCore/Math/Convolution.hpp>
+#include <VisionCore/Math/FFTConvolution.hpp>
+
+template<typename T>
+class Test_FFTConvolution : public ::testing::Test
+{
+public:
+    static void fill(vc::Buffer2DView<T,vc::TargetHost>& buf, std::mt19937& gen)
+    {
+        std::uniform_real_distribution<T> dist(T(-1.0), T(1.0));
+        
+        for(std::size_t y = 0 ; y < buf.height() ; ++y)
+        {
+            for(std::size_t x = 0 ; x < buf.width() ; ++x)
+            {
+                buf(x,y) = dist(gen);
+            }
+        }
+    }
+    
+    /**
+     * Straightforward correlation in double, taps through the view border helpers.
+     */
+    static double reference(const vc::Buffer2DView<T,vc::TargetHost>& buf, const vc::Buffer2DView<T,vc::TargetHost>& kern, 
+                            int x, int y, bool correlation, vc::BorderMode border, T value)
+    {
+        const int kw = kern.width(), kh = kern.height();
+        double sum = 0.0;
+        
+        for(int j = 0 ; j < kh ; ++j)
+        {
+            for(int i = 0 ; i < kw ; ++i)
+            {
+                const int sx = x + i - kw / 2, sy = y + j - kh / 2;
+                const bool inside = sx >= 0 && sy >= 0 && sx < (int)buf.width() && sy < (int)buf.height();
+                
+                double v = buf.getWithClampedRange(sx, sy);
+                if(border == vc::BorderMode::Reflect) { v = buf.getWithReflectedRange(sx, sy); }
+                if(border == vc::BorderMode::Wrap) { v = buf.getWithCircularRange(sx, sy); }
+                if(border == vc::BorderMode::Constant && !inside) { v = value; }
+                
+                sum += v * (correlation ? kern(i, j) : kern(kw - 1 - i, kh - 1 - j));
+            }
+        }
+        
+        return sum;
+    }
+    
+    static void check(const vc::Buffer2DView<T,vc::TargetHost>& buf_in, const vc::Buffer2DView<T,vc::TargetHost>& kern, 
+                      vc::math::FFTConvolution<T>& conv, bool correlation, vc::BorderMode border, double tolerance)
+    {
+        const T value(0.25), sentinel(7.0);
+        vc::Buffer2DManaged<T,vc::TargetHost> buf_out(buf_in.width(), buf_in.height());
+        for(std::size_t y = 0 ; y < buf_out.height() ; ++y)
+        {
+            for(std::size_t x = 0 ; x < buf_out.width() ; ++x) { buf_out(x, y) = sentinel; }
+        }
+        
+        conv(buf_in, buf_out, border, value);
+        
+        const int ax = kern.width() / 2, ay = kern.height() / 2;
+        
+        for(int y = 0 ; y < (int)buf_in.height() ; ++y)
+        {
+            for(int x = 0 ; x < (int)buf_in.width() ; ++x)
+            {
+                if(border == vc::BorderMode::Skip && (x < ax || y < ay || x + ax >= (int)buf_in.width() || y + ay >= (int)buf_in.height()))
+                {
+                    ASSERT_EQ(buf_out(x,y), sentinel) << "Written at " << x << " , " << y;
+                    continue;
+                }
+                
+                ASSERT_NEAR(double(buf_out(x,y)), reference(buf_in, kern, x, y, correlation, border, value), tolerance) 
+                    << "Mismatch at " << x << " , " << y;
+            }
+        }
+    }
+};
+
+typedef ::testing::Types<float, double> FFTConvolutionTypes;
+TYPED_TEST_CASE(Test_FFTConvolution, FFTConvolutionTypes);
+
+TYPED_TEST(Test_FFTConvolution, DirectAndFFT)
+{
+    const double tolerance = std::is_same<TypeParam,float>::value ? 1e-3 : 1e-9;
+    
+    std::mt19937 gen(1234);
+    vc::Buffer2DManaged<TypeParam,vc::TargetHost> buf_in(260, 240), buf_small(40, 33);
+    TestFixture::fill(buf_in, gen);
+    TestFixture::fill(buf_small, gen);
+    
+    // odd and even sizes, not symmetric, both make more than one tile on buf_in
+    vc::Buffer2DManaged<TypeParam,vc::TargetHost> kern_odd(17, 11), kern_even(12, 16);
+    TestFixture::fill(kern_odd, gen);
+    TestFixture::fill(kern_even, gen);
+    
+    for(vc::math::ConvolutionMethod method : { vc::math::ConvolutionMethod::Direct, vc::math::ConvolutionMethod::FFT })
+    {
+        for(bool correlation : { false, true })
+        {
+            vc::math::FFTConvolution<TypeParam> conv_odd(kern_odd, correlation, method), conv_even(kern_even, correlation, method);
+            ASSERT_EQ(conv_odd.method(buf_in.width(), buf_in.height()), method);
+            
+            for(vc::BorderMode border : { vc::BorderMode::Clamp, vc::BorderMode::Reflect, vc::BorderMode::Wrap, vc::BorderMode::Constant, vc::BorderMode::Skip })
+            {
+                SCOPED_TRACE(::testing::Message() << "method " << (int)method << " correlation " << correlation << " border " << (int)border);
+                
+                // the second image size has to replace the cached spectrum
+                TestFixture::check(buf_in, kern_odd, conv_odd, correlation, border, tolerance);
+                TestFixture::check(buf_small, kern_odd, conv_odd, correlation, border, tolerance);
+                TestFixture::check(buf_in, kern_even, conv_even, correlation, border, tolerance);
+            }
+        }
+    }
+}
+
+TYPED_TEST(Test_FFTConvolution, CostModel)
+{
+    vc::Buffer2DManaged<TypeParam,vc::TargetHost> kern_small(3, 3), kern_below(7, 7), kern_above(11, 11), kern_large(41, 41);
+    kern_small.memset(0);
+    kern_below.memset(0);
+    kern_above.memset(0);
+    kern_large.memset(0);
+    
+    vc::math::FFTConvolution<TypeParam> conv_small(kern_small), conv_below(kern_below), conv_above(kern_above), conv_large(kern_large);
+    ASSERT_EQ(conv_small.method(640, 480), vc::math::ConvolutionMethod::Direct);
+    // either side of the modelled crossover
+    ASSERT_EQ(conv_below.method(640, 480), vc::math::ConvolutionMethod::Direct);
+    ASSERT_EQ(conv_above.method(640, 480), vc::math::ConvolutionMethod::FFT);
+    ASSERT_EQ(conv_large.method(640, 480), vc::math::ConvolutionMethod::FFT);
+}
+
+TYPED_TEST(Test_FFTConvolution, Errors)
+{
+    vc::Buffer2DManaged<TypeParam,vc::TargetHost> buf_in(16, 16), buf_small(8, 16), kern(3, 3);
+    kern.memset(0);
+    
+    ASSERT_THROW(vc::math::fftConvolve(buf_in, buf_small, kern), std::runtime_error);
+    ASSERT_THROW(vc::math::fftCorrelate(buf_in, buf_small, kern), std::runtime_error);
+}
@@ -0,0 +1,81 @@
+/**
+ * ****************************************************************************
+ * Copyright (c) 2017, Robert Lukierski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ****************************************************************************
+ * CPU feature detection tests.
+ * ****************************************************************************
+ */
+
+// system
+#include <stdint.h>
+#include <stddef.h>
+#include <cstring>
+#include <stdexcept>
+
+// testing framework & libraries
+#include <gtest/gtest.h>
+
+// google logger
+#include <glog/logging.h>
+
+#include <VisionCore/CPUFeatures.hpp>
+
+TEST(Test_CPUFeatures, DetectAndOverride)
+{
+    const vc::CPULevel detected = vc::detectCPULevel();
+    const vc::CPULevel previous_level = vc::getCPULevel();
+    
+    ASSERT_LE(previous_level, detected);
+    ASSERT_TRUE(vc::isCPULevelAvailable(vc::CPULevel::Generic));
+    ASSERT_TRUE(vc::isCPULevelAvailable(detected));
+    
+    vc::setCPULevel(vc::CPULevel::Generic);
+    ASSERT_EQ(vc::getCPULevel(), vc::CPULevel::Generic);
+    
+    vc::setCPULevel(detected);
+    ASSERT_EQ(vc::getCPULevel(), detected);
+    
+    if(detected != vc::CPULevel::AVX512)
+    {
+        ASSERT_FALSE(vc::isCPULevelAvailable(vc::CPULevel::AVX512));
+        ASSERT_THROW(vc::setCPULevel(vc::CPULevel::AVX512), std::runtime_error);
+        ASSERT_EQ(vc::getCPULevel(), detected);
+    }
+    
+    vc::setCPULevel(previous_level);
+}
+
+TEST(Test_CPUFeatures, Names)
+{
+    ASSERT_STREQ(vc::cpuLevelName(vc::CPULevel::Generic), "generic");
+    ASSERT_STREQ(vc::cpuLevelName(vc::CPULevel::SSE42), "sse4.2");
+    ASSERT_STREQ(vc::cpuLevelName(vc::CPULevel::AVX2), "avx2");
+    ASSERT_STREQ(vc::cpuLevelName(vc::CPULevel::AVX512), "avx512");
+}
@@ -0,0 +1,251 @@
+/**
+ * ****************************************************************************
+ * Copyright (c) 2017, Robert Lukierski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ****************************************************************************
+ * Execution context tests.
+ * ****************************************************************************
+ */
+
+// system
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <sched.h>
+#endif // __linux__
+
+#ifdef VISIONCORE_HAVE_TBB
+#include <tbb/global_control.h>
+#endif // VISIONCORE_HAVE_TBB
+
+// testing framework & libraries
+#include <gtest/gtest.h>
+
+// google logger
+#include <glog/logging.h>
+
+#include <VisionCore/LaunchUtils.hpp>
+
+class Test_ExecutionContext : public ::testing::TestWithParam<vc::LaunchBackend>
+{
+public:
+    virtual void SetUp()
+    {
+        if(!vc::isLaunchBackendAvailable(GetParam()))
+        {
+            GTEST_SKIP() << "Backend not compiled in";
+        }
+    }
+    
+    std::size_t countThreads(std::size_t items)
+    {
+        std::mutex m;
+        std::set<std::thread::id> ids;
+        
+        vc::launchParallelFor(items, [&](std::size_t)
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+            std::lock_guard<std::mutex> lock(m);
+            ids.insert(std::this_thread::get_id());
+        });
+        
+        return ids.size();
+    }
+};
+
+INSTANTIATE_TEST_CASE_P(Backends, Test_ExecutionContext, ::testing::Values(vc::LaunchBackend::Serial, 
+                                                                           vc::LaunchBackend::ThreadPool, 
+                                                                           vc::LaunchBackend::TBB));
+
+TEST_P(Test_ExecutionContext, Scope)
+{
+    vc::ExecutionContext ctx1(2, {}, vc::ExecutionContext::Priority::Normal, GetParam());
+    vc::ExecutionContext ctx2(2, {}, vc::ExecutionContext::Priority::Normal, GetParam());
+    
+    ASSERT_EQ(vc::ExecutionContext::current(), nullptr);
+    
+    {
+        vc::ExecutionContextScope s1(ctx1);
+        ASSERT_EQ(vc::ExecutionContext::current(), &ctx1);
+        
+        {
+            vc::ExecutionContextScope s2(ctx2);
+            ASSERT_EQ(vc::ExecutionContext::current(), &ctx2);
+        }
+        
+        ASSERT_EQ(vc::ExecutionContext::current(), &ctx1);
+    }
+    
+    ASSERT_EQ(vc::ExecutionContext::current(), nullptr);
+    
+    ctx1.execute([&]()
+    {
+        ASSERT_EQ(vc::ExecutionContext::current(), &ctx1);
+    });
+    
+    ASSERT_EQ(vc::ExecutionContext::current(), nullptr);
+}
+
+TEST_P(Test_ExecutionContext, MaxConcurrency)
+{
+    vc::ExecutionContext ctx(2, {}, vc::ExecutionContext::Priority::Normal, GetParam());
+    
+    if(GetParam() == vc::LaunchBackend::Serial)
+    {
+        ASSERT_EQ(ctx.concurrency(), 1u);
+    }
+    else
+    {
+        ASSERT_EQ(ctx.concurrency(), 2u);
+    }
+    
+    vc::ExecutionContextScope scope(ctx);
+    ASSERT_LE(countThreads(256), ctx.concurrency());
+    
+    // nested launches stay in the context
+    std::mutex m;
+    std::set<std::thread::id> ids;
+    vc::launchParallelFor(16, [&](std::size_t)
+    {
+        vc::launchParallelFor(16, [&](std::size_t)
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+            std::lock_guard<std::mutex> lock(m);
+            ids.insert(std::this_thread::get_id());
+        });
+    });
+    ASSERT_LE(ids.size(), ctx.concurrency());
+}
+
+TEST_P(Test_ExecutionContext, Reduce)
+{
+    vc::ExecutionContext ctx(3, {}, vc::ExecutionContext::Priority::Low, GetParam());
+    vc::ExecutionContextScope scope(ctx);
+    
+    const std::size_t n = 100000;
+    const std::size_t sum = vc::launchParallelReduce(n, std::size_t(0), [&](std::size_t i, std::size_t& v)
+    {
+        v += i;
+    },
+    [&](std::size_t v1, std::size_t v2)
+    {
+        return v1 + v2;
+    });
+    
+    ASSERT_EQ(sum, (n * (n - 1)) / 2);
+}
+
+TEST_P(Test_ExecutionContext, Nested)
+{
+#ifdef VISIONCORE_HAVE_TBB
+    // make sure there are workers to share between the arenas, even on a single CPU
+    tbb::global_control workers(tbb::global_control::max_allowed_parallelism, 4);
+#endif // VISIONCORE_HAVE_TBB
+    
+    std::atomic<int> wrong(0);
+    
+    {
+        vc::ExecutionContext outer(4, {}, vc::ExecutionContext::Priority::Normal, GetParam());
+        vc::ExecutionContext inner(4, {}, vc::ExecutionContext::Priority::Normal, GetParam());
+        
+        outer.execute([&]()
+        {
+            vc::launchParallelFor(64, [&](std::size_t)
+            {
+                if(vc::ExecutionContext::current() != &outer) { ++wrong; }
+                
+                inner.execute([&]()
+                {
+                    vc::launchParallelFor(8, [&](std::size_t)
+                    {
+                        std::this_thread::sleep_for(std::chrono::microseconds(20));
+                        if(vc::ExecutionContext::current() != &inner) { ++wrong; }
+                    });
+                });
+                
+                // back in the outer context after leaving the inner one
+                if(vc::ExecutionContext::current() != &outer) { ++wrong; }
+                std::this_thread::sleep_for(std::chrono::microseconds(20));
+            });
+        });
+    }
+    
+    ASSERT_EQ(wrong.load(), 0);
+    
+    // threads that left both contexts do not keep either of them
+    vc::launchParallelFor(256, [&](std::size_t)
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(20));
+        if(vc::ExecutionContext::current() != nullptr) { ++wrong; }
+    });
+    
+    ASSERT_EQ(wrong.load(), 0);
+}
+
+#ifdef __linux__
+TEST_P(Test_ExecutionContext, Affinity)
+{
+    if(GetParam() == vc::LaunchBackend::Serial)
+    {
+        GTEST_SKIP() << "No worker threads";
+    }
+    
+    vc::ExecutionContext ctx(2, {0}, vc::ExecutionContext::Priority::Normal, GetParam());
+    ASSERT_EQ(ctx.affinity().size(), 1u);
+    
+    std::mutex m;
+    std::set<int> cpus;
+    std::thread::id caller = std::this_thread::get_id();
+    
+    ctx.execute([&]()
+    {
+        vc::launchParallelFor(256, [&](std::size_t)
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+            if(std::this_thread::get_id() != caller)
+            {
+                std::lock_guard<std::mutex> lock(m);
+                cpus.insert(sched_getcpu());
+            }
+        });
+    });
+    
+    for(int c : cpus)
+    {
+        ASSERT_EQ(c, 0);
+    }
+}
+#endif // __linux__
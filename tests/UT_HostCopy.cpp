@@ -0,0 +1,196 @@
+/**
+ * ****************************************************************************
+ * Copyright (c) 2017, Robert Lukierski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ****************************************************************************
+ * Host copy engine tests.
+ * ****************************************************************************
+ */
+
+// system
+#include <stdint.h>
+#include <stddef.h>
+#include <algorithm>
+#include <vector>
+
+// testing framework & libraries
+#include <gtest/gtest.h>
+
+// google logger
+#include <glog/logging.h>
+
+#include <VisionCore/HostCopy.hpp>
+#include <VisionCore/ExecutionContext.hpp>
+#include <VisionCore/Buffers/Buffer2D.hpp>
+#include <VisionCore/Buffers/Buffer3D.hpp>
+
+static constexpr std::size_t BufferSizeX = 1025;
+static constexpr std::size_t BufferSizeY = 769;
+static constexpr std::size_t BufferSizeZ = 5;
+
+class Test_HostCopy : public ::testing::TestWithParam<vc::CopyHint>
+{
+public:
+    Test_HostCopy() : previous(vc::getHostCopySettings()), ctx(4), scope(ctx)
+    {
+        // everything parallel, small chunks
+        vc::HostCopySettings settings = previous;
+        settings.parallel_threshold = 0;
+        settings.chunk_bytes = 4096;
+        vc::setHostCopySettings(settings);
+    }
+    
+    virtual ~Test_HostCopy()
+    {
+        vc::setHostCopySettings(previous);
+    }
+    
+    vc::HostCopySettings        previous;
+    vc::ExecutionContext        ctx;
+    vc::ExecutionContextScope   scope;
+};
+
+INSTANTIATE_TEST_CASE_P(Hints, Test_HostCopy, ::testing::Values(vc::CopyHint::Auto, 
+                                                                vc::CopyHint::Cached, 
+                                                                vc::CopyHint::Streaming));
+
+TEST_P(Test_HostCopy, Linear)
+{
+    // odd size and misaligned destination, exercises heads and tails
+    std::vector<uint8_t> src(1000003), dst(src.size() + 1, 0);
+    for(std::size_t i = 0 ; i < src.size() ; ++i) { src[i] = uint8_t(i * 7 + 3); }
+    
+    vc::hostCopy(dst.data() + 1, src.data(), src.size(), GetParam());
+    
+    ASSERT_EQ(dst[0], 0);
+    ASSERT_TRUE(std::equal(src.begin(), src.end(), dst.begin() + 1));
+}
+
+TEST_P(Test_HostCopy, SubBuffer2D)
+{
+    vc::Buffer2DManaged<uint32_t, vc::TargetHost> big(BufferSizeX, BufferSizeY);
+    vc::Buffer2DManaged<uint32_t, vc::TargetHost> out(BufferSizeX / 2, BufferSizeY / 2);
+    
+    for(std::size_t y = 0 ; y < big.height() ; ++y)
+    {
+        for(std::size_t x = 0 ; x < big.width() ; ++x)
+        {
+            big(x,y) = uint32_t(y * BufferSizeX + x);
+        }
+    }
+    
+    out.memset(0xFF);
+    
+    // centre region, row stride of the big image
+    const std::size_t ox = 3, oy = 100;
+    const vc::Buffer2DView<uint32_t, vc::TargetHost> sub(big.ptr(ox, oy), out.width(), out.height(), big.pitch());
+    out.copyFrom(sub, GetParam());
+    
+    for(std::size_t y = 0 ; y < out.height() ; ++y)
+    {
+        for(std::size_t x = 0 ; x < out.width() ; ++x)
+        {
+            ASSERT_EQ(out(x,y), uint32_t((y + oy) * BufferSizeX + x + ox)) << "Wrong value at " << x << "," << y;
+        }
+    }
+}
+
+TEST_P(Test_HostCopy, Volume3D)
+{
+    vc::Buffer3DManaged<uint16_t, vc::TargetHost> vol(BufferSizeX, BufferSizeY, BufferSizeZ);
+    
+    for(std::size_t z = 0 ; z < vol.depth() ; ++z)
+    {
+        for(std::size_t y = 0 ; y < vol.height() ; ++y)
+        {
+            for(std::size_t x = 0 ; x < vol.width() ; ++x)
+            {
+                vol(x,y,z) = uint16_t(z * 1000 + y * 3 + x);
+            }
+        }
+    }
+    
+    // packed destination with a padded plane pitch
+    const std::size_t pitch = BufferSizeX * sizeof(uint16_t), plane = pitch * (BufferSizeY + 3);
+    std::vector<uint8_t> storage(plane * BufferSizeZ, 0);
+    vc::Buffer3DView<uint16_t, vc::TargetHost> packed(storage.data(), BufferSizeX, BufferSizeY, BufferSizeZ, pitch, plane);
+    
+    packed.copyFrom(vol, GetParam());
+    
+    for(std::size_t z = 0 ; z < vol.depth() ; ++z)
+    {
+        for(std::size_t y = 0 ; y < vol.height() ; ++y)
+        {
+            for(std::size_t x = 0 ; x < vol.width() ; ++x)
+            {
+                ASSERT_EQ(packed(x,y,z), vol(x,y,z)) << "Wrong value at " << x << "," << y << "," << z;
+            }
+        }
+        
+        // plane padding untouched
+        ASSERT_EQ(storage[z * plane + pitch * BufferSizeY], 0);
+    }
+}
+
+TEST_P(Test_HostCopy, Memset)
+{
+    std::vector<uint8_t> dst(1000003 + 2, 0);
+    
+    vc::hostMemset(dst.data() + 1, 0x5A, dst.size() - 2);
+    
+    ASSERT_EQ(dst.front(), 0);
+    ASSERT_EQ(dst.back(), 0);
+    ASSERT_TRUE(std::all_of(dst.begin() + 1, dst.end() - 1, [](uint8_t v) { return v == 0x5A; }));
+}
+
+TEST_P(Test_HostCopy, FillSubBuffer)
+{
+    struct Pixel { float x, y, z; };
+    vc::Buffer2DManaged<Pixel, vc::TargetHost> big(BufferSizeX, BufferSizeY);
+    big.fill(Pixel{ 1.0f, 2.0f, 3.0f });
+    
+    // rows only, neighbours of the sub-buffer keep their value
+    const std::size_t ox = 5, oy = 7;
+    vc::Buffer2DView<Pixel, vc::TargetHost> sub(big.ptr(ox, oy), 100, 300, big.pitch());
+    sub.fill(Pixel{ -1.0f, -2.0f, -3.0f });
+    
+    for(std::size_t y = 0 ; y < big.height() ; ++y)
+    {
+        for(std::size_t x = 0 ; x < big.width() ; ++x)
+        {
+            const bool inside = x >= ox && x < ox + sub.width() && y >= oy && y < oy + sub.height();
+            ASSERT_EQ(big(x,y).z, inside ? -3.0f : 3.0f) << "Wrong value at " << x << "," << y;
+        }
+    }
+    
+    vc::Buffer3DManaged<double, vc::TargetHost> vol(BufferSizeX, 33, BufferSizeZ);
+    vol.fill(0.5);
+    ASSERT_EQ(vol(BufferSizeX - 1, 32, BufferSizeZ - 1), 0.5);
+    ASSERT_EQ(vol(0, 0, 0), 0.5);
+}
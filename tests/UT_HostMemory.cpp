@@ -0,0 +1,358 @@
+/**
+ * ****************************************************************************
+ * Copyright (c) 2017, Robert Lukierski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ****************************************************************************
+ * Host memory pool tests.
+ * ****************************************************************************
+ */
+
+// system
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// testing framework & libraries
+#include <gtest/gtest.h>
+
+// google logger
+#include <glog/logging.h>
+
+#include <VisionCore/HostMemory.hpp>
+#include <VisionCore/Buffers/Buffer2D.hpp>
+#include <VisionCore/Buffers/Buffer3D.hpp>
+
+class Test_HostMemory : public ::testing::Test
+{
+public:
+    Test_HostMemory() : was_enabled(vc::HostMemoryPool::isEnabled()), previous_hwm(vc::HostMemoryPool::highWaterMark())
+    {
+        vc::HostMemoryPool::setHighWaterMark(vc::HostMemoryPool::DefaultHighWaterMark);
+        vc::HostMemoryPool::setEnabled(true);
+        vc::HostMemoryPool::trim();
+        vc::HostMemoryPool::resetStats();
+    }
+    
+    virtual ~Test_HostMemory()
+    {
+        vc::HostMemoryPool::trim();
+        vc::HostMemoryPool::setHighWaterMark(previous_hwm);
+        vc::HostMemoryPool::setEnabled(was_enabled);
+    }
+    
+    bool was_enabled;
+    std::size_t previous_hwm;
+};
+
+TEST_F(Test_HostMemory, Alignment)
+{
+    for(std::size_t alignment : { 8, 64, 4096 })
+    {
+        for(std::size_t bytes : { 0, 1, 300, 100000 })
+        {
+            void* ptr = vc::hostAllocate(bytes, alignment);
+            ASSERT_EQ(reinterpret_cast<uintptr_t>(ptr) % alignment, 0u);
+            ASSERT_GE(vc::hostAllocationSize(ptr), bytes);
+            vc::hostDeallocate(ptr);
+        }
+    }
+    
+    // a 64 byte aligned block can't serve a page aligned request
+    void* ptr = vc::hostAllocate(1000, 64);
+    vc::hostDeallocate(ptr);
+    ptr = vc::hostAllocate(1000, 4096);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(ptr) % 4096, 0u);
+    vc::hostDeallocate(ptr);
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+TEST_F(Test_HostMemory, DefaultAlignment)
+{
+    unsetenv("VISIONCORE_HOST_ALIGNMENT");
+    ASSERT_EQ(vc::hostDefaultAlignment(64), 64u);
+    
+    setenv("VISIONCORE_HOST_ALIGNMENT", "4096", 1);
+    ASSERT_EQ(vc::hostDefaultAlignment(64), 4096u);
+    
+    // not a power of two, too small
+    setenv("VISIONCORE_HOST_ALIGNMENT", "48", 1);
+    ASSERT_EQ(vc::hostDefaultAlignment(64), 64u);
+    setenv("VISIONCORE_HOST_ALIGNMENT", "2", 1);
+    ASSERT_EQ(vc::hostDefaultAlignment(64), 64u);
+    
+    unsetenv("VISIONCORE_HOST_ALIGNMENT");
+}
+#endif
+
+TEST_F(Test_HostMemory, SteadyState)
+{
+    for(std::size_t frame = 0 ; frame < 10 ; ++frame)
+    {
+        if(frame == 1) { vc::HostMemoryPool::resetStats(); }
+        
+        vc::Buffer2DManaged<float, vc::TargetHost> depth(640, 480);
+        vc::Buffer2DManaged<uint8_t, vc::TargetHost> gray(640, 480);
+        vc::Buffer2DManaged<float, vc::TargetHost> small(320 - frame, 240);  // same size class
+        depth.memset(0);
+    }
+    
+    const vc::HostMemoryPoolStats st = vc::HostMemoryPool::stats();
+    ASSERT_EQ(st.system_allocations, 0u);
+    ASSERT_EQ(st.system_frees, 0u);
+    ASSERT_EQ(st.misses, 0u);
+    ASSERT_EQ(st.hits, 27u);
+    ASSERT_EQ(st.cached_blocks, 3u);
+}
+
+TEST_F(Test_HostMemory, HighWaterMark)
+{
+    vc::HostMemoryPool::setHighWaterMark(1 << 20);
+    
+    std::vector<void*> blocks;
+    for(std::size_t i = 0 ; i < 8 ; ++i) { blocks.push_back(vc::hostAllocate(256 * 1024, 64)); }
+    for(void* ptr : blocks) { vc::hostDeallocate(ptr); }
+    
+    const vc::HostMemoryPoolStats st = vc::HostMemoryPool::stats();
+    ASSERT_LE(st.cached_bytes, std::size_t(1 << 20));
+    ASSERT_LE(st.peak_cached_bytes, std::size_t(1 << 20));
+    ASSERT_EQ(st.cached_blocks, 4u);
+    ASSERT_EQ(st.system_frees, 4u);
+}
+
+TEST_F(Test_HostMemory, CrossThread)
+{
+    std::vector<void*> blocks(16);
+    
+    std::thread producer([&]()
+    {
+        for(auto& ptr : blocks) { ptr = vc::hostAllocate(4096, 64); }
+    });
+    producer.join();
+    
+    std::thread consumer([&]()
+    {
+        for(void* ptr : blocks) { vc::hostDeallocate(ptr); }
+    });
+    consumer.join();
+    
+    // the consumer's thread cache went to the shared lists when it exited
+    vc::HostMemoryPool::resetStats();
+    for(auto& ptr : blocks) { ptr = vc::hostAllocate(4096, 64); }
+    ASSERT_EQ(vc::HostMemoryPool::stats().hits, blocks.size());
+    for(void* ptr : blocks) { vc::hostDeallocate(ptr); }
+}
+
+TEST_F(Test_HostMemory, Trim)
+{
+    vc::hostDeallocate(vc::hostAllocate(1 << 20, 64));
+    ASSERT_GT(vc::HostMemoryPool::stats().cached_bytes, 0u);
+    
+    vc::HostMemoryPool::trim();
+    
+    const vc::HostMemoryPoolStats st = vc::HostMemoryPool::stats();
+    ASSERT_EQ(st.cached_bytes, 0u);
+    ASSERT_EQ(st.cached_blocks, 0u);
+    ASSERT_EQ(st.system_frees, 1u);
+}
+
+TEST_F(Test_HostMemory, TrimOtherThreads)
+{
+    std::mutex m;
+    std::condition_variable cv;
+    int stage = 0;
+    
+    // keeps blocks in its own cache and stays alive until trim() is done
+    std::thread worker([&]()
+    {
+        vc::hostDeallocate(vc::hostAllocate(4096, 64));
+        vc::hostDeallocate(vc::hostAllocate(100000, 64));
+        
+        std::unique_lock<std::mutex> lock(m);
+        stage = 1;
+        cv.notify_all();
+        cv.wait(lock, [&]() { return stage == 2; });
+        
+        // the emptied cache still works
+        vc::hostDeallocate(vc::hostAllocate(4096, 64));
+    });
+    
+    {
+        std::unique_lock<std::mutex> lock(m);
+        cv.wait(lock, [&]() { return stage == 1; });
+    }
+    
+    // EXPECT, the worker has to be released either way
+    EXPECT_EQ(vc::HostMemoryPool::stats().cached_blocks, 2u);
+    
+    vc::HostMemoryPool::trim();
+    
+    vc::HostMemoryPoolStats st = vc::HostMemoryPool::stats();
+    EXPECT_EQ(st.cached_bytes, 0u);
+    EXPECT_EQ(st.cached_blocks, 0u);
+    EXPECT_EQ(st.system_frees, 2u);
+    
+    {
+        std::lock_guard<std::mutex> lock(m);
+        stage = 2;
+        cv.notify_all();
+    }
+    worker.join();
+    
+    st = vc::HostMemoryPool::stats();
+    ASSERT_EQ(st.cached_blocks, 1u);
+    ASSERT_EQ(st.misses, 3u);
+}
+
+TEST_F(Test_HostMemory, Disabled)
+{
+    vc::HostMemoryPool::setEnabled(false);
+    vc::hostDeallocate(vc::hostAllocate(1000, 64));
+    
+    const vc::HostMemoryPoolStats st = vc::HostMemoryPool::stats();
+    ASSERT_EQ(st.cached_bytes, 0u);
+    ASSERT_EQ(st.hits + st.misses, 0u);
+    ASSERT_EQ(st.system_allocations, st.system_frees);
+}
+
+class Test_HostMapped : public ::testing::TestWithParam<vc::HugePages>
+{
+public:
+    Test_HostMapped() : previous(vc::getHostMapSettings())
+    {
+        vc::HostMapSettings settings;
+        settings.threshold = 1 << 20;
+        settings.huge_pages = GetParam();
+        settings.lazy_commit = true;
+        vc::setHostMapSettings(settings);
+    }
+    
+    virtual ~Test_HostMapped()
+    {
+        vc::setHostMapSettings(previous);
+    }
+    
+    vc::HostMapSettings previous;
+};
+
+INSTANTIATE_TEST_CASE_P(HugePages, Test_HostMapped, ::testing::Values(vc::HugePages::Off, 
+                                                                      vc::HugePages::Transparent, 
+                                                                      vc::HugePages::Explicit));
+
+TEST_P(Test_HostMapped, AllocateDiscard)
+{
+    void* small = vc::hostAllocate(1000, 64);
+    ASSERT_FALSE(vc::hostIsMapped(small));
+    ASSERT_FALSE(vc::hostDiscard(small, 1000));
+    vc::hostDeallocate(small);
+    
+    const std::size_t bytes = (3 << 20) + 123;
+    uint8_t* ptr = static_cast<uint8_t*>(vc::hostAllocate(bytes, 4096));
+    
+#if (defined(__unix__) || defined(__APPLE__)) && !defined(VISIONCORE_HAVE_CUDA)
+    ASSERT_TRUE(vc::hostIsMapped(ptr));
+    ASSERT_TRUE(vc::hostIsMapped(ptr + bytes - 1));
+    ASSERT_FALSE(vc::hostIsMapped(ptr + bytes));
+#endif
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(ptr) % 4096, 0u);
+    
+    for(std::size_t i = 0 ; i < bytes ; ++i) { ptr[i] = 0xAB; }
+    
+    // unaligned range, neighbours untouched
+    const std::size_t begin = 100, end = bytes - 77;
+    if(vc::hostDiscard(ptr + begin, end - begin))
+    {
+        for(std::size_t i = 0 ; i < bytes ; ++i)
+        {
+            ASSERT_EQ(ptr[i], (i >= begin && i < end) ? 0 : 0xAB) << "At " << i;
+        }
+    }
+    
+    // not fully inside
+    ASSERT_FALSE(vc::hostDiscard(ptr + 10, bytes));
+    
+    vc::hostDeallocate(ptr);
+    ASSERT_FALSE(vc::hostIsMapped(ptr));
+}
+
+TEST_P(Test_HostMapped, Volume)
+{
+    vc::Buffer3DManaged<float, vc::TargetHost> vol(128, 64, 64);
+    
+    for(std::size_t z = 0 ; z < vol.depth() ; ++z)
+    {
+        for(std::size_t y = 0 ; y < vol.height() ; ++y)
+        {
+            for(std::size_t x = 0 ; x < vol.width() ; ++x)
+            {
+                vol(x,y,z) = 1.0f;
+            }
+        }
+    }
+    
+    vol.memset(0);
+    
+    for(std::size_t z = 0 ; z < vol.depth() ; ++z)
+    {
+        for(std::size_t y = 0 ; y < vol.height() ; ++y)
+        {
+            for(std::size_t x = 0 ; x < vol.width() ; ++x)
+            {
+                ASSERT_EQ(vol(x,y,z), 0.0f);
+            }
+        }
+    }
+}
+
+TEST(Test_HostNuma, Placement)
+{
+    const vc::HostNumaSettings previous = vc::getHostNumaSettings();
+    
+    ASSERT_GE(vc::hostNumaNodes(), 1u);
+    
+    for(vc::NumaPolicy policy : { vc::NumaPolicy::Interleave, vc::NumaPolicy::Bind })
+    {
+        vc::HostNumaSettings settings;
+        settings.policy = policy;
+        settings.node = 0;
+        settings.threshold = 1 << 20;
+        vc::setHostNumaSettings(settings);
+        
+        vc::Buffer2DManaged<float, vc::TargetHost> buf(1024, 1024);
+        buf.fill(1.0f);
+        ASSERT_EQ(buf(1023, 1023), 1.0f);
+        
+        ASSERT_EQ(vc::hostNumaPlace(buf.ptr(), buf.bytes(), policy), vc::hostNumaAvailable());
+    }
+    
+    vc::setHostNumaSettings(previous);
+}
@@ -0,0 +1,186 @@
+/**
+ * ****************************************************************************
+ * Copyright (c) 2017, Robert Lukierski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ****************************************************************************
+ * Asynchronous launch tests.
+ * ****************************************************************************
+ */
+
+// system
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+// testing framework & libraries
+#include <gtest/gtest.h>
+
+// google logger
+#include <glog/logging.h>
+
+#include <VisionCore/LaunchUtils.hpp>
+#include <VisionCore/Buffers/Buffer2D.hpp>
+#include <VisionCore/Image/BufferOps.hpp>
+#include <VisionCore/Image/PixelConvert.hpp>
+
+class Test_LaunchAsync : public ::testing::Test
+{
+public:
+    Test_LaunchAsync()
+    {
+        
+    }
+    
+    virtual ~Test_LaunchAsync()
+    {
+        
+    }
+};
+
+TEST_F(Test_LaunchAsync, Value)
+{
+    vc::LaunchFuture<int> f = vc::launchAsync([]() { return 42; });
+    ASSERT_TRUE(f.valid());
+    ASSERT_EQ(f.get(), 42);
+    ASSERT_TRUE(f.ready());
+    
+    vc::LaunchEvent invalid;
+    ASSERT_FALSE(invalid.valid());
+    ASSERT_TRUE(invalid.ready());
+    invalid.wait();
+}
+
+TEST_F(Test_LaunchAsync, Dependencies)
+{
+    std::atomic<int> stage(0);
+    
+    vc::LaunchEvent e1 = vc::launchAsync([&]() { ASSERT_EQ(stage.load(), 0); stage = 1; });
+    vc::LaunchEvent e2 = vc::launchAsync([&]() { ASSERT_EQ(stage.load(), 1); stage = 2; }, {e1});
+    vc::LaunchEvent e3 = e2.then([&]() { ASSERT_EQ(stage.load(), 2); stage = 3; });
+    vc::LaunchFuture<int> f = e3.then([&]() { return stage.load(); });
+    
+    ASSERT_EQ(f.get(), 3);
+    
+    std::atomic<int> count(0);
+    std::vector<vc::LaunchEvent> events;
+    for(int i = 0 ; i < 16 ; ++i)
+    {
+        events.push_back(vc::launchAsync([&]() { count++; }));
+    }
+    
+    vc::whenAll(events).wait();
+    ASSERT_EQ(count.load(), 16);
+}
+
+TEST_F(Test_LaunchAsync, Exception)
+{
+    bool ran = false;
+    
+    vc::LaunchEvent e1 = vc::launchAsync([]() { throw std::runtime_error("failed"); });
+    vc::LaunchEvent e2 = e1.then([&]() { ran = true; });
+    
+    ASSERT_THROW(e1.wait(), std::runtime_error);
+    ASSERT_THROW(e2.wait(), std::runtime_error);
+    ASSERT_FALSE(ran);
+}
+
+TEST_F(Test_LaunchAsync, ContextLifetime)
+{
+    for(vc::LaunchBackend lb : { vc::LaunchBackend::ThreadPool, vc::LaunchBackend::TBB })
+    {
+        if(!vc::isLaunchBackendAvailable(lb)) { continue; }
+        
+        // completed by hand, so the task is still pending when the context goes away
+        std::shared_ptr<vc::detail::AsyncState> gate = std::make_shared<vc::detail::AsyncState>();
+        
+        std::unique_ptr<vc::ExecutionContext> ctx(new vc::ExecutionContext(2, std::vector<int>(), 
+                                                                           vc::ExecutionContext::Priority::Normal, lb));
+        vc::ExecutionContext* raw = ctx.get();
+        std::atomic<bool> ran_inside(false);
+        
+        vc::LaunchEvent ev;
+        {
+            vc::ExecutionContextScope scope(*ctx);
+            ev = vc::launchAsync([&]() 
+            { 
+                ran_inside = vc::ExecutionContext::current() == raw; 
+            }, { vc::LaunchEvent(gate) });
+        }
+        
+        std::thread opener([&]()
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            gate->complete();
+        });
+        
+        // blocks until the launch has run
+        ctx.reset();
+        
+        ASSERT_TRUE(ev.ready());
+        ASSERT_TRUE(ran_inside);
+        opener.join();
+        ev.wait();
+    }
+}
+
+TEST_F(Test_LaunchAsync, Parallel)
+{
+    const std::size_t n = 100000;
+    std::vector<std::size_t> data(n, 0);
+    
+    vc::LaunchEvent fill = vc::launchParallelForAsync(n, [&](std::size_t i) { data[i] = i; });
+    vc::LaunchFuture<std::size_t> sum = vc::launchParallelReduceAsync(n, std::size_t(0), 
+    [&](std::size_t i, std::size_t& v)
+    {
+        v += data[i];
+    },
+    [](std::size_t v1, std::size_t v2)
+    {
+        return v1 + v2;
+    }, {fill});
+    
+    ASSERT_EQ(sum.get(), (n * (n - 1)) / 2);
+}
+
+TEST_F(Test_LaunchAsync, BufferOps)
+{
+    vc::Buffer2DManaged<uint16_t, vc::TargetHost> depth(64, 48);
+    vc::Buffer2DManaged<float, vc::TargetHost> depthf(64, 48);
+    
+    vc::LaunchEvent filled = vc::image::fillBuffer(vc::AsyncLaunch(), depth, uint16_t(1000));
+    vc::LaunchEvent converted = vc::image::convertBuffer(vc::AsyncLaunch({filled}), depth, depthf);
+    vc::LaunchFuture<float> sum = vc::image::bufferSum(vc::AsyncLaunch({converted}), depthf, 0.0f);
+    
+    ASSERT_FLOAT_EQ(sum.get(), 1000.0f * 64.0f * 48.0f);
+}
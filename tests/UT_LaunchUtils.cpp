@@ -0,0 +1,166 @@
+/**
+ * ****************************************************************************
+ * Copyright (c) 2017, Robert Lukierski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ****************************************************************************
+ * Parallel launch tests.
+ * ****************************************************************************
+ */
+
+// system
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include <vector>
+
+// testing framework & libraries
+#include <gtest/gtest.h>
+
+// google logger
+#include <glog/logging.h>
+
+#include <VisionCore/LaunchUtils.hpp>
+
+static constexpr std::size_t BufferSizeX = 1025;
+static constexpr std::size_t BufferSizeY = 769;
+
+class Test_LaunchUtils : public ::testing::TestWithParam<vc::LaunchBackend>
+{
+public:
+    Test_LaunchUtils() : hits(BufferSizeX * BufferSizeY), previous_backend(vc::getLaunchBackend())
+    {
+        for(auto& h : hits) { h = 0; }
+    }
+
+    virtual ~Test_LaunchUtils()
+    {
+        vc::setLaunchBackend(previous_backend);
+    }
+
+    virtual void SetUp()
+    {
+        if(!vc::isLaunchBackendAvailable(GetParam()))
+        {
+            GTEST_SKIP() << "Backend not compiled in";
+        }
+
+        vc::setLaunchBackend(GetParam());
+    }
+
+    void checkHits()
+    {
+        for(std::size_t i = 0 ; i < hits.size() ; ++i)
+        {
+            ASSERT_EQ(hits[i].load(), 1) << "Element " << i << " visited wrong number of times";
+        }
+    }
+
+    std::vector<std::atomic<int>> hits;
+    vc::LaunchBackend previous_backend;
+};
+
+INSTANTIATE_TEST_CASE_P(Backends, Test_LaunchUtils, ::testing::Values(vc::LaunchBackend::Serial, 
+                                                                      vc::LaunchBackend::ThreadPool, 
+                                                                      vc::LaunchBackend::TBB));
+
+TEST_P(Test_LaunchUtils, PerItem)
+{
+    vc::launchParallelFor(BufferSizeX, BufferSizeY, [&](std::size_t x, std::size_t y)
+    {
+        hits[y * BufferSizeX + x]++;
+    });
+
+    checkHits();
+}
+
+TEST_P(Test_LaunchUtils, Rows)
+{
+    for(std::size_t grain : { vc::LaunchGrainAuto, std::size_t(1), std::size_t(7), BufferSizeY * 2 })
+    {
+        for(auto& h : hits) { h = 0; }
+
+        vc::launchParallelForRows(BufferSizeX, BufferSizeY, [&](std::size_t y, std::size_t x_begin, std::size_t x_end)
+        {
+            ASSERT_EQ(x_begin, 0u);
+            ASSERT_EQ(x_end, BufferSizeX);
+
+            for(std::size_t x = x_begin ; x < x_end ; ++x)
+            {
+                hits[y * BufferSizeX + x]++;
+            }
+        }, grain);
+
+        checkHits();
+    }
+}
+
+TEST_P(Test_LaunchUtils, Tiles)
+{
+    vc::launchParallelForTiles(BufferSizeX, BufferSizeY,
+                               [&](std::size_t x_begin, std::size_t x_end, std::size_t y_begin, std::size_t y_end)
+    {
+        ASSERT_LE(x_end - x_begin, 64u);
+        ASSERT_LE(y_end - y_begin, 8u);
+
+        for(std::size_t y = y_begin ; y < y_end ; ++y)
+        {
+            for(std::size_t x = x_begin ; x < x_end ; ++x)
+            {
+                hits[y * BufferSizeX + x]++;
+            }
+        }
+    }, 64, 8);
+
+    checkHits();
+}
+
+TEST_P(Test_LaunchUtils, ReduceRows)
+{
+    const std::size_t sum = vc::launchParallelReduceRows(BufferSizeX, BufferSizeY, std::size_t(0),
+    [&](std::size_t y, std::size_t x_begin, std::size_t x_end, std::size_t& v)
+    {
+        for(std::size_t x = x_begin ; x < x_end ; ++x)
+        {
+            v += y * BufferSizeX + x;
+        }
+    },
+    [&](std::size_t v1, std::size_t v2)
+    {
+        return v1 + v2;
+    });
+
+    const std::size_t n = BufferSizeX * BufferSizeY;
+    ASSERT_EQ(sum, (n * (n - 1)) / 2);
+}
+
+TEST_P(Test_LaunchUtils, Empty)
+{
+    vc::launchParallelForRows(0, BufferSizeY, [&](std::size_t, std::size_t, std::size_t) { FAIL(); });
+    vc::launchParallelForTiles(BufferSizeX, 0, [&](std::size_t, std::size_t, std::size_t, std::size_t) { FAIL(); });
+}
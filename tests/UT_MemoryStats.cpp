@@ -0,0 +1,150 @@
+/**
+ * ****************************************************************************
+ * Copyright (c) 2017, Robert Lukierski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ****************************************************************************
+ * Memory accounting tests.
+ * ****************************************************************************
+ */
+
+// system
+#include <stdint.h>
+#include <stddef.h>
+#include <algorithm>
+#include <sstream>
+#include <thread>
+
+// testing framework & libraries
+#include <gtest/gtest.h>
+
+// google logger
+#include <glog/logging.h>
+
+#include <VisionCore/MemoryStats.hpp>
+#include <VisionCore/MemoryPolicy.hpp>
+#include <VisionCore/Buffers/Buffer1D.hpp>
+#include <VisionCore/Buffers/Buffer2D.hpp>
+
+TEST(Test_MemoryStats, LiveAndPeak)
+{
+    const vc::memstats::Counters before = vc::memstats::counters(vc::MemoryTarget::Host);
+    
+    {
+        vc::Buffer2DManaged<float, vc::TargetHost> b1(640, 480);
+        vc::Buffer2DManaged<float, vc::TargetHost> b2(320, 240);
+        
+        const vc::memstats::Counters during = vc::memstats::counters(vc::MemoryTarget::Host);
+        ASSERT_GE(during.live_bytes - before.live_bytes, b1.bytes() + b2.bytes());
+        ASSERT_GE(during.peak_bytes, during.live_bytes);
+        ASSERT_EQ(during.allocations - before.allocations, 2u);
+    }
+    
+    const vc::memstats::Counters after = vc::memstats::counters(vc::MemoryTarget::Host);
+    ASSERT_EQ(after.live_bytes, before.live_bytes);
+    ASSERT_EQ(after.deallocations - before.deallocations, 2u);
+    ASSERT_GE(after.peak_bytes, before.live_bytes + 640 * 480 * sizeof(float));
+    
+    vc::memstats::resetCounters();
+    ASSERT_EQ(vc::memstats::counters(vc::MemoryTarget::Host).peak_bytes, after.live_bytes);
+}
+
+TEST(Test_MemoryStats, Labels)
+{
+    const std::size_t bytes = 1 << 20;
+    
+    {
+        vc::memstats::LabelScope outer("test-outer");
+        vc::Buffer1DManaged<uint8_t, vc::TargetHost> a(bytes);
+        
+        {
+            vc::memstats::LabelScope inner("test-inner");
+            vc::Buffer1DManaged<uint8_t, vc::TargetHost> b(bytes);
+            
+            ASSERT_GE(vc::memstats::counters(vc::MemoryTarget::Host, "test-inner").live_bytes, bytes);
+        }
+        
+        // freed outside its scope, still counted against its own label
+        ASSERT_EQ(vc::memstats::counters(vc::MemoryTarget::Host, "test-inner").live_bytes, 0u);
+        ASSERT_GE(vc::memstats::counters(vc::MemoryTarget::Host, "test-outer").live_bytes, bytes);
+        
+        // labels are per thread
+        std::thread([&]()
+        {
+            vc::Buffer1DManaged<uint8_t, vc::TargetHost> c(bytes);
+            ASSERT_EQ(vc::memstats::counters(vc::MemoryTarget::Host, "test-outer").allocations, 1u);
+        }).join();
+    }
+    
+    ASSERT_EQ(vc::memstats::counters(vc::MemoryTarget::Host, "test-outer").live_bytes, 0u);
+    ASSERT_EQ(vc::memstats::counters(vc::MemoryTarget::Host, "test-unknown").allocations, 0u);
+    
+    const std::vector<std::string> labels = vc::memstats::labels();
+    ASSERT_NE(std::find(labels.begin(), labels.end(), "test-inner"), labels.end());
+    
+    std::stringstream ss;
+    vc::memstats::writeReport(ss);
+    ASSERT_NE(ss.str().find("test-outer"), std::string::npos);
+}
+
+TEST(Test_MemoryStats, Transfers)
+{
+    vc::Buffer2DManaged<uint16_t, vc::TargetHost> src(100, 50), dst(100, 50);
+    
+    const uint64_t before = vc::memstats::transferredBytes(vc::MemoryTarget::Host, vc::MemoryTarget::Host);
+    
+    {
+        vc::memstats::LabelScope label("test-copy");
+        dst.copyFrom(src);
+    }
+    
+    const uint64_t expected = 100 * 50 * sizeof(uint16_t);
+    ASSERT_EQ(vc::memstats::transferredBytes(vc::MemoryTarget::Host, vc::MemoryTarget::Host) - before, expected);
+    ASSERT_EQ(vc::memstats::counters(vc::MemoryTarget::Host, "test-copy").bytes_copied_in, expected);
+    ASSERT_EQ(vc::memstats::counters(vc::MemoryTarget::Host, "test-copy").copies_in, 1u);
+}
+
+TEST(Test_MemoryStats, Tracked)
+{
+    int key = 0;
+    const vc::memstats::Counters before = vc::memstats::counters(vc::MemoryTarget::OpenCL);
+    
+    {
+        vc::memstats::LabelScope label("test-tracked");
+        vc::memstats::trackAllocation(vc::MemoryTarget::OpenCL, &key, 4096);
+    }
+    
+    ASSERT_EQ(vc::memstats::counters(vc::MemoryTarget::OpenCL).live_bytes - before.live_bytes, 4096u);
+    ASSERT_EQ(vc::memstats::counters(vc::MemoryTarget::OpenCL, "test-tracked").live_bytes, 4096u);
+    
+    vc::memstats::untrackAllocation(vc::MemoryTarget::OpenCL, &key);
+    vc::memstats::untrackAllocation(vc::MemoryTarget::OpenCL, &key); // unknown keys are ignored
+    
+    ASSERT_EQ(vc::memstats::counters(vc::MemoryTarget::OpenCL).live_bytes, before.live_bytes);
+    ASSERT_EQ(vc::memstats::counters(vc::MemoryTarget::OpenCL, "test-tracked").deallocations, 1u);
+}
@@ -0,0 +1,212 @@
+/**
+ * ****************************************************************************
+ * Copyright (c) 2017, Robert Lukierski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ****************************************************************************
+ * Hardware performance counters tests.
+ * ****************************************************************************
+ */
+
+// system
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+// testing framework & libraries
+#include <gtest/gtest.h>
+
+// google logger
+#include <glog/logging.h>
+
+#include <VisionCore/PerfCounters.hpp>
+#include <VisionCore/Trace.hpp>
+
+static double busyWork(std::size_t ms)
+{
+    volatile double acc = 0.0;
+    const auto until = std::chrono::steady_clock::now() + std::chrono::milliseconds(ms);
+    
+    while(std::chrono::steady_clock::now() < until)
+    {
+        for(int i = 0 ; i < 1000 ; ++i) { acc = acc + i * 0.5; }
+    }
+    
+    return acc;
+}
+
+TEST(Test_PerfCounters, Sample)
+{
+    vc::perf::Sample s1, s2;
+    ASSERT_FALSE(s1.any());
+    ASSERT_EQ(s1.ipc(), 0.0);
+    
+    s1.valid[(std::size_t)vc::perf::Counter::Cycles] = true;
+    s1.valid[(std::size_t)vc::perf::Counter::Instructions] = true;
+    s1.values[(std::size_t)vc::perf::Counter::Cycles] = 1000;
+    s1.values[(std::size_t)vc::perf::Counter::Instructions] = 2500;
+    
+    s2.valid[(std::size_t)vc::perf::Counter::Cycles] = true;
+    s2.values[(std::size_t)vc::perf::Counter::Cycles] = 400;
+    
+    ASSERT_TRUE(s1.any());
+    ASSERT_DOUBLE_EQ(s1.ipc(), 2.5);
+    
+    const vc::perf::Sample diff = s1 - s2;
+    ASSERT_TRUE(diff.has(vc::perf::Counter::Cycles));
+    ASSERT_FALSE(diff.has(vc::perf::Counter::Instructions));
+    ASSERT_EQ(diff.get(vc::perf::Counter::Cycles), 600u);
+    
+    // clamped
+    ASSERT_EQ((s2 - s1).get(vc::perf::Counter::Cycles), 0u);
+    
+    vc::perf::Sample acc;
+    acc += diff;
+    acc += diff;
+    ASSERT_TRUE(acc.has(vc::perf::Counter::Cycles));
+    ASSERT_EQ(acc.get(vc::perf::Counter::Cycles), 1200u);
+    
+    ASSERT_STREQ(vc::perf::counterName(vc::perf::Counter::LLCMisses), "llc_misses");
+}
+
+TEST(Test_PerfCounters, Thread)
+{
+    vc::perf::Counters counters(vc::perf::Counters::Mode::Thread);
+    
+    if(!counters.available(vc::perf::Counter::TaskClock))
+    {
+        GTEST_SKIP() << "Counters not available";
+    }
+    
+    ASSERT_EQ(counters.threads(), 1u);
+    
+    vc::perf::Sample s;
+    {
+        vc::perf::Scope scope(s, counters);
+        busyWork(20);
+    }
+    
+    ASSERT_TRUE(s.has(vc::perf::Counter::TaskClock));
+    ASSERT_GT(s.get(vc::perf::Counter::TaskClock), 5000000u);
+    
+    if(s.has(vc::perf::Counter::Instructions))
+    {
+        ASSERT_GT(s.get(vc::perf::Counter::Instructions), 0u);
+    }
+}
+
+TEST(Test_PerfCounters, Process)
+{
+    std::atomic<bool> start(false);
+    std::thread worker([&]()
+    {
+        while(!start) { std::this_thread::yield(); }
+        busyWork(30);
+    });
+    
+    vc::perf::Counters counters(vc::perf::Counters::Mode::Process);
+    
+    if(!counters.available(vc::perf::Counter::TaskClock))
+    {
+        start = true;
+        worker.join();
+        GTEST_SKIP() << "Counters not available";
+    }
+    
+    ASSERT_GE(counters.threads(), 2u);
+    
+    const vc::perf::Sample before = counters.read();
+    start = true;
+    worker.join();
+    
+    // the worker exited, its counts stay
+    const vc::perf::Sample diff = counters.read() - before;
+    ASSERT_GT(diff.get(vc::perf::Counter::TaskClock), 10000000u);
+}
+
+TEST(Test_PerfCounters, Rescan)
+{
+    vc::perf::Counters counters(vc::perf::Counters::Mode::Process);
+    
+    if(!counters.available(vc::perf::Counter::TaskClock))
+    {
+        GTEST_SKIP() << "Counters not available";
+    }
+    
+    const std::size_t base = counters.threads();
+    
+    for(int round = 0 ; round < 2 ; ++round)
+    {
+        std::atomic<bool> start(false);
+        std::thread w1([&]() { while(!start) { std::this_thread::yield(); } busyWork(15); });
+        std::thread w2([&]() { while(!start) { std::this_thread::yield(); } busyWork(15); });
+        
+        counters.rescan();
+        ASSERT_EQ(counters.threads(), base + 2);
+        
+        const vc::perf::Sample before = counters.read();
+        start = true;
+        w1.join();
+        w2.join();
+        
+        // exited threads are released, what they counted stays
+        counters.rescan();
+        ASSERT_EQ(counters.threads(), base);
+        
+        const vc::perf::Sample diff = counters.read() - before;
+        ASSERT_GT(diff.get(vc::perf::Counter::TaskClock), 10000000u);
+    }
+}
+
+TEST(Test_PerfCounters, Trace)
+{
+    vc::trace::setEnabled(true);
+    vc::trace::clear();
+    
+    if(!vc::trace::setHardwareCounters(true))
+    {
+        GTEST_SKIP() << "Counters not available";
+    }
+    
+    {
+        vc::trace::Scope scope("busy");
+        busyWork(10);
+    }
+    
+    vc::trace::setHardwareCounters(false);
+    
+    const std::vector<vc::trace::Event> evs = vc::trace::events();
+    vc::trace::clear();
+    
+    ASSERT_EQ(evs.size(), 1u);
+    ASSERT_TRUE(evs[0].counters.any());
+    ASSERT_GT(evs[0].counters.get(vc::perf::Counter::TaskClock), 1000000u);
+}
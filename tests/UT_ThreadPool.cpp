@@ -0,0 +1,143 @@
+/**
+ * ****************************************************************************
+ * Copyright (c) 2017, Robert Lukierski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * ****************************************************************************
+ * Thread pool tests.
+ * ****************************************************************************
+ */
+
+// system
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include <future>
+#include <stdexcept>
+#include <vector>
+
+// testing framework & libraries
+#include <gtest/gtest.h>
+
+// google logger
+#include <glog/logging.h>
+
+#include <VisionCore/ThreadPool.hpp>
+
+class Test_ThreadPool : public ::testing::Test
+{
+public:
+    Test_ThreadPool()
+    {
+
+    }
+
+    virtual ~Test_ThreadPool()
+    {
+
+    }
+};
+
+TEST_F(Test_ThreadPool, ParallelFor)
+{
+    for(std::size_t workers : { 1, 3, 8 })
+    {
+        vc::ThreadPool pool(workers);
+        ASSERT_EQ(pool.workers(), workers);
+
+        std::vector<std::atomic<int>> hits(100003);
+        for(auto& h : hits) { h = 0; }
+
+        pool.parallelFor(0, hits.size(), 16, [&](std::size_t b, std::size_t e)
+        {
+            ASSERT_LT(b, e);
+            for(std::size_t i = b ; i < e ; ++i) { hits[i]++; }
+        });
+
+        for(std::size_t i = 0 ; i < hits.size() ; ++i)
+        {
+            ASSERT_EQ(hits[i].load(), 1) << "Element " << i;
+        }
+    }
+}
+
+TEST_F(Test_ThreadPool, ParallelReduce)
+{
+    vc::ThreadPool pool(4);
+
+    const std::size_t n = 1000001;
+    const std::size_t sum = pool.parallelReduce(0, n, 1, std::size_t(0),
+    [&](std::size_t b, std::size_t e, std::size_t& v)
+    {
+        for(std::size_t i = b ; i < e ; ++i) { v += i; }
+    },
+    [&](std::size_t v1, std::size_t v2)
+    {
+        return v1 + v2;
+    });
+
+    ASSERT_EQ(sum, (n * (n - 1)) / 2);
+}
+
+TEST_F(Test_ThreadPool, Nested)
+{
+    vc::ThreadPool pool(2);
+    std::atomic<std::size_t> count(0);
+
+    pool.parallelFor(0, 16, 1, [&](std::size_t b, std::size_t e)
+    {
+        for(std::size_t i = b ; i < e ; ++i)
+        {
+            pool.parallelFor(0, 1000, 1, [&](std::size_t ib, std::size_t ie) { count += (ie - ib); });
+        }
+    });
+
+    ASSERT_EQ(count.load(), 16u * 1000u);
+}
+
+TEST_F(Test_ThreadPool, Exception)
+{
+    vc::ThreadPool pool(3);
+
+    ASSERT_THROW(pool.parallelFor(0, 1000, 1, [&](std::size_t b, std::size_t e)
+    {
+        if(b <= 500 && 500 < e) { throw std::runtime_error("Boom"); }
+    }), std::runtime_error);
+}
+
+TEST_F(Test_ThreadPool, Submit)
+{
+    vc::ThreadPool pool(2);
+    std::promise<int> p;
+    std::future<int> f = p.get_future();
+
+    pool.submit([&]() { p.set_value(42); });
+
+    ASSERT_EQ(f.get(), 42);
+}
@@ -0,0 +1,149 @@
+/**
+ * ****************************************************************************
+ * Copyright (c) 2017, Robert Lukierski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ****************************************************************************
+ * Tracing tests.
+ * ****************************************************************************
+ */
+
+// system
+#include <stdint.h>
+#include <stddef.h>
+#include <cstring>
+#include <sstream>
+#include <string>
+
+// testing framework & libraries
+#include <gtest/gtest.h>
+
+// google logger
+#include <glog/logging.h>
+
+#include <VisionCore/LaunchUtils.hpp>
+#include <VisionCore/Trace.hpp>
+
+class Test_Trace : public ::testing::Test
+{
+public:
+    Test_Trace()
+    {
+        vc::trace::setEnabled(true);
+        vc::trace::clear();
+    }
+    
+    virtual ~Test_Trace()
+    {
+        vc::trace::clear();
+    }
+};
+
+TEST_F(Test_Trace, Scope)
+{
+    {
+        vc::trace::Scope outer("outer", "op", 640, 480, 1024);
+        ASSERT_STREQ(vc::trace::currentScope(), "outer");
+        
+        {
+            vc::trace::Scope inner("inner");
+            ASSERT_STREQ(vc::trace::currentScope(), "inner");
+        }
+        
+        ASSERT_STREQ(vc::trace::currentScope(), "outer");
+    }
+    
+    ASSERT_STREQ(vc::trace::currentScope(), "launch");
+    
+    std::vector<vc::trace::Event> evs = vc::trace::events();
+    ASSERT_EQ(evs.size(), 2u);
+    
+    // ordered by start time, outer contains inner
+    ASSERT_STREQ(evs[0].name, "outer");
+    ASSERT_STREQ(evs[1].name, "inner");
+    ASSERT_EQ(evs[0].width, 640u);
+    ASSERT_EQ(evs[0].height, 480u);
+    ASSERT_EQ(evs[0].bytes, 1024u);
+    ASSERT_LE(evs[0].start_ns, evs[1].start_ns);
+    ASSERT_GE(evs[0].start_ns + evs[0].duration_ns, evs[1].start_ns + evs[1].duration_ns);
+    ASSERT_EQ(evs[0].thread_id, evs[1].thread_id);
+}
+
+TEST_F(Test_Trace, Disabled)
+{
+    vc::trace::setEnabled(false);
+    
+    {
+        vc::trace::Scope scope("ignored");
+    }
+    
+    vc::trace::setEnabled(true);
+    
+    ASSERT_TRUE(vc::trace::events().empty());
+}
+
+TEST_F(Test_Trace, ChromeTrace)
+{
+    {
+        vc::trace::Scope scope("with \"quotes\"", "op", 1, 2, 3);
+    }
+    
+    std::stringstream ss;
+    vc::trace::writeChromeTrace(ss);
+    const std::string json = ss.str();
+    
+    ASSERT_NE(json.find("\"traceEvents\":["), std::string::npos);
+    ASSERT_NE(json.find("\"name\":\"with \\\"quotes\\\"\""), std::string::npos);
+    ASSERT_NE(json.find("\"ph\":\"X\""), std::string::npos);
+    ASSERT_NE(json.find("\"args\":{\"width\":1,\"height\":2,\"bytes\":3}"), std::string::npos);
+}
+
+#ifdef VISIONCORE_HAVE_TRACE
+TEST_F(Test_Trace, Launch)
+{
+    {
+        VISIONCORE_TRACE_SCOPE("myop");
+        vc::launchParallelForRows(256, 256, [&](std::size_t, std::size_t, std::size_t) { });
+    }
+    
+    std::size_t kernels = 0, rows = 0;
+    for(const vc::trace::Event& ev : vc::trace::events())
+    {
+        ASSERT_STREQ(ev.name, "myop");
+        
+        if(std::strcmp(ev.category, "kernel") == 0)
+        {
+            kernels++;
+            rows += ev.width;
+        }
+    }
+    
+    ASSERT_GE(kernels, 1u);
+    ASSERT_EQ(rows, 256u);
+}
+#endif // VISIONCORE_HAVE_TRACE